@@ -0,0 +1,205 @@
+/******************************************************************************
+* File Name:   audio_capture.cpp
+*
+* Description: N-buffered PDM/PCM capture, see audio_capture.h.
+*
+* Every buffer is owned by exactly one side at a time:
+*   FREE    -> FILLING  (ISR, when the previous slice completes)
+*   FILLING -> READY    (ISR, slice complete and the next buffer is free)
+*   READY   -> IN_USE   (application, audio_capture_acquire)
+*   IN_USE  -> FREE     (application, audio_capture_release)
+* If the next buffer is not free when a slice completes, the DMA keeps
+* recording into the same buffer and the slice is counted as an overrun.
+*******************************************************************************/
+
+#include "audio_capture.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define DMA_TRANSFERS_PER_SLICE     (AUDIO_CAPTURE_SLICE_SAMPLES / AUDIO_CAPTURE_DMA_SAMPLES)
+
+/*******************************************************************************
+* Types
+********************************************************************************/
+typedef enum {
+    BUFFER_FREE = 0,
+    BUFFER_FILLING,
+    BUFFER_READY,
+    BUFFER_IN_USE
+} buffer_state_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+extern "C" {
+	 static void audio_capture_isr_handler(void *arg, cyhal_pdm_pcm_event_t event);
+}
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static int16_t slice_buffers[AUDIO_CAPTURE_NUM_BUFFERS][AUDIO_CAPTURE_SLICE_SAMPLES];
+static volatile uint8_t buffer_state[AUDIO_CAPTURE_NUM_BUFFERS];
+
+/* Buffer the DMA writes to, only changed by the ISR */
+static volatile uint32_t write_index = 0;
+/* Oldest buffer not yet released, only changed by the application */
+static volatile uint32_t read_index = 0;
+static volatile uint32_t dma_transfer_count = 0;
+static volatile bool capture_running = false;
+
+static volatile audio_capture_stats_t capture_stats;
+static cyhal_pdm_pcm_t *capture_pdm_pcm = NULL;
+
+
+/*******************************************************************************
+* Function Name: audio_capture_init
+********************************************************************************
+* Summary:
+* Resets the buffer ring and takes over the ASYNC_COMPLETE event of the
+* PDM/PCM block.
+*******************************************************************************/
+void audio_capture_init(cyhal_pdm_pcm_t *pdm_pcm)
+{
+    capture_pdm_pcm = pdm_pcm;
+    capture_running = false;
+
+    for (uint32_t i = 0; i < AUDIO_CAPTURE_NUM_BUFFERS; i++) {
+        buffer_state[i] = BUFFER_FREE;
+    }
+    write_index = 0;
+    read_index = 0;
+    dma_transfer_count = 0;
+
+    capture_stats.slices_captured = 0;
+    capture_stats.overruns = 0;
+    capture_stats.dropped_samples = 0;
+    capture_stats.max_ready = 0;
+
+    cyhal_pdm_pcm_register_callback(capture_pdm_pcm, audio_capture_isr_handler, NULL);
+    cyhal_pdm_pcm_enable_event(capture_pdm_pcm, CYHAL_PDM_PCM_ASYNC_COMPLETE, CYHAL_ISR_PRIORITY_DEFAULT, true);
+}
+
+/*******************************************************************************
+* Function Name: audio_capture_start
+********************************************************************************
+* Summary:
+* Starts filling the first free buffer.
+*******************************************************************************/
+cy_rslt_t audio_capture_start(void)
+{
+    buffer_state[write_index] = BUFFER_FILLING;
+    dma_transfer_count = 0;
+    capture_running = true;
+
+    return cyhal_pdm_pcm_read_async(capture_pdm_pcm, slice_buffers[write_index], AUDIO_CAPTURE_DMA_SAMPLES);
+}
+
+/*******************************************************************************
+* Function Name: audio_capture_stop
+********************************************************************************
+* Summary:
+* Stops issuing DMA transfers. Slices already completed can still be acquired.
+*******************************************************************************/
+void audio_capture_stop(void)
+{
+    capture_running = false;
+    cyhal_pdm_pcm_abort_async(capture_pdm_pcm);
+    buffer_state[write_index] = BUFFER_FREE;
+}
+
+/*******************************************************************************
+* Function Name: audio_capture_acquire
+********************************************************************************
+* Summary:
+* Hands the oldest completed slice to the application.
+*******************************************************************************/
+const int16_t *audio_capture_acquire(void)
+{
+    if (buffer_state[read_index] != BUFFER_READY) {
+        return NULL;
+    }
+    buffer_state[read_index] = BUFFER_IN_USE;
+
+    return slice_buffers[read_index];
+}
+
+/*******************************************************************************
+* Function Name: audio_capture_release
+********************************************************************************
+* Summary:
+* Gives the acquired slice back so the DMA can record into it again.
+*******************************************************************************/
+void audio_capture_release(const int16_t *slice)
+{
+    if ((buffer_state[read_index] != BUFFER_IN_USE) || (slice != slice_buffers[read_index])) {
+        return;
+    }
+    buffer_state[read_index] = BUFFER_FREE;
+    read_index = (read_index + 1u) % AUDIO_CAPTURE_NUM_BUFFERS;
+}
+
+/*******************************************************************************
+* Function Name: audio_capture_get_stats
+********************************************************************************
+* Summary:
+* Copies the capture counters.
+*******************************************************************************/
+void audio_capture_get_stats(audio_capture_stats_t *stats)
+{
+    stats->slices_captured = capture_stats.slices_captured;
+    stats->overruns = capture_stats.overruns;
+    stats->dropped_samples = capture_stats.dropped_samples;
+    stats->max_ready = capture_stats.max_ready;
+}
+
+/*******************************************************************************
+* Function Name: audio_capture_isr_handler
+********************************************************************************
+* Summary:
+* PDM/PCM ISR handler. Chains the DMA transfers of a slice and moves to the
+* next buffer once the slice is complete.
+*******************************************************************************/
+static void audio_capture_isr_handler(void *arg, cyhal_pdm_pcm_event_t event)
+{
+    (void) arg;
+    (void) event;
+
+    if (!capture_running) {
+        return;
+    }
+
+    dma_transfer_count++;
+
+    if (dma_transfer_count >= DMA_TRANSFERS_PER_SLICE)
+    {
+        uint32_t next_index = (write_index + 1u) % AUDIO_CAPTURE_NUM_BUFFERS;
+        dma_transfer_count = 0;
+
+        if (buffer_state[next_index] == BUFFER_FREE)
+        {
+            buffer_state[write_index] = BUFFER_READY;
+            buffer_state[next_index] = BUFFER_FILLING;
+            write_index = next_index;
+            capture_stats.slices_captured++;
+
+            uint32_t ready = (write_index + AUDIO_CAPTURE_NUM_BUFFERS - read_index) % AUDIO_CAPTURE_NUM_BUFFERS;
+            if (ready > capture_stats.max_ready) {
+                capture_stats.max_ready = ready;
+            }
+        }
+        else
+        {
+            /* Application still owns every other buffer: record over this slice */
+            capture_stats.overruns++;
+            capture_stats.dropped_samples += AUDIO_CAPTURE_SLICE_SAMPLES;
+        }
+    }
+
+    cyhal_pdm_pcm_read_async(capture_pdm_pcm,
+                             slice_buffers[write_index] + dma_transfer_count * AUDIO_CAPTURE_DMA_SAMPLES,
+                             AUDIO_CAPTURE_DMA_SAMPLES);
+}
+
+/* [] END OF FILE */
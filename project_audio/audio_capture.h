@@ -0,0 +1,70 @@
+/******************************************************************************
+* File Name:   audio_capture.h
+*
+* Description: N-buffered PDM/PCM capture. The DMA fills one slice buffer
+*              while the application owns the previously completed ones, so
+*              microphone acquisition overlaps DSP and inference.
+*******************************************************************************/
+
+#ifndef AUDIO_CAPTURE_H_
+#define AUDIO_CAPTURE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+extern "C"{
+	#include "cyhal.h"
+}
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of slice buffers, 2 = ping-pong */
+#ifndef AUDIO_CAPTURE_NUM_BUFFERS
+#define AUDIO_CAPTURE_NUM_BUFFERS       2u
+#endif
+/* Samples handed to the application at once */
+#ifndef AUDIO_CAPTURE_SLICE_SAMPLES
+#define AUDIO_CAPTURE_SLICE_SAMPLES     4000u
+#endif
+/* Samples per cyhal_pdm_pcm_read_async transfer */
+#ifndef AUDIO_CAPTURE_DMA_SAMPLES
+#define AUDIO_CAPTURE_DMA_SAMPLES       1000u
+#endif
+
+#if (AUDIO_CAPTURE_SLICE_SAMPLES % AUDIO_CAPTURE_DMA_SAMPLES) != 0
+#error "AUDIO_CAPTURE_SLICE_SAMPLES must be a multiple of AUDIO_CAPTURE_DMA_SAMPLES"
+#endif
+#if AUDIO_CAPTURE_NUM_BUFFERS < 2
+#error "AUDIO_CAPTURE_NUM_BUFFERS must be at least 2"
+#endif
+
+/*******************************************************************************
+* Types
+********************************************************************************/
+typedef struct {
+    uint32_t slices_captured;   /* slices handed over to the application */
+    uint32_t overruns;          /* slices overwritten because no buffer was free */
+    uint32_t dropped_samples;   /* samples lost to overruns */
+    uint32_t max_ready;         /* deepest backlog of completed slices seen */
+} audio_capture_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Registers the capture ISR on an initialized PDM/PCM object and resets all buffers */
+void audio_capture_init(cyhal_pdm_pcm_t *pdm_pcm);
+/* Issues the first DMA transfer; capture then runs until audio_capture_stop */
+cy_rslt_t audio_capture_start(void);
+void audio_capture_stop(void);
+
+/* Oldest completed slice, or NULL. The buffer belongs to the caller until released */
+const int16_t *audio_capture_acquire(void);
+/* Returns the slice acquired last to the DMA */
+void audio_capture_release(const int16_t *slice);
+
+void audio_capture_get_stats(audio_capture_stats_t *stats);
+
+#endif /* AUDIO_CAPTURE_H_ */
+
+/* [] END OF FILE */
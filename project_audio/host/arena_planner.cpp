@@ -0,0 +1,1462 @@
+/******************************************************************************
+* File Name:   arena_planner.cpp
+*
+* Description: Offline tensor arena planner for the EON-compiled model. Reads
+*              the node graph (inputsN / outputsN, used_ops[]) and the tensor
+*              table (tensorData[]) of tflite-model/<model>_compiled.cpp, derives
+*              the lifetime of every arena tensor (first to last node that
+*              reads or writes it; graph inputs from node 0, graph outputs to
+*              the last node) and lays the tensors out again:
+*
+*              - In place: the output of a RESHAPE, or of an element-wise op
+*                (same bytes as its first input), shares the bytes of that
+*                input when the input is not read after it. The RESHAPE
+*                kernel skips its copy when both are the same buffer.
+*              - The merged buffers go through the TFLM memory planners
+*                (GreedyMemoryPlanner, LinearMemoryPlanner) and a first fit
+*                in order of first use, with 16-byte aligned sizes, like the
+*                generated plan.
+*
+*              Every plan is checked (no two buffers alive at the same node
+*              overlap) and compared with the lower bound, the most bytes
+*              alive at any node. --write puts the smaller of the greedy and
+*              first fit plans into tensorData[] unless it is larger than the
+*              generated one; the
+*              room kTensorArenaSize keeps above the tensors (persistent and
+*              scratch buffers of the kernels) stays the same.
+*
+*              --fold rewrites the graph before planning it:
+*
+*              - A RESHAPE of a graph input that no other node reads is
+*                dropped, its output becomes the graph input.
+*              - A PAD (zero point, height and width only) that only feeds a
+*                CONV_2D or DEPTHWISE_CONV_2D is dropped, the convolution reads
+*                its input and takes the padding as explicit_padding_* in its
+*                params. Every other convolution gets them as zeros, so all
+*                the params initializers are complete.
+*
+*              --fuse (after --fold) rewrites every DEPTHWISE_CONV_2D whose
+*              output only feeds a 1x1, stride 1 CONV_2D (int8, constant
+*              filters) into one DEPTHWISE_SEPARABLE_CONV_2D node
+*              (micro/kernels/depthwise_separable_conv.cc) with the inputs of
+*              both and the params of both; the CONV_2D is dropped. The
+*              intermediate tensor keeps its dims but only FUSED_TILE_BYTES
+*              (whole pixels) of arena: the kernel runs through it a tile at a
+*              time. Adds the operator to used_operators_e, the registrations
+*              and the profiler tables, and the tensor slots it needs.
+*              The fused kernel is only measured faster with the x86 kernels
+*              (nn_kernel_bench); with CMSIS-NN it would trade the SIMD
+*              depthwise kernels for a portable loop, so a fused model stops
+*              the build with #error when EI_CLASSIFIER_TFLITE_ENABLE_CMSIS_NN
+*              is set. The model this project ships is not fused.
+*
+*              The tensors of the dropped nodes stay in tensorData[] (out of
+*              the arena) so no tensor index changes. A table compares the
+*              bytes alive at every node before and after; --write then writes
+*              the rewritten graph with its own plan.
+*
+*              --classify runs the test_sample.h clip through the linked model
+*              and prints the scores and the arena the kernels use, to compare
+*              a build before and after --write.
+*
+* Usage:       arena_planner [--verbose] [--fold] [--fuse] [--write] [--classify] [compiled.cpp]
+*******************************************************************************/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "test_sample.h"
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "edge-impulse-sdk/dsp/numpy.hpp"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/padding.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/memory_planner/linear_memory_planner.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Offsets and sizes of the arena tensors, as in the generated plan */
+#define ARENA_ALIGNMENT             16
+
+/* Arena bytes --fuse gives the intermediate tile of a fused node */
+#define FUSED_TILE_BYTES            256
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+/* One entry of tensorData[] */
+typedef struct {
+    std::string line;           // its line in the source text
+    size_t line_pos;
+    bool arena;                 // kTfLiteArenaRw
+    int bytes;
+    int offset;                 // generated offset (arena tensors)
+    size_t offset_pos;          // position of the offset in the source text
+    size_t offset_len;
+    int first;                  // first and last node using it (-1: unused)
+    int last;
+    int group;                  // buffer it shares (itself unless in place)
+    int buffer_first;           // lifetime of the buffer (group tensor only)
+    int buffer_last;
+} planned_tensor_t;
+
+/* One node: operator name and tensor indices */
+typedef struct {
+    int id;                     // N of its inputsN, outputsN and opdataN
+    bool has_opdata;
+    std::string op;
+    std::vector<int> inputs;
+    std::vector<int> outputs;
+} planned_node_t;
+
+/* The model as read from the compiled source */
+typedef struct {
+    std::string text;
+    std::vector<planned_tensor_t> tensors;
+    std::vector<planned_node_t> nodes;
+    std::vector<int> graph_inputs;
+    std::vector<int> graph_outputs;
+    std::vector<size_t> arena_size_pos;     // every kTensorArenaSize definition
+    std::vector<size_t> arena_size_len;
+    int arena_size;
+} planned_model_t;
+
+/* A replacement in the source text */
+typedef struct {
+    size_t pos;
+    size_t len;
+    std::string value;
+} source_edit_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Element-wise operators whose output may take the place of their first input:
+ * every kernel writes output[i] only from input[i] (and the other input at i) */
+static const char *in_place_ops[] = {
+    "OP_RESHAPE", "OP_ADD", "OP_SUB", "OP_MUL", "OP_RELU", "OP_RELU6",
+    "OP_LOGISTIC", "OP_TANH", "OP_HARD_SWISH",
+};
+
+/*******************************************************************************
+* Function Name: read_file
+*******************************************************************************/
+static bool read_file(const char *path, std::string *text)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    char buffer[65536];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        text->append(buffer, n);
+    }
+    fclose(f);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: parse_int_list
+********************************************************************************
+* Summary:
+* The comma separated integers between text[start] and the next '}'.
+*******************************************************************************/
+static std::vector<int> parse_int_list(const std::string &text, size_t start)
+{
+    std::vector<int> values;
+    size_t end = text.find('}', start);
+    const char *p = text.c_str() + start;
+    const char *stop = text.c_str() + end;
+    while (p < stop) {
+        char *next;
+        long v = strtol(p, &next, 10);
+        if (next == p) {
+            p++;
+            continue;
+        }
+        values.push_back((int)v);
+        p = next;
+    }
+    return values;
+}
+
+/*******************************************************************************
+* Function Name: parse_array
+********************************************************************************
+* Summary:
+* Elements of "name[] = { ... }" (the first definition of name).
+*******************************************************************************/
+static bool parse_array(const std::string &text, const char *name, std::vector<int> *values)
+{
+    size_t pos = text.find(std::string(name) + "[] = {");
+    if (pos == std::string::npos) {
+        return false;
+    }
+    *values = parse_int_list(text, text.find('{', pos) + 1);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: parse_model
+*******************************************************************************/
+static bool parse_model(planned_model_t *model)
+{
+    const std::string &text = model->text;
+
+    /* tensorData[]: "{ kTfLiteArenaRw, type, (int32_t*)(tensor_arena + N), dims, bytes, ..." */
+    size_t pos = text.find("TensorInfo_t tensorData[] = {");
+    if (pos == std::string::npos) {
+        printf("ERR: no tensorData[] table\n");
+        return false;
+    }
+    size_t table_end = text.find("\n};", pos);
+    pos = text.find('\n', pos);
+    while ((pos = text.find("\n{ kTfLite", pos)) != std::string::npos && pos < table_end) {
+        pos++;
+        size_t line_end = text.find('\n', pos);
+        std::string line = text.substr(pos, line_end - pos);
+
+        planned_tensor_t t = { };
+        t.line = line;
+        t.line_pos = pos;
+        t.arena = line.compare(0, strlen("{ kTfLiteArenaRw"), "{ kTfLiteArenaRw") == 0;
+        t.first = -1;
+        t.last = -1;
+        t.group = (int)model->tensors.size();
+
+        /* the fields after the data pointer: dims, then the byte count */
+        size_t data_pos = line.find("(int32_t*)");
+        size_t dims_pos;
+        if (t.arena) {
+            const char *marker = "tensor_arena + ";
+            size_t m = line.find(marker, data_pos);
+            if (m == std::string::npos) {
+                printf("ERR: arena tensor %d without a tensor_arena offset\n", (int)model->tensors.size());
+                return false;
+            }
+            m += strlen(marker);
+            size_t m_end = m;
+            while (m_end < line.size() && line[m_end] >= '0' && line[m_end] <= '9') {
+                m_end++;
+            }
+            t.offset = atoi(line.c_str() + m);
+            t.offset_pos = pos + m;
+            t.offset_len = m_end - m;
+            dims_pos = line.find(')', m_end) + 1;
+        }
+        else {
+            dims_pos = line.find(',', data_pos);
+        }
+        size_t bytes_pos = line.find(',', dims_pos + 1);
+        t.bytes = atoi(line.c_str() + bytes_pos + 1);
+        model->tensors.push_back(t);
+        pos = line_end;
+    }
+
+    /* nodes: "{ (TfLiteIntArray*)&g0::inputsN, ..." lines of tflNodes[], operator
+     * per node in used_ops[], tensors in inputsN / outputsN */
+    std::vector<int> node_index;
+    if (!parse_array(text, "tflNodes_subgraph_index", &node_index) || node_index.size() < 2) {
+        printf("ERR: no tflNodes_subgraph_index[]\n");
+        return false;
+    }
+    size_t node_count = (size_t)node_index.back();
+
+    const char *node_marker = "\n{ (TfLiteIntArray*)&g0::inputs";
+    pos = text.find("TfLiteNode tflNodes[");
+    table_end = pos == std::string::npos ? pos : text.find("\n};", pos);
+    while (pos != std::string::npos && (pos = text.find(node_marker, pos)) < table_end) {
+        pos += strlen(node_marker);
+        size_t line_end = text.find('\n', pos);
+        planned_node_t node;
+        node.id = atoi(text.c_str() + pos);
+        node.has_opdata = text.substr(pos, line_end - pos).find("&g0::opdata") != std::string::npos;
+        model->nodes.push_back(node);
+        pos = line_end;
+    }
+    if (model->nodes.size() != node_count) {
+        printf("ERR: %d nodes in tflNodes[], %d in tflNodes_subgraph_index[]\n",
+               (int)model->nodes.size(), (int)node_count);
+        return false;
+    }
+
+    pos = text.find("used_ops[] =");
+    if (pos == std::string::npos) {
+        printf("ERR: no used_ops[]\n");
+        return false;
+    }
+    pos = text.find('{', pos) + 1;
+    for (size_t n = 0; n < node_count; n++) {
+        while (text[pos] == ' ' || text[pos] == ',') {
+            pos++;
+        }
+        size_t end = pos;
+        while (text[end] == '_' || isalnum((unsigned char)text[end])) {
+            end++;
+        }
+        planned_node_t &node = model->nodes[n];
+        node.op = text.substr(pos, end - pos);
+        pos = end;
+
+        for (int io = 0; io < 2; io++) {
+            char name[32];
+            snprintf(name, sizeof(name), " %s%d = {", io == 0 ? "inputs" : "outputs", node.id);
+            size_t p = text.find(name);
+            if (p == std::string::npos) {
+                printf("ERR: no%s\n", name);
+                return false;
+            }
+            /* "{ count, { a,b,c } }" */
+            std::vector<int> list = parse_int_list(text, text.find('{', p + strlen(name)) + 1);
+            (io == 0 ? node.inputs : node.outputs) = list;
+        }
+    }
+
+    if (!parse_array(text, "in_tensor_indices", &model->graph_inputs) ||
+        !parse_array(text, "out_tensor_indices", &model->graph_outputs)) {
+        printf("ERR: no in_tensor_indices[] / out_tensor_indices[]\n");
+        return false;
+    }
+
+    /* every "constexpr int kTensorArenaSize = N;" (one per allocation variant) */
+    const char *marker = "constexpr int kTensorArenaSize = ";
+    pos = 0;
+    while ((pos = text.find(marker, pos)) != std::string::npos) {
+        pos += strlen(marker);
+        size_t end = text.find(';', pos);
+        model->arena_size_pos.push_back(pos);
+        model->arena_size_len.push_back(end - pos);
+        pos = end;
+    }
+    if (model->arena_size_pos.empty()) {
+        printf("ERR: no kTensorArenaSize\n");
+        return false;
+    }
+    model->arena_size = atoi(text.c_str() + model->arena_size_pos.back());
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: parse_tfarray
+********************************************************************************
+* Summary:
+* Elements of "name = { count, { a,b,c } }" (dims of a tensor).
+*******************************************************************************/
+static std::vector<int> parse_tfarray(const std::string &text, const std::string &name)
+{
+    size_t pos = text.find(" " + name + " = {");
+    if (pos == std::string::npos) {
+        return std::vector<int>();
+    }
+    std::vector<int> values = parse_int_list(text, text.find('{', pos) + 1);
+    if (!values.empty()) {
+        values.erase(values.begin());
+    }
+    return values;
+}
+
+/*******************************************************************************
+* Function Name: tensor_field
+********************************************************************************
+* Summary:
+* Field ix (0: allocation type, 1: type, 2: data, 3: dims, 4: bytes, 5:
+* quantization) of a tensorData[] line.
+*******************************************************************************/
+static std::string tensor_field(const planned_tensor_t &tensor, int ix)
+{
+    const std::string &line = tensor.line;
+    size_t start = 2;
+    for (int i = 0; i < ix; i++) {
+        start = line.find(", ", start) + 2;
+    }
+    if (ix == 5) {
+        return line.substr(start, line.rfind("}, }") - start + 1);
+    }
+    return line.substr(start, line.find(", ", start) - start);
+}
+
+/*******************************************************************************
+* Function Name: tensor_dims
+*******************************************************************************/
+static std::vector<int> tensor_dims(const planned_model_t &model, int t)
+{
+    std::string dims = tensor_field(model.tensors[t], 3);
+    return parse_tfarray(model.text, dims.substr(dims.find("::") + 2));
+}
+
+/*******************************************************************************
+* Function Name: tensor_values
+********************************************************************************
+* Summary:
+* Contents of a constant tensor, "tensor_dataN[...] = { ... }".
+*******************************************************************************/
+static std::vector<int> tensor_values(const planned_model_t &model, int t)
+{
+    std::string data = tensor_field(model.tensors[t], 2);
+    size_t name = data.find("::");
+    if (model.tensors[t].arena || name == std::string::npos) {
+        return std::vector<int>();
+    }
+    size_t pos = model.text.find(" " + data.substr(name + 2) + "[");
+    if (pos == std::string::npos) {
+        return std::vector<int>();
+    }
+    return parse_int_list(model.text, model.text.find('{', pos) + 1);
+}
+
+/*******************************************************************************
+* Function Name: readers_of
+*******************************************************************************/
+static std::vector<int> readers_of(const planned_model_t &model, int t)
+{
+    std::vector<int> readers;
+    for (size_t n = 0; n < model.nodes.size(); n++) {
+        const std::vector<int> &inputs = model.nodes[n].inputs;
+        if (std::find(inputs.begin(), inputs.end(), t) != inputs.end()) {
+            readers.push_back((int)n);
+        }
+    }
+    return readers;
+}
+
+/*******************************************************************************
+* Function Name: line_edit
+********************************************************************************
+* Summary:
+* Removes the line holding text[pos].
+*******************************************************************************/
+static source_edit_t line_edit(const std::string &text, size_t pos)
+{
+    size_t start = text.rfind('\n', pos) + 1;
+    return { start, text.find('\n', pos) + 1 - start, "" };
+}
+
+/*******************************************************************************
+* Function Name: apply_edits
+*******************************************************************************/
+static void apply_edits(std::string *text, std::vector<source_edit_t> edits)
+{
+    /* replaced from the end so the positions before stay valid */
+    std::sort(edits.begin(), edits.end(),
+              [](const source_edit_t &a, const source_edit_t &b) { return a.pos > b.pos; });
+    for (const source_edit_t &edit : edits) {
+        text->replace(edit.pos, edit.len, edit.value);
+    }
+}
+
+/*******************************************************************************
+* Function Name: parse_opdata
+********************************************************************************
+* Summary:
+* Fields of "opdataN = { a, b,c, ... }" (builtin params of node N) and the
+* position of its closing brace.
+*******************************************************************************/
+static bool parse_opdata(const std::string &text, int id, std::vector<std::string> *fields, size_t *end_pos)
+{
+    char name[32];
+    snprintf(name, sizeof(name), " opdata%d = {", id);
+    size_t opdata_pos = text.find(name);
+    if (opdata_pos == std::string::npos) {
+        return false;
+    }
+    opdata_pos += strlen(name);
+    size_t opdata_end = text.find('}', opdata_pos);
+    fields->clear();
+    for (size_t p = opdata_pos; p < opdata_end; p++) {
+        size_t end = std::min(text.find(',', p), opdata_end);
+        size_t start = text.find_first_not_of(' ', p);
+        size_t last = text.find_last_not_of(' ', end - 1);
+        fields->push_back(start <= last ? text.substr(start, last - start + 1) : "");
+        p = end;
+    }
+    *end_pos = opdata_end;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: drop_nodes
+********************************************************************************
+* Summary:
+* Edits of model.text that take out the nodes flagged in dropped: their
+* inputsN, outputsN, opdataN and tflNodes[] lines, the node counts and the
+* registrations of operators no node uses any more. used_ops[] becomes ops[]
+* of the nodes left, in_tensor_indices[] graph_inputs; dropped_tensors leave
+* the arena.
+*******************************************************************************/
+static bool drop_nodes(const planned_model_t &model, const std::vector<bool> &dropped,
+                       const std::vector<std::string> &ops, const std::vector<int> &dropped_tensors,
+                       const std::vector<int> &graph_inputs, std::vector<source_edit_t> *edits)
+{
+    const std::string &text = model.text;
+    int node_count = (int)model.nodes.size();
+    int kept = (int)std::count(dropped.begin(), dropped.end(), false);
+    if (node_count == (int)model.tensors.size()) {
+        printf("ERR: as many nodes as tensors, cannot tell their loops apart\n");
+        return false;
+    }
+
+    /* the tensors of dropped nodes leave the arena: "{ kTfLiteMmapRo, type, nullptr, ..." */
+    for (int t : dropped_tensors) {
+        const planned_tensor_t &tensor = model.tensors[t];
+        size_t data_end = tensor.line.find("), ", tensor.line.find("tensor_arena + ")) + 3;
+        edits->push_back({ tensor.line_pos, data_end,
+                           "{ kTfLiteMmapRo, " + tensor_field(tensor, 1) + ", nullptr, " });
+    }
+
+    /* the dropped nodes' inputsN, outputsN, opdataN and tflNodes[] lines */
+    std::string used_ops;
+    std::vector<std::string> kept_ops;
+    for (int n = 0; n < node_count; n++) {
+        const planned_node_t &node = model.nodes[n];
+        if (!dropped[n]) {
+            used_ops += ops[n] + ", ";
+            kept_ops.push_back(ops[n]);
+            continue;
+        }
+        const char *names[] = { " inputs%d = {", " outputs%d = {", " opdata%d = {", " opdata%d[" };
+        for (const char *format : names) {
+            char name[32];
+            snprintf(name, sizeof(name), format, node.id);
+            size_t pos = text.find(name);
+            if (pos != std::string::npos) {
+                edits->push_back(line_edit(text, pos));
+            }
+        }
+        std::string entry = "\n{ (TfLiteIntArray*)&g0::inputs" + std::to_string(node.id) + ",";
+        for (size_t pos = 0; (pos = text.find(entry, pos)) != std::string::npos; pos++) {
+            edits->push_back(line_edit(text, pos + 1));
+        }
+    }
+    size_t pos = text.find('{', text.find("used_ops[] =")) + 1;
+    edits->push_back({ pos, text.find('}', pos) - pos, used_ops });
+
+    /* node count: tflNodes[N], tflNodes_subgraph_index[] and the node loops */
+    const std::string counts[] = { "tflNodes[", "tflNodes_subgraph_index[] = {0, ", "; i < " };
+    for (const std::string &count : counts) {
+        std::string old_count = count + std::to_string(node_count);
+        for (pos = 0; (pos = text.find(old_count, pos)) != std::string::npos; pos += old_count.size()) {
+            char next = text[pos + old_count.size()];
+            if (next >= '0' && next <= '9') {
+                continue;
+            }
+            edits->push_back({ pos + count.size(), old_count.size() - count.size(), std::to_string(kept) });
+        }
+    }
+
+    /* graph inputs */
+    pos = text.find('{', text.find("in_tensor_indices[] = {")) + 1;
+    std::string inputs = "\n";
+    for (int t : graph_inputs) {
+        inputs += "  " + std::to_string(t) + ", \n";
+    }
+    edits->push_back({ pos, text.find('}', pos) - pos, inputs });
+
+    /* registrations of operators no node uses any more */
+    std::vector<std::string> unused_ops;
+    for (int n = 0; n < node_count; n++) {
+        const std::string &op = model.nodes[n].op;
+        if (std::find(kept_ops.begin(), kept_ops.end(), op) == kept_ops.end() &&
+            std::find(unused_ops.begin(), unused_ops.end(), op) == unused_ops.end()) {
+            unused_ops.push_back(op);
+        }
+    }
+    for (const std::string &op : unused_ops) {
+        pos = text.find("registrations[" + op + "] =");
+        if (pos != std::string::npos) {
+            edits->push_back(line_edit(text, pos));
+        }
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: fold_graph
+********************************************************************************
+* Summary:
+* The --fold rewrite of model->text (see the file header). notes[n] says what
+* became of every node it drops; returns how many. The model has to be parsed
+* again from model->text afterwards.
+*******************************************************************************/
+static int fold_graph(planned_model_t *model, std::vector<std::string> *notes)
+{
+    const std::string &text = model->text;
+    std::vector<source_edit_t> edits;
+    std::vector<int> graph_inputs = model->graph_inputs;
+    std::vector<bool> dropped(model->nodes.size(), false);
+    std::vector<bool> padded(model->nodes.size(), false);
+    std::vector<int> dropped_tensors;
+    char note[128];
+
+    for (size_t n = 0; n < model->nodes.size(); n++) {
+        const planned_node_t &node = model->nodes[n];
+        if (node.inputs.empty() || node.outputs.size() != 1) {
+            continue;
+        }
+        int in = node.inputs[0];
+        int out = node.outputs[0];
+        if (in < 0 || !model->tensors[in].arena || !model->tensors[out].arena ||
+            std::find(model->graph_outputs.begin(), model->graph_outputs.end(), out) != model->graph_outputs.end() ||
+            tensor_field(model->tensors[in], 1) != tensor_field(model->tensors[out], 1) ||
+            tensor_field(model->tensors[in], 5) != tensor_field(model->tensors[out], 5)) {
+            continue;
+        }
+
+        if (node.op == "OP_RESHAPE") {
+            /* nothing runs before a graph input is filled: it may as well be
+             * filled with the reshaped dims */
+            if (std::find(graph_inputs.begin(), graph_inputs.end(), in) == graph_inputs.end() ||
+                readers_of(*model, in).size() != 1 || model->tensors[in].bytes != model->tensors[out].bytes) {
+                continue;
+            }
+            std::replace(graph_inputs.begin(), graph_inputs.end(), in, out);
+            dropped_tensors.push_back(in);
+            snprintf(note, sizeof(note), "dropped, tensor %d is the graph input", out);
+        }
+        else if (node.op == "OP_PAD" && node.inputs.size() == 2) {
+            std::vector<int> readers = readers_of(*model, out);
+            if (readers.size() != 1) {
+                continue;
+            }
+            const planned_node_t &conv = model->nodes[readers[0]];
+            bool depthwise = conv.op == "OP_DEPTHWISE_CONV_2D";
+            if ((!depthwise && conv.op != "OP_CONV_2D") || !conv.has_opdata || conv.inputs.size() < 2 ||
+                conv.inputs[0] != out) {
+                continue;
+            }
+            /* { before, after } of N, H, W, C; padded with the zero point */
+            std::vector<int> paddings = tensor_values(*model, node.inputs[1]);
+            if (paddings.size() != 8 || paddings[0] || paddings[1] || paddings[6] || paddings[7] ||
+                *std::min_element(paddings.begin(), paddings.end()) < 0) {
+                continue;
+            }
+
+            /* TfLiteConvParams { padding, stride_w, stride_h, activation, dilation_w, dilation_h }
+             * TfLiteDepthwiseConvParams { padding, stride_w, stride_h, depth_multiplier, activation,
+             *                             dilation_w, dilation_h }, not folded into yet */
+            std::vector<std::string> fields;
+            size_t opdata_end;
+            if (!parse_opdata(text, conv.id, &fields, &opdata_end) ||
+                fields.size() != (depthwise ? 7u : 6u) ||
+                (fields[0] != "kTfLitePaddingSame" && fields[0] != "kTfLitePaddingValid")) {
+                continue;
+            }
+            TfLitePadding padding = fields[0] == "kTfLitePaddingSame" ? kTfLitePaddingSame : kTfLitePaddingValid;
+            int stride_w = atoi(fields[1].c_str());
+            int stride_h = atoi(fields[2].c_str());
+            int dilation_w = atoi(fields[fields.size() - 2].c_str());
+            int dilation_h = atoi(fields[fields.size() - 1].c_str());
+
+            std::vector<int> in_dims = tensor_dims(*model, in);
+            std::vector<int> filter_dims = tensor_dims(*model, conv.inputs[1]);
+            std::vector<int> out_dims = tensor_dims(*model, conv.outputs[0]);
+            if (in_dims.size() != 4 || filter_dims.size() != 4 || out_dims.size() != 4) {
+                continue;
+            }
+            /* a 1x1 filter over padding only adds a border of outputs, which
+             * the 1x1 CMSIS-NN kernels (output as large as the input) skip */
+            if (((paddings[2] || paddings[3]) && filter_dims[1] == 1) ||
+                ((paddings[4] || paddings[5]) && filter_dims[2] == 1)) {
+                continue;
+            }
+            if (tflite::ComputeOutSize(padding, in_dims[1] + paddings[2] + paddings[3], filter_dims[1],
+                                       stride_h, dilation_h) != out_dims[1] ||
+                tflite::ComputeOutSize(padding, in_dims[2] + paddings[4] + paddings[5], filter_dims[2],
+                                       stride_w, dilation_w) != out_dims[2]) {
+                continue;
+            }
+
+            /* the convolution reads the PAD input... */
+            char name[32];
+            snprintf(name, sizeof(name), " inputs%d = {", conv.id);
+            size_t list = text.find('{', text.find('{', text.find(name)) + 1) + 1;
+            std::string value = " " + std::to_string(in);
+            for (size_t ix = 1; ix < conv.inputs.size(); ix++) {
+                value += "," + std::to_string(conv.inputs[ix]);
+            }
+            edits.push_back({ list, text.find('}', list) - list, value + " " });
+            /* ...and pads it: explicit_padding_top, _bottom, _left, _right */
+            std::string explicit_padding = ", " + std::to_string(paddings[2]) + "," + std::to_string(paddings[3]) +
+                                           ", " + std::to_string(paddings[4]) + "," + std::to_string(paddings[5]);
+            edits.push_back({ text.find_last_not_of(' ', opdata_end - 1) + 1, 0, explicit_padding });
+            padded[readers[0]] = true;
+            dropped_tensors.push_back(out);
+            snprintf(note, sizeof(note), "folded into node %d (%s), explicit padding %d,%d %d,%d",
+                     readers[0], conv.op.c_str() + 3, paddings[2], paddings[3], paddings[4], paddings[5]);
+        }
+        else {
+            continue;
+        }
+        dropped[n] = true;
+        (*notes)[n] = note;
+    }
+
+    /* the other convolutions get explicit_padding_* as zeros, so no params
+     * initializer leaves fields out (-Wmissing-field-initializers) */
+    for (size_t n = 0; n < model->nodes.size(); n++) {
+        const planned_node_t &conv = model->nodes[n];
+        bool depthwise = conv.op == "OP_DEPTHWISE_CONV_2D";
+        std::vector<std::string> fields;
+        size_t opdata_end;
+        if ((!depthwise && conv.op != "OP_CONV_2D") || !conv.has_opdata || padded[n] ||
+            !parse_opdata(text, conv.id, &fields, &opdata_end) || fields.size() != (depthwise ? 7u : 6u)) {
+            continue;
+        }
+        edits.push_back({ text.find_last_not_of(' ', opdata_end - 1) + 1, 0, ", 0,0, 0,0" });
+    }
+
+    int kept = (int)std::count(dropped.begin(), dropped.end(), false);
+    int node_count = (int)model->nodes.size();
+    if (kept == node_count) {
+        apply_edits(&model->text, edits);
+        return 0;
+    }
+    std::vector<std::string> ops;
+    for (const planned_node_t &node : model->nodes) {
+        ops.push_back(node.op);
+    }
+    if (!drop_nodes(*model, dropped, ops, dropped_tensors, graph_inputs, &edits)) {
+        return -1;
+    }
+    apply_edits(&model->text, edits);
+    return node_count - kept;
+}
+
+/*******************************************************************************
+* Function Name: fuse_graph
+********************************************************************************
+* Summary:
+* The --fuse rewrite of model->text (see the file header). origin[n] is the
+* node of the notes table node n was; returns how many nodes it fuses away.
+* The model has to be parsed again from model->text afterwards.
+*******************************************************************************/
+static int fuse_graph(planned_model_t *model, const std::vector<int> &origin, std::vector<std::string> *notes)
+{
+    const std::string &text = model->text;
+    std::vector<source_edit_t> edits;
+    std::vector<bool> dropped(model->nodes.size(), false);
+    std::vector<std::string> ops;
+    for (const planned_node_t &node : model->nodes) {
+        ops.push_back(node.op);
+    }
+    char note[128];
+
+    for (size_t n = 0; n < model->nodes.size(); n++) {
+        const planned_node_t &node = model->nodes[n];
+        if (node.op != "OP_DEPTHWISE_CONV_2D" || !node.has_opdata || node.inputs.size() != 3 ||
+            node.outputs.size() != 1) {
+            continue;
+        }
+        int in = node.inputs[0];
+        int mid = node.outputs[0];
+        std::vector<int> readers = readers_of(*model, mid);
+        if (in < 0 || mid < 0 || !model->tensors[mid].arena || readers.size() != 1 ||
+            std::find(model->graph_outputs.begin(), model->graph_outputs.end(), mid) != model->graph_outputs.end()) {
+            continue;
+        }
+        const planned_node_t &conv = model->nodes[readers[0]];
+        if (conv.op != "OP_CONV_2D" || !conv.has_opdata || conv.inputs.size() != 3 || conv.outputs.size() != 1 ||
+            conv.inputs[0] != mid || dropped[readers[0]]) {
+            continue;
+        }
+        /* int8 activations, constant int8 filters (the fused node runs where the
+         * depthwise one did, so the 1x1 convolution may only read constants
+         * besides mid) */
+        int tensors[] = { in, node.inputs[1], mid, conv.inputs[1], conv.outputs[0] };
+        bool int8 = node.inputs[2] >= 0 && conv.inputs[2] >= 0;
+        for (int t : tensors) {
+            int8 &= t >= 0 && tensor_field(model->tensors[t], 1) == "kTfLiteInt8";
+        }
+        if (!int8 || model->tensors[node.inputs[1]].arena || model->tensors[node.inputs[2]].arena ||
+            model->tensors[conv.inputs[1]].arena || model->tensors[conv.inputs[2]].arena) {
+            continue;
+        }
+
+        /* depth_multiplier 1; a 1x1 filter, stride 1, dilation 1 and no explicit
+         * padding, so every output pixel is one pixel of mid */
+        std::vector<std::string> depthwise_fields;
+        std::vector<std::string> conv_fields;
+        size_t depthwise_end;
+        size_t conv_end;
+        if (!parse_opdata(text, node.id, &depthwise_fields, &depthwise_end) ||
+            !parse_opdata(text, conv.id, &conv_fields, &conv_end) ||
+            (depthwise_fields.size() != 7 && depthwise_fields.size() != 11) ||
+            (conv_fields.size() != 6 && conv_fields.size() != 10) || depthwise_fields[3] != "1") {
+            continue;
+        }
+        bool pointwise = conv_fields[1] == "1" && conv_fields[2] == "1" && conv_fields[4] == "1" &&
+                         conv_fields[5] == "1";
+        for (size_t ix = 6; ix < conv_fields.size(); ix++) {
+            pointwise &= conv_fields[ix] == "0";
+        }
+        std::vector<int> in_dims = tensor_dims(*model, in);
+        std::vector<int> mid_dims = tensor_dims(*model, mid);
+        std::vector<int> filter_dims = tensor_dims(*model, conv.inputs[1]);
+        std::vector<int> out_dims = tensor_dims(*model, conv.outputs[0]);
+        if (!pointwise || in_dims.size() != 4 || mid_dims.size() != 4 || filter_dims.size() != 4 ||
+            out_dims.size() != 4 || filter_dims[1] != 1 || filter_dims[2] != 1 ||
+            filter_dims[3] != mid_dims[3] || in_dims[3] != mid_dims[3] || out_dims[1] != mid_dims[1] ||
+            out_dims[2] != mid_dims[2]) {
+            continue;
+        }
+
+        /* mid keeps its dims and quantization, but only a tile of it is in the
+         * arena: an even number of pixels, for the two-row matrix product */
+        int depth = mid_dims[3];
+        int pixels = mid_dims[1] * mid_dims[2];
+        int tile_pixels = std::min(pixels, std::max(1, FUSED_TILE_BYTES / depth));
+        if (tile_pixels > 1 && tile_pixels < pixels) {
+            tile_pixels &= ~1;
+        }
+        const planned_tensor_t &tile = model->tensors[mid];
+        size_t bytes_pos = 2;
+        for (int ix = 0; ix < 4; ix++) {
+            bytes_pos = tile.line.find(", ", bytes_pos) + 2;
+        }
+        edits.push_back({ tile.line_pos + bytes_pos, tile.line.find(", ", bytes_pos) - bytes_pos,
+                          std::to_string(tile_pixels * depth) });
+
+        /* the depthwise node becomes the fused one: both inputs, the 1x1 output, both params */
+        char name[32];
+        snprintf(name, sizeof(name), " inputs%d = {", node.id);
+        const int fused_inputs[] = { in, node.inputs[1], node.inputs[2], mid, conv.inputs[1], conv.inputs[2] };
+        std::string line = "const TfArray<6, int> inputs" + std::to_string(node.id) + " = { 6, { ";
+        for (size_t ix = 0; ix < 6; ix++) {
+            line += std::to_string(fused_inputs[ix]) + (ix < 5 ? "," : " } };\n");
+        }
+        source_edit_t edit = line_edit(text, text.find(name));
+        edit.value = line;
+        edits.push_back(edit);
+
+        snprintf(name, sizeof(name), " outputs%d = {", node.id);
+        size_t list = text.find('{', text.find('{', text.find(name)) + 1) + 1;
+        edits.push_back({ list, text.find('}', list) - list, " " + std::to_string(conv.outputs[0]) + " " });
+
+        snprintf(name, sizeof(name), " opdata%d = {", node.id);
+        size_t depthwise_pos = text.find(name) + strlen(name);
+        snprintf(name, sizeof(name), " opdata%d = {", conv.id);
+        size_t conv_pos = text.find(name) + strlen(name);
+        edit = line_edit(text, depthwise_pos);
+        edit.value = "const TfLiteDepthwiseSeparableConvParams opdata" + std::to_string(node.id) + " = { {" +
+                     text.substr(depthwise_pos, depthwise_end - depthwise_pos) + "}, {" +
+                     text.substr(conv_pos, conv_end - conv_pos) + "} };\n";
+        edits.push_back(edit);
+
+        ops[n] = "OP_DEPTHWISE_SEPARABLE_CONV_2D";
+        dropped[readers[0]] = true;
+        snprintf(note, sizeof(note), "fused into node %d (DW_SEPARABLE_CONV_2D), tile %d pixels (%d bytes)",
+                 origin[n], tile_pixels, tile_pixels * depth);
+        (*notes)[origin[readers[0]]] = note;
+    }
+
+    int fused = (int)std::count(dropped.begin(), dropped.end(), true);
+    if (fused == 0) {
+        return 0;
+    }
+    if (!drop_nodes(*model, dropped, ops, std::vector<int>(), model->graph_inputs, &edits)) {
+        return -1;
+    }
+
+    /* the operator: used_operators_e, its registration, its profiler code and MACs,
+     * and the guard against CMSIS-NN builds */
+    if (text.find("OP_DEPTHWISE_SEPARABLE_CONV_2D") == std::string::npos) {
+        const char *profiler_include = "#include \"edge-impulse-sdk/classifier/ei_node_profiler.h\"\n";
+        size_t pos = text.find(profiler_include);
+        if (pos == std::string::npos) {
+            printf("ERR: no ei_node_profiler.h include to put the CMSIS-NN guard after\n");
+            return -1;
+        }
+        edits.push_back({ pos + strlen(profiler_include), 0,
+            "#include \"edge-impulse-sdk/classifier/ei_classifier_config.h\"\n"
+            "#if EI_CLASSIFIER_TFLITE_ENABLE_CMSIS_NN == 1\n"
+            "// the fused node runs its depthwise half without the CMSIS-NN kernels\n"
+            "#error \"graph fused by arena_planner --fuse (x86 only); regenerate it without --fuse for CMSIS-NN\"\n"
+            "#endif\n" });
+
+        pos = text.find("OP_LAST", text.find("enum used_operators_e {"));
+        edits.push_back({ pos, 0, "OP_DEPTHWISE_SEPARABLE_CONV_2D, " });
+
+        pos = text.rfind("] = Register_");
+        pos = text.find('\n', pos) + 1;
+        edits.push_back({ pos, 0,
+                          "  registrations[OP_DEPTHWISE_SEPARABLE_CONV_2D] = Register_DEPTHWISE_SEPARABLE_CONV_2D();\n" });
+
+        pos = text.find("used_op_builtins[OP_LAST] = {");
+        if (pos != std::string::npos) {
+            edits.push_back({ text.find("\n};", pos), 0, "\n  EI_NODE_PROFILER_OP_DEPTHWISE_SEPARABLE_CONV_2D," });
+        }
+        pos = text.find("static uint32_t node_macs(");
+        if (pos != std::string::npos) {
+            edits.push_back({ text.find("    default:", pos), 0,
+                "    case OP_DEPTHWISE_SEPARABLE_CONV_2D: { // depthwise filter [1, h, w, channels] into the\n"
+                "      // intermediate tensor (dims kept, bytes one tile), 1x1 filter [out channels, 1, 1, channels]\n"
+                "      const TfLiteIntArray *depthwise = tensorData[inputs->data[1]].dims;\n"
+                "      const TfLiteIntArray *pointwise = tensorData[inputs->data[4]].dims;\n"
+                "      return tensor_elements(tensorData[inputs->data[3]].dims) * depthwise->data[1] * depthwise->data[2] +\n"
+                "        out_elements * pointwise->data[3];\n"
+                "    }\n" });
+        }
+    }
+
+    /* the fused node takes 7 tensors at once */
+    const char *slot_counts[] = { "MAX_TFL_TENSOR_COUNT = ", "MAX_TFL_EVAL_COUNT = " };
+    for (const char *count : slot_counts) {
+        size_t pos = text.find(count);
+        if (pos == std::string::npos) {
+            continue;
+        }
+        pos += strlen(count);
+        if (atoi(text.c_str() + pos) < 7) {
+            edits.push_back({ pos, text.find(';', pos) - pos, "7" });
+        }
+    }
+
+    apply_edits(&model->text, edits);
+    return fused;
+}
+
+/*******************************************************************************
+* Function Name: find_lifetimes
+*******************************************************************************/
+static void find_lifetimes(planned_model_t *model)
+{
+    const int last_node = (int)model->nodes.size() - 1;
+    for (int n = 0; n <= last_node; n++) {
+        const planned_node_t &node = model->nodes[n];
+        for (int io = 0; io < 2; io++) {
+            for (int t : io == 0 ? node.inputs : node.outputs) {
+                if (t < 0 || t >= (int)model->tensors.size() || !model->tensors[t].arena) {
+                    continue;
+                }
+                planned_tensor_t &tensor = model->tensors[t];
+                if (tensor.first < 0 || n < tensor.first) {
+                    tensor.first = n;
+                }
+                tensor.last = std::max(tensor.last, n);
+            }
+        }
+    }
+    /* filled before the first node, read after the last one */
+    for (int t : model->graph_inputs) {
+        model->tensors[t].first = 0;
+    }
+    for (int t : model->graph_outputs) {
+        model->tensors[t].last = last_node;
+    }
+    for (planned_tensor_t &tensor : model->tensors) {
+        tensor.buffer_first = tensor.first;
+        tensor.buffer_last = tensor.last;
+    }
+}
+
+/*******************************************************************************
+* Function Name: reparse_model
+********************************************************************************
+* Summary:
+* Parses model->text again after a rewrite, with the new lifetimes.
+*******************************************************************************/
+static bool reparse_model(planned_model_t *model)
+{
+    planned_model_t rewritten;
+    rewritten.text = model->text;
+    if (!parse_model(&rewritten)) {
+        return false;
+    }
+    *model = rewritten;
+    find_lifetimes(model);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: merge_in_place
+********************************************************************************
+* Summary:
+* Lets the output of every in-place node take its input's buffer. Prints the
+* merges if print; returns how many there are.
+*******************************************************************************/
+static int merge_in_place(planned_model_t *model, bool print)
+{
+    int merged = 0;
+    for (size_t n = 0; n < model->nodes.size(); n++) {
+        const planned_node_t &node = model->nodes[n];
+        bool in_place = false;
+        for (const char *op : in_place_ops) {
+            in_place |= node.op == op;
+        }
+        if (!in_place || node.inputs.empty() || node.outputs.size() != 1) {
+            continue;
+        }
+        int in = node.inputs[0];
+        int out = node.outputs[0];
+        if (in < 0 || !model->tensors[in].arena || !model->tensors[out].arena) {
+            continue;
+        }
+        planned_tensor_t &input = model->tensors[in];
+        planned_tensor_t &output = model->tensors[out];
+        bool graph_output = std::find(model->graph_outputs.begin(), model->graph_outputs.end(), in) !=
+                            model->graph_outputs.end();
+        if (input.last != (int)n || graph_output || input.bytes != output.bytes) {
+            continue;
+        }
+
+        output.group = input.group;
+        planned_tensor_t &buffer = model->tensors[output.group];
+        buffer.buffer_last = std::max(buffer.buffer_last, output.last);
+        merged++;
+        if (!print) {
+            continue;
+        }
+        printf("  in place: tensor %d (%s, node %d) shares the buffer of tensor %d\n",
+               out, node.op.c_str() + 3, (int)n, in);
+    }
+    return merged;
+}
+
+/*******************************************************************************
+* Function Name: plan_end
+********************************************************************************
+* Summary:
+* Bytes a plan needs for its tensors: the end of the highest one, as the
+* tensor boundary of the compiled model's init.
+*******************************************************************************/
+static int plan_end(const planned_model_t &model, const std::vector<int> &offsets)
+{
+    int end = 0;
+    for (size_t t = 0; t < model.tensors.size(); t++) {
+        if (model.tensors[t].arena && model.tensors[t].first >= 0) {
+            end = std::max(end, offsets[t] + model.tensors[t].bytes);
+        }
+    }
+    return end;
+}
+
+/*******************************************************************************
+* Function Name: check_plan
+********************************************************************************
+* Summary:
+* Number of pairs of tensors that are alive at the same node and overlap in the
+* arena, unless they are merged in place and start at the same offset.
+*******************************************************************************/
+static int check_plan(const planned_model_t &model, const std::vector<int> &offsets, const char *name)
+{
+    int conflicts = 0;
+    for (size_t a = 0; a < model.tensors.size(); a++) {
+        const planned_tensor_t &ta = model.tensors[a];
+        if (!ta.arena || ta.first < 0) {
+            continue;
+        }
+        for (size_t b = a + 1; b < model.tensors.size(); b++) {
+            const planned_tensor_t &tb = model.tensors[b];
+            if (!tb.arena || tb.first < 0 || (ta.group == tb.group && offsets[a] == offsets[b])) {
+                continue;
+            }
+            bool in_time = ta.first <= tb.last && tb.first <= ta.last;
+            bool in_space = offsets[a] < offsets[b] + tb.bytes && offsets[b] < offsets[a] + ta.bytes;
+            if (in_time && in_space) {
+                if (conflicts < 10) {
+                    printf("ERR: %s plan: tensors %d and %d overlap\n", name, (int)a, (int)b);
+                }
+                conflicts++;
+            }
+        }
+    }
+    return conflicts;
+}
+
+/*******************************************************************************
+* Function Name: alive_bytes
+********************************************************************************
+* Summary:
+* Bytes of the buffers (after merging) alive at node n.
+*******************************************************************************/
+static int alive_bytes(const planned_model_t &model, int n)
+{
+    int alive = 0;
+    for (size_t t = 0; t < model.tensors.size(); t++) {
+        const planned_tensor_t &tensor = model.tensors[t];
+        if (tensor.arena && tensor.group == (int)t && tensor.buffer_first <= n && n <= tensor.buffer_last) {
+            alive += tensor.bytes;
+        }
+    }
+    return alive;
+}
+
+/*******************************************************************************
+* Function Name: lower_bound
+********************************************************************************
+* Summary:
+* The most bytes alive at one node (buffers after merging), and that node.
+*******************************************************************************/
+static int lower_bound(const planned_model_t &model, int *peak_node)
+{
+    int best = 0;
+    *peak_node = 0;
+    for (int n = 0; n < (int)model.nodes.size(); n++) {
+        int alive = alive_bytes(model, n);
+        if (alive > best) {
+            best = alive;
+            *peak_node = n;
+        }
+    }
+    return best;
+}
+
+/*******************************************************************************
+* Function Name: run_planner
+********************************************************************************
+* Summary:
+* Lays out the merged buffers with planner; offsets per tensor.
+*******************************************************************************/
+static bool run_planner(const planned_model_t &model, tflite::MicroMemoryPlanner *planner,
+                        std::vector<int> *offsets)
+{
+    std::vector<int> buffer_of(model.tensors.size(), -1);
+    int buffers = 0;
+    for (size_t t = 0; t < model.tensors.size(); t++) {
+        const planned_tensor_t &tensor = model.tensors[t];
+        if (!tensor.arena || tensor.first < 0 || tensor.group != (int)t) {
+            continue;
+        }
+        int size = (tensor.bytes + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+        if (planner->AddBuffer(size, tensor.buffer_first, tensor.buffer_last) != kTfLiteOk) {
+            return false;
+        }
+        buffer_of[t] = buffers++;
+    }
+
+    offsets->assign(model.tensors.size(), 0);
+    for (size_t t = 0; t < model.tensors.size(); t++) {
+        const planned_tensor_t &tensor = model.tensors[t];
+        if (!tensor.arena || tensor.first < 0) {
+            continue;
+        }
+        if (planner->GetOffsetForBuffer(buffer_of[tensor.group], &(*offsets)[t]) != kTfLiteOk) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: run_first_fit
+********************************************************************************
+* Summary:
+* Lays out the merged buffers in order of first use, each at the lowest offset
+* clear of the buffers placed before it that are alive at the same time. On a
+* chain of nodes this tends to reach the lower bound where the size ordered
+* greedy planner doesn't.
+*******************************************************************************/
+static void run_first_fit(const planned_model_t &model, std::vector<int> *offsets)
+{
+    std::vector<int> order;
+    for (size_t t = 0; t < model.tensors.size(); t++) {
+        const planned_tensor_t &tensor = model.tensors[t];
+        if (tensor.arena && tensor.first >= 0 && tensor.group == (int)t) {
+            order.push_back((int)t);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&model](int a, int b) {
+        const planned_tensor_t &ta = model.tensors[a];
+        const planned_tensor_t &tb = model.tensors[b];
+        return ta.buffer_first != tb.buffer_first ? ta.buffer_first < tb.buffer_first : ta.bytes > tb.bytes;
+    });
+
+    offsets->assign(model.tensors.size(), 0);
+    for (size_t ix = 0; ix < order.size(); ix++) {
+        const planned_tensor_t &tensor = model.tensors[order[ix]];
+        int size = (tensor.bytes + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+        /* { offset, end } of the placed buffers alive with this one, by offset */
+        std::vector<std::pair<int, int>> taken;
+        for (size_t p = 0; p < ix; p++) {
+            const planned_tensor_t &placed = model.tensors[order[p]];
+            if (placed.buffer_first <= tensor.buffer_last && tensor.buffer_first <= placed.buffer_last) {
+                int start = (*offsets)[order[p]];
+                taken.push_back({ start, start + ((placed.bytes + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1)) });
+            }
+        }
+        std::sort(taken.begin(), taken.end());
+        int offset = 0;
+        for (const std::pair<int, int> &range : taken) {
+            if (offset + size <= range.first) {
+                break;
+            }
+            offset = std::max(offset, range.second);
+        }
+        (*offsets)[order[ix]] = offset;
+    }
+    for (size_t t = 0; t < model.tensors.size(); t++) {
+        const planned_tensor_t &tensor = model.tensors[t];
+        if (tensor.arena && tensor.first >= 0) {
+            (*offsets)[t] = (*offsets)[tensor.group];
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: write_plan
+********************************************************************************
+* Summary:
+* Puts offsets into tensorData[] and moves kTensorArenaSize by the bytes the
+* tensors need less, then writes the source back to path.
+*******************************************************************************/
+static bool write_plan(planned_model_t *model, const std::vector<int> &offsets, int saved, const char *path)
+{
+    std::vector<source_edit_t> edits;
+    for (size_t t = 0; t < model->tensors.size(); t++) {
+        const planned_tensor_t &tensor = model->tensors[t];
+        if (tensor.arena && tensor.first >= 0) {
+            edits.push_back({ tensor.offset_pos, tensor.offset_len, std::to_string(offsets[t]) });
+        }
+    }
+    for (size_t ix = 0; ix < model->arena_size_pos.size(); ix++) {
+        int size = atoi(model->text.c_str() + model->arena_size_pos[ix]) - saved;
+        edits.push_back({ model->arena_size_pos[ix], model->arena_size_len[ix], std::to_string(size) });
+    }
+    apply_edits(&model->text, edits);
+
+    FILE *f = fopen(path, "wb");
+    if (!f || fwrite(model->text.data(), 1, model->text.size(), f) != model->text.size()) {
+        printf("ERR: cannot write %s\n", path);
+        if (f) {
+            fclose(f);
+        }
+        return false;
+    }
+    fclose(f);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: classify_test_sample
+********************************************************************************
+* Summary:
+* Scores of the linked model on test_sample.h, and the part of its arena the
+* kernels took (persistent and scratch buffers, above the idle range).
+*******************************************************************************/
+static int classify_test_sample(void)
+{
+    signal_t signal;
+    ei_impulse_result_t result;
+    ei::numpy::signal_from_int16_buffer(test_audio_16000, EI_CLASSIFIER_RAW_SAMPLE_COUNT, &signal);
+    EI_IMPULSE_ERROR ei_error = run_classifier(&signal, &result, false);
+    if (ei_error != EI_IMPULSE_OK) {
+        printf("ERR: run_classifier failed with code %d\n", ei_error);
+        return 1;
+    }
+    printf("test_sample.h with the linked model:");
+    for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+        printf(" %s %.8f", result.classification[ix].label, result.classification[ix].value);
+    }
+    printf("\n");
+
+    /* the graph stays set up with EI_CLASSIFIER_TFLITE_EON_PERSISTENT_GRAPH */
+    const ei_learning_block_config_tflite_graph_t *block_config =
+        (const ei_learning_block_config_tflite_graph_t *)ei_default_impulse.impulse->learning_blocks[0].config;
+    const ei_config_tflite_eon_graph_t *graph_config =
+        (const ei_config_tflite_eon_graph_t *)block_config->graph_config;
+    uint8_t *idle_start;
+    size_t idle_bytes;
+    if (graph_config->model_idle_arena && graph_config->model_idle_arena(&idle_start, &idle_bytes) == kTfLiteOk) {
+        printf("  tensor arena below the kernels' buffers: %lu bytes\n", (unsigned long)idle_bytes);
+    }
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    const char *path = EON_COMPILED_SOURCE;
+    bool verbose = false;
+    bool fold = false;
+    bool fuse = false;
+    bool write = false;
+    bool classify = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--verbose")) {
+            verbose = true;
+        }
+        else if (!strcmp(argv[i], "--fold")) {
+            fold = true;
+        }
+        else if (!strcmp(argv[i], "--fuse")) {
+            fuse = true;
+        }
+        else if (!strcmp(argv[i], "--write")) {
+            write = true;
+        }
+        else if (!strcmp(argv[i], "--classify")) {
+            classify = true;
+        }
+        else if (argv[i][0] != '-') {
+            path = argv[i];
+        }
+        else {
+            printf("usage: %s [--verbose] [--fold] [--fuse] [--write] [--classify] [compiled.cpp]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (classify) {
+        return classify_test_sample();
+    }
+
+    planned_model_t model;
+    if (!read_file(path, &model.text)) {
+        printf("ERR: cannot open %s\n", path);
+        return 1;
+    }
+    if (!parse_model(&model)) {
+        return 1;
+    }
+    find_lifetimes(&model);
+
+    int arena_tensors = 0;
+    std::vector<int> generated(model.tensors.size(), 0);
+    for (size_t t = 0; t < model.tensors.size(); t++) {
+        if (model.tensors[t].arena) {
+            generated[t] = model.tensors[t].offset;
+            arena_tensors++;
+        }
+    }
+    const char *file_name = strrchr(path, '/') ? strrchr(path, '/') + 1 : path;
+    printf("%s: %d nodes, %d tensors (%d in the arena), kTensorArenaSize %d\n", file_name,
+           (int)model.nodes.size(), (int)model.tensors.size(), arena_tensors, model.arena_size);
+
+    /* the generated plan, on the graph it was made for */
+    planned_model_t generated_model = model;
+    merge_in_place(&generated_model, false);
+    int conflicts = check_plan(generated_model, generated, "generated");
+    int generated_end = plan_end(generated_model, generated);
+
+    std::vector<std::string> notes(model.nodes.size());
+    int folded = 0;
+    if (fold) {
+        folded = fold_graph(&model, &notes);
+        if (folded < 0 || !reparse_model(&model)) {
+            return 1;
+        }
+        printf("folded: %d node%s, %d left\n", folded, folded == 1 ? "" : "s", (int)model.nodes.size());
+    }
+    int fused = 0;
+    if (fuse) {
+        /* node of the notes table every node left was */
+        std::vector<int> origin;
+        for (size_t n = 0; n < notes.size(); n++) {
+            if (notes[n].empty()) {
+                origin.push_back((int)n);
+            }
+        }
+        fused = fuse_graph(&model, origin, &notes);
+        if (fused < 0 || !reparse_model(&model)) {
+            return 1;
+        }
+        printf("fused: %d depthwise-separable block%s, %d nodes left\n", fused, fused == 1 ? "" : "s",
+               (int)model.nodes.size());
+    }
+
+    int no_merge_node;
+    int no_merge_bound = lower_bound(model, &no_merge_node);
+
+    int merged = merge_in_place(&model, true);
+    int peak_node;
+    int bound = lower_bound(model, &peak_node);
+
+    if (fold || fuse) {
+        printf("  %4s %-20s %12s %5s %12s\n", "node", "op", "alive before", "node", "alive after");
+        int n_after = 0;
+        for (size_t n = 0; n < generated_model.nodes.size(); n++) {
+            printf("  %4d %-20s %12d", (int)n, generated_model.nodes[n].op.c_str() + 3,
+                   alive_bytes(generated_model, (int)n));
+            if (notes[n].empty()) {
+                printf(" %5d %12d\n", n_after, alive_bytes(model, n_after));
+                n_after++;
+            }
+            else {
+                printf("   %s\n", notes[n].c_str());
+            }
+        }
+    }
+
+    std::vector<unsigned char> scratch(tflite::GreedyMemoryPlanner::per_buffer_size() * model.tensors.size());
+    tflite::GreedyMemoryPlanner greedy_planner;
+    tflite::LinearMemoryPlanner linear_planner;
+    std::vector<int> greedy;
+    std::vector<int> linear;
+    if (greedy_planner.Init(scratch.data(), (int)scratch.size()) != kTfLiteOk ||
+        !run_planner(model, &greedy_planner, &greedy) || !run_planner(model, &linear_planner, &linear)) {
+        printf("ERR: planning failed\n");
+        return 1;
+    }
+    std::vector<int> first_fit;
+    run_first_fit(model, &first_fit);
+    conflicts += check_plan(model, greedy, "greedy");
+    conflicts += check_plan(model, linear, "linear");
+    conflicts += check_plan(model, first_fit, "first fit");
+    int greedy_end = plan_end(model, greedy);
+    int first_fit_end = plan_end(model, first_fit);
+    /* the smaller of the two */
+    const std::vector<int> &best = first_fit_end < greedy_end ? first_fit : greedy;
+    int best_end = std::min(greedy_end, first_fit_end);
+
+    printf("  %-36s %12s\n", "plan", "tensor bytes");
+    printf("  %-36s %12d\n", "generated (EON)", generated_end);
+    printf("  %-36s %12d\n", "linear, in place merged", plan_end(model, linear));
+    printf("  %-36s %12d\n", "greedy, in place merged", greedy_end);
+    printf("  %-36s %12d\n", "first fit, in place merged", first_fit_end);
+    printf("  %-36s %12d   (node %d, %s)\n", "lower bound, every tensor on its own", no_merge_bound,
+           no_merge_node, model.nodes[no_merge_node].op.c_str() + 3);
+    printf("  %-36s %12d   (node %d, %s:", "lower bound, in place merged", bound, peak_node,
+           model.nodes[peak_node].op.c_str() + 3);
+    for (size_t t = 0; t < model.tensors.size(); t++) {
+        const planned_tensor_t &tensor = model.tensors[t];
+        if (tensor.arena && tensor.group == (int)t && tensor.buffer_first <= peak_node &&
+            peak_node <= tensor.buffer_last) {
+            printf(" %d=%dB", (int)t, tensor.bytes);
+        }
+    }
+    printf(")\n");
+
+    if (verbose) {
+        printf("  %6s %6s %6s %6s %10s %10s %10s\n", "tensor", "bytes", "first", "last", "generated", "greedy",
+               "first fit");
+        for (size_t t = 0; t < model.tensors.size(); t++) {
+            const planned_tensor_t &tensor = model.tensors[t];
+            if (!tensor.arena || tensor.first < 0) {
+                continue;
+            }
+            printf("  %6d %6d %6d %6d %10d %10d %10d\n", (int)t, tensor.bytes, tensor.first, tensor.last,
+                   generated[t], greedy[t], first_fit[t]);
+        }
+    }
+
+    if (conflicts > 0) {
+        printf("ERR: %d overlapping tensor pairs\n", conflicts);
+        return 1;
+    }
+
+    /* a rewritten graph needs a new plan, the generated one doesn't fit it */
+    int saved = generated_end - best_end;
+    if (saved < 0 && !folded && !fused) {
+        printf("the generated plan is smaller, keeping it\n");
+        return 0;
+    }
+    printf("%s: %d tensor bytes (kTensorArenaSize %d -> %d), %d in-place node%s\n", saved < 0 ? "cost" : "saving",
+           saved < 0 ? -saved : saved, model.arena_size, model.arena_size - saved, merged, merged == 1 ? "" : "s");
+
+    if (write) {
+        if (!write_plan(&model, best, saved, path)) {
+            return 1;
+        }
+        printf("wrote %s; rebuild and compare --classify before and after\n", path);
+    }
+    return 0;
+}
@@ -0,0 +1,396 @@
+/******************************************************************************
+* File Name:   capture_replay.cpp
+*
+* Description: Replays 16 kHz mono WAV files through the real capture layer
+*              (audio_capture.cpp) on the simulated PDM/PCM block and runs
+*              run_classifier_continuous on every slice, like main.cpp does on
+*              the board. The classifier time is charged to the virtual clock,
+*              so the run reports the real-time factor and how many samples
+*              would have been dropped.
+*
+* Usage:       capture_replay [--slowdown X] [--vad] [--check-heap] [--q15] [--profile[-csv]] [--verbose] [file.wav ...]
+*              --slowdown X  multiply measured CPU time by X, to emulate a
+*                            core that is X times slower than the host
+*              --vad         replay every file with and without the
+*                            voice-activity gate (vad.cpp) and report the
+*                            skip ratio and the keyword miss rates. The
+*                            expected label is the file name up to the first
+*                            '.' (Edge Impulse export naming) or else the
+*                            name of the parent directory.
+*              --check-heap  count ei_malloc / ei_calloc calls made by
+*                            run_classifier_continuous once the first model
+*                            window has been classified and exit with 1 if
+*                            there are any (EIDSP_WORKSPACE_ARENA=1 should
+*                            make steady-state inference heap free)
+*              --q15         use the fixed-point MFE
+*                            (ei_dsp_config_mfe_t::fixed_point)
+*              --profile     print the per-node profile of the graph at the
+*                            end (last and average time, MACs, arena bytes);
+*                            --profile-csv prints it as CSV. Needs a build
+*                            with -DPROFILE_NODES=ON
+*              Without files the test_sample.h clip is replayed.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "cyhal.h"
+#include "audio_capture.h"
+#include "vad.h"
+#include "wav.h"
+#include "test_sample.h"
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "edge-impulse-sdk/dsp/numpy.hpp"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define CORRECT_CLASSIFICATION      0.5f
+
+/*******************************************************************************
+* Types
+********************************************************************************/
+typedef struct {
+    uint64_t busy_us;
+    uint64_t dsp_us;                            /* sums of result.timing, unscaled */
+    uint64_t nn_us;
+    uint32_t decisions;
+    uint32_t slices;
+    uint32_t slices_skipped;
+    uint32_t heap_allocations;                  /* --check-heap, after the first window */
+    bool detected[EI_CLASSIFIER_LABEL_COUNT];   /* label crossed the threshold at least once */
+} replay_result_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static bool check_heap = false;
+#if EI_CLASSIFIER_PROFILE_NODES
+static bool profile_nodes = false;
+static bool profile_csv = false;
+#endif
+static bool heap_counting = false;
+static uint32_t heap_allocations = 0;
+
+/* The posix port defines these weak, so the replay can count them */
+void *ei_malloc(size_t size)
+{
+    heap_allocations += heap_counting;
+    return malloc(size);
+}
+
+void *ei_calloc(size_t nitems, size_t size)
+{
+    heap_allocations += heap_counting;
+    return calloc(nitems, size);
+}
+
+
+/*******************************************************************************
+* Function Name: classify_slice
+********************************************************************************
+* Summary:
+* One run_classifier_continuous call, timed and scaled by slowdown.
+*******************************************************************************/
+static bool classify_slice(const int16_t *samples, double slowdown, bool verbose, replay_result_t *res)
+{
+    signal_t signal;
+    ei_impulse_result_t ei_result;
+    ei::numpy::signal_from_int16_buffer(samples, AUDIO_CAPTURE_SLICE_SAMPLES, &signal);
+
+    /* The first window fills the lazily allocated state (features, filterbank, graph) */
+    heap_counting = check_heap && res->decisions >= EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW;
+    heap_allocations = 0;
+
+    uint64_t start_us = ei_read_timer_us();
+    EI_IMPULSE_ERROR ei_error = run_classifier_continuous(&signal, &ei_result, false, true);
+    res->busy_us += (uint64_t)((double)(ei_read_timer_us() - start_us) * slowdown);
+
+    heap_counting = false;
+    res->heap_allocations += heap_allocations;
+
+    if (ei_error != EI_IMPULSE_OK) {
+        printf("ERR: run_classifier_continuous failed with code %d\n", ei_error);
+        return false;
+    }
+    res->decisions++;
+    res->dsp_us += (uint64_t)ei_result.timing.dsp_us;
+    res->nn_us += (uint64_t)ei_result.timing.classification_us;
+
+    size_t best = 0;
+    for (size_t i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++) {
+        if (ei_result.classification[i].value >= CORRECT_CLASSIFICATION) {
+            res->detected[i] = true;
+        }
+        if (ei_result.classification[i].value > ei_result.classification[best].value) {
+            best = i;
+        }
+    }
+    if (verbose && ei_result.classification[best].value >= CORRECT_CLASSIFICATION) {
+        printf("  t=%7.3f s  %-6s %.3f\n", cyhal_host_time_us() / 1e6,
+               ei_result.classification[best].label, ei_result.classification[best].value);
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: replay
+********************************************************************************
+* Summary:
+* Streams one clip through capture (+ optional VAD) + classifier and prints
+* the statistics.
+*******************************************************************************/
+static replay_result_t replay(const char *name, const int16_t *samples, size_t length, uint32_t sample_rate,
+                              double slowdown, bool use_vad, bool verbose)
+{
+    replay_result_t res;
+    memset(&res, 0, sizeof(res));
+
+    cyhal_pdm_pcm_t pdm_pcm;
+    memset(&pdm_pcm, 0, sizeof(pdm_pcm));
+
+    audio_capture_init(&pdm_pcm);
+    cyhal_pdm_pcm_start(&pdm_pcm);
+    cyhal_host_pdm_pcm_load(&pdm_pcm, samples, length, sample_rate);
+    run_classifier_init();
+
+    vad_config_t vad_cfg;
+    vad_get_default_config(&vad_cfg, sample_rate);
+    vad_init(&vad_cfg);
+
+    audio_capture_start();
+
+    for (;;) {
+        const int16_t *slice = audio_capture_acquire();
+        if (slice == NULL) {
+            if (cyhal_host_pdm_pcm_finished()) {
+                break;
+            }
+            cyhal_host_wait_for_event();
+            continue;
+        }
+
+        uint64_t busy_before = res.busy_us;
+        bool ok = true;
+
+        if (use_vad) {
+            uint64_t start_us = ei_read_timer_us();
+            vad_decision_t gate = vad_process(slice, AUDIO_CAPTURE_SLICE_SAMPLES);
+            res.busy_us += (uint64_t)((double)(ei_read_timer_us() - start_us) * slowdown);
+
+            if (gate == VAD_RUN_PREROLL) {
+                ok = classify_slice(vad_preroll(), slowdown, verbose, &res);
+            }
+            if (ok && gate != VAD_SKIP) {
+                ok = classify_slice(slice, slowdown, verbose, &res);
+            }
+        }
+        else {
+            ok = classify_slice(slice, slowdown, verbose, &res);
+        }
+
+        audio_capture_release(slice);
+        if (!ok) {
+            break;
+        }
+
+        /* The core was busy, the microphone kept going */
+        cyhal_host_advance_us(res.busy_us - busy_before);
+    }
+
+    audio_capture_stop();
+    run_classifier_deinit();
+
+    audio_capture_stats_t stats;
+    audio_capture_get_stats(&stats);
+    double audio_s = (double)length / (double)sample_rate;
+
+    res.slices = stats.slices_captured;
+    if (use_vad) {
+        vad_stats_t vstats;
+        vad_get_stats(&vstats);
+        res.slices_skipped = vstats.slices_skipped;
+    }
+
+    printf("%s%s: %.2f s audio, %lu slices, %lu decisions", name, use_vad ? " [vad]" : "", audio_s,
+           (unsigned long)stats.slices_captured, (unsigned long)res.decisions);
+    if (use_vad) {
+        printf(", %lu skipped", (unsigned long)res.slices_skipped);
+    }
+    printf("\n  real-time factor %.4f (%.1f us per slice)\n", (res.busy_us / 1e6) / audio_s,
+           stats.slices_captured ? (double)res.busy_us / stats.slices_captured : 0.0);
+    if (res.decisions > 0) {
+        printf("  per decision: dsp %.1f us, nn %.1f us (result.timing, monotonic clock)\n",
+               (double)res.dsp_us / res.decisions, (double)res.nn_us / res.decisions);
+    }
+    printf("  overruns %lu, dropped samples %lu (+%llu lost in FIFO), max backlog %lu/%u\n",
+           (unsigned long)stats.overruns, (unsigned long)stats.dropped_samples,
+           (unsigned long long)cyhal_host_pdm_pcm_lost_samples(),
+           (unsigned long)stats.max_ready, (unsigned)AUDIO_CAPTURE_NUM_BUFFERS);
+    if (check_heap) {
+        ei_dsp_workspace_stats_t arena;
+        ei::ei_dsp_get_workspace_stats(&arena);
+        printf("  heap: %lu ei_malloc/ei_calloc calls after the first window; workspace arena peak %lu of %lu bytes "
+               "(+%lu lent by the tensor arena), %lu heap fallbacks\n",
+               (unsigned long)res.heap_allocations, (unsigned long)arena.peak, (unsigned long)arena.size,
+               (unsigned long)arena.lent_peak, (unsigned long)arena.heap_fallbacks);
+    }
+
+    return res;
+}
+
+/*******************************************************************************
+* Function Name: expected_label
+********************************************************************************
+* Summary:
+* Label index from "<label>.<id>.wav" or ".../<label>/<file>.wav", -1 if none.
+*******************************************************************************/
+static int expected_label(const char *path)
+{
+    const char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+
+    for (size_t i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++) {
+        const char *label = ei_classifier_inferencing_categories[i];
+        size_t n = strlen(label);
+        if (strncmp(base, label, n) == 0 && base[n] == '.') {
+            return (int)i;
+        }
+        if ((size_t)(base - path) > n && base[-1] == '/' && strncmp(base - n - 1, label, n) == 0 &&
+            (base - n - 1 == path || base[-(ptrdiff_t)n - 2] == '/')) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/*******************************************************************************
+* Function Name: print_node_profile
+********************************************************************************
+* Summary:
+* --profile: the per-node profile of the graph (ei_node_profiler.h).
+*******************************************************************************/
+static void print_node_profile(void)
+{
+#if EI_CLASSIFIER_PROFILE_NODES
+    if (profile_nodes) {
+        printf("\nper-node profile (last decision, average over the run):\n");
+        ei_node_profiler_print(profile_csv);
+    }
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    double slowdown = 1.0;
+    bool use_vad = false;
+    bool verbose = false;
+    std::vector<const char *> files;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--slowdown") == 0 && i + 1 < argc) {
+            slowdown = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--vad") == 0) {
+            use_vad = true;
+        }
+        else if (strcmp(argv[i], "--check-heap") == 0) {
+            check_heap = true;
+        }
+        else if (strcmp(argv[i], "--q15") == 0) {
+            const ei_model_dsp_t *block = &ei_default_impulse.impulse->dsp_blocks[0];
+            if (block->extract_fn != &extract_mfe_features) {
+                printf("ERR: --q15 needs an MFE block\n");
+                return 1;
+            }
+            ((ei_dsp_config_mfe_t *)block->config)->fixed_point = 1;
+        }
+        else if (strcmp(argv[i], "--profile") == 0 || strcmp(argv[i], "--profile-csv") == 0) {
+#if EI_CLASSIFIER_PROFILE_NODES
+            profile_nodes = true;
+            profile_csv = strcmp(argv[i], "--profile-csv") == 0;
+#else
+            printf("ERR: %s needs a build with -DPROFILE_NODES=ON\n", argv[i]);
+            return 1;
+#endif
+        }
+        else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        }
+        else {
+            files.push_back(argv[i]);
+        }
+    }
+
+    if (files.empty()) {
+        replay_result_t res = replay("test_sample.h", test_audio_16000,
+                                     sizeof(test_audio_16000) / sizeof(test_audio_16000[0]),
+                                     EI_CLASSIFIER_FREQUENCY, slowdown, use_vad, verbose);
+        print_node_profile();
+        return (check_heap && res.heap_allocations > 0) ? 1 : 0;
+    }
+
+    /* --vad summary */
+    uint64_t busy_ref = 0, busy_vad = 0;
+    uint32_t slices = 0, skipped = 0;
+    uint32_t keyword_files = 0, missed_ref = 0, missed_vad = 0, lost_by_vad = 0;
+    uint32_t heap_allocations_total = 0;
+
+    for (const char *path : files) {
+        std::vector<int16_t> samples;
+        uint32_t sample_rate = 0;
+        if (!wav_read(path, samples, &sample_rate)) {
+            return 1;
+        }
+        if (sample_rate != EI_CLASSIFIER_FREQUENCY) {
+            printf("WARN: %s is %lu Hz, the model expects %d Hz\n", path, (unsigned long)sample_rate,
+                   EI_CLASSIFIER_FREQUENCY);
+        }
+
+        replay_result_t ref = replay(path, samples.data(), samples.size(), sample_rate, slowdown, false, verbose);
+        heap_allocations_total += ref.heap_allocations;
+        if (!use_vad) {
+            continue;
+        }
+        replay_result_t gated = replay(path, samples.data(), samples.size(), sample_rate, slowdown, true, verbose);
+        heap_allocations_total += gated.heap_allocations;
+
+        busy_ref += ref.busy_us;
+        busy_vad += gated.busy_us;
+        slices += gated.slices;
+        skipped += gated.slices_skipped;
+
+        int label = expected_label(path);
+        if (label >= 0 && strcmp(ei_classifier_inferencing_categories[label], "noise") != 0) {
+            keyword_files++;
+            missed_ref += !ref.detected[label];
+            missed_vad += !gated.detected[label];
+            lost_by_vad += ref.detected[label] && !gated.detected[label];
+        }
+    }
+
+    if (use_vad && slices > 0) {
+        printf("\nVAD summary: %lu/%lu slices skipped (%.1f %%), classifier CPU %.1f %% of ungated\n",
+               (unsigned long)skipped, (unsigned long)slices, 100.0 * skipped / slices,
+               busy_ref ? 100.0 * busy_vad / busy_ref : 0.0);
+        if (keyword_files > 0) {
+            printf("  keyword files %lu: miss rate %.1f %% ungated, %.1f %% gated, %lu detections lost to the gate\n",
+                   (unsigned long)keyword_files, 100.0 * missed_ref / keyword_files,
+                   100.0 * missed_vad / keyword_files, (unsigned long)lost_by_vad);
+        }
+    }
+
+    print_node_profile();
+
+    if (check_heap && heap_allocations_total > 0) {
+        printf("\nERR: %lu heap allocations in steady-state inference\n", (unsigned long)heap_allocations_total);
+        return 1;
+    }
+
+    return 0;
+}
+
+/* [] END OF FILE */
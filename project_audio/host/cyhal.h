@@ -0,0 +1,86 @@
+/******************************************************************************
+* File Name:   cyhal.h
+*
+* Description: Host (Linux) stand-in for the parts of the Infineon HAL used by
+*              audio_capture.cpp. The PDM/PCM block is simulated on a virtual
+*              clock: audio is taken from a buffer loaded with
+*              cyhal_host_pdm_pcm_load and only advances when the host calls
+*              cyhal_host_advance_us / cyhal_host_wait_for_event, so replaying
+*              a WAV behaves like a real microphone with a known CPU budget.
+*
+*              Only used by the host build, never by the ModusToolbox build
+*              (see ../.cyignore).
+*******************************************************************************/
+
+#ifndef CYHAL_HOST_H_
+#define CYHAL_HOST_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Types / Macros (same names as the real HAL)
+********************************************************************************/
+typedef uint32_t cy_rslt_t;
+
+#define CY_RSLT_SUCCESS                 ((cy_rslt_t)0x00000000U)
+#define CYHAL_PDM_PCM_RSLT_ERR_ASYNC_IN_PROGRESS ((cy_rslt_t)0x04020001U)
+#define CYHAL_ISR_PRIORITY_DEFAULT      (7)
+
+typedef enum {
+    CYHAL_PDM_PCM_RX_HALF_FULL    = 0x01,
+    CYHAL_PDM_PCM_RX_NOT_EMPTY    = 0x02,
+    CYHAL_PDM_PCM_RX_OVERFLOW     = 0x04,
+    CYHAL_PDM_PCM_RX_UNDERFLOW    = 0x08,
+    CYHAL_PDM_PCM_ASYNC_COMPLETE  = 0x10,
+} cyhal_pdm_pcm_event_t;
+
+typedef void (*cyhal_pdm_pcm_event_callback_t)(void *callback_arg, cyhal_pdm_pcm_event_t event);
+
+typedef struct {
+    cyhal_pdm_pcm_event_callback_t callback;
+    void *callback_arg;
+    uint32_t event_mask;
+    bool running;
+    void *async_dst;
+    size_t async_length;
+    size_t async_done;
+} cyhal_pdm_pcm_t;
+
+/*******************************************************************************
+* HAL functions
+********************************************************************************/
+void cyhal_pdm_pcm_register_callback(cyhal_pdm_pcm_t *obj, cyhal_pdm_pcm_event_callback_t callback, void *callback_arg);
+void cyhal_pdm_pcm_enable_event(cyhal_pdm_pcm_t *obj, cyhal_pdm_pcm_event_t event, uint8_t intr_priority, bool enable);
+cy_rslt_t cyhal_pdm_pcm_start(cyhal_pdm_pcm_t *obj);
+cy_rslt_t cyhal_pdm_pcm_stop(cyhal_pdm_pcm_t *obj);
+cy_rslt_t cyhal_pdm_pcm_read_async(cyhal_pdm_pcm_t *obj, void *data, size_t length);
+cy_rslt_t cyhal_pdm_pcm_abort_async(cyhal_pdm_pcm_t *obj);
+
+/*******************************************************************************
+* Host simulation controls
+********************************************************************************/
+/* Audio the simulated microphone will produce, at sample_rate_hz */
+void cyhal_host_pdm_pcm_load(cyhal_pdm_pcm_t *obj, const int16_t *samples, size_t length, uint32_t sample_rate_hz);
+/* Lets virtual time pass; DMA completions fire as callbacks on the way */
+void cyhal_host_advance_us(uint64_t us);
+/* Advances to the next DMA completion (an idle CPU sleeping until the ISR) */
+void cyhal_host_wait_for_event(void);
+/* True once every loaded sample has been produced */
+bool cyhal_host_pdm_pcm_finished(void);
+/* Samples produced while no read was pending (lost in the hardware FIFO) */
+uint64_t cyhal_host_pdm_pcm_lost_samples(void);
+uint64_t cyhal_host_time_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CYHAL_HOST_H_ */
+
+/* [] END OF FILE */
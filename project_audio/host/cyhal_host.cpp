@@ -0,0 +1,170 @@
+/******************************************************************************
+* File Name:   cyhal_host.cpp
+*
+* Description: Virtual-clock PDM/PCM simulation behind host/cyhal.h.
+*              One microphone per process, which is all the application has.
+*******************************************************************************/
+
+#include "cyhal.h"
+
+#include <string.h>
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static cyhal_pdm_pcm_t *sim_obj = NULL;
+static const int16_t *sim_samples = NULL;
+static size_t sim_length = 0;
+static uint32_t sim_rate_hz = 16000;
+
+/* Samples the microphone has produced so far (position in sim_samples) */
+static size_t sim_position = 0;
+/* Virtual clock, counted in (fractional) samples */
+static double sim_clock = 0.0;
+static uint64_t sim_lost = 0;
+
+
+/*******************************************************************************
+* Function Name: produce_until
+********************************************************************************
+* Summary:
+* Moves the microphone to sample position target, copying into the pending
+* async read and firing ASYNC_COMPLETE whenever a read is filled.
+*******************************************************************************/
+static void produce_until(size_t target)
+{
+    if (target > sim_length) {
+        target = sim_length;
+    }
+
+    while (sim_position < target) {
+        cyhal_pdm_pcm_t *obj = sim_obj;
+
+        if (obj && obj->running && obj->async_dst && (obj->async_done < obj->async_length)) {
+            size_t take = obj->async_length - obj->async_done;
+            if (take > target - sim_position) {
+                take = target - sim_position;
+            }
+            memcpy((int16_t *)obj->async_dst + obj->async_done, sim_samples + sim_position, take * sizeof(int16_t));
+            sim_position += take;
+            obj->async_done += take;
+
+            if (obj->async_done == obj->async_length) {
+                obj->async_dst = NULL;
+                if (obj->callback && (obj->event_mask & CYHAL_PDM_PCM_ASYNC_COMPLETE)) {
+                    obj->callback(obj->callback_arg, CYHAL_PDM_PCM_ASYNC_COMPLETE);
+                }
+            }
+        }
+        else {
+            /* Nobody is reading: the FIFO overflows and the audio is gone */
+            sim_lost += target - sim_position;
+            sim_position = target;
+        }
+    }
+}
+
+/*******************************************************************************
+* HAL functions
+********************************************************************************/
+void cyhal_pdm_pcm_register_callback(cyhal_pdm_pcm_t *obj, cyhal_pdm_pcm_event_callback_t callback, void *callback_arg)
+{
+    obj->callback = callback;
+    obj->callback_arg = callback_arg;
+    sim_obj = obj;
+}
+
+void cyhal_pdm_pcm_enable_event(cyhal_pdm_pcm_t *obj, cyhal_pdm_pcm_event_t event, uint8_t intr_priority, bool enable)
+{
+    (void) intr_priority;
+
+    if (enable) {
+        obj->event_mask |= (uint32_t)event;
+    }
+    else {
+        obj->event_mask &= ~(uint32_t)event;
+    }
+}
+
+cy_rslt_t cyhal_pdm_pcm_start(cyhal_pdm_pcm_t *obj)
+{
+    obj->running = true;
+    sim_obj = obj;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_pdm_pcm_stop(cyhal_pdm_pcm_t *obj)
+{
+    obj->running = false;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_pdm_pcm_read_async(cyhal_pdm_pcm_t *obj, void *data, size_t length)
+{
+    if (obj->async_dst != NULL) {
+        return CYHAL_PDM_PCM_RSLT_ERR_ASYNC_IN_PROGRESS;
+    }
+    obj->async_dst = data;
+    obj->async_length = length;
+    obj->async_done = 0;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_pdm_pcm_abort_async(cyhal_pdm_pcm_t *obj)
+{
+    obj->async_dst = NULL;
+    obj->async_length = 0;
+    obj->async_done = 0;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Host simulation controls
+********************************************************************************/
+void cyhal_host_pdm_pcm_load(cyhal_pdm_pcm_t *obj, const int16_t *samples, size_t length, uint32_t sample_rate_hz)
+{
+    sim_obj = obj;
+    sim_samples = samples;
+    sim_length = length;
+    sim_rate_hz = sample_rate_hz;
+    sim_position = 0;
+    sim_clock = 0.0;
+    sim_lost = 0;
+}
+
+void cyhal_host_advance_us(uint64_t us)
+{
+    sim_clock += (double)us * (double)sim_rate_hz / 1e6;
+    produce_until((size_t)sim_clock);
+}
+
+void cyhal_host_wait_for_event(void)
+{
+    cyhal_pdm_pcm_t *obj = sim_obj;
+    size_t target = sim_length;
+
+    if (obj && obj->running && obj->async_dst) {
+        target = sim_position + (obj->async_length - obj->async_done);
+    }
+    if ((double)target > sim_clock) {
+        sim_clock = (double)target;
+    }
+    produce_until(target);
+}
+
+bool cyhal_host_pdm_pcm_finished(void)
+{
+    return sim_position >= sim_length;
+}
+
+uint64_t cyhal_host_pdm_pcm_lost_samples(void)
+{
+    return sim_lost;
+}
+
+uint64_t cyhal_host_time_us(void)
+{
+    return (uint64_t)(sim_clock * 1e6 / (double)sim_rate_hz);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,301 @@
+/******************************************************************************
+* File Name:   gateway_bench.cpp
+*
+* Description: Load test of the multi-stream gateway (kws_gateway.h) with
+*              synthetic streams. For every stream count, that many streams
+*              hand in one slice every EI_CLASSIFIER_SLICE_SIZE samples of
+*              real time, their arrivals spread evenly over the slice period.
+*              Each stream replays the test_sample.h clip and the given WAVs,
+*              looped, from its own starting slice. Reports the offered and
+*              decided decisions per second, the average batch, the DSP time
+*              per slice and the network time per window, and the p50/p99
+*              decision latency (slice handed in to result out). A stream
+*              count is sustained when p99 stays within the SLO and no slice
+*              is left queued; the largest sustained count is divided by the
+*              cores the workers can use.
+*
+* Usage:       gateway_bench [--streams N,N,...] [--workers N] [--max-batch N]
+*                            [--max-delay-ms N] [--slo-ms N] [--seconds N]
+*                            [file.wav | dir ...]
+*              --streams N,...   stream counts (default 64,128,256,512,1024)
+*              --workers N       worker threads (default: all cores;
+*                                more than 1 needs -DREENTRANT=ON)
+*              --max-batch N     windows per batched invoke (default 8)
+*              --max-delay-ms N  longest a slice waits for its batch (default 20)
+*              --slo-ms N        p99 decision latency to sustain (default 100)
+*              --seconds N       measured time per stream count (default 5)
+*              Exits with 1 if a file cannot be read or the gateway fails.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "wav.h"
+#include "test_sample.h"
+#include "kws_gateway.h"
+
+#include "model-parameters/model_metadata.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define DEFAULT_SECONDS             5
+#define DEFAULT_SLO_MS              100
+/* slices before the first decision of a stream are not measured */
+#define WARMUP_SLICES               (EI_CLASSIFIER_RAW_SAMPLE_COUNT / EI_CLASSIFIER_SLICE_SIZE)
+
+/*******************************************************************************
+* Types
+********************************************************************************/
+typedef struct {
+    std::mutex mutex;
+    uint64_t measure_from_us;       /* decisions on slices before this are warm-up */
+    uint64_t measure_to_us;
+    std::vector<uint32_t> latency_us;
+} bench_decisions_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static std::vector<int16_t> tape;   /* every clip, whole slices only, looped by the streams */
+
+
+/*******************************************************************************
+* Function Name: add_path
+********************************************************************************
+* Summary:
+* Appends a WAV file, or every *.wav below a directory (sorted by path), to the
+* tape, cut to whole slices.
+*******************************************************************************/
+static bool add_path(const std::string &path)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        printf("ERR: cannot open %s\n", path.c_str());
+        return false;
+    }
+
+    if (S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir(path.c_str());
+        if (!dir) {
+            printf("ERR: cannot open %s\n", path.c_str());
+            return false;
+        }
+        std::vector<std::string> entries;
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            std::string name = entry->d_name;
+            if (name == "." || name == "..") {
+                continue;
+            }
+            std::string child = path + "/" + name;
+            bool is_wav = name.size() > 4 && strcasecmp(name.c_str() + name.size() - 4, ".wav") == 0;
+            if (is_wav || (stat(child.c_str(), &st) == 0 && S_ISDIR(st.st_mode))) {
+                entries.push_back(child);
+            }
+        }
+        closedir(dir);
+
+        std::sort(entries.begin(), entries.end());
+        for (const std::string &child : entries) {
+            if (!add_path(child)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<int16_t> samples;
+    uint32_t sample_rate = 0;
+    if (!wav_read(path.c_str(), samples, &sample_rate)) {
+        return false;
+    }
+    if (sample_rate != EI_CLASSIFIER_FREQUENCY) {
+        printf("WARN: skipping %s, %lu Hz instead of %d Hz\n", path.c_str(), (unsigned long)sample_rate,
+               EI_CLASSIFIER_FREQUENCY);
+        return true;
+    }
+    size_t length = samples.size() - samples.size() % EI_CLASSIFIER_SLICE_SIZE;
+    tape.insert(tape.end(), samples.begin(), samples.begin() + length);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: on_decision
+********************************************************************************
+* Summary:
+* Gateway callback: keeps the latency of decisions on slices that arrived in
+* the measured interval.
+*******************************************************************************/
+static void on_decision(const kws_gateway_decision_t *decision, void *arg)
+{
+    bench_decisions_t *decisions = (bench_decisions_t *)arg;
+    std::lock_guard<std::mutex> lock(decisions->mutex);
+    if (decision->arrival_us >= decisions->measure_from_us && decision->arrival_us < decisions->measure_to_us) {
+        decisions->latency_us.push_back((uint32_t)(decision->decision_us - decision->arrival_us));
+    }
+}
+
+/*******************************************************************************
+* Function Name: percentile_ms
+*******************************************************************************/
+static double percentile_ms(const std::vector<uint32_t> &sorted, double p)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t rank = (size_t)((p / 100.0) * sorted.size() + 0.999999);
+    return sorted[rank > 0 ? rank - 1 : 0] / 1000.0;
+}
+
+/*******************************************************************************
+* Function Name: run_streams
+********************************************************************************
+* Summary:
+* Feeds streams synthetic streams through the gateway for warm-up plus
+* seconds, then gives the queue one SLO to drain and prints one table row.
+* Sets *sustained.
+*******************************************************************************/
+static bool run_streams(const kws_gateway_config_t *base_config, uint32_t stream_count, uint32_t seconds,
+                        uint32_t slo_ms, bool *sustained)
+{
+    kws_gateway_config_t config = *base_config;
+    config.streams = stream_count;
+
+    bench_decisions_t decisions;
+    if (!kws_gateway_start(&config, on_decision, &decisions)) {
+        return false;
+    }
+
+    const uint64_t period_us = (uint64_t)EI_CLASSIFIER_SLICE_SIZE * 1000000 / EI_CLASSIFIER_FREQUENCY;
+    const size_t tape_slices = tape.size() / EI_CLASSIFIER_SLICE_SIZE;
+    const uint64_t rounds = WARMUP_SLICES + (uint64_t)seconds * 1000000 / period_us;
+
+    const uint64_t start_us = kws_gateway_now_us();
+    {
+        std::lock_guard<std::mutex> lock(decisions.mutex);
+        decisions.measure_from_us = start_us + WARMUP_SLICES * period_us;
+        decisions.measure_to_us = start_us + rounds * period_us;
+    }
+
+    /* slice n of stream s arrives at n * period + s * period / streams */
+    for (uint64_t round = 0; round < rounds; round++) {
+        for (uint32_t s = 0; s < stream_count; s++) {
+            const uint64_t arrival_us = start_us + round * period_us + s * period_us / stream_count;
+            const uint64_t now_us = kws_gateway_now_us();
+            if (arrival_us > now_us) {
+                std::this_thread::sleep_for(std::chrono::microseconds(arrival_us - now_us));
+            }
+            const size_t slice = (s * 7 + round) % tape_slices;
+            if (!kws_gateway_push(s, tape.data() + slice * EI_CLASSIFIER_SLICE_SIZE, EI_CLASSIFIER_SLICE_SIZE,
+                                  arrival_us)) {
+                kws_gateway_stop();
+                return false;
+            }
+        }
+    }
+
+    /* whatever is still queued one SLO after the last arrival counts as backlog */
+    kws_gateway_stats_t stats;
+    const uint64_t drain_until_us = decisions.measure_to_us + (uint64_t)slo_ms * 1000;
+    do {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        kws_gateway_get_stats(&stats);
+    } while (stats.pending > 0 && kws_gateway_now_us() < drain_until_us);
+    const uint32_t backlog = stats.pending;
+
+    kws_gateway_stop();
+    kws_gateway_get_stats(&stats);
+
+    std::lock_guard<std::mutex> lock(decisions.mutex);
+    std::sort(decisions.latency_us.begin(), decisions.latency_us.end());
+    const uint64_t offered = (uint64_t)stream_count * (rounds - WARMUP_SLICES);
+    const double measured_s = (double)(rounds - WARMUP_SLICES) * period_us / 1e6;
+    const double p99_ms = percentile_ms(decisions.latency_us, 99.0);
+
+    *sustained = stats.errors == 0 && backlog == 0 && decisions.latency_us.size() == offered && p99_ms <= slo_ms;
+
+    printf("  %7lu %10.1f %10.1f %9.2f %8.1f %8.1f %8.1f %8.1f %8lu  %s\n", (unsigned long)stream_count,
+           offered / measured_s, decisions.latency_us.size() / measured_s,
+           stats.batches ? (double)stats.decisions / stats.batches : 0.0,
+           stats.slices ? (double)stats.dsp_us / stats.slices : 0.0,
+           stats.decisions ? (double)stats.nn_us / stats.decisions : 0.0,
+           percentile_ms(decisions.latency_us, 50.0), p99_ms, (unsigned long)backlog,
+           *sustained ? "yes" : "no");
+    if (stats.errors != 0) {
+        printf("ERR: %lu slices failed\n", (unsigned long)stats.errors);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    kws_gateway_config_t config;
+    kws_gateway_get_default_config(&config);
+    std::vector<uint32_t> stream_counts = { 64, 128, 256, 512, 1024 };
+    uint32_t seconds = DEFAULT_SECONDS;
+    uint32_t slo_ms = DEFAULT_SLO_MS;
+
+    const size_t test_length = sizeof(test_audio_16000) / sizeof(test_audio_16000[0]);
+    tape.assign(test_audio_16000, test_audio_16000 + test_length - test_length % EI_CLASSIFIER_SLICE_SIZE);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--streams") == 0 && i + 1 < argc) {
+            stream_counts.clear();
+            for (char *token = strtok(argv[++i], ","); token; token = strtok(NULL, ",")) {
+                stream_counts.push_back((uint32_t)std::max(1, atoi(token)));
+            }
+        }
+        else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            config.workers = (uint32_t)std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--max-batch") == 0 && i + 1 < argc) {
+            config.max_batch = (uint32_t)std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--max-delay-ms") == 0 && i + 1 < argc) {
+            config.max_queue_delay_us = (uint32_t)std::max(0, atoi(argv[++i])) * 1000;
+        }
+        else if (strcmp(argv[i], "--slo-ms") == 0 && i + 1 < argc) {
+            slo_ms = (uint32_t)std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = (uint32_t)std::max(1, atoi(argv[++i]));
+        }
+        else if (!add_path(argv[i])) {
+            return 1;
+        }
+    }
+
+    const uint32_t cores = std::max(1u, std::min(config.workers, std::thread::hardware_concurrency()));
+    printf("gateway_bench: %lu workers on %u cores, batch <= %lu, max queue delay %lu ms, p99 SLO %lu ms, "
+           "%lu s per point\n", (unsigned long)config.workers, cores, (unsigned long)config.max_batch,
+           (unsigned long)(config.max_queue_delay_us / 1000), (unsigned long)slo_ms, (unsigned long)seconds);
+    printf("  %7s %10s %10s %9s %8s %8s %8s %8s %8s  %s\n", "streams", "offered/s", "decided/s", "avg batch",
+           "dsp us", "nn us", "p50 ms", "p99 ms", "backlog", "sustained");
+
+    uint32_t best = 0;
+    for (uint32_t stream_count : stream_counts) {
+        bool sustained = false;
+        if (!run_streams(&config, stream_count, seconds, slo_ms, &sustained)) {
+            return 1;
+        }
+        if (sustained) {
+            best = std::max(best, stream_count);
+        }
+    }
+
+    printf("  sustained up to %lu streams, %.0f streams per core\n", (unsigned long)best, (double)best / cores);
+    return 0;
+}
+
+/* [] END OF FILE */
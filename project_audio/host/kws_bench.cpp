@@ -0,0 +1,570 @@
+/******************************************************************************
+* File Name:   kws_bench.cpp
+*
+* Description: Benchmark of the whole impulse on the host. Replays the
+*              test_sample.h clip and the 16 kHz WAV files given on the
+*              command line (directories are searched recursively for *.wav)
+*              N times through run_classifier, one model window at a time
+*              (clips shorter than a window are padded with silence), or
+*              through run_classifier_continuous one slice at a time like
+*              main.cpp. Reports the DSP, NN and total latency per decision
+*              as p50/p95/p99/max (result.timing, ei_read_cycles), the
+*              throughput in decisions per second, the heap high-water
+*              mark of ei_malloc/ei_calloc (plus the workspace arena peak),
+*              and the allocations (ei_malloc/ei_calloc and operator new)
+*              made inside the timed calls, after the warm-up clip.
+*              With --threads, 1, 2, 4 ... N threads each replay the set on
+*              their own impulse handle at the same time (needs a
+*              -DREENTRANT=ON build) and the aggregate throughput is compared
+*              with one thread.
+*
+* Usage:       kws_bench [--iterations N] [--continuous] [--q15] [--float] [--check-heap]
+*                        [--threads N] [file.wav | dir ...]
+*              --iterations N  replays of the whole set (default 10)
+*              --continuous    run_classifier_continuous per slice instead of
+*                              run_classifier per window
+*              --q15           use the fixed-point MFE
+*                              (ei_dsp_config_mfe_t::fixed_point)
+*              --float         classify a float copy of the audio
+*                              (signal_from_buffer) instead of the int16
+*                              samples (signal_from_int16_buffer)
+*              --check-heap    exit with 1 if the timed calls allocate
+*              --threads N     throughput scaling up to N concurrent handles
+*              Exits with 1 if a file cannot be read or the classifier fails.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "wav.h"
+#include "test_sample.h"
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "edge-impulse-sdk/dsp/numpy.hpp"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define DEFAULT_ITERATIONS          10
+
+/*******************************************************************************
+* Types
+********************************************************************************/
+typedef struct {
+    std::string name;
+    std::vector<int16_t> samples;
+} bench_clip_t;
+
+typedef struct {
+    std::vector<uint32_t> dsp_us;               /* result.timing, per decision */
+    std::vector<uint32_t> nn_us;
+    std::vector<uint32_t> total_us;             /* the whole run_classifier call */
+    uint64_t cycles;                            /* sum of the calls, ei_read_cycles units */
+    uint64_t audio_samples;                     /* new audio classified */
+    uint32_t checksum;                          /* FNV-1a of the scores, in order */
+    uint32_t allocations;                       /* heap allocations inside the calls */
+} bench_result_t;
+
+typedef struct {
+    const std::vector<bench_clip_t> *clips;
+    int iterations;
+    bool continuous;
+    uint64_t decisions;
+    uint32_t checksum;
+    bool ok;
+} bench_thread_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static thread_local int16_t window_buffer[EI_CLASSIFIER_RAW_SAMPLE_COUNT];
+/* --float: the samples of one call as float */
+static thread_local float float_buffer[EI_CLASSIFIER_RAW_SAMPLE_COUNT];
+static bool float_signal = false;
+
+static std::mutex heap_mutex;
+static size_t heap_in_use = 0;
+static size_t heap_peak = 0;
+static uint32_t heap_allocations = 0;
+static std::atomic<uint32_t> new_allocations(0);
+
+/* --threads: workers wait for go once their handle is warm */
+static std::atomic<int> threads_ready(0);
+static std::atomic<bool> threads_go(false);
+
+/* The posix port defines these weak, so the bench can track the live heap
+ * (usable size of the glibc chunks, slightly more than requested) */
+static void *heap_track(void *ptr)
+{
+    if (ptr) {
+        std::lock_guard<std::mutex> lock(heap_mutex);
+        heap_allocations++;
+        heap_in_use += malloc_usable_size(ptr);
+        heap_peak = std::max(heap_peak, heap_in_use);
+    }
+    return ptr;
+}
+
+void *ei_malloc(size_t size)
+{
+    return heap_track(malloc(size));
+}
+
+void *ei_calloc(size_t nitems, size_t size)
+{
+    return heap_track(calloc(nitems, size));
+}
+
+void ei_free(void *ptr)
+{
+    if (ptr) {
+        std::lock_guard<std::mutex> lock(heap_mutex);
+        heap_in_use -= std::min(heap_in_use, malloc_usable_size(ptr));
+    }
+    free(ptr);
+}
+
+/* Counted too, for the allocations of the classifier that bypass ei_malloc
+ * (std::vector, new without an operator new of the class) */
+void *operator new(size_t size)
+{
+    new_allocations++;
+    void *ptr = malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+/* ei_malloc/ei_calloc calls plus operator new calls so far */
+static uint32_t allocation_count()
+{
+    std::lock_guard<std::mutex> lock(heap_mutex);
+    return heap_allocations + new_allocations;
+}
+
+
+/*******************************************************************************
+* Function Name: add_path
+********************************************************************************
+* Summary:
+* Loads a WAV file, or every *.wav below a directory (sorted by path).
+*******************************************************************************/
+static bool add_path(const std::string &path, std::vector<bench_clip_t> &clips)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        printf("ERR: cannot open %s\n", path.c_str());
+        return false;
+    }
+
+    if (S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir(path.c_str());
+        if (!dir) {
+            printf("ERR: cannot open %s\n", path.c_str());
+            return false;
+        }
+        std::vector<std::string> entries;
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            std::string name = entry->d_name;
+            if (name == "." || name == "..") {
+                continue;
+            }
+            std::string child = path + "/" + name;
+            bool is_wav = name.size() > 4 && strcasecmp(name.c_str() + name.size() - 4, ".wav") == 0;
+            if (is_wav || (stat(child.c_str(), &st) == 0 && S_ISDIR(st.st_mode))) {
+                entries.push_back(child);
+            }
+        }
+        closedir(dir);
+
+        std::sort(entries.begin(), entries.end());
+        for (const std::string &child : entries) {
+            if (!add_path(child, clips)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bench_clip_t clip;
+    uint32_t sample_rate = 0;
+    clip.name = path;
+    if (!wav_read(path.c_str(), clip.samples, &sample_rate)) {
+        return false;
+    }
+    if (sample_rate != EI_CLASSIFIER_FREQUENCY) {
+        printf("WARN: skipping %s, %lu Hz instead of %d Hz\n", path.c_str(), (unsigned long)sample_rate,
+               EI_CLASSIFIER_FREQUENCY);
+        return true;
+    }
+    clips.push_back(clip);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: classify
+********************************************************************************
+* Summary:
+* One run_classifier(_continuous) call of handle on length samples, recorded
+* in res.
+*******************************************************************************/
+static bool classify(ei_impulse_handle_t *handle, const int16_t *samples, size_t length, bool continuous,
+                     bench_result_t *res)
+{
+    signal_t signal;
+    ei_impulse_result_t result;
+    if (float_signal) {
+        for (size_t ix = 0; ix < length; ix++) {
+            float_buffer[ix] = (float)samples[ix];
+        }
+        ei::numpy::signal_from_buffer(float_buffer, length, &signal);
+    }
+    else {
+        ei::numpy::signal_from_int16_buffer(samples, length, &signal);
+    }
+
+    uint32_t allocations = allocation_count();
+    uint64_t start_cycles = ei_read_cycles();
+    EI_IMPULSE_ERROR ei_error = continuous ? run_classifier_continuous(handle, &signal, &result, false, true)
+                                           : run_classifier(handle, &signal, &result, false);
+    uint64_t cycles = ei_read_cycles() - start_cycles;
+    allocations = allocation_count() - allocations;
+
+    if (ei_error != EI_IMPULSE_OK) {
+        printf("ERR: %s failed with code %d\n", continuous ? "run_classifier_continuous" : "run_classifier",
+               ei_error);
+        return false;
+    }
+    if (res) {
+        res->dsp_us.push_back((uint32_t)result.timing.dsp_us);
+        res->nn_us.push_back((uint32_t)result.timing.classification_us);
+        res->total_us.push_back((uint32_t)ei_cycles_to_us(cycles));
+        res->cycles += cycles;
+        res->audio_samples += length;
+        res->allocations += allocations;
+        for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+            uint32_t bits;
+            memcpy(&bits, &result.classification[ix].value, sizeof(bits));
+            res->checksum = (res->checksum ^ bits) * 16777619u;
+        }
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: run_clip
+********************************************************************************
+* Summary:
+* Classifies one clip on handle: every full window (the last one padded with
+* silence) or, with continuous, every full slice from a fresh classifier state.
+*******************************************************************************/
+static bool run_clip(ei_impulse_handle_t *handle, const bench_clip_t &clip, bool continuous, bench_result_t *res)
+{
+    const int16_t *samples = clip.samples.data();
+    const size_t length = clip.samples.size();
+
+    if (continuous) {
+        run_classifier_init(handle);
+        for (size_t offset = 0; offset + EI_CLASSIFIER_SLICE_SIZE <= length; offset += EI_CLASSIFIER_SLICE_SIZE) {
+            if (!classify(handle, samples + offset, EI_CLASSIFIER_SLICE_SIZE, true, res)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t offset = 0;
+    do {
+        size_t n = std::min((size_t)EI_CLASSIFIER_RAW_SAMPLE_COUNT, length - offset);
+        memcpy(window_buffer, samples + offset, n * sizeof(int16_t));
+        memset(window_buffer + n, 0, (EI_CLASSIFIER_RAW_SAMPLE_COUNT - n) * sizeof(int16_t));
+        if (!classify(handle, window_buffer, EI_CLASSIFIER_RAW_SAMPLE_COUNT, false, res)) {
+            return false;
+        }
+        offset += n;
+    } while (offset < length);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: print_percentiles
+********************************************************************************
+* Summary:
+* Nearest-rank p50/p95/p99 and the maximum of one latency series.
+*******************************************************************************/
+static void print_percentiles(const char *name, std::vector<uint32_t> &values)
+{
+    std::sort(values.begin(), values.end());
+    const double percentiles[] = { 50.0, 95.0, 99.0 };
+
+    printf("  %-6s", name);
+    for (double p : percentiles) {
+        size_t rank = (size_t)((p / 100.0) * values.size() + 0.999999);
+        printf(" %9lu", (unsigned long)values[rank > 0 ? rank - 1 : 0]);
+    }
+    printf(" %9lu\n", (unsigned long)values.back());
+}
+
+/*******************************************************************************
+* Function Name: bench_thread
+********************************************************************************
+* Summary:
+* --threads worker: warms up its own impulse handle, waits for the others,
+* then replays the set iterations times on it.
+*******************************************************************************/
+static void bench_thread(bench_thread_t *worker)
+{
+    ei_impulse_handle_t handle(ei_default_impulse.impulse);
+    const std::vector<bench_clip_t> &clips = *worker->clips;
+
+    bench_result_t res;
+    res.cycles = 0;
+    res.audio_samples = 0;
+    res.checksum = 2166136261u;
+    res.allocations = 0;
+
+    run_classifier_init(&handle);
+    worker->ok = run_clip(&handle, clips[0], worker->continuous, NULL);
+
+    threads_ready++;
+    while (!threads_go) {
+        std::this_thread::yield();
+    }
+
+    for (int it = 0; it < worker->iterations && worker->ok; it++) {
+        for (const bench_clip_t &clip : clips) {
+            if (!run_clip(&handle, clip, worker->continuous, &res)) {
+                worker->ok = false;
+                break;
+            }
+        }
+    }
+    run_classifier_deinit(&handle);
+    worker->decisions = res.total_us.size();
+    worker->checksum = res.checksum;
+}
+
+/*******************************************************************************
+* Function Name: run_threads
+********************************************************************************
+* Summary:
+* Aggregate decisions per second of 1, 2, 4 ... max_threads handles running
+* concurrently, each on its own thread, against one thread. Every thread has
+* to come up with the scores of the single-thread run.
+*******************************************************************************/
+static bool run_threads(const std::vector<bench_clip_t> &clips, int iterations, bool continuous, int max_threads)
+{
+#if !EI_CLASSIFIER_REENTRANT
+    printf("ERR: --threads needs a re-entrant build (cmake -DREENTRANT=ON)\n");
+    return false;
+#endif
+    std::vector<int> counts;
+    for (int n = 1; n < max_threads; n *= 2) {
+        counts.push_back(n);
+    }
+    counts.push_back(max_threads);
+
+    printf("kws_bench: %lu clips x %d iterations per thread (%s, %u hardware threads)\n",
+           (unsigned long)clips.size(), iterations,
+           continuous ? "run_classifier_continuous per slice" : "run_classifier per window",
+           std::thread::hardware_concurrency());
+    printf("  %7s %12s %9s %10s\n", "threads", "decisions/s", "speedup", "efficiency");
+
+    double single_rate = 0;
+    uint32_t single_checksum = 0;
+    for (int n : counts) {
+        std::vector<bench_thread_t> workers(n);
+        std::vector<std::thread> threads;
+        threads_ready = 0;
+        threads_go = false;
+
+        for (bench_thread_t &worker : workers) {
+            worker.clips = &clips;
+            worker.iterations = iterations;
+            worker.continuous = continuous;
+            worker.decisions = 0;
+            worker.ok = true;
+            threads.emplace_back(bench_thread, &worker);
+        }
+        while (threads_ready < n) {
+            std::this_thread::yield();
+        }
+
+        uint64_t start_cycles = ei_read_cycles();
+        threads_go = true;
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        double seconds = (double)ei_cycles_to_us(ei_read_cycles() - start_cycles) / 1e6;
+
+        uint64_t decisions = 0;
+        for (const bench_thread_t &worker : workers) {
+            if (!worker.ok) {
+                return false;
+            }
+            if (n > 1 && worker.checksum != single_checksum) {
+                printf("ERR: %d threads: scores differ from the single-thread run\n", n);
+                return false;
+            }
+            decisions += worker.decisions;
+        }
+
+        double rate = decisions / seconds;
+        if (n == 1) {
+            single_rate = rate;
+            single_checksum = workers[0].checksum;
+        }
+        printf("  %7d %12.1f %8.2fx %9.0f%%\n", n, rate, rate / single_rate, 100.0 * rate / (single_rate * n));
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = DEFAULT_ITERATIONS;
+    bool continuous = false;
+    int threads = 0;
+    bool check_heap = false;
+    std::vector<bench_clip_t> clips;
+
+    bench_clip_t test_clip;
+    test_clip.name = "test_sample.h";
+    test_clip.samples.assign(test_audio_16000,
+                             test_audio_16000 + sizeof(test_audio_16000) / sizeof(test_audio_16000[0]));
+    clips.push_back(test_clip);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--continuous") == 0) {
+            continuous = true;
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--q15") == 0) {
+            const ei_model_dsp_t *block = &ei_default_impulse.impulse->dsp_blocks[0];
+            if (block->extract_fn != &extract_mfe_features) {
+                printf("ERR: --q15 needs an MFE block\n");
+                return 1;
+            }
+            ((ei_dsp_config_mfe_t *)block->config)->fixed_point = 1;
+        }
+        else if (strcmp(argv[i], "--float") == 0) {
+            float_signal = true;
+        }
+        else if (strcmp(argv[i], "--check-heap") == 0) {
+            check_heap = true;
+        }
+        else if (!add_path(argv[i], clips)) {
+            return 1;
+        }
+    }
+    if (iterations < 1) {
+        iterations = 1;
+    }
+
+    if (threads > 0) {
+        return run_threads(clips, iterations, continuous, threads) ? 0 : 1;
+    }
+
+    /* Lazily allocated state (filterbank, graph, feature ring) is set up by
+     * the first call; keep it out of the latencies, not out of the heap peak */
+    if (!run_clip(&ei_default_impulse, clips[0], continuous, NULL)) {
+        return 1;
+    }
+
+    bench_result_t res;
+    res.cycles = 0;
+    res.audio_samples = 0;
+    res.checksum = 2166136261u;
+    res.allocations = 0;
+
+    for (int it = 0; it < iterations; it++) {
+        for (const bench_clip_t &clip : clips) {
+            if (!run_clip(&ei_default_impulse, clip, continuous, &res)) {
+                return 1;
+            }
+        }
+    }
+    run_classifier_deinit();
+
+    const size_t decisions = res.total_us.size();
+    printf("kws_bench: %lu clips x %d iterations, %lu decisions (%s, %s signal)\n", (unsigned long)clips.size(),
+           iterations, (unsigned long)decisions,
+           continuous ? "run_classifier_continuous per slice" : "run_classifier per window",
+           float_signal ? "float" : "int16");
+    if (decisions == 0) {
+        printf("ERR: no clip holds a full slice\n");
+        return 1;
+    }
+
+    printf("  %-6s %9s %9s %9s %9s   (us)\n", "", "p50", "p95", "p99", "max");
+    print_percentiles("dsp", res.dsp_us);
+    print_percentiles("nn", res.nn_us);
+    print_percentiles("total", res.total_us);
+
+    double seconds = (double)ei_cycles_to_us(res.cycles) / 1e6;
+    double audio_s = (double)res.audio_samples / EI_CLASSIFIER_FREQUENCY;
+    printf("  throughput %.1f decisions/s, %.1f x real time\n", decisions / seconds, audio_s / seconds);
+
+    printf("  heap high-water mark %lu bytes (%lu ei_malloc/ei_calloc calls)", (unsigned long)heap_peak,
+           (unsigned long)heap_allocations);
+#if EIDSP_WORKSPACE_ARENA
+    ei_dsp_workspace_stats_t arena;
+    ei::ei_dsp_get_workspace_stats(&arena);
+    printf(", workspace arena peak %lu of %lu bytes (+%lu lent by the tensor arena, %lu heap fallbacks)",
+           (unsigned long)arena.peak, (unsigned long)arena.size, (unsigned long)arena.lent_peak,
+           (unsigned long)arena.heap_fallbacks);
+#endif
+    printf("\n");
+    printf("  %lu heap allocations in the timed calls (ei_malloc/ei_calloc and operator new)\n",
+           (unsigned long)res.allocations);
+
+    if (check_heap && res.allocations > 0) {
+        printf("ERR: the timed calls allocate\n");
+        return 1;
+    }
+    return 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,355 @@
+/******************************************************************************
+* File Name:   kws_gateway.cpp
+*
+* Description: Multi-stream keyword spotting service, see kws_gateway.h.
+*              The streams with a pending slice and no worker on them wait in
+*              one FIFO (oldest slice first), so a stream is never in two
+*              batches at once and its slices run in order.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "kws_gateway.h"
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "edge-impulse-sdk/dsp/numpy.hpp"
+
+/*******************************************************************************
+* Types
+********************************************************************************/
+typedef struct {
+    const int16_t *samples;
+    size_t length;
+    uint64_t arrival_us;
+} gateway_slice_t;
+
+typedef struct {
+    ei_impulse_handle_t *handle;
+    std::deque<gateway_slice_t> pending;
+    bool busy;                      /* a worker has its oldest slice */
+} gateway_stream_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static kws_gateway_config_t gateway_config;
+static kws_gateway_decision_cb_t gateway_callback = NULL;
+static void *gateway_callback_arg = NULL;
+
+static std::mutex gateway_mutex;
+static std::condition_variable gateway_cv;
+static std::vector<gateway_stream_t> streams;
+static std::deque<uint32_t> ready_streams;     /* pending slice, not busy, oldest first */
+static std::vector<std::thread> workers;
+static std::vector<std::vector<void *> > worker_contexts;     /* max_batch graph contexts per worker */
+static bool running = false;
+static kws_gateway_stats_t gateway_stats;
+
+
+/*******************************************************************************
+* Function Name: kws_gateway_now_us
+*******************************************************************************/
+uint64_t kws_gateway_now_us(void)
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*******************************************************************************
+* Function Name: gateway_take_batch
+********************************************************************************
+* Summary:
+* Waits until max_batch streams are ready or the oldest ready slice has waited
+* max_queue_delay_us, then takes up to max_batch of them (oldest first). Called
+* and returns with the lock held; false once the gateway stops.
+*******************************************************************************/
+static bool gateway_take_batch(std::unique_lock<std::mutex> &lock, std::vector<uint32_t> &picked,
+                               std::vector<gateway_slice_t> &slices)
+{
+    picked.clear();
+    slices.clear();
+
+    while (running) {
+        if (ready_streams.empty()) {
+            gateway_cv.wait(lock);
+            continue;
+        }
+
+        const uint64_t deadline_us = streams[ready_streams.front()].pending.front().arrival_us +
+                                     gateway_config.max_queue_delay_us;
+        const uint64_t now_us = kws_gateway_now_us();
+        if (ready_streams.size() < gateway_config.max_batch && now_us < deadline_us) {
+            gateway_cv.wait_for(lock, std::chrono::microseconds(deadline_us - now_us));
+            continue;
+        }
+
+        while (!ready_streams.empty() && picked.size() < gateway_config.max_batch) {
+            uint32_t id = ready_streams.front();
+            ready_streams.pop_front();
+            streams[id].busy = true;
+            slices.push_back(streams[id].pending.front());
+            streams[id].pending.pop_front();
+            picked.push_back(id);
+        }
+        gateway_stats.pending -= (uint32_t)picked.size();
+        return true;
+    }
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: gateway_worker
+********************************************************************************
+* Summary:
+* Takes batches of slices, runs the DSP of each one into its stream's feature
+* ring and the network over the windows that are complete, on graph contexts
+* of its own (created by kws_gateway_start), then hands the streams back.
+*******************************************************************************/
+static void gateway_worker(uint32_t worker)
+{
+    const uint32_t max_batch = gateway_config.max_batch;
+    const std::vector<void *> &contexts = worker_contexts[worker];
+
+    std::vector<uint32_t> picked;
+    std::vector<gateway_slice_t> slices;
+    std::vector<ei_impulse_handle_t *> handles(max_batch);
+    std::vector<ei_impulse_result_t> results(max_batch);
+    std::vector<size_t> window_slices(max_batch);      /* slice of each window */
+    picked.reserve(max_batch);
+    slices.reserve(max_batch);
+
+    std::unique_lock<std::mutex> lock(gateway_mutex);
+    while (gateway_take_batch(lock, picked, slices)) {
+        lock.unlock();
+
+        uint64_t dsp_us = 0, nn_us = 0;
+        uint32_t errors = 0;
+        size_t windows = 0;
+        for (size_t ix = 0; ix < picked.size(); ix++) {
+            signal_t signal;
+            ei::numpy::signal_from_int16_buffer(slices[ix].samples, slices[ix].length, &signal);
+
+            bool window_ready = false;
+            EI_IMPULSE_ERROR ei_error = process_impulse_continuous_features(streams[picked[ix]].handle, &signal,
+                                                                             &results[windows], &window_ready);
+            if (ei_error != EI_IMPULSE_OK) {
+                printf("ERR: stream %lu: DSP failed with code %d\n", (unsigned long)picked[ix], ei_error);
+                errors++;
+                continue;
+            }
+            dsp_us += results[windows].timing.dsp_us;
+            if (window_ready) {
+                handles[windows] = streams[picked[ix]].handle;
+                window_slices[windows] = ix;
+                windows++;
+            }
+        }
+
+        if (windows > 0) {
+            EI_IMPULSE_ERROR ei_error = process_impulse_continuous_batch(handles.data(), contexts.data(), windows,
+                                                                         results.data());
+            if (ei_error != EI_IMPULSE_OK) {
+                printf("ERR: batch of %lu windows failed with code %d\n", (unsigned long)windows, ei_error);
+                errors += windows;
+                windows = 0;
+            }
+            else {
+                nn_us = results[0].timing.classification_us;
+            }
+        }
+
+        const uint64_t decision_us = kws_gateway_now_us();
+        for (size_t w = 0; w < windows && gateway_callback; w++) {
+            kws_gateway_decision_t decision;
+            decision.stream = picked[window_slices[w]];
+            decision.arrival_us = slices[window_slices[w]].arrival_us;
+            decision.decision_us = decision_us;
+            decision.batch = (uint32_t)windows;
+            decision.label = 0;
+            decision.value = results[w].classification[0].value;
+            for (uint16_t ix = 1; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+                if (results[w].classification[ix].value > decision.value) {
+                    decision.label = ix;
+                    decision.value = results[w].classification[ix].value;
+                }
+            }
+            gateway_callback(&decision, gateway_callback_arg);
+        }
+
+        lock.lock();
+        gateway_stats.slices += picked.size();
+        gateway_stats.decisions += windows;
+        gateway_stats.batches += windows > 0 ? 1 : 0;
+        gateway_stats.dsp_us += dsp_us;
+        gateway_stats.nn_us += nn_us;
+        gateway_stats.errors += errors;
+
+        bool requeued = false;
+        for (uint32_t id : picked) {
+            streams[id].busy = false;
+            if (!streams[id].pending.empty()) {
+                ready_streams.push_back(id);
+                requeued = true;
+            }
+        }
+        if (requeued) {
+            gateway_cv.notify_all();
+        }
+    }
+    lock.unlock();
+
+    /* per thread in re-entrant builds */
+    ei::speechpy::feature::release_mel_filterbanks();
+}
+
+/*******************************************************************************
+* Function Name: gateway_free_contexts
+*******************************************************************************/
+static void gateway_free_contexts(void)
+{
+    for (std::vector<void *> &contexts : worker_contexts) {
+        for (void *ctx : contexts) {
+            process_impulse_batch_context_free(ei_default_impulse.impulse, ctx);
+        }
+    }
+    worker_contexts.clear();
+}
+
+/*******************************************************************************
+* Function Name: kws_gateway_get_default_config
+*******************************************************************************/
+void kws_gateway_get_default_config(kws_gateway_config_t *config)
+{
+    config->streams = 64;
+    config->workers = std::max(1u, std::thread::hardware_concurrency());
+#if !EI_CLASSIFIER_REENTRANT
+    config->workers = 1;
+#endif
+    config->max_batch = 8;
+    config->max_queue_delay_us = 20000;
+}
+
+/*******************************************************************************
+* Function Name: kws_gateway_start
+*******************************************************************************/
+bool kws_gateway_start(const kws_gateway_config_t *config, kws_gateway_decision_cb_t callback, void *arg)
+{
+    if (running || config->streams == 0 || config->workers == 0 || config->max_batch == 0) {
+        return false;
+    }
+#if !EI_CLASSIFIER_REENTRANT
+    if (config->workers > 1) {
+        printf("ERR: more than one gateway worker needs a re-entrant build (cmake -DREENTRANT=ON)\n");
+        return false;
+    }
+#endif
+
+    /* every graph context up front, so a worker never runs a batch without one */
+    worker_contexts.resize(config->workers);
+    for (uint32_t worker = 0; worker < config->workers; worker++) {
+        for (uint32_t ix = 0; ix < config->max_batch; ix++) {
+            void *ctx = process_impulse_batch_context_create(ei_default_impulse.impulse);
+            if (ctx == NULL) {
+                if (worker == 0 && ix == 0) {
+                    printf("ERR: this impulse can't be batched (quantized MFE model compiled with EON only)\n");
+                }
+                else {
+                    printf("ERR: out of memory for the graph contexts (%lu workers x %lu)\n",
+                        (unsigned long)config->workers, (unsigned long)config->max_batch);
+                }
+                gateway_free_contexts();
+                return false;
+            }
+            worker_contexts[worker].push_back(ctx);
+        }
+    }
+
+    gateway_config = *config;
+    gateway_callback = callback;
+    gateway_callback_arg = arg;
+    memset(&gateway_stats, 0, sizeof(gateway_stats));
+
+    streams.resize(config->streams);
+    for (gateway_stream_t &stream : streams) {
+        stream.handle = new ei_impulse_handle_t(ei_default_impulse.impulse);
+        stream.busy = false;
+        run_classifier_init(stream.handle);
+    }
+
+    running = true;
+    for (uint32_t ix = 0; ix < config->workers; ix++) {
+        workers.emplace_back(gateway_worker, ix);
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: kws_gateway_stop
+*******************************************************************************/
+void kws_gateway_stop(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(gateway_mutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+        gateway_cv.notify_all();
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    gateway_free_contexts();
+
+    gateway_stats.dropped += gateway_stats.pending;
+    gateway_stats.pending = 0;
+    ready_streams.clear();
+    for (gateway_stream_t &stream : streams) {
+        run_classifier_deinit(stream.handle);
+        delete stream.handle;
+    }
+    streams.clear();
+}
+
+/*******************************************************************************
+* Function Name: kws_gateway_push
+*******************************************************************************/
+bool kws_gateway_push(uint32_t stream, const int16_t *slice, size_t length, uint64_t arrival_us)
+{
+    std::lock_guard<std::mutex> lock(gateway_mutex);
+    if (!running || stream >= streams.size()) {
+        return false;
+    }
+
+    gateway_stream_t &s = streams[stream];
+    gateway_slice_t pending = { slice, length, arrival_us };
+    s.pending.push_back(pending);
+    if (!s.busy && s.pending.size() == 1) {
+        ready_streams.push_back(stream);
+        gateway_cv.notify_one();
+    }
+
+    gateway_stats.pending++;
+    gateway_stats.max_pending = std::max(gateway_stats.max_pending, gateway_stats.pending);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: kws_gateway_get_stats
+*******************************************************************************/
+void kws_gateway_get_stats(kws_gateway_stats_t *stats)
+{
+    std::lock_guard<std::mutex> lock(gateway_mutex);
+    *stats = gateway_stats;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,79 @@
+/******************************************************************************
+* File Name:   kws_gateway.h
+*
+* Description: Keyword spotting for many microphones at once on a Linux
+*              gateway. Every stream (one room) has its own impulse handle,
+*              i.e. its own feature ring, and hands in slices as they arrive.
+*              A pool of worker threads takes up to max_batch streams with a
+*              pending slice at a time, runs the DSP of each slice
+*              (process_impulse_continuous_features) and then the network
+*              over all windows that are complete in one batched invoke
+*              (process_impulse_continuous_batch: one graph context per batch
+*              slot, every layer runs over the whole batch before the next).
+*
+*              A worker waits for a full batch at most max_queue_delay_us
+*              after the oldest pending slice arrived: that is the latency
+*              budget batching may spend. Past it, whatever is queued goes.
+*******************************************************************************/
+
+#ifndef KWS_GATEWAY_H_
+#define KWS_GATEWAY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+* Types
+********************************************************************************/
+typedef struct {
+    uint32_t streams;
+    uint32_t workers;               /* threads, more than 1 needs EI_CLASSIFIER_REENTRANT */
+    uint32_t max_batch;             /* windows per batched invoke */
+    uint32_t max_queue_delay_us;    /* longest a slice waits for its batch to fill */
+} kws_gateway_config_t;
+
+typedef struct {
+    uint32_t stream;
+    uint64_t arrival_us;            /* as given to kws_gateway_push */
+    uint64_t decision_us;           /* kws_gateway_now_us when the result was out */
+    uint32_t batch;                 /* windows in the invoke it was part of */
+    uint16_t label;                 /* top scoring label and its score */
+    float value;
+} kws_gateway_decision_t;
+
+/* Called on a worker thread for every slice that completed a window */
+typedef void (*kws_gateway_decision_cb_t)(const kws_gateway_decision_t *decision, void *arg);
+
+typedef struct {
+    uint64_t slices;                /* slices through the DSP */
+    uint64_t decisions;
+    uint64_t batches;               /* batched invokes */
+    uint64_t dsp_us;                /* DSP time, summed over the slices */
+    uint64_t nn_us;                 /* batched invokes, summed over the batches */
+    uint32_t pending;               /* slices queued right now */
+    uint32_t max_pending;
+    uint32_t dropped;               /* slices still queued at kws_gateway_stop */
+    uint32_t errors;                /* slices the classifier failed on */
+} kws_gateway_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+void kws_gateway_get_default_config(kws_gateway_config_t *config);
+/* Sets up the streams and starts the workers; false if the config can't run */
+bool kws_gateway_start(const kws_gateway_config_t *config, kws_gateway_decision_cb_t callback, void *arg);
+/* Stops the workers and frees the streams, dropping slices not started yet */
+void kws_gateway_stop(void);
+
+/* Queues one slice of a stream. The samples stay the caller's and have to be
+ * valid until the slice is processed (or kws_gateway_stop) */
+bool kws_gateway_push(uint32_t stream, const int16_t *slice, size_t length, uint64_t arrival_us);
+
+void kws_gateway_get_stats(kws_gateway_stats_t *stats);
+/* Monotonic clock of arrival_us and decision_us */
+uint64_t kws_gateway_now_us(void);
+
+#endif /* KWS_GATEWAY_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,771 @@
+/******************************************************************************
+* File Name:   mfe_bench.cpp
+*
+* Description: Micro-benchmark of the MFE front end on the host. Times the
+*              stages of the frame loop in speechpy::feature::mfe over all
+*              frames of one model window (power spectrum, mel filterbank),
+*              then the whole speechpy::feature::mfe call with the model's
+*              DSP configuration, the int16 front end (preemphasis class read
+*              per frame against processing::preemphasis_int16 once per
+*              sample, and extract_mfe_features through get_data against
+*              signal_t::int16_data), the fixed-point MFE
+*              (ei_dsp_config_mfe_t::fixed_point) against the float one, the
+*              continuous DSP per slice with the window normalized on every
+*              slice against frames normalized once as they enter the feature
+*              ring, and finally result.timing.dsp_us of run_classifier. The legacy versions of the stages (magnitude
+*              rfft then squared; mel points rebuilt per call and triangle
+*              weights divided out per bin) are kept here as the reference
+*              the numbers and the results are compared against.
+*
+* Usage:       mfe_bench [--iterations N]
+*              Runs on the test_sample.h clip.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "test_sample.h"
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "edge-impulse-sdk/dsp/numpy.hpp"
+#include "edge-impulse-sdk/dsp/speechpy/speechpy.hpp"
+
+using namespace ei;
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define DEFAULT_ITERATIONS          200
+
+/* Largest difference of the fixed-point MFE from the float one, in steps of
+ * 1/256 (the quantization of mfe_normalization) */
+#define MFE_Q15_TOLERANCE           3
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static float window_samples[EI_CLASSIFIER_RAW_SAMPLE_COUNT];
+
+/* Power spectra of all frames of the window, input of the mel stage */
+static float *power_frames = NULL;
+static size_t power_frame_count = 0;
+
+
+static int window_get_data(size_t offset, size_t length, float *out_ptr)
+{
+    memcpy(out_ptr, window_samples + offset, length * sizeof(float));
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: legacy_power_spectrum
+********************************************************************************
+* Summary:
+* Power spectrum as numpy::power_spectrum computed it before the workspace
+* variant: magnitude rfft (allocating, one sqrt per bin), squared and scaled.
+*******************************************************************************/
+static int legacy_power_spectrum(float *frame, size_t frame_size, float *out_buffer,
+                                 size_t out_buffer_size, uint16_t fft_points)
+{
+    int r = numpy::rfft(frame, frame_size, out_buffer, out_buffer_size, fft_points);
+    if (r != EIDSP_OK) {
+        return r;
+    }
+
+    for (size_t ix = 0; ix < out_buffer_size; ix++) {
+        out_buffer[ix] = (1.0 / static_cast<float>(fft_points)) *
+            (out_buffer[ix] * out_buffer[ix]);
+    }
+    return EIDSP_OK;
+}
+
+/*******************************************************************************
+* Function Name: bench_power_spectrum
+********************************************************************************
+* Summary:
+* One model window worth of frames through the three power spectrum paths.
+*******************************************************************************/
+static int bench_power_spectrum(const ei_dsp_config_mfe_t *config, uint32_t iterations)
+{
+    const size_t frame_length = (size_t)(config->frame_length * EI_CLASSIFIER_FREQUENCY);
+    const size_t frame_stride = (size_t)(config->frame_stride * EI_CLASSIFIER_FREQUENCY);
+    const size_t frames = (EI_CLASSIFIER_RAW_SAMPLE_COUNT - frame_length) / frame_stride + 1;
+    const size_t bins = config->fft_length / 2 + 1;
+
+    float *reference = (float *)calloc(frames * bins, sizeof(float));
+    float *out = (float *)calloc(frames * bins, sizeof(float));
+    if (!reference || !out) {
+        printf("ERR: out of memory\n");
+        free(reference);
+        free(out);
+        return -1;
+    }
+
+    uint64_t legacy_us = 0, per_call_us = 0, workspace_us = 0;
+    int ret = EIDSP_OK;
+
+    for (uint32_t it = 0; it < iterations && ret == EIDSP_OK; it++) {
+        uint64_t start_us = ei_read_timer_us();
+        for (size_t f = 0; f < frames && ret == EIDSP_OK; f++) {
+            ret = legacy_power_spectrum(window_samples + f * frame_stride, frame_length,
+                                        reference + f * bins, bins, config->fft_length);
+        }
+        legacy_us += ei_read_timer_us() - start_us;
+
+        start_us = ei_read_timer_us();
+        for (size_t f = 0; f < frames && ret == EIDSP_OK; f++) {
+            ret = numpy::power_spectrum(window_samples + f * frame_stride, frame_length,
+                                        out + f * bins, bins, config->fft_length);
+        }
+        per_call_us += ei_read_timer_us() - start_us;
+
+        start_us = ei_read_timer_us();
+        power_spectrum_workspace workspace(config->fft_length);
+        for (size_t f = 0; f < frames && ret == EIDSP_OK; f++) {
+            ret = numpy::power_spectrum(window_samples + f * frame_stride, frame_length,
+                                        out + f * bins, bins, &workspace);
+        }
+        workspace_us += ei_read_timer_us() - start_us;
+    }
+
+    if (ret != EIDSP_OK) {
+        printf("ERR: power spectrum failed (%d)\n", ret);
+        free(reference);
+        free(out);
+        return -1;
+    }
+
+    float max_rel_diff = 0.0f;
+    for (size_t i = 0; i < frames * bins; i++) {
+        float diff = fabsf(out[i] - reference[i]);
+        float mag = fabsf(reference[i]) > 1e-20f ? fabsf(reference[i]) : 1e-20f;
+        if (diff / mag > max_rel_diff) {
+            max_rel_diff = diff / mag;
+        }
+    }
+
+    printf("power spectrum, %u frames x %u bins (fft %u), per window:\n",
+        (unsigned)frames, (unsigned)bins, (unsigned)config->fft_length);
+    printf("  legacy (rfft magnitude, squared): %8.1f us\n", (double)legacy_us / iterations);
+    printf("  workspace per call:               %8.1f us\n", (double)per_call_us / iterations);
+    printf("  workspace per window:             %8.1f us\n", (double)workspace_us / iterations);
+    printf("  max relative difference to legacy: %g\n", max_rel_diff);
+
+    power_frames = reference;
+    power_frame_count = frames;
+    free(out);
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: legacy_mel
+********************************************************************************
+* Summary:
+* Mel stage as speechpy::feature::mfe did it before the sparse filterbank:
+* mel points and FFT bins rebuilt on every call, two divisions per bin.
+*******************************************************************************/
+static int legacy_mel(const ei_dsp_config_mfe_t *config, float *out)
+{
+    const uint32_t sampling_frequency = EI_CLASSIFIER_FREQUENCY;
+    const uint16_t num_filters = config->num_filters;
+    const uint16_t fft_length = config->fft_length;
+    const uint16_t version = config->implementation_version;
+    uint32_t low_frequency = config->low_frequency;
+    uint32_t high_frequency = config->high_frequency ? config->high_frequency : sampling_frequency / 2;
+    if (version < 4 && low_frequency == 0) {
+        low_frequency = 300;
+    }
+
+    const size_t power_spectrum_frame_size = (fft_length / 2 + 1);
+    const int MELS_SIZE = num_filters + 2;
+    float *mels = (float *)ei_dsp_calloc(MELS_SIZE, sizeof(float));
+    if (!mels) {
+        return EIDSP_OUT_OF_MEM;
+    }
+    uint16_t *bins = reinterpret_cast<uint16_t *>(mels);
+
+    numpy::linspace(
+        speechpy::functions::frequency_to_mel(static_cast<float>(low_frequency)),
+        speechpy::functions::frequency_to_mel(static_cast<float>(high_frequency)),
+        num_filters + 2,
+        mels);
+
+    uint16_t max_bin = version >= 4 ? fft_length : power_spectrum_frame_size;
+    for (uint16_t ix = 0; ix < MELS_SIZE - 1; ix++) {
+        mels[ix] = speechpy::functions::mel_to_frequency(mels[ix]);
+        if (mels[ix] < low_frequency) {
+            mels[ix] = low_frequency;
+        }
+        if (mels[ix] > high_frequency) {
+            mels[ix] = high_frequency;
+        }
+        bins[ix] = speechpy::feature::get_fft_bin_from_hertz(max_bin, mels[ix], sampling_frequency);
+    }
+    mels[MELS_SIZE - 1] = speechpy::functions::mel_to_frequency(mels[MELS_SIZE - 1]);
+    if (mels[MELS_SIZE - 1] > high_frequency) {
+        mels[MELS_SIZE - 1] = high_frequency;
+    }
+    mels[MELS_SIZE - 1] -= 0.001;
+    bins[MELS_SIZE - 1] = speechpy::feature::get_fft_bin_from_hertz(max_bin, mels[MELS_SIZE - 1], sampling_frequency);
+
+    for (size_t f = 0; f < power_frame_count; f++) {
+        const float *power = power_frames + f * power_spectrum_frame_size;
+        float *row_ptr = out + f * num_filters;
+        for (size_t i = 0; i < num_filters; i++) {
+            size_t left = bins[i];
+            size_t middle = bins[i + 1];
+            size_t right = bins[i + 2];
+
+            row_ptr[i] = power[middle];
+            for (size_t bin = left + 1; bin < right; bin++) {
+                if (bin < middle) {
+                    row_ptr[i] += ((static_cast<float>(bin) - left) / (middle - left)) * power[bin];
+                }
+                if (bin > middle) {
+                    row_ptr[i] += ((right - static_cast<float>(bin)) / (right - middle)) * power[bin];
+                }
+            }
+        }
+    }
+
+    ei_dsp_free(mels, MELS_SIZE * sizeof(float));
+    return EIDSP_OK;
+}
+
+/*******************************************************************************
+* Function Name: bench_mel
+********************************************************************************
+* Summary:
+* Mel stage over the power spectra of one window: legacy vs the cached
+* sparse filterbank.
+*******************************************************************************/
+static int bench_mel(const ei_dsp_config_mfe_t *config, uint32_t iterations)
+{
+    const size_t bins = config->fft_length / 2 + 1;
+    const size_t num_filters = (size_t)config->num_filters;
+    const size_t count = power_frame_count * num_filters;
+    uint32_t high_frequency = config->high_frequency ? config->high_frequency : EI_CLASSIFIER_FREQUENCY / 2;
+    uint32_t low_frequency = config->low_frequency;
+    if (config->implementation_version < 4 && low_frequency == 0) {
+        low_frequency = 300;
+    }
+
+    float *reference = (float *)calloc(count, sizeof(float));
+    float *out = (float *)calloc(count, sizeof(float));
+    if (!reference || !out) {
+        printf("ERR: out of memory\n");
+        free(reference);
+        free(out);
+        return -1;
+    }
+
+    uint64_t legacy_us = 0, sparse_us = 0;
+    int ret = EIDSP_OK;
+
+    for (uint32_t it = 0; it < iterations && ret == EIDSP_OK; it++) {
+        uint64_t start_us = ei_read_timer_us();
+        ret = legacy_mel(config, reference);
+        legacy_us += ei_read_timer_us() - start_us;
+
+        start_us = ei_read_timer_us();
+        const speechpy::mel_filterbank_t *filterbank = speechpy::feature::get_mel_filterbank(
+            EI_CLASSIFIER_FREQUENCY, config->num_filters, config->fft_length,
+            low_frequency, high_frequency, config->implementation_version);
+        if (!filterbank) {
+            ret = EIDSP_OUT_OF_MEM;
+            break;
+        }
+        for (size_t f = 0; f < power_frame_count; f++) {
+            const float *power = power_frames + f * bins;
+            float *row_ptr = out + f * num_filters;
+            for (size_t i = 0; i < num_filters; i++) {
+                const speechpy::mel_filter_t *filter = &filterbank->filters[i];
+                row_ptr[i] = numpy::dot(filterbank->weights + filter->weights_offset,
+                    power + filter->start_bin, filter->length);
+            }
+        }
+        sparse_us += ei_read_timer_us() - start_us;
+    }
+
+    if (ret != EIDSP_OK) {
+        printf("ERR: mel stage failed (%d)\n", ret);
+        free(reference);
+        free(out);
+        return -1;
+    }
+
+    float max_rel_diff = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        float diff = fabsf(out[i] - reference[i]);
+        float mag = fabsf(reference[i]) > 1e-20f ? fabsf(reference[i]) : 1e-20f;
+        if (diff / mag > max_rel_diff) {
+            max_rel_diff = diff / mag;
+        }
+    }
+
+    printf("mel filterbank, %u frames x %u filters, per window:\n",
+        (unsigned)power_frame_count, (unsigned)config->num_filters);
+    printf("  legacy (rebuilt per call, divisions per bin): %8.1f us\n", (double)legacy_us / iterations);
+    printf("  sparse filterbank, cached:                    %8.1f us\n", (double)sparse_us / iterations);
+    printf("  max relative difference to legacy: %g\n", max_rel_diff);
+
+    free(reference);
+    free(out);
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: bench_mfe
+********************************************************************************
+* Summary:
+* Whole speechpy::feature::mfe call over one model window.
+*******************************************************************************/
+static int bench_mfe(const ei_dsp_config_mfe_t *config, uint32_t iterations)
+{
+    signal_t signal;
+    signal.total_length = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
+    signal.get_data = &window_get_data;
+
+    matrix_size_t size = speechpy::feature::calculate_mfe_buffer_size(
+        signal.total_length, EI_CLASSIFIER_FREQUENCY, config->frame_length, config->frame_stride,
+        config->num_filters, config->implementation_version);
+    matrix_t features(size.rows, size.cols);
+    if (!features.buffer) {
+        printf("ERR: out of memory\n");
+        return -1;
+    }
+
+    uint64_t total_us = 0;
+    for (uint32_t it = 0; it < iterations; it++) {
+        uint64_t start_us = ei_read_timer_us();
+        int ret = speechpy::feature::mfe(&features, nullptr, &signal,
+            EI_CLASSIFIER_FREQUENCY, config->frame_length, config->frame_stride, config->num_filters,
+            config->fft_length, config->low_frequency, config->high_frequency,
+            config->implementation_version);
+        total_us += ei_read_timer_us() - start_us;
+        if (ret != EIDSP_OK) {
+            printf("ERR: mfe failed (%d)\n", ret);
+            return -1;
+        }
+    }
+
+    double per_window_us = (double)total_us / iterations;
+    printf("speechpy::feature::mfe, %u x %u features: %8.1f us per window, %.2f us per frame\n",
+        (unsigned)size.rows, (unsigned)size.cols, per_window_us, per_window_us / size.rows);
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: bench_front_end
+********************************************************************************
+* Summary:
+* int16 -> preemphasized float frames of one window: the preemphasis class
+* behind get_data, read frame by frame as the MFE did, against one
+* preemphasis_int16 pass; then the whole extract_mfe_features block over a
+* get_data signal and over an int16 signal.
+*******************************************************************************/
+static int bench_front_end(const ei_dsp_config_mfe_t *config, uint32_t iterations)
+{
+    const size_t frame_length = (size_t)(config->frame_length * EI_CLASSIFIER_FREQUENCY);
+    const size_t frame_stride = (size_t)(config->frame_stride * EI_CLASSIFIER_FREQUENCY);
+    const size_t frames = (EI_CLASSIFIER_RAW_SAMPLE_COUNT - frame_length) / frame_stride + 1;
+    const size_t span = (frames - 1) * frame_stride + frame_length;
+
+    signal_t int16_signal;
+    numpy::signal_from_int16_buffer(test_audio_16000, EI_CLASSIFIER_RAW_SAMPLE_COUNT, &int16_signal);
+    signal_t float_signal;
+    float_signal.total_length = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
+    float_signal.get_data = &window_get_data;
+
+    float *reference = (float *)calloc(frames * frame_length, sizeof(float));
+    float *out = (float *)calloc(span, sizeof(float));
+    matrix_t features_reference(frames, config->num_filters);
+    matrix_t features(frames, config->num_filters);
+    if (!reference || !out || !features_reference.buffer || !features.buffer) {
+        printf("ERR: out of memory\n");
+        free(reference);
+        free(out);
+        return -1;
+    }
+
+    uint64_t class_us = 0, fused_us = 0, block_us = 0, block_int16_us = 0;
+    int ret = EIDSP_OK;
+
+    for (uint32_t it = 0; it < iterations && ret == EIDSP_OK; it++) {
+        uint64_t start_us = ei_read_timer_us();
+        {
+            class speechpy::processing::preemphasis pre(&int16_signal, 1, 0.98f, true);
+            for (size_t f = 0; f < frames && ret == EIDSP_OK; f++) {
+                ret = pre.get_data(f * frame_stride, frame_length, reference + f * frame_length);
+            }
+        }
+        class_us += ei_read_timer_us() - start_us;
+
+        start_us = ei_read_timer_us();
+        if (ret == EIDSP_OK) {
+            ret = speechpy::processing::preemphasis_int16(test_audio_16000, EI_CLASSIFIER_RAW_SAMPLE_COUNT,
+                0, span, 0.98f, true, out);
+        }
+        fused_us += ei_read_timer_us() - start_us;
+
+        start_us = ei_read_timer_us();
+        if (ret == EIDSP_OK) {
+            features_reference.rows = frames;
+            features_reference.cols = config->num_filters;
+            ret = extract_mfe_features(&float_signal, &features_reference, (void *)config, EI_CLASSIFIER_FREQUENCY);
+        }
+        block_us += ei_read_timer_us() - start_us;
+
+        start_us = ei_read_timer_us();
+        if (ret == EIDSP_OK) {
+            features.rows = frames;
+            features.cols = config->num_filters;
+            ret = extract_mfe_features(&int16_signal, &features, (void *)config, EI_CLASSIFIER_FREQUENCY);
+        }
+        block_int16_us += ei_read_timer_us() - start_us;
+    }
+
+    if (ret != EIDSP_OK) {
+        printf("ERR: front end failed (%d)\n", ret);
+        free(reference);
+        free(out);
+        return -1;
+    }
+
+    size_t sample_mismatches = 0;
+    for (size_t f = 0; f < frames; f++) {
+        if (memcmp(reference + f * frame_length, out + f * frame_stride, frame_length * sizeof(float)) != 0) {
+            sample_mismatches++;
+        }
+    }
+    size_t feature_mismatches = 0;
+    for (size_t i = 0; i < frames * config->num_filters; i++) {
+        if (features.buffer[i] != features_reference.buffer[i]) {
+            feature_mismatches++;
+        }
+    }
+
+    printf("int16 front end, %u frames of %u samples, per window:\n", (unsigned)frames, (unsigned)frame_length);
+    printf("  preemphasis class, read per frame:            %8.1f us\n", (double)class_us / iterations);
+    printf("  preemphasis_int16, once per sample:           %8.1f us\n", (double)fused_us / iterations);
+    printf("  extract_mfe_features, get_data signal:        %8.1f us\n", (double)block_us / iterations);
+    printf("  extract_mfe_features, int16 signal:           %8.1f us\n", (double)block_int16_us / iterations);
+    printf("  frames differing: %u, features differing: %u\n",
+        (unsigned)sample_mismatches, (unsigned)feature_mismatches);
+
+    free(reference);
+    free(out);
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: extract_mfe_timed
+********************************************************************************
+* Summary:
+* extract_mfe_features over one window, returns the time in us and the
+* workspace arena bytes it used (0 without the arena) through the pointers.
+*******************************************************************************/
+static int extract_mfe_timed(signal_t *signal, matrix_t *features, size_t frames, ei_dsp_config_mfe_t *config,
+    uint64_t *time_us, size_t *arena_bytes)
+{
+    ei_dsp_workspace_stats_t stats;
+    ei_dsp_get_workspace_stats(&stats);
+#if EIDSP_WORKSPACE_ARENA
+    ei_dsp_workspace_stats.peak = ei_dsp_workspace_stats.in_use;
+#endif
+
+    features->rows = frames;
+    features->cols = config->num_filters;
+
+    uint64_t start_us = ei_read_timer_us();
+    int ret = extract_mfe_features(signal, features, (void *)config, EI_CLASSIFIER_FREQUENCY);
+    *time_us += ei_read_timer_us() - start_us;
+
+    ei_dsp_workspace_stats_t after;
+    ei_dsp_get_workspace_stats(&after);
+    if (after.peak - stats.in_use > *arena_bytes) {
+        *arena_bytes = after.peak - stats.in_use;
+    }
+#if EIDSP_WORKSPACE_ARENA
+    if (after.peak < stats.peak) {
+        ei_dsp_workspace_stats.peak = stats.peak;
+    }
+#endif
+    return ret;
+}
+
+/*******************************************************************************
+* Function Name: bench_fixed_point
+********************************************************************************
+* Summary:
+* extract_mfe_features with the fixed-point MFE (q15 preemphasis, FFT and mel
+* filterbank, integer log) against the float MFE on the int16 clip: time,
+* workspace arena bytes, and how far the normalized features are apart in
+* steps of 1/256. Fails if that is more than MFE_Q15_TOLERANCE.
+*******************************************************************************/
+static int bench_fixed_point(const ei_dsp_config_mfe_t *config, uint32_t iterations)
+{
+    const size_t frame_length = (size_t)(config->frame_length * EI_CLASSIFIER_FREQUENCY);
+    const size_t frame_stride = (size_t)(config->frame_stride * EI_CLASSIFIER_FREQUENCY);
+    const size_t frames = (EI_CLASSIFIER_RAW_SAMPLE_COUNT - frame_length) / frame_stride + 1;
+
+    ei_dsp_config_mfe_t float_config = *config;
+    float_config.fixed_point = 0;
+    ei_dsp_config_mfe_t q15_config = *config;
+    q15_config.fixed_point = 1;
+
+    signal_t int16_signal;
+    numpy::signal_from_int16_buffer(test_audio_16000, EI_CLASSIFIER_RAW_SAMPLE_COUNT, &int16_signal);
+    signal_t float_signal;
+    float_signal.total_length = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
+    float_signal.get_data = &window_get_data;
+
+    matrix_t features_float(frames, config->num_filters);
+    matrix_t features_q15(frames, config->num_filters);
+    matrix_t features_q15_get_data(frames, config->num_filters);
+    if (!features_float.buffer || !features_q15.buffer || !features_q15_get_data.buffer) {
+        printf("ERR: out of memory\n");
+        return -1;
+    }
+
+    uint64_t float_us = 0, q15_us = 0, unused_us = 0;
+    size_t float_bytes = 0, q15_bytes = 0, unused_bytes = 0;
+    int ret = EIDSP_OK;
+
+    for (uint32_t it = 0; it < iterations && ret == EIDSP_OK; it++) {
+        ret = extract_mfe_timed(&int16_signal, &features_float, frames, &float_config, &float_us, &float_bytes);
+        if (ret == EIDSP_OK) {
+            ret = extract_mfe_timed(&int16_signal, &features_q15, frames, &q15_config, &q15_us, &q15_bytes);
+        }
+    }
+    if (ret == EIDSP_OK) {
+        ret = extract_mfe_timed(&float_signal, &features_q15_get_data, frames, &q15_config, &unused_us, &unused_bytes);
+    }
+    if (ret != EIDSP_OK) {
+        printf("ERR: fixed-point MFE failed (%d)\n", ret);
+        return -1;
+    }
+
+    const size_t count = frames * config->num_filters;
+    size_t exact = 0, get_data_mismatches = 0;
+    int max_diff = 0;
+    double sum_diff = 0;
+    for (size_t i = 0; i < count; i++) {
+        int diff = abs((int)lroundf(features_q15.buffer[i] * 256.0f) - (int)lroundf(features_float.buffer[i] * 256.0f));
+        if (diff == 0) {
+            exact++;
+        }
+        if (diff > max_diff) {
+            max_diff = diff;
+        }
+        sum_diff += diff;
+        if (features_q15_get_data.buffer[i] != features_q15.buffer[i]) {
+            get_data_mismatches++;
+        }
+    }
+
+    printf("fixed-point MFE, %u x %u features, int16 signal, per window:\n",
+        (unsigned)frames, (unsigned)config->num_filters);
+    printf("  extract_mfe_features, float:                  %8.1f us, %u arena bytes\n",
+        (double)float_us / iterations, (unsigned)float_bytes);
+    printf("  extract_mfe_features, fixed point:            %8.1f us, %u arena bytes\n",
+        (double)q15_us / iterations, (unsigned)q15_bytes);
+    printf("  features equal: %.1f%%, mean |diff| %.3f / 256, max |diff| %d / 256 (tolerance %d)\n",
+        100.0 * exact / count, sum_diff / count, max_diff, MFE_Q15_TOLERANCE);
+    printf("  get_data signal against int16 signal, features differing: %u\n", (unsigned)get_data_mismatches);
+
+    if (max_diff > MFE_Q15_TOLERANCE || get_data_mismatches != 0) {
+        printf("ERR: fixed-point MFE out of tolerance\n");
+        return -1;
+    }
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: continuous_slice
+********************************************************************************
+* Summary:
+* DSP of one slice as process_impulse_continuous does it for a float input
+* tensor: the slice's frames go to the feature ring, then the window is copied
+* out (oldest first) and, unless the ring normalizes its frames, normalized.
+*******************************************************************************/
+static int continuous_slice(const int16_t *slice, ei_feature_ring_t *ring, ei_dsp_config_mfe_t *config,
+    matrix_t *window)
+{
+    signal_t signal;
+    numpy::signal_from_int16_buffer(slice, EI_CLASSIFIER_SLICE_SIZE, &signal);
+
+    matrix_size_t features_written = { 0, 0 };
+    int ret = extract_mfe_per_slice_features_ring(&signal, ring, config, EI_CLASSIFIER_FREQUENCY, &features_written);
+    if (ret != EIDSP_OK) {
+        return ret;
+    }
+
+    ei_feature_ring_read(ring, window->buffer);
+    if (!ring->normalized) {
+        calc_cepstral_mean_and_var_normalization_mfe(window, config);
+    }
+    return EIDSP_OK;
+}
+
+/*******************************************************************************
+* Function Name: bench_continuous
+********************************************************************************
+* Summary:
+* Continuous DSP per slice over the clip: raw MFE frames in the ring and the
+* whole window normalized on every slice, against frames normalized once as
+* they enter the ring (ei_feature_ring_t::normalized, v3+). The windows must
+* be identical.
+*******************************************************************************/
+static int bench_continuous(const ei_dsp_config_mfe_t *config, uint32_t iterations)
+{
+    const size_t slices = EI_CLASSIFIER_RAW_SAMPLE_COUNT / EI_CLASSIFIER_SLICE_SIZE;
+    ei_dsp_config_mfe_t slice_config = *config;
+
+    matrix_t raw_buffer(1, EI_CLASSIFIER_NN_INPUT_FRAME_SIZE);
+    matrix_t normalized_buffer(1, EI_CLASSIFIER_NN_INPUT_FRAME_SIZE);
+    matrix_t raw_window(1, EI_CLASSIFIER_NN_INPUT_FRAME_SIZE);
+    matrix_t normalized_window(1, EI_CLASSIFIER_NN_INPUT_FRAME_SIZE);
+    if (!raw_buffer.buffer || !normalized_buffer.buffer || !raw_window.buffer || !normalized_window.buffer) {
+        printf("ERR: out of memory\n");
+        return -1;
+    }
+
+    ei_feature_ring_t rings[2];
+    matrix_t *windows[2] = { &raw_window, &normalized_window };
+    uint64_t slice_us[2] = { 0, 0 };
+    int ret = EIDSP_OK;
+
+    for (size_t r = 0; r < 2 && ret == EIDSP_OK; r++) {
+        rings[r].buffer = r ? normalized_buffer.buffer : raw_buffer.buffer;
+        rings[r].buffer_u8 = NULL;
+        rings[r].cols = config->num_filters;
+        rings[r].rows = EI_CLASSIFIER_NN_INPUT_FRAME_SIZE / config->num_filters;
+        rings[r].normalized = r == 1;
+        rings[r].frame = NULL;
+        rings[r].frame_size = 0;
+        rings[r].frame_ix = 0;
+
+        for (uint32_t it = 0; it < iterations && ret == EIDSP_OK; it++) {
+            ei_dsp_clear_continuous_audio_state();
+            rings[r].head = 0;
+            for (size_t s = 0; s < slices && ret == EIDSP_OK; s++) {
+                uint64_t start_us = ei_read_timer_us();
+                ret = continuous_slice(test_audio_16000 + s * EI_CLASSIFIER_SLICE_SIZE, &rings[r], &slice_config,
+                    windows[r]);
+                slice_us[r] += ei_read_timer_us() - start_us;
+            }
+        }
+    }
+    if (ret != EIDSP_OK) {
+        printf("ERR: continuous MFE failed (%d)\n", ret);
+        return -1;
+    }
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < EI_CLASSIFIER_NN_INPUT_FRAME_SIZE; i++) {
+        if (raw_window.buffer[i] != normalized_window.buffer[i]) {
+            mismatches++;
+        }
+    }
+
+    printf("continuous MFE, %u slices of %u samples, float feature ring, per slice:\n",
+        (unsigned)slices, (unsigned)EI_CLASSIFIER_SLICE_SIZE);
+    printf("  window normalized on every slice:             %8.1f us\n",
+        (double)slice_us[0] / (iterations * slices));
+    printf("  frames normalized as they enter the ring:     %8.1f us\n",
+        (double)slice_us[1] / (iterations * slices));
+    printf("  features differing: %u\n", (unsigned)mismatches);
+
+    if (mismatches != 0) {
+        printf("ERR: normalized ring differs from the normalized window\n");
+        return -1;
+    }
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: bench_run_classifier
+********************************************************************************
+* Summary:
+* Average result.timing of run_classifier over the clip.
+*******************************************************************************/
+static int bench_run_classifier(uint32_t iterations)
+{
+    signal_t signal;
+    numpy::signal_from_int16_buffer(test_audio_16000, EI_CLASSIFIER_RAW_SAMPLE_COUNT, &signal);
+
+    uint64_t dsp_us = 0, nn_us = 0;
+    for (uint32_t it = 0; it < iterations; it++) {
+        ei_impulse_result_t result;
+        EI_IMPULSE_ERROR ei_error = run_classifier(&signal, &result, false);
+        if (ei_error != EI_IMPULSE_OK) {
+            printf("ERR: run_classifier failed (%d)\n", ei_error);
+            return -1;
+        }
+        dsp_us += result.timing.dsp_us;
+        nn_us += result.timing.classification_us;
+    }
+    run_classifier_deinit();
+
+    printf("run_classifier, per window: dsp %.1f us, nn %.1f us (result.timing)\n",
+        (double)dsp_us / iterations, (double)nn_us / iterations);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iterations = DEFAULT_ITERATIONS;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--iterations") && i + 1 < argc) {
+            iterations = (uint32_t)atoi(argv[++i]);
+        }
+        else {
+            printf("usage: %s [--iterations N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    const ei_model_dsp_t *block = &ei_default_impulse.impulse->dsp_blocks[0];
+    if (block->extract_fn != &extract_mfe_features) {
+        printf("ERR: the first DSP block is not MFE\n");
+        return 1;
+    }
+    const ei_dsp_config_mfe_t *config = (const ei_dsp_config_mfe_t *)block->config;
+
+    numpy::int16_to_float(test_audio_16000, window_samples, EI_CLASSIFIER_RAW_SAMPLE_COUNT);
+
+    printf("%u iterations\n", (unsigned)iterations);
+    if (bench_power_spectrum(config, iterations) != 0) {
+        return 1;
+    }
+    if (bench_mel(config, iterations) != 0) {
+        return 1;
+    }
+    if (bench_mfe(config, iterations) != 0) {
+        return 1;
+    }
+    if (bench_front_end(config, iterations) != 0) {
+        return 1;
+    }
+    if (bench_fixed_point(config, iterations) != 0) {
+        return 1;
+    }
+    if (bench_continuous(config, iterations) != 0) {
+        return 1;
+    }
+    if (bench_run_classifier(iterations) != 0) {
+        return 1;
+    }
+
+    free(power_frames);
+    return 0;
+}
+
+/* [] END OF FILE */
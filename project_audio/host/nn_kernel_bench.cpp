@@ -0,0 +1,887 @@
+/******************************************************************************
+* File Name:   nn_kernel_bench.cpp
+*
+* Description: Micro-benchmark of the x86 int8 kernels
+*              (tensorflow/lite/kernels/internal/optimized/x86_int8.h) on the
+*              layer shapes of this model's MobileNet: the first 3x3 stride 2
+*              convolution, every depthwise 3x3 (stride 1 "same", stride 2
+*              "valid" after PAD) and pointwise 1x1 convolution, and the two
+*              fully connected layers. Every layer runs with random int8 data
+*              and random per-channel scaling, zero points and activation
+*              ranges, once with reference_integer_ops and once per
+*              instruction set the CPU supports; the outputs must be
+*              identical (exits with 1 otherwise), and the time per layer
+*              and the speedup against the reference kernel are printed.
+*
+*              Every depthwise layer and the 1x1 convolution after it are
+*              also checked as one depthwise-separable block (the
+*              DEPTHWISE_SEPARABLE_CONV_2D node of arena_planner --fuse):
+*              the fused reference kernel and the fused x86 kernels, at
+*              several tile sizes, must match the two layers run one after
+*              the other, and the time per block is printed for the two
+*              layers and for the fused kernel with a BLOCK_TILE_BYTES tile.
+*
+* Usage:       nn_kernel_bench [--iterations N] [--seeds N]
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/x86_int8.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/conv.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/depthwise_conv.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/depthwise_separable_conv.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/fully_connected.h"
+
+using namespace tflite;
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define DEFAULT_ITERATIONS          200
+
+/* Random parameter sets every layer is checked with (the first one is timed) */
+#define DEFAULT_SEEDS               4
+
+#define ISA_COUNT                   4
+
+/* Tile arena bytes of a timed block, as arena_planner --fuse gives them */
+#define BLOCK_TILE_BYTES            256
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+typedef enum {
+    LAYER_CONV,
+    LAYER_DEPTHWISE,
+    LAYER_FULLY_CONNECTED,
+} layer_kind_t;
+
+/* One layer: input height x width x depth, output depth, square kernel, stride
+ * and padding ("same": output = ceil(input / stride), "valid": no padding) */
+typedef struct {
+    const char *name;
+    layer_kind_t kind;
+    int in_h;
+    int in_w;
+    int in_c;
+    int out_c;
+    int kernel;
+    int stride;
+    bool same;
+} layer_shape_t;
+
+/* Tensors and parameters of one layer instance */
+typedef struct {
+    int out_h;
+    int out_w;
+    RuntimeShape input_shape;
+    RuntimeShape filter_shape;
+    RuntimeShape bias_shape;
+    RuntimeShape output_shape;
+    int8_t *input;
+    int8_t *filter;
+    int32_t *bias;
+    int32_t *multiplier;
+    int32_t *shift;
+    int8_t *reference;
+    int8_t *output;
+    void *packed_buffer;
+    x86_int8::PackedFilter packed;
+    ConvParams conv;
+    DepthwiseParams depthwise;
+    FullyConnectedParams fully_connected;
+} layer_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* In graph order (MobileNetV1 0.1 on the 99x40 MFE window); the stride 2
+ * depthwise layers read the output of the PAD node before them */
+static const layer_shape_t layers[] = {
+    { "conv 3x3/2",      LAYER_CONV,            99, 40,   1,   3, 3, 2, true  },
+    { "dw 3x3",          LAYER_DEPTHWISE,       50, 20,   3,   3, 3, 1, true  },
+    { "pw 3>6",          LAYER_CONV,            50, 20,   3,   6, 1, 1, true  },
+    { "dw 3x3/2",        LAYER_DEPTHWISE,       51, 21,   6,   6, 3, 2, false },
+    { "pw 6>12",         LAYER_CONV,            25, 10,   6,  12, 1, 1, true  },
+    { "dw 3x3",          LAYER_DEPTHWISE,       25, 10,  12,  12, 3, 1, true  },
+    { "pw 12>12",        LAYER_CONV,            25, 10,  12,  12, 1, 1, true  },
+    { "dw 3x3/2",        LAYER_DEPTHWISE,       26, 11,  12,  12, 3, 2, false },
+    { "pw 12>25",        LAYER_CONV,            12,  5,  12,  25, 1, 1, true  },
+    { "dw 3x3",          LAYER_DEPTHWISE,       12,  5,  25,  25, 3, 1, true  },
+    { "pw 25>25",        LAYER_CONV,            12,  5,  25,  25, 1, 1, true  },
+    { "dw 3x3/2",        LAYER_DEPTHWISE,       13,  6,  25,  25, 3, 2, false },
+    { "pw 25>51",        LAYER_CONV,             6,  2,  25,  51, 1, 1, true  },
+    { "dw 3x3",          LAYER_DEPTHWISE,        6,  2,  51,  51, 3, 1, true  },
+    { "pw 51>51",        LAYER_CONV,             6,  2,  51,  51, 1, 1, true  },
+    { "dw 3x3/2",        LAYER_DEPTHWISE,        7,  3,  51,  51, 3, 2, false },
+    { "pw 51>102",       LAYER_CONV,             3,  1,  51, 102, 1, 1, true  },
+    { "dw 3x3",          LAYER_DEPTHWISE,        3,  1, 102, 102, 3, 1, true  },
+    { "pw 102>102",      LAYER_CONV,             3,  1, 102, 102, 1, 1, true  },
+    { "fc 102>128",      LAYER_FULLY_CONNECTED,  1,  1, 102, 128, 1, 1, true  },
+    { "fc 128>8",        LAYER_FULLY_CONNECTED,  1,  1, 128,   8, 1, 1, true  },
+};
+
+#define LAYER_COUNT     (sizeof(layers) / sizeof(layers[0]))
+
+/* Tile sizes in pixels every block is checked with (0: the whole output) */
+static const int block_tiles[] = { 1, 2, 3, 8, 0 };
+
+#define BLOCK_TILE_COUNT (sizeof(block_tiles) / sizeof(block_tiles[0]))
+
+static const x86_int8::Isa isas[ISA_COUNT] = {
+    x86_int8::Isa::kNone, x86_int8::Isa::kAvx2,
+    x86_int8::Isa::kAvxVnni, x86_int8::Isa::kAvx512Vnni,
+};
+
+static uint32_t rng_state = 1;
+
+
+static uint32_t rng_next(void)
+{
+    /* xorshift32 */
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static int32_t rng_range(int32_t lo, int32_t hi)
+{
+    return lo + (int32_t)(rng_next() % (uint32_t)(hi - lo + 1));
+}
+
+static void fill_int8(int8_t *data, int count)
+{
+    for (int i = 0; i < count; i++) {
+        data[i] = (int8_t)rng_range(-128, 127);
+    }
+}
+
+static int output_size(const layer_shape_t *shape, int in)
+{
+    if (shape->same) {
+        return (in + shape->stride - 1) / shape->stride;
+    }
+    return (in - shape->kernel) / shape->stride + 1;
+}
+
+static void set_shape(RuntimeShape *shape, int count, int32_t d0, int32_t d1 = 0,
+                      int32_t d2 = 0, int32_t d3 = 0)
+{
+    const int32_t dims[4] = { d0, d1, d2, d3 };
+    shape->ReplaceWith(count, dims);
+}
+
+static int padding(const layer_shape_t *shape, int in, int out)
+{
+    int total = (out - 1) * shape->stride + shape->kernel - in;
+    return total > 0 ? total / 2 : 0;
+}
+
+/*******************************************************************************
+* Function Name: layer_free
+*******************************************************************************/
+static void layer_free(layer_t *layer)
+{
+    free(layer->input);
+    free(layer->filter);
+    free(layer->bias);
+    free(layer->multiplier);
+    free(layer->shift);
+    free(layer->reference);
+    free(layer->output);
+    free(layer->packed_buffer);
+    layer->input = layer->filter = layer->reference = layer->output = NULL;
+    layer->bias = layer->multiplier = layer->shift = NULL;
+    layer->packed_buffer = NULL;
+}
+
+/*******************************************************************************
+* Function Name: layer_init
+********************************************************************************
+* Summary:
+* Random tensors and quantization parameters for one layer shape (as
+* CalculateOpDataConv would produce them: multipliers in [2^30, 2^31),
+* mostly right shifts), packed for the x86 kernels.
+*
+* Return:
+*  0 on success, -1 when out of memory
+*******************************************************************************/
+static int layer_init(const layer_shape_t *shape, layer_t *layer)
+{
+    layer->out_h = output_size(shape, shape->in_h);
+    layer->out_w = output_size(shape, shape->in_w);
+
+    const int input_count = shape->in_h * shape->in_w * shape->in_c;
+    const int output_count = layer->out_h * layer->out_w * shape->out_c;
+    int filter_count;
+
+    switch (shape->kind) {
+    case LAYER_CONV:
+        set_shape(&layer->filter_shape, 4, shape->out_c, shape->kernel, shape->kernel, shape->in_c);
+        break;
+    case LAYER_DEPTHWISE:
+        set_shape(&layer->filter_shape, 4, 1, shape->kernel, shape->kernel, shape->out_c);
+        break;
+    default:
+        set_shape(&layer->filter_shape, 2, shape->out_c, shape->in_c);
+        break;
+    }
+    filter_count = layer->filter_shape.FlatSize();
+
+    if (shape->kind == LAYER_FULLY_CONNECTED) {
+        set_shape(&layer->input_shape, 2, 1, shape->in_c);
+        set_shape(&layer->output_shape, 2, 1, shape->out_c);
+    }
+    else {
+        set_shape(&layer->input_shape, 4, 1, shape->in_h, shape->in_w, shape->in_c);
+        set_shape(&layer->output_shape, 4, 1, layer->out_h, layer->out_w, shape->out_c);
+    }
+    set_shape(&layer->bias_shape, 1, shape->out_c);
+
+    layer->input = (int8_t *)malloc(input_count);
+    layer->filter = (int8_t *)malloc(filter_count);
+    layer->bias = (int32_t *)malloc(shape->out_c * sizeof(int32_t));
+    layer->multiplier = (int32_t *)malloc(shape->out_c * sizeof(int32_t));
+    layer->shift = (int32_t *)malloc(shape->out_c * sizeof(int32_t));
+    layer->reference = (int8_t *)malloc(output_count);
+    layer->output = (int8_t *)malloc(output_count);
+    if (!layer->input || !layer->filter || !layer->bias || !layer->multiplier ||
+        !layer->shift || !layer->reference || !layer->output) {
+        layer_free(layer);
+        return -1;
+    }
+
+    fill_int8(layer->input, input_count);
+    fill_int8(layer->filter, filter_count);
+    for (int c = 0; c < shape->out_c; c++) {
+        layer->bias[c] = rng_range(-20000, 20000);
+        layer->multiplier[c] = rng_range(1 << 30, INT32_MAX);
+        layer->shift[c] = rng_range(-12, 1);
+    }
+
+    const int32_t input_offset = -rng_range(-128, 127);
+    const int32_t output_offset = rng_range(-128, 127);
+    /* Half of the layers with a ReLU-like clamp */
+    const int32_t activation_min = (rng_next() & 1) ? output_offset : -128;
+    const int32_t activation_max = (rng_next() & 1) ? std::min(127, output_offset + 100) : 127;
+
+    const int pad_h = padding(shape, shape->in_h, layer->out_h);
+    const int pad_w = padding(shape, shape->in_w, layer->out_w);
+
+    size_t packed_bytes;
+    switch (shape->kind) {
+    case LAYER_CONV:
+        layer->conv.padding_type = shape->same ? PaddingType::kSame : PaddingType::kValid;
+        layer->conv.padding_values.height = pad_h;
+        layer->conv.padding_values.width = pad_w;
+        layer->conv.stride_height = shape->stride;
+        layer->conv.stride_width = shape->stride;
+        layer->conv.dilation_height_factor = 1;
+        layer->conv.dilation_width_factor = 1;
+        layer->conv.input_offset = input_offset;
+        layer->conv.output_offset = output_offset;
+        layer->conv.quantized_activation_min = activation_min;
+        layer->conv.quantized_activation_max = activation_max;
+        packed_bytes = x86_int8::ConvPackedBytes(layer->filter_shape);
+        break;
+    case LAYER_DEPTHWISE:
+        layer->depthwise.padding_type = shape->same ? PaddingType::kSame : PaddingType::kValid;
+        layer->depthwise.padding_values.height = pad_h;
+        layer->depthwise.padding_values.width = pad_w;
+        layer->depthwise.stride_height = shape->stride;
+        layer->depthwise.stride_width = shape->stride;
+        layer->depthwise.dilation_height_factor = 1;
+        layer->depthwise.dilation_width_factor = 1;
+        layer->depthwise.depth_multiplier = 1;
+        layer->depthwise.input_offset = input_offset;
+        layer->depthwise.output_offset = output_offset;
+        layer->depthwise.quantized_activation_min = activation_min;
+        layer->depthwise.quantized_activation_max = activation_max;
+        packed_bytes = x86_int8::DepthwiseConvPackedBytes(layer->filter_shape);
+        break;
+    default:
+        layer->fully_connected.input_offset = input_offset;
+        layer->fully_connected.weights_offset = 0;
+        layer->fully_connected.output_offset = output_offset;
+        layer->fully_connected.output_multiplier = layer->multiplier[0];
+        layer->fully_connected.output_shift = layer->shift[0];
+        layer->fully_connected.quantized_activation_min = activation_min;
+        layer->fully_connected.quantized_activation_max = activation_max;
+        packed_bytes = x86_int8::FullyConnectedPackedBytes(layer->filter_shape);
+        break;
+    }
+
+    layer->packed_buffer = malloc(packed_bytes);
+    if (!layer->packed_buffer) {
+        layer_free(layer);
+        return -1;
+    }
+    switch (shape->kind) {
+    case LAYER_CONV:
+        x86_int8::PackConvPerChannel(layer->filter_shape, layer->filter, layer->bias,
+            layer->multiplier, layer->shift, layer->packed_buffer, &layer->packed);
+        break;
+    case LAYER_DEPTHWISE:
+        x86_int8::PackDepthwiseConvPerChannel(layer->filter_shape, layer->filter, layer->bias,
+            layer->multiplier, layer->shift, layer->packed_buffer, &layer->packed);
+        break;
+    default:
+        x86_int8::PackFullyConnected(layer->filter_shape, layer->filter, layer->bias,
+            layer->fully_connected.output_multiplier, layer->fully_connected.output_shift,
+            layer->packed_buffer, &layer->packed);
+        break;
+    }
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: layer_run_reference
+*******************************************************************************/
+static void layer_run_reference(const layer_shape_t *shape, layer_t *layer)
+{
+    switch (shape->kind) {
+    case LAYER_CONV:
+        reference_integer_ops::ConvPerChannel(layer->conv, layer->multiplier, layer->shift,
+            layer->input_shape, layer->input, layer->filter_shape, layer->filter,
+            layer->bias_shape, layer->bias, layer->output_shape, layer->reference);
+        break;
+    case LAYER_DEPTHWISE:
+        reference_integer_ops::DepthwiseConvPerChannel(layer->depthwise, layer->multiplier, layer->shift,
+            layer->input_shape, layer->input, layer->filter_shape, layer->filter,
+            layer->bias_shape, layer->bias, layer->output_shape, layer->reference);
+        break;
+    default:
+        reference_integer_ops::FullyConnected(layer->fully_connected,
+            layer->input_shape, layer->input, layer->filter_shape, layer->filter,
+            layer->bias_shape, layer->bias, layer->output_shape, layer->reference);
+        break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: layer_run_x86
+********************************************************************************
+* Return:
+*  false when the kernel declined the layer (ActiveIsa() kNone or shape)
+*******************************************************************************/
+static bool layer_run_x86(const layer_shape_t *shape, layer_t *layer)
+{
+    switch (shape->kind) {
+    case LAYER_CONV:
+        return x86_int8::ConvPerChannel(layer->conv, layer->packed, layer->input_shape,
+            layer->input, layer->filter_shape, layer->output_shape, layer->output);
+    case LAYER_DEPTHWISE:
+        return x86_int8::DepthwiseConvPerChannel(layer->depthwise, layer->packed, layer->input_shape,
+            layer->input, layer->filter_shape, layer->output_shape, layer->output);
+    default:
+        return x86_int8::FullyConnected(layer->fully_connected, layer->packed, layer->input_shape,
+            layer->input, layer->filter_shape, layer->output_shape, layer->output);
+    }
+}
+
+static uint64_t layer_macs(const layer_shape_t *shape, const layer_t *layer)
+{
+    uint64_t taps = (uint64_t)shape->kernel * shape->kernel;
+    uint64_t pixels = (uint64_t)layer->out_h * layer->out_w;
+    switch (shape->kind) {
+    case LAYER_CONV:
+        return pixels * taps * shape->in_c * shape->out_c;
+    case LAYER_DEPTHWISE:
+        return pixels * taps * shape->out_c;
+    default:
+        return (uint64_t)shape->in_c * shape->out_c;
+    }
+}
+
+/*******************************************************************************
+* Function Name: check_layer
+********************************************************************************
+* Summary:
+* Runs one random instance of a layer on every supported instruction set and
+* compares the outputs with the reference kernel.
+*
+* Return:
+*  number of mismatching outputs, -1 when out of memory
+*******************************************************************************/
+static int check_layer(const layer_shape_t *shape, const bool *supported)
+{
+    layer_t layer = {};
+    if (layer_init(shape, &layer) != 0) {
+        return -1;
+    }
+    layer_run_reference(shape, &layer);
+
+    const int output_count = layer.output_shape.FlatSize();
+    int mismatches = 0;
+    for (int i = 1; i < ISA_COUNT; i++) {
+        if (!supported[i]) {
+            continue;
+        }
+        x86_int8::SetIsa(isas[i]);
+        memset(layer.output, 0, output_count);
+        if (!layer_run_x86(shape, &layer)) {
+            printf("ERR: %s declined by the %s kernel\n", shape->name, x86_int8::IsaName(isas[i]));
+            mismatches++;
+            continue;
+        }
+        for (int j = 0; j < output_count; j++) {
+            if (layer.output[j] != layer.reference[j]) {
+                if (mismatches < 8) {
+                    printf("ERR: %s, %s: output %d is %d, reference %d\n", shape->name,
+                        x86_int8::IsaName(isas[i]), j, layer.output[j], layer.reference[j]);
+                }
+                mismatches++;
+            }
+        }
+    }
+    layer_free(&layer);
+    return mismatches;
+}
+
+/*******************************************************************************
+* Function Name: bench_layer
+********************************************************************************
+* Summary:
+* Times one layer with the reference kernel and each supported instruction
+* set; us[i] is the time per call in microseconds (0 when not supported).
+*******************************************************************************/
+static int bench_layer(const layer_shape_t *shape, const bool *supported, uint32_t iterations,
+                       double *us, uint64_t *macs)
+{
+    layer_t layer = {};
+    if (layer_init(shape, &layer) != 0) {
+        return -1;
+    }
+    *macs = layer_macs(shape, &layer);
+
+    for (int i = 0; i < ISA_COUNT; i++) {
+        us[i] = 0.0;
+        if (!supported[i]) {
+            continue;
+        }
+        x86_int8::SetIsa(isas[i]);
+        /* warm up caches and the packed weights */
+        if (i == 0) {
+            layer_run_reference(shape, &layer);
+        }
+        else {
+            layer_run_x86(shape, &layer);
+        }
+        uint64_t start_us = ei_read_timer_us();
+        for (uint32_t it = 0; it < iterations; it++) {
+            if (i == 0) {
+                layer_run_reference(shape, &layer);
+            }
+            else {
+                layer_run_x86(shape, &layer);
+            }
+        }
+        us[i] = (double)(ei_read_timer_us() - start_us) / iterations;
+    }
+    layer_free(&layer);
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: is_block
+********************************************************************************
+* Return:
+*  true when layers[l] is a depthwise layer feeding a 1x1 convolution
+*******************************************************************************/
+static bool is_block(size_t l)
+{
+    return l + 1 < LAYER_COUNT && layers[l].kind == LAYER_DEPTHWISE &&
+        layers[l + 1].kind == LAYER_CONV && layers[l + 1].kernel == 1 &&
+        layers[l + 1].stride == 1;
+}
+
+/*******************************************************************************
+* Function Name: block_tile_pixels
+********************************************************************************
+* Summary:
+* Tile of a block in pixels: tile_pixels, or the whole output when 0 or more.
+*******************************************************************************/
+static int block_tile_pixels(const layer_t *pointwise, int tile_pixels)
+{
+    const int pixels = pointwise->out_h * pointwise->out_w;
+    return tile_pixels <= 0 || tile_pixels > pixels ? pixels : tile_pixels;
+}
+
+/*******************************************************************************
+* Function Name: block_run_layers
+********************************************************************************
+* Summary:
+* The block as two layers: the depthwise outputs go to the input of the 1x1
+* layer, its outputs to pointwise->reference (x86: pointwise->output).
+*******************************************************************************/
+static bool block_run_layers(const layer_shape_t *shape, layer_t *depthwise, layer_t *pointwise,
+                             bool x86)
+{
+    if (!x86) {
+        reference_integer_ops::DepthwiseConvPerChannel(depthwise->depthwise, depthwise->multiplier,
+            depthwise->shift, depthwise->input_shape, depthwise->input, depthwise->filter_shape,
+            depthwise->filter, depthwise->bias_shape, depthwise->bias, depthwise->output_shape,
+            pointwise->input);
+        layer_run_reference(shape + 1, pointwise);
+        return true;
+    }
+    return x86_int8::DepthwiseConvPerChannel(depthwise->depthwise, depthwise->packed,
+               depthwise->input_shape, depthwise->input, depthwise->filter_shape,
+               depthwise->output_shape, pointwise->input) &&
+        layer_run_x86(shape + 1, pointwise);
+}
+
+/*******************************************************************************
+* Function Name: block_run_fused
+********************************************************************************
+* Summary:
+* The block through the fused kernel (reference, or x86 with the active
+* instruction set) into pointwise->output, tile_pixels pixels at a time.
+*
+* Return:
+*  false when the x86 kernel declined the block
+*******************************************************************************/
+static bool block_run_fused(layer_t *depthwise, layer_t *pointwise, int8_t *tile, int tile_pixels,
+                            bool x86)
+{
+    if (!x86) {
+        reference_integer_ops::DepthwiseSeparableConvPerChannel(depthwise->depthwise,
+            depthwise->multiplier, depthwise->shift, depthwise->input_shape, depthwise->input,
+            depthwise->filter_shape, depthwise->filter, depthwise->bias, pointwise->conv,
+            pointwise->multiplier, pointwise->shift, pointwise->filter_shape, pointwise->filter,
+            pointwise->bias, pointwise->output_shape, pointwise->output, tile, tile_pixels);
+        return true;
+    }
+    return x86_int8::DepthwiseSeparableConvPerChannel(depthwise->depthwise, depthwise->packed,
+        pointwise->conv, pointwise->packed, depthwise->input_shape, depthwise->input,
+        depthwise->filter_shape, pointwise->output_shape, pointwise->output, tile, tile_pixels);
+}
+
+/*******************************************************************************
+* Function Name: compare_block
+*******************************************************************************/
+static int compare_block(const layer_shape_t *shape, const layer_t *pointwise, const char *kernel,
+                         int tile_pixels, int mismatches)
+{
+    const int output_count = pointwise->output_shape.FlatSize();
+    int found = 0;
+    for (int j = 0; j < output_count; j++) {
+        if (pointwise->output[j] != pointwise->reference[j]) {
+            if (mismatches + found < 8) {
+                printf("ERR: %s + %s, %s, %d pixel tiles: output %d is %d, two layers %d\n",
+                    shape[0].name, shape[1].name, kernel, tile_pixels, j, pointwise->output[j],
+                    pointwise->reference[j]);
+            }
+            found++;
+        }
+    }
+    return found;
+}
+
+/*******************************************************************************
+* Function Name: check_block
+********************************************************************************
+* Summary:
+* Runs one random instance of the block starting at shape with the two
+* reference kernels, then with the fused reference kernel and the fused x86
+* kernel of every supported instruction set at every block_tiles size, and
+* compares the outputs.
+*
+* Return:
+*  number of mismatching outputs, -1 when out of memory
+*******************************************************************************/
+static int check_block(const layer_shape_t *shape, const bool *supported)
+{
+    layer_t depthwise = {};
+    layer_t pointwise = {};
+    if (layer_init(&shape[0], &depthwise) != 0) {
+        return -1;
+    }
+    if (layer_init(&shape[1], &pointwise) != 0) {
+        layer_free(&depthwise);
+        return -1;
+    }
+    const int output_count = pointwise.output_shape.FlatSize();
+    int8_t *tile = (int8_t *)malloc((size_t)depthwise.out_h * depthwise.out_w * shape->out_c);
+    if (!tile) {
+        layer_free(&depthwise);
+        layer_free(&pointwise);
+        return -1;
+    }
+    block_run_layers(shape, &depthwise, &pointwise, false);
+
+    int mismatches = 0;
+    for (size_t t = 0; t < BLOCK_TILE_COUNT; t++) {
+        const int tile_pixels = block_tile_pixels(&pointwise, block_tiles[t]);
+        for (int i = 0; i < ISA_COUNT; i++) {
+            if (!supported[i]) {
+                continue;
+            }
+            x86_int8::SetIsa(isas[i]);
+            memset(pointwise.output, 0, output_count);
+            if (!block_run_fused(&depthwise, &pointwise, tile, tile_pixels, i > 0)) {
+                printf("ERR: %s + %s declined by the %s kernel\n", shape[0].name, shape[1].name,
+                    x86_int8::IsaName(isas[i]));
+                mismatches++;
+                continue;
+            }
+            mismatches += compare_block(shape, &pointwise,
+                i > 0 ? x86_int8::IsaName(isas[i]) : "reference", tile_pixels, mismatches);
+        }
+    }
+    free(tile);
+    layer_free(&depthwise);
+    layer_free(&pointwise);
+    return mismatches;
+}
+
+/*******************************************************************************
+* Function Name: bench_block
+********************************************************************************
+* Summary:
+* Times the block starting at shape as two layers and fused (with a
+* BLOCK_TILE_BYTES tile), with the reference kernels and each supported
+* instruction set; layers_us[i] and fused_us[i] are the times per call in
+* microseconds (0 when not supported).
+*******************************************************************************/
+static int bench_block(const layer_shape_t *shape, const bool *supported, uint32_t iterations,
+                       double *layers_us, double *fused_us, int *tile_pixels)
+{
+    layer_t depthwise = {};
+    layer_t pointwise = {};
+    if (layer_init(&shape[0], &depthwise) != 0) {
+        return -1;
+    }
+    if (layer_init(&shape[1], &pointwise) != 0) {
+        layer_free(&depthwise);
+        return -1;
+    }
+    /* as arena_planner --fuse: whole pixels, an even number unless all */
+    const int pixels = pointwise.out_h * pointwise.out_w;
+    *tile_pixels = std::min(pixels, std::max(1, BLOCK_TILE_BYTES / shape->out_c));
+    if (*tile_pixels > 1 && *tile_pixels < pixels) {
+        *tile_pixels &= ~1;
+    }
+    int8_t *tile = (int8_t *)malloc((size_t)*tile_pixels * shape->out_c);
+    if (!tile) {
+        layer_free(&depthwise);
+        layer_free(&pointwise);
+        return -1;
+    }
+
+    for (int i = 0; i < ISA_COUNT; i++) {
+        layers_us[i] = fused_us[i] = 0.0;
+        if (!supported[i]) {
+            continue;
+        }
+        x86_int8::SetIsa(isas[i]);
+        for (int fused = 0; fused < 2; fused++) {
+            /* warm up caches and the packed weights */
+            if (fused) {
+                block_run_fused(&depthwise, &pointwise, tile, *tile_pixels, i > 0);
+            }
+            else {
+                block_run_layers(shape, &depthwise, &pointwise, i > 0);
+            }
+            uint64_t start_us = ei_read_timer_us();
+            for (uint32_t it = 0; it < iterations; it++) {
+                if (fused) {
+                    block_run_fused(&depthwise, &pointwise, tile, *tile_pixels, i > 0);
+                }
+                else {
+                    block_run_layers(shape, &depthwise, &pointwise, i > 0);
+                }
+            }
+            double us = (double)(ei_read_timer_us() - start_us) / iterations;
+            if (fused) {
+                fused_us[i] = us;
+            }
+            else {
+                layers_us[i] = us;
+            }
+        }
+    }
+    free(tile);
+    layer_free(&depthwise);
+    layer_free(&pointwise);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    uint32_t seeds = DEFAULT_SEEDS;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--iterations") && i + 1 < argc) {
+            iterations = (uint32_t)atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--seeds") && i + 1 < argc) {
+            seeds = (uint32_t)atoi(argv[++i]);
+        }
+        else {
+            printf("usage: %s [--iterations N] [--seeds N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    bool supported[ISA_COUNT];
+    supported[0] = true;
+    for (int i = 1; i < ISA_COUNT; i++) {
+        supported[i] = x86_int8::IsaSupported(isas[i]);
+    }
+    printf("detected: %s; checked and timed:", x86_int8::IsaName(x86_int8::DetectedIsa()));
+    for (int i = 0; i < ISA_COUNT; i++) {
+        if (supported[i]) {
+            printf(" %s", x86_int8::IsaName(isas[i]));
+        }
+    }
+    printf("\n");
+
+    /* Bit-exactness on random instances of every layer */
+    int mismatches = 0;
+    for (uint32_t seed = 0; seed < seeds; seed++) {
+        rng_state = 0x9e3779b9u ^ (seed * 0x85ebca6bu);
+        if (rng_state == 0) {
+            rng_state = 1;
+        }
+        for (size_t l = 0; l < LAYER_COUNT; l++) {
+            int r = check_layer(&layers[l], supported);
+            if (r < 0) {
+                printf("ERR: out of memory\n");
+                return 1;
+            }
+            mismatches += r;
+        }
+    }
+    printf("bit-exact against reference_integer_ops: %s (%u layers x %u random instances)\n",
+        mismatches == 0 ? "yes" : "NO", (unsigned)LAYER_COUNT, (unsigned)seeds);
+
+    /* The fused blocks against their two layers, on the same instances */
+    int block_mismatches = 0;
+    size_t block_count = 0;
+    for (uint32_t seed = 0; seed < seeds; seed++) {
+        rng_state = 0x9e3779b9u ^ (seed * 0x85ebca6bu);
+        if (rng_state == 0) {
+            rng_state = 1;
+        }
+        block_count = 0;
+        for (size_t l = 0; l < LAYER_COUNT; l++) {
+            if (!is_block(l)) {
+                continue;
+            }
+            int r = check_block(&layers[l], supported);
+            if (r < 0) {
+                printf("ERR: out of memory\n");
+                return 1;
+            }
+            block_mismatches += r;
+            block_count++;
+        }
+    }
+    printf("fused blocks bit-exact against their two layers: %s (%u blocks x %u random instances"
+        " x %u tile sizes)\n", block_mismatches == 0 ? "yes" : "NO", (unsigned)block_count,
+        (unsigned)seeds, (unsigned)BLOCK_TILE_COUNT);
+    mismatches += block_mismatches;
+
+    /* Time per layer */
+    printf("%u iterations, us per call (speedup against reference)\n", (unsigned)iterations);
+    printf("  %-12s %-16s %9s %10s", "layer", "input", "MACs", "reference");
+    for (int i = 1; i < ISA_COUNT; i++) {
+        if (supported[i]) {
+            printf(" %18s", x86_int8::IsaName(isas[i]));
+        }
+    }
+    printf("\n");
+
+    double total_us[ISA_COUNT] = { 0 };
+    uint64_t total_macs = 0;
+    rng_state = 12345;
+    for (size_t l = 0; l < LAYER_COUNT; l++) {
+        const layer_shape_t *shape = &layers[l];
+        double us[ISA_COUNT];
+        uint64_t macs;
+        if (bench_layer(shape, supported, iterations, us, &macs) != 0) {
+            printf("ERR: out of memory\n");
+            return 1;
+        }
+        char input[24];
+        snprintf(input, sizeof(input), "%dx%dx%d", shape->in_h, shape->in_w, shape->in_c);
+        printf("  %-12s %-16s %9llu %10.2f", shape->name, input, (unsigned long long)macs, us[0]);
+        for (int i = 1; i < ISA_COUNT; i++) {
+            if (supported[i]) {
+                printf(" %10.2f (%4.1fx)", us[i], us[i] > 0.0 ? us[0] / us[i] : 0.0);
+            }
+            total_us[i] += us[i];
+        }
+        total_us[0] += us[0];
+        total_macs += macs;
+        printf("\n");
+    }
+    printf("  %-12s %-16s %9llu %10.2f", "total", "", (unsigned long long)total_macs, total_us[0]);
+    for (int i = 1; i < ISA_COUNT; i++) {
+        if (supported[i]) {
+            printf(" %10.2f (%4.1fx)", total_us[i], total_us[i] > 0.0 ? total_us[0] / total_us[i] : 0.0);
+        }
+    }
+    printf("\n");
+
+    /* Time per block, two layers and fused */
+    printf("depthwise-separable blocks, us per call: two layers / fused (%d byte tiles)\n",
+        BLOCK_TILE_BYTES);
+    printf("  %-22s %-6s %19s", "block", "tile", "reference");
+    for (int i = 1; i < ISA_COUNT; i++) {
+        if (supported[i]) {
+            printf(" %19s", x86_int8::IsaName(isas[i]));
+        }
+    }
+    printf("\n");
+
+    double total_layers_us[ISA_COUNT] = { 0 };
+    double total_fused_us[ISA_COUNT] = { 0 };
+    rng_state = 12345;
+    for (size_t l = 0; l < LAYER_COUNT; l++) {
+        if (!is_block(l)) {
+            continue;
+        }
+        double layers_us[ISA_COUNT];
+        double fused_us[ISA_COUNT];
+        int tile_pixels;
+        if (bench_block(&layers[l], supported, iterations, layers_us, fused_us, &tile_pixels) != 0) {
+            printf("ERR: out of memory\n");
+            return 1;
+        }
+        char name[32];
+        snprintf(name, sizeof(name), "%s + %s", layers[l].name, layers[l + 1].name);
+        printf("  %-22s %-6d", name, tile_pixels);
+        for (int i = 0; i < ISA_COUNT; i++) {
+            if (supported[i]) {
+                printf(" %9.2f /%8.2f", layers_us[i], fused_us[i]);
+            }
+            total_layers_us[i] += layers_us[i];
+            total_fused_us[i] += fused_us[i];
+        }
+        printf("\n");
+    }
+    printf("  %-22s %-6s", "total", "");
+    for (int i = 0; i < ISA_COUNT; i++) {
+        if (supported[i]) {
+            printf(" %9.2f /%8.2f", total_layers_us[i], total_fused_us[i]);
+        }
+    }
+    printf("\n");
+
+    x86_int8::SetIsa(x86_int8::DetectedIsa());
+    return mismatches == 0 ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,73 @@
+/******************************************************************************
+* File Name:   wav.cpp
+*
+* Description: WAV reader of the host tools, see wav.h.
+*******************************************************************************/
+
+#include "wav.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+* Function Name: wav_read
+********************************************************************************
+* Summary:
+* Loads a 16-bit PCM WAV, keeping the first channel only.
+*******************************************************************************/
+bool wav_read(const char *path, std::vector<int16_t> &samples, uint32_t *sample_rate)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        printf("ERR: cannot open %s\n", path);
+        return false;
+    }
+
+    char riff[12];
+    if (fread(riff, 1, 12, f) != 12 || memcmp(riff, "RIFF", 4) != 0 || memcmp(riff + 8, "WAVE", 4) != 0) {
+        printf("ERR: %s is not a WAV file\n", path);
+        fclose(f);
+        return false;
+    }
+
+    uint16_t channels = 0, bits = 0, format = 0;
+    bool ok = false;
+    char id[4];
+    uint32_t size;
+
+    while (fread(id, 1, 4, f) == 4 && fread(&size, 4, 1, f) == 1) {
+        if (memcmp(id, "fmt ", 4) == 0) {
+            uint8_t fmt[16];
+            if (size < 16 || fread(fmt, 1, 16, f) != 16) {
+                break;
+            }
+            memcpy(&format, fmt, 2);
+            memcpy(&channels, fmt + 2, 2);
+            memcpy(sample_rate, fmt + 4, 4);
+            memcpy(&bits, fmt + 14, 2);
+            fseek(f, (long)(size - 16 + (size & 1)), SEEK_CUR);
+        }
+        else if (memcmp(id, "data", 4) == 0) {
+            if (format != 1 || bits != 16 || channels == 0) {
+                printf("ERR: %s must be 16-bit PCM\n", path);
+                break;
+            }
+            std::vector<int16_t> interleaved(size / 2);
+            size_t read = fread(interleaved.data(), 2, interleaved.size(), f);
+            samples.clear();
+            for (size_t i = 0; i + channels <= read; i += channels) {
+                samples.push_back(interleaved[i]);
+            }
+            ok = true;
+            break;
+        }
+        else {
+            fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+
+    fclose(f);
+    return ok;
+}
+
+/* [] END OF FILE */
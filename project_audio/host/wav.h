@@ -0,0 +1,23 @@
+/******************************************************************************
+* File Name:   wav.h
+*
+* Description: Minimal WAV reader for the host tools (capture_replay,
+*              kws_bench): 16-bit PCM, first channel only.
+*******************************************************************************/
+
+#ifndef WAV_H_
+#define WAV_H_
+
+#include <stdint.h>
+#include <vector>
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Loads the samples of the first channel and the sample rate; prints the
+ * reason and returns false if the file is not 16-bit PCM */
+bool wav_read(const char *path, std::vector<int16_t> &samples, uint32_t *sample_rate);
+
+#endif /* WAV_H_ */
+
+/* [] END OF FILE */
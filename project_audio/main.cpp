@@ -12,6 +12,8 @@ extern "C"{
 
 #include "voice-recognition-cpp-mcu-v3/edge-impulse-sdk/dsp/numpy.hpp"
 #include "voice-recognition-cpp-mcu-v3/edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "audio_capture.h"
+#include "vad.h"
 
 /*******************************************************************************
 * Macros
@@ -20,6 +22,18 @@ extern "C"{
 #define TOTAL_SAMPLES               EI_CLASSIFIER_RAW_SAMPLE_COUNT 
 #define NUM_DMA_TRANSFERS           16u 
 
+/* 1 - capture never stops, every slice goes to run_classifier_continuous
+ * 0 - record one full window per timer period and call run_classifier */
+#ifndef CONTINUOUS_INFERENCE
+#define CONTINUOUS_INFERENCE        1
+#endif
+/* One slice = 1/EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW of the model window */
+#define SLICE_SAMPLES               EI_CLASSIFIER_SLICE_SIZE
+/* 1 - silent slices are dropped by the voice-activity gate before the DSP */
+#ifndef VAD_ENABLED
+#define VAD_ENABLED                 1
+#endif
+
 
 /* Desired sample rate */
 #define SAMPLE_RATE_HZ              16000u
@@ -61,21 +75,28 @@ extern "C" {
 	 void set_yellow(bool command);
 	 void blinking_mode(void);
 }
-/*******************************************************************************
-* Function Prototypes from Edge Impulse
-********************************************************************************/
-int raw_feature_get_data(size_t offset, size_t length, float *out_ptr);
+
+void handle_classification(const ei_impulse_result_t *ei_result);
+void classify_slice(const int16_t *samples);
 
 /*******************************************************************************
 * Global Variables
 ********************************************************************************/
 /* Interrupt flags */
-bool pdm_pcm_flag = false;
-bool timer_interrupt_flag = false;
-bool blink_interrupt_flag = false;
-
+volatile bool pdm_pcm_flag = false;
+volatile bool timer_interrupt_flag = false;
+volatile bool blink_interrupt_flag = false;
+
+#if CONTINUOUS_INFERENCE
+static_assert(AUDIO_CAPTURE_SLICE_SAMPLES == SLICE_SAMPLES, "capture slice must match the model slice");
+static_assert(AUDIO_CAPTURE_DMA_SAMPLES == FRAME_SIZE, "capture DMA transfer must match FRAME_SIZE");
+/* Slice owned by the classifier, see audio_capture_acquire */
+const int16_t *current_slice = NULL;
+uint32_t reported_overruns = 0;
+#else
 /* Audio buffer */
 int16_t audio_frame[TOTAL_SAMPLES] = {0};
+#endif
 uint32_t current_audio_offset = 0; 
 uint32_t dma_transfer_count = 0;
 
@@ -132,12 +153,6 @@ const cyhal_timer_cfg_t blinking_timer_cfg =
 };
 
 
-int raw_feature_get_data(size_t offset, size_t length, float *out_ptr) {
-    // converting input data from audio buffer
-	return ei::numpy::int16_to_float(audio_frame + offset, out_ptr, length);
-};
-
-
 /*******************************************************************************
 * Function Name: main
 ********************************************************************************/
@@ -158,8 +173,10 @@ int main(void)
     /* Initialize the clocks */
     clock_init();
     
+#if !CONTINUOUS_INFERENCE
     /* Initialize the timer */
     timer_init();
+#endif
 
 	/* Initialize the blinking timer */
     blinking_timer_init();
@@ -172,12 +189,59 @@ int main(void)
 
     /* Initialize the PDM/PCM block */
     cyhal_pdm_pcm_init(&pdm_pcm, PDM_DATA, PDM_CLK, &audio_clock, &pdm_pcm_cfg);
+#if CONTINUOUS_INFERENCE
+    audio_capture_init(&pdm_pcm);
+#else
     cyhal_pdm_pcm_register_callback(&pdm_pcm, pdm_pcm_isr_handler, NULL);
     cyhal_pdm_pcm_enable_event(&pdm_pcm, CYHAL_PDM_PCM_ASYNC_COMPLETE, CYHAL_ISR_PRIORITY_DEFAULT, true);
+#endif
     cyhal_pdm_pcm_start(&pdm_pcm);
 
+#if CONTINUOUS_INFERENCE
+    /* Reset the sliding feature window and start the endless capture */
+    run_classifier_init();
+#if VAD_ENABLED
+    vad_config_t vad_cfg;
+    vad_get_default_config(&vad_cfg, SAMPLE_RATE_HZ);
+    vad_init(&vad_cfg);
+#endif
+    cyhal_gpio_write(CYBSP_USER_LED, CYBSP_LED_STATE_ON);
+    printf("Continuous inference: %u ms per decision\r\n",
+           (unsigned)(SLICE_SAMPLES * 1000u / SAMPLE_RATE_HZ));
+    audio_capture_start();
+#endif
+
     for(;;)
     {	
+#if CONTINUOUS_INFERENCE
+        while ((current_slice = audio_capture_acquire()) != NULL)
+        {
+            // one slice recorded, DMA is already filling the next buffer
+#if VAD_ENABLED
+            vad_decision_t gate = vad_process(current_slice, SLICE_SAMPLES);
+            if (gate == VAD_RUN_PREROLL) {
+                classify_slice(vad_preroll());
+            }
+            if (gate != VAD_SKIP) {
+                classify_slice(current_slice);
+            }
+#else
+            classify_slice(current_slice);
+#endif
+
+            audio_capture_release(current_slice);
+            current_slice = NULL;
+
+            audio_capture_stats_t capture_stats;
+            audio_capture_get_stats(&capture_stats);
+            if (capture_stats.overruns != reported_overruns) {
+                reported_overruns = capture_stats.overruns;
+                printf("WARN: classifier slower than real time (%lu overruns, %lu samples dropped)\r\n",
+                       (unsigned long)capture_stats.overruns,
+                       (unsigned long)capture_stats.dropped_samples);
+            }
+        }
+#else
 		if (timer_interrupt_flag){
 			timer_interrupt_flag = false;
 	        current_audio_offset = 0;
@@ -197,8 +261,8 @@ int main(void)
 
             signal_t signal;
             ei_impulse_result_t ei_result; 
-	        signal.total_length = TOTAL_SAMPLES;
-	        signal.get_data = &raw_feature_get_data;
+            // the MFE reads the int16 samples directly (no float copy of the window)
+	        ei::numpy::signal_from_int16_buffer(audio_frame, TOTAL_SAMPLES, &signal);
 	
             printf("Starting classifier\r\n"); 
 	      
@@ -220,43 +284,11 @@ int main(void)
 	                ei_result.classification[i].value);
 	        }
 	        
-	        if (ei_result.classification[3].value >= CORRECT_CLASSIFICATION){
-				// light
-				set_red(false);
-			    set_green(false);
-			    set_blue(false);
-			    set_yellow(true);
-
-			} else if (ei_result.classification[5].value >= CORRECT_CLASSIFICATION){
-				// off
-				set_red(false);
-			    set_green(false);
-			    set_blue(false);
-			    set_yellow(false);
-			} else if (ei_result.classification[6].value >= CORRECT_CLASSIFICATION){
-				// red
-				set_red(true);
-			    set_green(false);
-			    set_blue(false);
-			    set_yellow(false);
-				
-			} else if (ei_result.classification[1].value >= CORRECT_CLASSIFICATION){
-				// blue
-				set_red(false);
-			    set_green(false);
-			    set_blue(true);
-			    set_yellow(false);
-
-			} else if (ei_result.classification[2].value >= CORRECT_CLASSIFICATION){
-				// green
-				set_red(false);
-			    set_green(true);
-			    set_blue(false);
-			    set_yellow(false);			
-			}
+	        handle_classification(&ei_result);
 			
 			printf("Waiting for next timer...\r\n");
         }
+#endif
 		
 		if(blink_interrupt_flag){
 			blink_interrupt_flag = false;
@@ -269,6 +301,75 @@ int main(void)
 }
 
 
+#if CONTINUOUS_INFERENCE
+/*******************************************************************************
+* Function Name: classify_slice
+********************************************************************************
+* Summary:
+* Pushes one slice through run_classifier_continuous and acts on the result
+*******************************************************************************/
+void classify_slice(const int16_t *samples)
+{
+    signal_t signal;
+    ei_impulse_result_t ei_result;
+    // samples is either current_slice or the VAD pre-roll, the MFE reads it directly
+    ei::numpy::signal_from_int16_buffer(samples, SLICE_SAMPLES, &signal);
+
+    EI_IMPULSE_ERROR ei_error = run_classifier_continuous(&signal, &ei_result, false, true);
+    if (ei_error != EI_IMPULSE_OK) {
+        printf("ERROR: run_classifier_continuous failed with code %d\r\n", ei_error);
+    } else {
+        handle_classification(&ei_result);
+    }
+}
+#endif
+
+
+/*******************************************************************************
+* Function Name: handle_classification
+********************************************************************************
+* Summary:
+* Switches the LEDs according to the label that passed the threshold
+*******************************************************************************/
+void handle_classification(const ei_impulse_result_t *ei_result)
+{
+	if (ei_result->classification[3].value >= CORRECT_CLASSIFICATION){
+		// light
+		set_red(false);
+	    set_green(false);
+	    set_blue(false);
+	    set_yellow(true);
+
+	} else if (ei_result->classification[5].value >= CORRECT_CLASSIFICATION){
+		// off
+		set_red(false);
+	    set_green(false);
+	    set_blue(false);
+	    set_yellow(false);
+	} else if (ei_result->classification[6].value >= CORRECT_CLASSIFICATION){
+		// red
+		set_red(true);
+	    set_green(false);
+	    set_blue(false);
+	    set_yellow(false);
+		
+	} else if (ei_result->classification[1].value >= CORRECT_CLASSIFICATION){
+		// blue
+		set_red(false);
+	    set_green(false);
+	    set_blue(true);
+	    set_yellow(false);
+
+	} else if (ei_result->classification[2].value >= CORRECT_CLASSIFICATION){
+		// green
+		set_red(false);
+	    set_green(true);
+	    set_blue(false);
+	    set_yellow(false);			
+	}
+}
+
+
 /* Function Name: timer_isr_handler
 ********************************************************************************
 * Summary:
@@ -295,6 +396,7 @@ void blinking_timer_isr_handler(void *callback_arg, cyhal_timer_event_t event){
 	blink_interrupt_flag = true;
 }
 
+#if !CONTINUOUS_INFERENCE
 /*******************************************************************************
 * Function Name: pdm_pcm_isr_handler
 ********************************************************************************
@@ -318,6 +420,7 @@ void pdm_pcm_isr_handler(void *arg, cyhal_pdm_pcm_event_t event)
         cyhal_pdm_pcm_read_async(&pdm_pcm, audio_frame + current_audio_offset, FRAME_SIZE);
     }
 }
+#endif
 
 
 /*******************************************************************************
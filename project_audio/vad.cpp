@@ -0,0 +1,200 @@
+/******************************************************************************
+* File Name:   vad.cpp
+*
+* Description: Energy / zero-crossing voice-activity gate, see vad.h.
+*              Integer only, one pass over each slice plus the pre-roll copy.
+*******************************************************************************/
+
+#include "vad.h"
+
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Noise floor tracking: silent frames pull the floor towards their energy
+ * (~160 ms time constant), active frames raise it by 1/256 per frame (x2 in
+ * ~1.8 s), so a fan switching on eventually stops keeping the gate open while
+ * speech itself cannot drag the floor up */
+#define FLOOR_SHIFT_SILENCE         4
+#define FLOOR_SHIFT_SPEECH          8
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static vad_config_t vad_config;
+static vad_stats_t vad_stats;
+
+static bool floor_valid = false;
+static uint32_t hangover_samples = 0;
+static uint32_t hangover_left = 0;
+
+static int16_t preroll_buffer[VAD_MAX_SLICE_SAMPLES];
+static bool preroll_valid = false;
+
+
+/*******************************************************************************
+* Function Name: vad_get_default_config
+********************************************************************************
+* Summary:
+* 10 ms frames, 1 s hangover (one model window), 6 dB over the noise floor
+* for voiced frames, 3 dB plus a high zero-crossing rate for fricatives.
+*******************************************************************************/
+void vad_get_default_config(vad_config_t *config, uint32_t sample_rate_hz)
+{
+    config->sample_rate_hz = sample_rate_hz;
+    config->frame_samples = sample_rate_hz / 100u;
+    config->hangover_ms = 1000u;
+    config->energy_ratio_q4 = 64u;
+    config->unvoiced_ratio_q4 = 32u;
+    config->unvoiced_min_zcr = config->frame_samples / 4u;
+    config->min_energy = 64u;
+    config->min_active_frames = 3u;
+}
+
+/*******************************************************************************
+* Function Name: vad_init
+********************************************************************************
+* Summary:
+* Applies the configuration and forgets the noise floor.
+*******************************************************************************/
+void vad_init(const vad_config_t *config)
+{
+    vad_config = *config;
+    if (vad_config.frame_samples == 0) {
+        vad_config.frame_samples = 1;
+    }
+
+    memset(&vad_stats, 0, sizeof(vad_stats));
+    floor_valid = false;
+    hangover_samples = (uint32_t)((uint64_t)vad_config.hangover_ms * vad_config.sample_rate_hz / 1000u);
+    hangover_left = 0;
+    preroll_valid = false;
+}
+
+/*******************************************************************************
+* Function Name: frame_is_active
+********************************************************************************
+* Summary:
+* Classifies one frame and updates the noise floor.
+*******************************************************************************/
+static bool frame_is_active(const int16_t *frame, uint32_t length)
+{
+    int64_t sum = 0;
+    uint64_t sum_sq = 0;
+
+    for (uint32_t i = 0; i < length; i++) {
+        int32_t x = frame[i];
+        sum += x;
+        sum_sq += (uint64_t)(x * x);
+    }
+
+    /* Mean square around the frame mean, so a DC offset from the mic is ignored */
+    int32_t mean = (int32_t)(sum / (int64_t)length);
+    uint64_t dc = (uint64_t)((int64_t)mean * mean);
+    uint64_t ms = sum_sq / length;
+    uint32_t energy = (ms > dc) ? (uint32_t)(ms - dc) : 0;
+
+    uint32_t zcr = 0;
+    bool above = frame[0] >= mean;
+    for (uint32_t i = 1; i < length; i++) {
+        bool now_above = frame[i] >= mean;
+        zcr += (now_above != above);
+        above = now_above;
+    }
+
+    if (!floor_valid) {
+        vad_stats.noise_floor = (energy > 0) ? energy : 1;
+        floor_valid = true;
+    }
+
+    uint64_t floor = vad_stats.noise_floor;
+    uint64_t e16 = (uint64_t)energy * 16u;
+    bool active = (energy >= vad_config.min_energy) &&
+                  ((e16 > floor * vad_config.energy_ratio_q4) ||
+                   ((e16 > floor * vad_config.unvoiced_ratio_q4) && (zcr >= vad_config.unvoiced_min_zcr)));
+
+    if (active) {
+        floor += (floor >> FLOOR_SHIFT_SPEECH) + 1u;
+    }
+    else if (energy < floor) {
+        floor -= (floor - energy) >> FLOOR_SHIFT_SILENCE;
+    }
+    else {
+        floor += (energy - floor) >> FLOOR_SHIFT_SILENCE;
+    }
+    vad_stats.noise_floor = (floor > 0) ? (uint32_t)floor : 1;
+
+    return active;
+}
+
+/*******************************************************************************
+* Function Name: vad_process
+********************************************************************************
+* Summary:
+* Gate decision for one slice.
+*******************************************************************************/
+vad_decision_t vad_process(const int16_t *slice, size_t length)
+{
+    uint32_t active_frames = 0;
+
+    for (size_t offset = 0; offset + vad_config.frame_samples <= length; offset += vad_config.frame_samples) {
+        active_frames += frame_is_active(slice + offset, vad_config.frame_samples);
+    }
+
+    vad_stats.slices++;
+
+    bool was_open = hangover_left > 0;
+
+    if (active_frames >= vad_config.min_active_frames) {
+        /* This slice counts too: the hangover starts after it */
+        hangover_left = hangover_samples + (uint32_t)length;
+    }
+    else if (hangover_left > length) {
+        hangover_left -= (uint32_t)length;
+    }
+    else {
+        hangover_left = 0;
+        vad_stats.slices_skipped++;
+
+        /* Keep the last silent slice, it becomes the pre-roll when the gate opens */
+        if (length <= VAD_MAX_SLICE_SAMPLES) {
+            memcpy(preroll_buffer, slice, length * sizeof(int16_t));
+            preroll_valid = true;
+        }
+        return VAD_SKIP;
+    }
+
+    if (!was_open) {
+        vad_stats.gate_openings++;
+        if (preroll_valid) {
+            preroll_valid = false;
+            return VAD_RUN_PREROLL;
+        }
+    }
+    return VAD_RUN;
+}
+
+/*******************************************************************************
+* Function Name: vad_preroll
+********************************************************************************
+* Summary:
+* Copy of the slice recorded just before the gate opened.
+*******************************************************************************/
+const int16_t *vad_preroll(void)
+{
+    return preroll_buffer;
+}
+
+/*******************************************************************************
+* Function Name: vad_get_stats
+********************************************************************************
+* Summary:
+* Copies the gate counters.
+*******************************************************************************/
+void vad_get_stats(vad_stats_t *stats)
+{
+    *stats = vad_stats;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,74 @@
+/******************************************************************************
+* File Name:   vad.h
+*
+* Description: Cheap streaming voice-activity gate in front of
+*              run_classifier_continuous. Works on the raw int16 slices with
+*              per-frame energy and zero-crossing rate against an adaptive
+*              noise floor, so silent slices never reach the DSP or the NN.
+*
+*              After the last active slice the gate stays open until at least
+*              hangover_ms of audio past it has been classified. With
+*              hangover_ms >= the model window the sliding feature window
+*              holds only that background noise when the gate closes, so
+*              nothing has to be reset when it opens again; only the slice
+*              before the opening (pre-roll) is replayed to keep the onset.
+*******************************************************************************/
+
+#ifndef VAD_H_
+#define VAD_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Largest slice the pre-roll copy can hold */
+#ifndef VAD_MAX_SLICE_SAMPLES
+#define VAD_MAX_SLICE_SAMPLES       4000u
+#endif
+
+/*******************************************************************************
+* Types
+********************************************************************************/
+typedef struct {
+    uint32_t sample_rate_hz;
+    uint32_t frame_samples;         /* analysis frame, 160 = 10 ms at 16 kHz */
+    uint32_t hangover_ms;           /* keep classifying this long after speech */
+    uint32_t energy_ratio_q4;       /* voiced frame: energy > floor * ratio / 16 */
+    uint32_t unvoiced_ratio_q4;     /* unvoiced frame: energy > floor * ratio / 16 ... */
+    uint32_t unvoiced_min_zcr;      /* ... and at least this many zero crossings per frame */
+    uint32_t min_energy;            /* frames below this mean-square are never speech */
+    uint32_t min_active_frames;     /* active frames needed to call a slice speech */
+} vad_config_t;
+
+typedef enum {
+    VAD_SKIP = 0,       /* silence, do not classify */
+    VAD_RUN,            /* classify this slice */
+    VAD_RUN_PREROLL     /* gate just opened: classify vad_preroll() first, then this slice */
+} vad_decision_t;
+
+typedef struct {
+    uint32_t slices;
+    uint32_t slices_skipped;
+    uint32_t gate_openings;
+    uint32_t noise_floor;           /* current mean-square noise estimate */
+} vad_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+void vad_get_default_config(vad_config_t *config, uint32_t sample_rate_hz);
+void vad_init(const vad_config_t *config);
+
+/* Analyses one slice and decides whether it has to go to the classifier */
+vad_decision_t vad_process(const int16_t *slice, size_t length);
+/* Slice before the one that opened the gate, valid after VAD_RUN_PREROLL */
+const int16_t *vad_preroll(void);
+
+void vad_get_stats(vad_stats_t *stats);
+
+#endif /* VAD_H_ */
+
+/* [] END OF FILE */
@@ -95,6 +95,18 @@
     #define ESP_NN                                  1
 #endif
 
+// int8 kernels for x86-64 hosts (tensorflow/lite/kernels/internal/optimized/x86_int8.h):
+// AVX2 or VNNI picked from CPUID at runtime, the reference kernels on older CPUs.
+// Needs GCC 11 / clang 12 for the AVX-VNNI intrinsics.
+#ifndef EI_CLASSIFIER_TFLITE_ENABLE_X86_SIMD
+#if defined(__x86_64__) && ((defined(__clang__) && __clang_major__ >= 12) || \
+    (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 11))
+    #define EI_CLASSIFIER_TFLITE_ENABLE_X86_SIMD    1
+#else
+    #define EI_CLASSIFIER_TFLITE_ENABLE_X86_SIMD    0
+#endif
+#endif // EI_CLASSIFIER_TFLITE_ENABLE_X86_SIMD
+
 // no include checks in the compiler? then just include metadata and then ops_define (optional if on EON model)
 #ifndef __has_include
     #include "model-parameters/model_metadata.h"
@@ -39,6 +39,7 @@
 // needed for standalone C example
 #include "model-parameters/model_metadata.h"
 #include "edge-impulse-sdk/dsp/numpy_types.h"
+#include "edge-impulse-sdk/classifier/ei_node_profiler.h"
 
 #ifndef EI_CLASSIFIER_MAX_OBJECT_DETECTION_COUNT
 #define EI_CLASSIFIER_MAX_OBJECT_DETECTION_COUNT 10
@@ -227,6 +228,20 @@ typedef struct {
      * the impulse contains an anomaly detection block, otherwise 0.
      */
     int64_t anomaly_us;
+
+#if EI_CLASSIFIER_PROFILE_NODES
+    /**
+     * Per-node profile of the graph (EON, EI_CLASSIFIER_PROFILE_NODES=1): time of the
+     * last invoke and the average, op, MACs and arena bytes of every node, see
+     * ei_node_profiler.h. Points into a static ring that the next inference updates.
+     */
+    const ei_node_profile_t *nodes;
+
+    /**
+     * Number of entries in `nodes`
+     */
+    uint32_t nodes_count;
+#endif // EI_CLASSIFIER_PROFILE_NODES
 } ei_impulse_result_timing_t;
 
 /**
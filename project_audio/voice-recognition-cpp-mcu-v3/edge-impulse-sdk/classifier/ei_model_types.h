@@ -303,6 +303,20 @@ typedef struct {
     TfLiteStatus (*model_reset)(void (*free)(void* ptr));
     TfLiteStatus (*model_input)(int, TfLiteTensor*);
     TfLiteStatus (*model_output)(int, TfLiteTensor*);
+    // Re-entrant variants (nullptr if the graph was compiled without them): the graph
+    // state (tensors, kernel data, arena) lives in model_context_size() bytes of caller
+    // memory, so several contexts of one graph can be invoked at the same time
+    size_t (*model_context_size)();
+    TfLiteStatus (*model_init_ctx)(void *ctx);
+    TfLiteStatus (*model_invoke_ctx)(void *ctx);
+    TfLiteStatus (*model_reset_ctx)(void *ctx);
+    TfLiteStatus (*model_input_ctx)(void *ctx, int, TfLiteTensor*);
+    TfLiteStatus (*model_output_ctx)(void *ctx, int, TfLiteTensor*);
+    // runs several contexts layer by layer (nullptr: invoked one after the other)
+    TfLiteStatus (*model_invoke_batch_ctx)(void *const *ctxs, size_t count);
+    // the part of the arena that is idle outside invoke, lent to the DSP (nullptr: none)
+    TfLiteStatus (*model_idle_arena)(uint8_t **start, size_t *bytes);
+    TfLiteStatus (*model_idle_arena_ctx)(void *ctx, uint8_t **start, size_t *bytes);
 } ei_config_tflite_eon_graph_t;
 
 typedef struct {
@@ -411,12 +425,33 @@ typedef struct ei_impulse {
     uint32_t *freeform_outputs;
 } ei_impulse_t;
 
+#if EI_CLASSIFIER_REENTRANT
+/** EON graph context of one learning block, owned by an impulse handle (tflite_eon.h) */
+typedef struct {
+    void *graph;                                // set up by model_init_ctx, nullptr until first use
+    TfLiteStatus (*model_reset_ctx)(void *ctx); // of its graph: releases it, and identifies the graph
+} ei_inference_context_t;
+#endif // EI_CLASSIFIER_REENTRANT
+
 class ei_impulse_state_t {
 typedef DspHandle* _dsp_handle_ptr_t;
 public:
     const ei_impulse_t *impulse; // keep a pointer to the impulse
     _dsp_handle_ptr_t *dsp_handles;
     bool is_temp_handle = false; // to know if we're using the old (stateless) API
+    // continuous inference: the feature window of every DSP block (ei_feature_ring_t
+    // per block, see ei_run_dsp.h) and the features written since run_classifier_init
+    void *feature_rings = nullptr;
+    void *feature_ring_buffer = nullptr;
+    uint64_t continuous_features_written = 0;
+    // the classification results and the DSP features of process_impulse, allocated
+    // on first use so that later calls on this handle don't allocate (ei_run_classifier.h)
+    void *result_classification = nullptr;
+    void *features = nullptr;
+#if EI_CLASSIFIER_REENTRANT
+    // one graph context per learning block, allocated on first inference
+    ei_inference_context_t *inference_contexts = nullptr;
+#endif // EI_CLASSIFIER_REENTRANT
     ei_impulse_state_t(const ei_impulse_t *impulse)
         : impulse(impulse)
     {
@@ -442,6 +477,26 @@ public:
                 dsp_handles[ix] = nullptr;
             }
         }
+        continuous_features_written = 0;
+    }
+
+    // frees the graph contexts, the next inference sets them up again
+    void release_inference_contexts()
+    {
+#if EI_CLASSIFIER_REENTRANT
+        if (inference_contexts == nullptr) {
+            return;
+        }
+        for (size_t ix = 0; ix < impulse->learning_blocks_size; ix++) {
+            ei_inference_context_t *context = &inference_contexts[ix];
+            if (context->graph != nullptr) {
+                context->model_reset_ctx(context->graph);
+                ei_aligned_free(context->graph);
+            }
+        }
+        ei_free(inference_contexts);
+        inference_contexts = nullptr;
+#endif // EI_CLASSIFIER_REENTRANT
     }
 
     void* operator new(size_t size) {
@@ -463,6 +518,11 @@ public:
     ~ei_impulse_state_t()
     {
         reset();
+        release_inference_contexts();
+        ei_free(feature_rings);
+        ei_free(feature_ring_buffer);
+        ei_free(result_classification);
+        ei_free(features);
         ei_free(dsp_handles);
     }
 };
@@ -486,6 +546,30 @@ public:
 #endif // EI_CLASSIFIER_FREEFORM_OUTPUT
 };
 
+#if EI_CLASSIFIER_REENTRANT
+// Handle state the impulse is running on in this thread: the inferencing
+// engines only get the impulse, and find the handle's graph contexts here
+static thread_local ei_impulse_state_t *ei_current_impulse_state = nullptr;
+
+/** Makes state the current one of this thread while in scope (process_impulse) */
+class ei_impulse_state_binding {
+public:
+    ei_impulse_state_binding(ei_impulse_state_t *state) : _prev(ei_current_impulse_state) {
+        ei_current_impulse_state = state;
+    }
+
+    ~ei_impulse_state_binding() {
+        ei_current_impulse_state = _prev;
+    }
+
+    ei_impulse_state_binding(const ei_impulse_state_binding &) = delete;
+    ei_impulse_state_binding &operator=(const ei_impulse_state_binding &) = delete;
+
+private:
+    ei_impulse_state_t *_prev;
+};
+#endif // EI_CLASSIFIER_REENTRANT
+
 typedef struct {
     uint32_t block_id;
     uint16_t implementation_version;
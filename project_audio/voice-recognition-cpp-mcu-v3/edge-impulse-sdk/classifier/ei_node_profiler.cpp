@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2024 EdgeImpulse Inc.
+ *
+ * Generated by Edge Impulse and licensed under the applicable Edge Impulse
+ * Terms of Service. Community and Professional Terms of Service
+ * (https://edgeimpulse.com/legal/terms-of-service) or Enterprise Terms of
+ * Service (https://edgeimpulse.com/legal/enterprise-terms-of-service),
+ * according to your product plan subscription (the “License”).
+ *
+ * This software, documentation and other associated files (collectively referred
+ * to as the “Software”) is a single SDK variation generated by the Edge Impulse
+ * platform and requires an active paid Edge Impulse subscription to use this
+ * Software for any purpose.
+ *
+ * You may NOT use this Software unless you have an active Edge Impulse subscription
+ * that meets the eligibility requirements for the applicable License, subject to
+ * your full and continued compliance with the terms and conditions of the License,
+ * including without limitation any usage restrictions under the applicable License.
+ *
+ * If you do not have an active Edge Impulse product plan subscription, or if use
+ * of this Software exceeds the usage limitations of your Edge Impulse product plan
+ * subscription, you are not permitted to use this Software and must immediately
+ * delete and erase all copies of this Software within your control or possession.
+ * Edge Impulse reserves all rights and remedies available to enforce its rights.
+ *
+ * Unless required by applicable law or agreed to in writing, the Software is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language governing
+ * permissions, disclaimers and limitations under the License.
+ */
+#include "ei_node_profiler.h"
+
+#if EI_CLASSIFIER_PROFILE_NODES
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/tensorflow/lite/schema/schema_generated.h"
+
+EI_NODE_PROFILER_THREAD_LOCAL ei_node_profiler_t ei_node_profiler = { };
+
+void ei_node_profiler_reset() {
+    for (size_t ix = 0; ix < EI_CLASSIFIER_PROFILE_NODES_MAX; ix++) {
+        ei_node_profiler.nodes[ix].total_cycles = 0;
+        ei_node_profiler.nodes[ix].invokes = 0;
+    }
+}
+
+void ei_node_profiler_print(bool csv) {
+    const uint32_t count = ei_node_profiler.count < EI_CLASSIFIER_PROFILE_NODES_MAX ?
+        ei_node_profiler.count : EI_CLASSIFIER_PROFILE_NODES_MAX;
+
+    if (csv) {
+        ei_printf("node,op,time_us,avg_us,macs,arena_bytes\n");
+    }
+    else {
+        ei_printf("node op                    time_us    avg_us       MACs  arena bytes\n");
+    }
+
+    uint64_t total_tenths = 0;
+    uint64_t total_macs = 0;
+    for (uint32_t ix = 0; ix < count; ix++) {
+        const ei_node_profile_t *p = &ei_node_profiler.nodes[ix];
+        if (p->invokes == 0) {
+            continue;
+        }
+        // tenths of a microsecond, ei_printf may not do floats
+        const uint64_t last_tenths = ei_cycles_to_us((uint64_t)p->cycles * 10);
+        const uint64_t avg_tenths = ei_cycles_to_us(p->total_cycles * 10 / p->invokes);
+        const char *op = p->op == EI_NODE_PROFILER_OP_DEPTHWISE_SEPARABLE_CONV_2D ? "DW_SEPARABLE_CONV_2D" :
+            tflite::EnumNameBuiltinOperator(static_cast<tflite::BuiltinOperator>(p->op));
+        total_tenths += avg_tenths;
+        total_macs += p->macs;
+
+        ei_printf(csv ? "%u,%s,%lu.%lu,%lu.%lu,%lu,%lu\n" : "%4u %-20s %6lu.%lu %7lu.%lu %10lu %12lu\n",
+            (unsigned)p->node, op, (unsigned long)(last_tenths / 10), (unsigned long)(last_tenths % 10),
+            (unsigned long)(avg_tenths / 10), (unsigned long)(avg_tenths % 10),
+            (unsigned long)p->macs, (unsigned long)p->arena_bytes);
+    }
+
+    if (!csv) {
+        ei_printf("     %-20s %8s %7lu.%lu %10lu\n", "total", "",
+            (unsigned long)(total_tenths / 10), (unsigned long)(total_tenths % 10), (unsigned long)total_macs);
+    }
+}
+
+#endif // EI_CLASSIFIER_PROFILE_NODES
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2024 EdgeImpulse Inc.
+ *
+ * Generated by Edge Impulse and licensed under the applicable Edge Impulse
+ * Terms of Service. Community and Professional Terms of Service
+ * (https://edgeimpulse.com/legal/terms-of-service) or Enterprise Terms of
+ * Service (https://edgeimpulse.com/legal/enterprise-terms-of-service),
+ * according to your product plan subscription (the “License”).
+ *
+ * This software, documentation and other associated files (collectively referred
+ * to as the “Software”) is a single SDK variation generated by the Edge Impulse
+ * platform and requires an active paid Edge Impulse subscription to use this
+ * Software for any purpose.
+ *
+ * You may NOT use this Software unless you have an active Edge Impulse subscription
+ * that meets the eligibility requirements for the applicable License, subject to
+ * your full and continued compliance with the terms and conditions of the License,
+ * including without limitation any usage restrictions under the applicable License.
+ *
+ * If you do not have an active Edge Impulse product plan subscription, or if use
+ * of this Software exceeds the usage limitations of your Edge Impulse product plan
+ * subscription, you are not permitted to use this Software and must immediately
+ * delete and erase all copies of this Software within your control or possession.
+ * Edge Impulse reserves all rights and remedies available to enforce its rights.
+ *
+ * Unless required by applicable law or agreed to in writing, the Software is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language governing
+ * permissions, disclaimers and limitations under the License.
+ */
+#ifndef _EI_NODE_PROFILER_H_
+#define _EI_NODE_PROFILER_H_
+
+// clang-format off
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * Opt-in per-node profile of the EON-compiled graph (EI_CLASSIFIER_PROFILE_NODES=1).
+ * The generated invoke loop times every node with ei_read_cycles() and records
+ * it with ei_node_profiler_record(); the records live in a static ring of
+ * EI_CLASSIFIER_PROFILE_NODES_MAX entries indexed by node (a graph with more
+ * nodes overwrites the first ones). Read them through result.timing.nodes after
+ * run_classifier, or print them with ei_node_profiler_print().
+ */
+#ifndef EI_CLASSIFIER_PROFILE_NODES
+#define EI_CLASSIFIER_PROFILE_NODES         0
+#endif
+
+#ifndef EI_CLASSIFIER_PROFILE_NODES_MAX
+#define EI_CLASSIFIER_PROFILE_NODES_MAX     64
+#endif
+
+// with EI_CLASSIFIER_REENTRANT (dsp/config.hpp) every thread records its own invokes
+#if defined(EI_CLASSIFIER_REENTRANT) && EI_CLASSIFIER_REENTRANT
+#define EI_NODE_PROFILER_THREAD_LOCAL       thread_local
+#else
+#define EI_NODE_PROFILER_THREAD_LOCAL
+#endif
+
+// operators the EON compiler fuses out of builtins, numbered past them
+#define EI_NODE_PROFILER_OP_DEPTHWISE_SEPARABLE_CONV_2D     0x8000
+
+typedef struct {
+    uint16_t node;              // index in the invoke loop
+    uint16_t op;                // builtin operator (TfLiteBuiltinOperator), or EI_NODE_PROFILER_OP_*
+    uint32_t cycles;            // last invoke, ei_read_cycles() units
+    uint64_t total_cycles;      // all invokes since ei_node_profiler_reset()
+    uint32_t invokes;
+    uint32_t macs;              // multiply-accumulates per invoke, from the tensor dims
+    uint32_t arena_bytes;       // bytes of arena tensors the node reads and writes
+} ei_node_profile_t;
+
+#if EI_CLASSIFIER_PROFILE_NODES
+
+typedef struct {
+    ei_node_profile_t nodes[EI_CLASSIFIER_PROFILE_NODES_MAX];
+    uint32_t count;             // nodes recorded by the last invoke
+} ei_node_profiler_t;
+
+extern EI_NODE_PROFILER_THREAD_LOCAL ei_node_profiler_t ei_node_profiler;
+
+__attribute__((unused)) static inline void ei_node_profiler_record(size_t node, uint16_t op, uint32_t cycles,
+    uint32_t macs, uint32_t arena_bytes) {
+    ei_node_profile_t *p = &ei_node_profiler.nodes[node % EI_CLASSIFIER_PROFILE_NODES_MAX];
+    if (p->node != node || p->invokes == 0) {
+        p->node = (uint16_t)node;
+        p->total_cycles = 0;
+        p->invokes = 0;
+    }
+    p->op = op;
+    p->cycles = cycles;
+    p->total_cycles += cycles;
+    p->invokes++;
+    p->macs = macs;
+    p->arena_bytes = arena_bytes;
+    if (node + 1 > ei_node_profiler.count) {
+        ei_node_profiler.count = (uint32_t)(node + 1);
+    }
+}
+
+/**
+ * Clear the accumulated times
+ */
+void ei_node_profiler_reset();
+
+/**
+ * Print the nodes through ei_printf: last and average time (converted with
+ * ei_cycles_to_us, in tenths of a microsecond), MACs and arena bytes
+ * per node as a table, or as CSV (node,op,time_us,avg_us,macs,arena_bytes)
+ */
+void ei_node_profiler_print(bool csv);
+
+#endif // EI_CLASSIFIER_PROFILE_NODES
+
+// clang-format on
+#endif // _EI_NODE_PROFILER_H_
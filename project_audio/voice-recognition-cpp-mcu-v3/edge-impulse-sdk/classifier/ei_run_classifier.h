@@ -102,16 +102,17 @@ namespace {
 extern "C" EI_IMPULSE_ERROR run_inference(ei_impulse_handle_t *handle, ei_feature_t *fmatrix, ei_impulse_result_t *result, bool debug);
 extern "C" EI_IMPULSE_ERROR run_classifier_image_quantized(const ei_impulse_t *impulse, signal_t *signal, ei_impulse_result_t *result, bool debug);
 static EI_IMPULSE_ERROR can_run_classifier_image_quantized(const ei_impulse_t *impulse, ei_learning_block_t block_ptr);
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1)
+extern "C" EI_IMPULSE_ERROR run_classifier_audio_quantized(const ei_impulse_t *impulse, signal_t *signal, ei_impulse_result_t *result, bool debug);
+static EI_IMPULSE_ERROR run_classifier_audio_ring_quantized(const ei_impulse_t *impulse, const ei_feature_ring_t *ring, ei_impulse_result_t *result, bool debug);
+static EI_IMPULSE_ERROR can_run_classifier_audio_quantized(const ei_impulse_t *impulse, ei_learning_block_t block_ptr);
+#endif
 
 #if EI_CLASSIFIER_LOAD_IMAGE_SCALING
 EI_IMPULSE_ERROR ei_scale_fmatrix(ei_learning_block_t *block, ei::matrix_t *fmatrix);
 EI_IMPULSE_ERROR ei_unscale_fmatrix(ei_learning_block_t *block, ei::matrix_t *fmatrix);
 #endif // EI_CLASSIFIER_LOAD_IMAGE_SCALING
 
-/* Private variables ------------------------------------------------------- */
-
-static uint64_t classifier_continuous_features_written = 0;
-
 /* Private functions ------------------------------------------------------- */
 
 /* These functions (up to Public functions section) are not exposed to end-user,
@@ -179,6 +180,96 @@ extern "C" EI_IMPULSE_ERROR run_inference(
     return EI_IMPULSE_OK;
 }
 
+/**
+ * Number of classification results of an impulse (label_count, or EI_DSP_RESULT_OVERRIDE)
+ */
+__attribute__((unused)) static size_t impulse_result_classification_count(const ei_impulse_t *impulse)
+{
+#ifdef EI_DSP_RESULT_OVERRIDE
+    return EI_DSP_RESULT_OVERRIDE;
+#else
+    return impulse->label_count;
+#endif
+}
+
+/**
+ * The classification results of a handle, allocated with their labels on first use
+ * and zeroed on every call. The results of process_impulse and
+ * process_impulse_continuous point into them, so they stay valid until the next
+ * call on the same handle.
+ *
+ * @return     The results, or nullptr if they can't be allocated
+ */
+__attribute__((unused)) static ei_impulse_result_classification_t *get_impulse_result_classification(ei_impulse_handle_t *handle)
+{
+    const size_t count = impulse_result_classification_count(handle->impulse);
+
+    ei_impulse_result_classification_t *classification =
+        (ei_impulse_result_classification_t *)handle->state.result_classification;
+    if (classification == nullptr) {
+        classification = (ei_impulse_result_classification_t *)ei_calloc(count > 0 ? count : 1,
+            sizeof(ei_impulse_result_classification_t));
+        if (classification == nullptr) {
+            return nullptr;
+        }
+        for (size_t ix = 0; ix < count; ix++) {
+#ifdef EI_DSP_RESULT_OVERRIDE
+            classification[ix].label = "";
+#else
+            classification[ix].label = handle->impulse->categories[ix];
+#endif
+        }
+        handle->state.result_classification = classification;
+    }
+
+    for (size_t ix = 0; ix < count; ix++) {
+        classification[ix].value = 0.0f;
+    }
+    return classification;
+}
+
+/**
+ * The features of every DSP block for process_impulse, owned by the handle and
+ * allocated on first use in one buffer: dsp_blocks_size ei_feature_t, their
+ * matrices, then the float features. The matrices are set up (and the features
+ * zeroed) again on every call, as the DSP blocks resize them.
+ *
+ * @return     The features, or nullptr if they can't be allocated
+ */
+static ei_feature_t *get_impulse_features(ei_impulse_handle_t *handle)
+{
+    auto impulse = handle->impulse;
+    const size_t block_num = impulse->dsp_blocks_size;
+
+    size_t features_size = 0;
+    for (size_t ix = 0; ix < block_num; ix++) {
+        features_size += impulse->dsp_blocks[ix].n_output_features;
+    }
+
+    ei_feature_t *features = (ei_feature_t *)handle->state.features;
+    if (features == nullptr) {
+        features = (ei_feature_t *)ei_calloc(1,
+            block_num * (sizeof(ei_feature_t) + sizeof(ei::matrix_t)) + features_size * sizeof(float));
+        if (features == nullptr) {
+            return nullptr;
+        }
+        handle->state.features = features;
+    }
+
+    ei::matrix_t *matrices = (ei::matrix_t *)(features + block_num);
+    float *buffer = (float *)(matrices + block_num);
+    memset(buffer, 0, features_size * sizeof(float));
+
+    // the matrices only point into the buffer, so they need no destructor call
+    for (size_t ix = 0; ix < block_num; ix++) {
+        ei_model_dsp_t block = impulse->dsp_blocks[ix];
+        features[ix].matrix = ::new (matrices + ix) ei::matrix_t(1, block.n_output_features, buffer);
+        features[ix].blockId = block.blockId;
+        buffer += block.n_output_features;
+    }
+    return features;
+}
+
 /**
  * @brief      Process a complete impulse
  *
@@ -202,39 +293,30 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
     memset(result, 0, sizeof(ei_impulse_result_t));
 
 #if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
-    static std::vector<ei_impulse_result_classification_t> classification_results;
-    classification_results.clear(); // todo, should not clear and re-gen this every time...
-
+    // owned by the handle, so concurrent handles don't share results
     if (handle->impulse->results_type == EI_CLASSIFIER_TYPE_CLASSIFICATION ||
         handle->impulse->results_type == EI_CLASSIFIER_TYPE_REGRESSION) {
-    #ifdef EI_DSP_RESULT_OVERRIDE
-        for (size_t ix = 0; ix < EI_DSP_RESULT_OVERRIDE; ix++) {
-            ei_impulse_result_classification_t classification = {
-                .label = "",
-                .value = 0.0f
-            };
-            classification_results.push_back(classification);
-        }
-    #else
-        for (size_t ix = 0; ix < handle->impulse->label_count; ix++) {
-            ei_impulse_result_classification_t classification = {
-                .label = handle->impulse->categories[ix],
-                .value = 0.0f
-            };
-            classification_results.push_back(classification);
+        result->classification = get_impulse_result_classification(handle);
+        if (result->classification == nullptr) {
+            return EI_IMPULSE_ALLOC_FAILED;
         }
-    #endif // EI_DSP_RESULT_OVERRIDE
     }
-
-    result->classification = classification_results.data();
 #endif // EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
 
-    uint8_t num_results = handle->impulse->output_tensors_size;
+    // everything below that only lives for this call is scratch (see ei_dsp_workspace_scope)
+    ei_dsp_workspace_scope workspace_scope;
+#if EI_CLASSIFIER_REENTRANT
+    // the engines run the graph contexts of this handle
+    ei_impulse_state_binding state_binding(&handle->state);
+#endif
 
-    std::unique_ptr<ei_feature_t[]> raw_results_ptr(new ei_feature_t[num_results]);
+    uint8_t num_results = handle->impulse->output_tensors_size;
 
-    result->_raw_outputs = raw_results_ptr.get();
-    memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * num_results);
+    ei_dsp_scratch_buffer<ei_feature_t> raw_results_buffer(num_results);
+    result->_raw_outputs = raw_results_buffer.get();
+    if (result->_raw_outputs == nullptr) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
 
 #if (EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TENSAIFLOW || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_ONNX_TIDL) || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_DRPAI || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_ATON)
     // Shortcut for quantized image models
@@ -249,51 +331,33 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
     }
 #endif
 
-    uint32_t block_num = handle->impulse->dsp_blocks_size;
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1) && !EI_CLASSIFIER_DSP_ONLY
+    // Shortcut for quantized MFE models (EON), features go straight into the input tensor
+    if (can_run_classifier_audio_quantized(handle->impulse, handle->impulse->learning_blocks[0]) == EI_IMPULSE_OK) {
+        EI_IMPULSE_ERROR res = run_classifier_audio_quantized(handle->impulse, signal, result, debug);
+        if (res != EI_IMPULSE_OK) {
+            return res;
+        }
+        return run_postprocessing(handle, result);
+    }
+#endif
 
-    // smart pointer to features array
-    std::unique_ptr<ei_feature_t[]> features_ptr(new ei_feature_t[block_num]);
-    ei_feature_t* features = features_ptr.get();
+    uint32_t block_num = handle->impulse->dsp_blocks_size;
 
+    // owned by the handle, see get_impulse_features
+    ei_feature_t *features = get_impulse_features(handle);
     if (features == nullptr) {
         ei_printf("ERR: Out of memory, can't allocate features\n");
         return EI_IMPULSE_ALLOC_FAILED;
     }
 
-    memset(features, 0, sizeof(ei_feature_t) * block_num);
-
-    // have it outside of the loop to avoid going out of scope
-    std::unique_ptr<std::unique_ptr<ei::matrix_t>[]> matrix_ptrs_ptr(new std::unique_ptr<ei::matrix_t>[block_num]);
-    std::unique_ptr<ei::matrix_t> *matrix_ptrs = matrix_ptrs_ptr.get();
-
-    if (matrix_ptrs == nullptr) {
-        delete[] matrix_ptrs;
-        ei_printf("ERR: Out of memory, can't allocate matrix_ptrs\n");
-        return EI_IMPULSE_ALLOC_FAILED;
-    }
-
-    uint64_t dsp_start_us = ei_read_timer_us();
+    uint64_t dsp_start_cycles = ei_read_cycles();
 
     size_t out_features_index = 0;
 
     for (size_t ix = 0; ix < handle->impulse->dsp_blocks_size; ix++) {
         ei_model_dsp_t block = handle->impulse->dsp_blocks[ix];
 
-        matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(new ei::matrix_t(1, block.n_output_features));
-        if (matrix_ptrs[ix] == nullptr) {
-            ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
-            return EI_IMPULSE_ALLOC_FAILED;
-        }
-
-        if (matrix_ptrs[ix]->buffer == nullptr) {
-            ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
-            delete[] matrix_ptrs;
-            return EI_IMPULSE_ALLOC_FAILED;
-        }
-
-        features[ix].matrix = matrix_ptrs[ix].get();
-        features[ix].blockId = block.blockId;
-
         if (out_features_index + block.n_output_features > handle->impulse->nn_input_frame_size) {
             ei_printf("ERR: Would write outside feature buffer\n");
             return EI_IMPULSE_DSP_ERROR;
@@ -356,7 +420,7 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
     }
 #endif
 
-    result->timing.dsp_us = ei_read_timer_us() - dsp_start_us;
+    result->timing.dsp_us = ei_cycles_to_us(ei_read_cycles() - dsp_start_cycles);
     result->timing.dsp = (int)(result->timing.dsp_us / 1000);
 
     if (debug) {
@@ -406,76 +470,93 @@ extern "C" EI_IMPULSE_ERROR init_impulse(ei_impulse_handle_t *handle) {
 }
 
 /**
- * @brief      Process a complete impulse for continuous inference
- *
- * @param      handle               struct with information about model and DSP
- * @param      signal               Sample data
- * @param      result               Output classifier results
- * @param[in]  debug                Debug output enable
- *
- * @return     The ei impulse error.
+ * Drops the partial frames the feature rings of a handle carry between slices,
+ * as ei_dsp_clear_continuous_audio_state does for the shared one
  */
-extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *handle,
-                                                       signal_t *signal,
-                                                       ei_impulse_result_t *result,
-                                                       bool debug = false)
+static void clear_continuous_feature_rings(ei_impulse_handle_t *handle)
 {
-    if ((handle == nullptr) || (handle->impulse  == nullptr) || (result  == nullptr) || (signal  == nullptr)) {
-        return EI_IMPULSE_INFERENCE_ERROR;
+    ei_feature_ring_t *feature_rings = (ei_feature_ring_t *)handle->state.feature_rings;
+    if (feature_rings == nullptr) {
+        return;
     }
-
-    memset(result, 0, sizeof(ei_impulse_result_t));
-
-#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
-    static std::vector<ei_impulse_result_classification_t> classification_results;
-    classification_results.clear(); // todo, should not clear and re-gen this every time...
-
-    if (handle->impulse->results_type == EI_CLASSIFIER_TYPE_CLASSIFICATION ||
-        handle->impulse->results_type == EI_CLASSIFIER_TYPE_REGRESSION) {
-    #ifdef EI_DSP_RESULT_OVERRIDE
-        for (size_t ix = 0; ix < EI_DSP_RESULT_OVERRIDE; ix++) {
-            ei_impulse_result_classification_t classification = {
-                .label = "",
-                .value = 0.0f
-            };
-            classification_results.push_back(classification);
-        }
-    #else
-        for (size_t ix = 0; ix < handle->impulse->label_count; ix++) {
-            ei_impulse_result_classification_t classification = {
-                .label = handle->impulse->categories[ix],
-                .value = 0.0f
-            };
-            classification_results.push_back(classification);
-        }
-    #endif
+    for (size_t ix = 0; ix < handle->impulse->dsp_blocks_size; ix++) {
+        feature_rings[ix].frame_ix = 0;
     }
+}
 
-    result->classification = classification_results.data();
-
-#else // EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 1
+/**
+ * DSP half of process_impulse_continuous: runs the slice through every DSP block
+ * into the feature rings of the handle (allocated on first use) and counts the
+ * features written. Sets result->timing.dsp_us.
+ */
+static EI_IMPULSE_ERROR process_impulse_continuous_dsp(ei_impulse_handle_t *handle,
+                                                       signal_t *signal,
+                                                       ei_impulse_result_t *result)
+{
+    auto impulse = handle->impulse;
 
-    for (int i = 0; i < handle->impulse->label_count; i++) {
-        // set label correctly in the result struct if we have no results (otherwise is nullptr)
-        result->classification[i].label = handle->impulse->categories[(uint32_t)i];
-    }
+    // the features of every DSP block as a ring of frames (feature window kept between slices,
+    // owned by the handle): MFE blocks write their new frames in place
+    // (extract_mfe_per_slice_features_ring), the other per-slice blocks roll their part and keep head at 0
+    ei_feature_ring_t *feature_rings = (ei_feature_ring_t *)handle->state.feature_rings;
+    if (!feature_rings) {
+        // quantized MFE models only ever read the window into the int8 input tensor, so
+        // their ring keeps the normalized features as uint8 (a quarter of the float window)
+        bool store_u8 = false;
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1) && !EI_CLASSIFIER_DSP_ONLY
+        store_u8 = can_run_classifier_audio_quantized(impulse, impulse->learning_blocks[0]) == EI_IMPULSE_OK;
+#endif
 
-#endif // EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+        // MFE blocks carry the partial frame between slices in their ring, behind the rings
+        size_t frames_size = 0;
+        for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+            if (impulse->dsp_blocks[ix].extract_fn == extract_mfe_features) {
+                ei_dsp_config_mfe_t *mfe_config = (ei_dsp_config_mfe_t *)impulse->dsp_blocks[ix].config;
+                frames_size += (size_t)(static_cast<uint32_t>(impulse->frequency) * mfe_config->frame_length);
+            }
+        }
 
-    // smart pointer to results array
-    std::unique_ptr<ei_feature_t[]> raw_results_ptr(new ei_feature_t[handle->impulse->learning_blocks_size]);
-    result->_raw_outputs = raw_results_ptr.get();
-    memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * handle->impulse->learning_blocks_size);
+        feature_rings = (ei_feature_ring_t *)ei_calloc(1,
+            impulse->dsp_blocks_size * sizeof(ei_feature_ring_t) + frames_size * sizeof(float));
+        float *float_features = store_u8 ? nullptr : (float *)ei_calloc(impulse->nn_input_frame_size, sizeof(float));
+        uint8_t *u8_features = store_u8 ? (uint8_t *)ei_calloc(impulse->nn_input_frame_size, sizeof(uint8_t)) : nullptr;
+        if (!feature_rings || (!float_features && !u8_features)) {
+            ei_free(feature_rings);
+            ei_free(float_features);
+            ei_free(u8_features);
+            return EI_IMPULSE_ALLOC_FAILED;
+        }
+        handle->state.feature_rings = feature_rings;
+        handle->state.feature_ring_buffer = store_u8 ? (void *)u8_features : (void *)float_features;
 
-    auto impulse = handle->impulse;
-    static ei::matrix_t static_features_matrix(1, impulse->nn_input_frame_size);
-    if (!static_features_matrix.buffer) {
-        return EI_IMPULSE_ALLOC_FAILED;
+        float *frames = (float *)(feature_rings + impulse->dsp_blocks_size);
+        size_t features_index = 0;
+        for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+            ei_model_dsp_t block = impulse->dsp_blocks[ix];
+            ei_feature_ring_t *ring = &feature_rings[ix];
+            if (store_u8) {
+                ring->buffer_u8 = u8_features + features_index;
+            }
+            else {
+                ring->buffer = float_features + features_index;
+            }
+            ring->cols = block.n_output_features;
+            if (block.extract_fn == extract_mfe_features) {
+                ei_dsp_config_mfe_t *mfe_config = (ei_dsp_config_mfe_t *)block.config;
+                ring->cols = mfe_config->num_filters;
+                // v3+ normalizes per feature, so frames are normalized once when they enter the ring
+                ring->normalized = mfe_config->implementation_version >= 3;
+                ring->frame = frames;
+                ring->frame_size = (size_t)(static_cast<uint32_t>(impulse->frequency) * mfe_config->frame_length);
+                frames += ring->frame_size;
+            }
+            ring->rows = block.n_output_features / ring->cols;
+            ring->head = 0;
+            features_index += block.n_output_features;
+        }
     }
 
-    EI_IMPULSE_ERROR ei_impulse_error = EI_IMPULSE_OK;
-
-    uint64_t dsp_start_us = ei_read_timer_us();
+    uint64_t dsp_start_cycles = ei_read_cycles();
 
     size_t out_features_index = 0;
 
@@ -487,10 +568,7 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
             return EI_IMPULSE_DSP_ERROR;
         }
 
-        ei::matrix_t fm(1, block.n_output_features,
-                        static_features_matrix.buffer + out_features_index);
-
-        int (*extract_fn_slice)(ei::signal_t *signal, ei::matrix_t *output_matrix, void *config, const float frequency, matrix_size_t *out_matrix_size);
+        int (*extract_fn_slice)(ei::signal_t *signal, ei::matrix_t *output_matrix, void *config, const float frequency, matrix_size_t *out_matrix_size) = nullptr;
 
         /* Switch to the slice version of the mfcc feature extract function */
         if (block.extract_fn == extract_mfcc_features) {
@@ -499,10 +577,7 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
         else if (block.extract_fn == extract_spectrogram_features) {
             extract_fn_slice = &extract_spectrogram_per_slice_features;
         }
-        else if (block.extract_fn == extract_mfe_features) {
-            extract_fn_slice = &extract_mfe_per_slice_features;
-        }
-        else {
+        else if (block.extract_fn != extract_mfe_features) {
             ei_printf("ERR: Unknown extract function, only MFCC, MFE and spectrogram supported\n");
             return EI_IMPULSE_DSP_ERROR;
         }
@@ -514,11 +589,20 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
             ei_printf("ERR: EIDSP_SIGNAL_C_FN_POINTER can only be used when all axes are selected for DSP blocks\n");
             return EI_IMPULSE_DSP_ERROR;
         }
-        int ret = extract_fn_slice(signal, &fm, block.config, impulse->frequency, &features_written);
+        signal_t *block_signal = signal;
 #else
         SignalWithAxes swa(signal, block.axes, block.axes_size, impulse);
-        int ret = extract_fn_slice(swa.get_signal(), &fm, block.config, impulse->frequency, &features_written);
+        signal_t *block_signal = swa.get_signal();
 #endif
+        int ret;
+        if (extract_fn_slice) {
+            ei::matrix_t fm(1, block.n_output_features, feature_rings[ix].buffer);
+            ret = extract_fn_slice(block_signal, &fm, block.config, impulse->frequency, &features_written);
+        }
+        else {
+            ret = extract_mfe_per_slice_features_ring(block_signal, &feature_rings[ix], block.config, impulse->frequency,
+                &features_written);
+        }
 
         if (ret != EIDSP_OK) {
             ei_printf("ERR: Failed to run DSP process (%d)\n", ret);
@@ -529,59 +613,147 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
             return EI_IMPULSE_CANCELED;
         }
 
-        classifier_continuous_features_written += (features_written.rows * features_written.cols);
+        handle->state.continuous_features_written += (features_written.rows * features_written.cols);
 
         out_features_index += block.n_output_features;
     }
 
-    result->timing.dsp_us = ei_read_timer_us() - dsp_start_us;
+    result->timing.dsp_us = ei_cycles_to_us(ei_read_cycles() - dsp_start_cycles);
     result->timing.dsp = (int)(result->timing.dsp_us / 1000);
 
-    if (classifier_continuous_features_written >= impulse->nn_input_frame_size) {
-        dsp_start_us = ei_read_timer_us();
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * @brief      Process a complete impulse for continuous inference
+ *
+ * @param      handle               struct with information about model and DSP
+ * @param      signal               Sample data
+ * @param      result               Output classifier results
+ * @param[in]  debug                Debug output enable
+ *
+ * @return     The ei impulse error.
+ */
+extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *handle,
+                                                       signal_t *signal,
+                                                       ei_impulse_result_t *result,
+                                                       bool debug = false)
+{
+    if ((handle == nullptr) || (handle->impulse  == nullptr) || (result  == nullptr) || (signal  == nullptr)) {
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+
+    memset(result, 0, sizeof(ei_impulse_result_t));
+
+#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+    // owned by the handle, so concurrent handles don't share results
+    if (handle->impulse->results_type == EI_CLASSIFIER_TYPE_CLASSIFICATION ||
+        handle->impulse->results_type == EI_CLASSIFIER_TYPE_REGRESSION) {
+        result->classification = get_impulse_result_classification(handle);
+        if (result->classification == nullptr) {
+            return EI_IMPULSE_ALLOC_FAILED;
+        }
+    }
+
+#else // EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 1
+
+    for (int i = 0; i < handle->impulse->label_count; i++) {
+        // set label correctly in the result struct if we have no results (otherwise is nullptr)
+        result->classification[i].label = handle->impulse->categories[(uint32_t)i];
+    }
+
+#endif // EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+
+    // everything below that only lives for this call is scratch (see ei_dsp_workspace_scope)
+    ei_dsp_workspace_scope workspace_scope;
+#if EI_CLASSIFIER_REENTRANT
+    // the engines run the graph contexts of this handle
+    ei_impulse_state_binding state_binding(&handle->state);
+#endif
+
+    // scratch results array
+    ei_dsp_scratch_buffer<ei_feature_t> raw_results_buffer(handle->impulse->learning_blocks_size);
+    result->_raw_outputs = raw_results_buffer.get();
+    if (result->_raw_outputs == nullptr) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+
+    auto impulse = handle->impulse;
+
+    EI_IMPULSE_ERROR ei_impulse_error;
+    {
+        uint8_t *idle_arena = nullptr;
+        size_t idle_arena_bytes = 0;
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1) && !EI_CLASSIFIER_DSP_ONLY
+        // the window lives in the feature ring, so the slice DSP scratch can go
+        // into the tensor arena of the graph, idle until the inference below
+        if (can_run_classifier_audio_quantized(impulse, impulse->learning_blocks[0]) == EI_IMPULSE_OK) {
+            ei_impulse_error = inference_tflite_idle_arena(impulse, 0, &idle_arena, &idle_arena_bytes);
+            if (ei_impulse_error != EI_IMPULSE_OK) {
+                return ei_impulse_error;
+            }
+        }
+#endif
+        ei_dsp_workspace_overlay overlay(idle_arena, idle_arena_bytes);
+
+        ei_impulse_error = process_impulse_continuous_dsp(handle, signal, result);
+    }
+    if (ei_impulse_error != EI_IMPULSE_OK) {
+        return ei_impulse_error;
+    }
+    ei_feature_ring_t *feature_rings = (ei_feature_ring_t *)handle->state.feature_rings;
+
+    if (handle->state.continuous_features_written >= impulse->nn_input_frame_size) {
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1) && !EI_CLASSIFIER_DSP_ONLY
+        // quantized MFE models (EON): the ring goes straight into the input tensor.
+        // The graph itself still runs over the whole window: activations of one window
+        // can only be reused for the next one when the slice hop (in frames) is a
+        // multiple of the graph's stride along time, otherwise no output row lines up.
+        if (can_run_classifier_audio_quantized(impulse, impulse->learning_blocks[0]) == EI_IMPULSE_OK) {
+            const uint64_t slice_dsp_us = result->timing.dsp_us;
+            ei_impulse_error = run_classifier_audio_ring_quantized(impulse, &feature_rings[0], result, debug);
+            result->timing.dsp_us += slice_dsp_us;
+            result->timing.dsp = (int)(result->timing.dsp_us / 1000);
+            if (ei_impulse_error != EI_IMPULSE_OK) {
+                return ei_impulse_error;
+            }
+            return run_postprocessing(handle, result);
+        }
+#endif
+
+        uint64_t dsp_start_cycles = ei_read_cycles();
 
         uint32_t block_num = impulse->dsp_blocks_size + impulse->learning_blocks_size;
 
-        // smart pointer to features array
-        std::unique_ptr<ei_feature_t[]> features_ptr(new ei_feature_t[block_num]);
-        ei_feature_t* features = features_ptr.get();
+        // scratch features array
+        ei_dsp_scratch_buffer<ei_feature_t> features_buffer(block_num);
+        ei_feature_t* features = features_buffer.get();
         if (features == nullptr) {
             ei_printf("ERR: Out of memory, can't allocate features\n");
             return EI_IMPULSE_ALLOC_FAILED;
         }
-        memset(features, 0, sizeof(ei_feature_t) * block_num);
 
-        // have it outside of the loop to avoid going out of scope
-        std::unique_ptr<ei::matrix_t> *matrix_ptrs = new std::unique_ptr<ei::matrix_t>[block_num];
-        if (matrix_ptrs == nullptr) {
-            ei_printf("ERR: Out of memory, can't allocate matrix_ptrs\n");
+        // the normalized copies of all blocks share one scratch buffer; the matrices
+        // only point into it, so they need no destructor call
+        ei_dsp_scratch_buffer<ei::matrix_t> matrices_buffer(impulse->dsp_blocks_size);
+        ei_dsp_scratch_buffer<float> normalized_buffer(impulse->nn_input_frame_size);
+        if (matrices_buffer.get() == nullptr || normalized_buffer.get() == nullptr) {
+            ei_printf("ERR: Out of memory, can't allocate normalized features\n");
             return EI_IMPULSE_ALLOC_FAILED;
         }
 
-        out_features_index = 0;
+        size_t out_features_index = 0;
         // iterate over every dsp block and run normalization
         for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
             ei_model_dsp_t block = impulse->dsp_blocks[ix];
-            matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(new ei::matrix_t(1, block.n_output_features));
+            ei::matrix_t *matrix = ::new (matrices_buffer.get() + ix) ei::matrix_t(1, block.n_output_features,
+                normalized_buffer.get() + out_features_index);
 
-            if (matrix_ptrs[ix] == nullptr) {
-                ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
-                return EI_IMPULSE_ALLOC_FAILED;
-            }
-
-            if (matrix_ptrs[ix]->buffer == nullptr) {
-                ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
-                delete[] matrix_ptrs;
-                return EI_IMPULSE_ALLOC_FAILED;
-            }
-
-            features[ix].matrix = matrix_ptrs[ix].get();
+            features[ix].matrix = matrix;
             features[ix].blockId = block.blockId;
 
-            /* Create a copy of the matrix for normalization */
-            for (size_t m_ix = 0; m_ix < block.n_output_features; m_ix++) {
-                features[ix].matrix->buffer[m_ix] = static_features_matrix.buffer[out_features_index + m_ix];
-            }
+            /* Copy the frames for normalization, oldest first */
+            ei_feature_ring_read(&feature_rings[ix], features[ix].matrix->buffer);
 
             if (block.extract_fn == extract_mfcc_features) {
                 calc_cepstral_mean_and_var_normalization_mfcc(features[ix].matrix, block.config);
@@ -589,13 +761,13 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
             else if (block.extract_fn == extract_spectrogram_features) {
                 calc_cepstral_mean_and_var_normalization_spectrogram(features[ix].matrix, block.config);
             }
-            else if (block.extract_fn == extract_mfe_features) {
+            else if (block.extract_fn == extract_mfe_features && !feature_rings[ix].normalized) {
                 calc_cepstral_mean_and_var_normalization_mfe(features[ix].matrix, block.config);
             }
             out_features_index += block.n_output_features;
         }
 
-        result->timing.dsp_us += ei_read_timer_us() - dsp_start_us;
+        result->timing.dsp_us += ei_cycles_to_us(ei_read_cycles() - dsp_start_cycles);
         result->timing.dsp = (int)(result->timing.dsp_us / 1000);
 
         if (debug) {
@@ -612,7 +784,6 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
         if (ei_impulse_error != EI_IMPULSE_OK) {
             return ei_impulse_error;
         }
-        delete[] matrix_ptrs;
         ei_impulse_error = run_postprocessing(handle, result);
         if (ei_impulse_error != EI_IMPULSE_OK) {
             return ei_impulse_error;
@@ -622,6 +793,153 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
     return ei_impulse_error;
 }
 
+/**
+ * @brief      DSP half of process_impulse_continuous, for callers that run the
+ *             network over the windows of several handles at once
+ *             (process_impulse_continuous_batch)
+ *
+ * @param      handle        struct with information about model and DSP
+ * @param      signal        Sample data (one slice)
+ * @param      result        Only timing.dsp_us is set
+ * @param[out] window_ready  Set once the feature rings hold a whole window
+ *
+ * @return     The ei impulse error.
+ */
+extern "C" EI_IMPULSE_ERROR process_impulse_continuous_features(ei_impulse_handle_t *handle,
+                                                                signal_t *signal,
+                                                                ei_impulse_result_t *result,
+                                                                bool *window_ready)
+{
+    if ((handle == nullptr) || (handle->impulse == nullptr) || (result == nullptr) || (signal == nullptr) ||
+        (window_ready == nullptr)) {
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+
+    memset(result, 0, sizeof(ei_impulse_result_t));
+    *window_ready = false;
+
+    ei_dsp_workspace_scope workspace_scope;
+
+    EI_IMPULSE_ERROR ei_impulse_error = process_impulse_continuous_dsp(handle, signal, result);
+    if (ei_impulse_error != EI_IMPULSE_OK) {
+        return ei_impulse_error;
+    }
+
+    *window_ready = handle->state.continuous_features_written >= handle->impulse->nn_input_frame_size;
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * @brief      Graph context for process_impulse_continuous_batch: one instance of
+ *             the impulse's network (tensor arena included) in its own memory
+ *
+ * @return     nullptr if it can't be allocated or the impulse can't be batched
+ */
+extern "C" void *process_impulse_batch_context_create(const ei_impulse_t *impulse)
+{
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1) && !EI_CLASSIFIER_DSP_ONLY
+    if (can_run_classifier_audio_quantized(impulse, impulse->learning_blocks[0]) != EI_IMPULSE_OK) {
+        return nullptr;
+    }
+    ei_learning_block_config_tflite_graph_t *block_config =
+        (ei_learning_block_config_tflite_graph_t *)impulse->learning_blocks[0].config;
+    EI_IMPULSE_ERROR error;
+    return ei_tflite_eon_context_create((const ei_config_tflite_eon_graph_t *)block_config->graph_config, &error);
+#else
+    return nullptr;
+#endif
+}
+
+extern "C" void process_impulse_batch_context_free(const ei_impulse_t *impulse, void *ctx)
+{
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1) && !EI_CLASSIFIER_DSP_ONLY
+    ei_learning_block_config_tflite_graph_t *block_config =
+        (ei_learning_block_config_tflite_graph_t *)impulse->learning_blocks[0].config;
+    ei_tflite_eon_context_free((const ei_config_tflite_eon_graph_t *)block_config->graph_config, ctx);
+#endif
+}
+
+/**
+ * @brief      Network half of process_impulse_continuous over the windows of several
+ *             handles of one impulse: the window of handles[i] goes into
+ *             graph_contexts[i] (process_impulse_batch_context_create), the graphs
+ *             are invoked together layer by layer and results[i] gets its result.
+ *             Only for impulses on the quantized MFE path of the EON compiler, and
+ *             only for handles whose window is ready (process_impulse_continuous_features).
+ *
+ * @return     The ei impulse error.
+ */
+extern "C" EI_IMPULSE_ERROR process_impulse_continuous_batch(ei_impulse_handle_t *const *handles,
+                                                             void *const *graph_contexts,
+                                                             size_t count,
+                                                             ei_impulse_result_t *results,
+                                                             bool debug = false)
+{
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1) && !EI_CLASSIFIER_DSP_ONLY
+    if ((handles == nullptr) || (graph_contexts == nullptr) || (results == nullptr)) {
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+    if (count == 0) {
+        return EI_IMPULSE_OK;
+    }
+
+    const ei_impulse_t *impulse = handles[0]->impulse;
+    if (can_run_classifier_audio_quantized(impulse, impulse->learning_blocks[0]) != EI_IMPULSE_OK) {
+        return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+    }
+    for (size_t ix = 0; ix < count; ix++) {
+        if (handles[ix]->impulse != impulse || graph_contexts[ix] == nullptr ||
+            handles[ix]->state.feature_rings == nullptr ||
+            handles[ix]->state.continuous_features_written < impulse->nn_input_frame_size) {
+            return EI_IMPULSE_INFERENCE_ERROR;
+        }
+        memset(&results[ix], 0, sizeof(ei_impulse_result_t));
+    }
+
+    for (size_t ix = 0; ix < count; ix++) {
+#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+        // owned by each handle, as in process_impulse_continuous
+        results[ix].classification = get_impulse_result_classification(handles[ix]);
+        if (results[ix].classification == nullptr) {
+            return EI_IMPULSE_ALLOC_FAILED;
+        }
+#endif
+        for (size_t label = 0; label < impulse->label_count; label++) {
+            results[ix].classification[label].label = impulse->categories[label];
+            results[ix].classification[label].value = 0.0f;
+        }
+    }
+
+    ei_dsp_workspace_scope workspace_scope;
+
+    ei_dsp_scratch_buffer<ei_feature_t> raw_results_buffer(count * impulse->learning_blocks_size);
+    ei_dsp_scratch_buffer<const ei_feature_ring_t *> rings_buffer(count);
+    if (raw_results_buffer.get() == nullptr || rings_buffer.get() == nullptr) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+    for (size_t ix = 0; ix < count; ix++) {
+        results[ix]._raw_outputs = raw_results_buffer.get() + ix * impulse->learning_blocks_size;
+        rings_buffer.get()[ix] = &((const ei_feature_ring_t *)handles[ix]->state.feature_rings)[0];
+    }
+
+    EI_IMPULSE_ERROR ei_impulse_error = run_nn_inference_audio_ring_quantized_batch(impulse, rings_buffer.get(),
+        graph_contexts, count, results, impulse->learning_blocks[0].config, debug);
+    if (ei_impulse_error != EI_IMPULSE_OK) {
+        return ei_impulse_error;
+    }
+
+    for (size_t ix = 0; ix < count; ix++) {
+        ei_impulse_error = run_postprocessing(handles[ix], &results[ix]);
+        if (ei_impulse_error != EI_IMPULSE_OK) {
+            return ei_impulse_error;
+        }
+    }
+    return EI_IMPULSE_OK;
+#else
+    return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+#endif
+}
+
 /**
  * Check if the current impulse could be used by 'run_classifier_image_quantized'
  */
@@ -660,6 +978,78 @@ __attribute__((unused)) static EI_IMPULSE_ERROR can_run_classifier_image_quantiz
     return EI_IMPULSE_OK;
 }
 
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1)
+/**
+ * Check if the current impulse could be used by 'run_classifier_audio_quantized':
+ * one MFE block (v3+) feeding one quantized EON graph, nothing in between
+ */
+__attribute__((unused)) static EI_IMPULSE_ERROR can_run_classifier_audio_quantized(const ei_impulse_t *impulse, ei_learning_block_t block_ptr) {
+
+    if (impulse->inferencing_engine != EI_CLASSIFIER_TFLITE) {
+        return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+    }
+
+    if (impulse->has_anomaly || impulse->learning_blocks_size != 1) {
+        return EI_IMPULSE_ONLY_SUPPORTED_FOR_IMAGES;
+    }
+
+#if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
+    // features are normalized after the DSP, needs the float matrix
+    return EI_IMPULSE_ONLY_SUPPORTED_FOR_IMAGES;
+#endif
+
+    if (block_ptr.infer_fn != run_nn_inference) {
+        return EI_IMPULSE_ONLY_SUPPORTED_FOR_IMAGES;
+    }
+
+    ei_learning_block_config_tflite_graph_t *block_config = (ei_learning_block_config_tflite_graph_t*)block_ptr.config;
+    if (block_config->quantized != 1) {
+        return EI_IMPULSE_ONLY_SUPPORTED_FOR_IMAGES;
+    }
+
+    if (impulse->dsp_blocks_size != 1 || impulse->dsp_blocks[0].extract_fn != extract_mfe_features ||
+        impulse->dsp_blocks[0].factory != nullptr ||
+        impulse->dsp_blocks[0].n_output_features != impulse->nn_input_frame_size) {
+        return EI_IMPULSE_ONLY_SUPPORTED_FOR_IMAGES;
+    }
+
+    // before v3 the features are normalized over the whole window (cmvnw)
+    ei_dsp_config_mfe_t *dsp_config = (ei_dsp_config_mfe_t*)impulse->dsp_blocks[0].config;
+    if (dsp_config->implementation_version < 3) {
+        return EI_IMPULSE_ONLY_SUPPORTED_FOR_IMAGES;
+    }
+
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * Audio counterpart of 'run_classifier_image_quantized': the MFE output is quantized
+ * straight into the input tensor, so the float feature matrix (nn_input_frame_size floats)
+ * is never allocated. This only works if 'can_run_classifier_audio_quantized' returns EI_IMPULSE_OK.
+ */
+extern "C" EI_IMPULSE_ERROR run_classifier_audio_quantized(
+    const ei_impulse_t *impulse,
+    signal_t *signal,
+    ei_impulse_result_t *result,
+    bool debug = false)
+{
+    return run_nn_inference_audio_quantized(impulse, signal, 0, result, impulse->learning_blocks[0].config, debug);
+}
+
+/**
+ * run_classifier_audio_quantized for process_impulse_continuous: the input tensor is
+ * filled from the MFE feature ring. Same conditions (can_run_classifier_audio_quantized).
+ */
+static EI_IMPULSE_ERROR run_classifier_audio_ring_quantized(
+    const ei_impulse_t *impulse,
+    const ei_feature_ring_t *ring,
+    ei_impulse_result_t *result,
+    bool debug)
+{
+    return run_nn_inference_audio_ring_quantized(impulse, ring, 0, result, impulse->learning_blocks[0].config, debug);
+}
+#endif // EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1)
+
 #if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TENSAIFLOW || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_DRPAI || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_ONNX_TIDL || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_ATON)
 
 /**
@@ -831,9 +1221,8 @@ will be documented by Doxygen. */
  */
 extern "C" void run_classifier_init(void)
 {
-
-    classifier_continuous_features_written = 0;
     ei_dsp_clear_continuous_audio_state();
+    clear_continuous_feature_rings(&ei_default_impulse);
     init_impulse(&ei_default_impulse);
     init_postprocessing(&ei_default_impulse);
 #if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
@@ -857,8 +1246,8 @@ extern "C" void run_classifier_init(void)
  */
 __attribute__((unused)) void run_classifier_init(ei_impulse_handle_t *handle)
 {
-    classifier_continuous_features_written = 0;
     ei_dsp_clear_continuous_audio_state();
+    clear_continuous_feature_rings(handle);
     init_impulse(handle);
     init_postprocessing(handle);
 #if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
@@ -880,6 +1269,11 @@ __attribute__((unused)) void run_classifier_init(ei_impulse_handle_t *handle)
 extern "C" void run_classifier_deinit(void)
 {
     deinit_postprocessing(&ei_default_impulse);
+#if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1)
+    ei_tflite_eon_release_graphs();
+#endif
+    ei_default_impulse.state.release_inference_contexts();
+    ei::speechpy::feature::release_mel_filterbanks();
 }
 
 __attribute__((unused)) void run_classifier_deinit(ei_impulse_handle_t *handle)
@@ -888,6 +1282,13 @@ __attribute__((unused)) void run_classifier_deinit(ei_impulse_handle_t *handle)
 #if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
     deinit_data_normalization(handle);
 #endif
+    // re-entrant builds: other handles may still be running, so only this handle's
+    // graph contexts go (run_classifier_deinit(void) releases the shared graphs)
+#if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1) && !EI_CLASSIFIER_REENTRANT
+    ei_tflite_eon_release_graphs();
+#endif
+    handle->state.release_inference_contexts();
+    ei::speechpy::feature::release_mel_filterbanks();
 }
 
 /**
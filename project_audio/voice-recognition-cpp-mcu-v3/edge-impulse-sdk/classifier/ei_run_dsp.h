@@ -85,9 +85,111 @@ float ei_dsp_image_buffer[EI_DSP_IMAGE_BUFFER_STATIC_SIZE];
 #endif
 
 // this is the frame we work on... allocate it statically so we share between invocations
-static float *ei_dsp_cont_current_frame = nullptr;
-static size_t ei_dsp_cont_current_frame_size = 0;
-static int ei_dsp_cont_current_frame_ix = 0;
+// (MFCC / spectrogram continuous mode; per thread with EI_CLASSIFIER_REENTRANT)
+static EIDSP_THREAD_LOCAL float *ei_dsp_cont_current_frame = nullptr;
+static EIDSP_THREAD_LOCAL size_t ei_dsp_cont_current_frame_size = 0;
+static EIDSP_THREAD_LOCAL int ei_dsp_cont_current_frame_ix = 0;
+
+/**
+ * Feature frames of continuous classification as a ring: `rows` frames of `cols`
+ * features in `buffer`, the oldest one (and the next one to be overwritten) at
+ * `head`. New frames are written in place instead of rolling the whole window.
+ * MFE rings can keep their frames normalized in `buffer_u8` instead (buffer is
+ * nullptr then): mfe_normalization only yields 1/256 steps, so one byte per
+ * feature holds them (see extract_mfe_ring_store_u8).
+ * With `normalized` set (MFE v3+, where the normalization is per feature) every
+ * frame is normalized once, as it enters the ring, rather than the whole window
+ * on every classification. uint8 rings are always normalized.
+ * The rings of an impulse belong to its handle (ei_impulse_state_t::feature_rings).
+ * An MFE ring with a `frame` keeps the partial frame that carries over to the next
+ * slice there (`frame_ix` samples of `frame_size`), so handles don't share it;
+ * without one the shared ei_dsp_cont_current_frame is used.
+ */
+typedef struct {
+    float *buffer;
+    uint8_t *buffer_u8;
+    size_t rows;
+    size_t cols;
+    size_t head;
+    bool normalized;
+    float *frame;
+    size_t frame_size;
+    int frame_ix;
+} ei_feature_ring_t;
+
+__attribute__((unused)) static void ei_feature_ring_advance(ei_feature_ring_t *ring, size_t rows) {
+    ring->head = (ring->head + rows) % ring->rows;
+}
+
+/**
+ * Copy `rows` frames to the head of the ring (at most two memcpy's)
+ */
+__attribute__((unused)) static void ei_feature_ring_push(ei_feature_ring_t *ring, const float *frames, size_t rows) {
+    size_t head_rows = ring->rows - ring->head;
+    if (head_rows > rows) {
+        head_rows = rows;
+    }
+    memcpy(ring->buffer + (ring->head * ring->cols), frames, head_rows * ring->cols * sizeof(float));
+    memcpy(ring->buffer, frames + (head_rows * ring->cols), (rows - head_rows) * ring->cols * sizeof(float));
+    ei_feature_ring_advance(ring, rows);
+}
+
+/**
+ * Compute `rows` frames straight into the head of the ring. extract_rows(first_row, matrix)
+ * fills matrix with frames [first_row, first_row + matrix->rows) of the slice; it runs
+ * twice when the frames wrap around the end of the ring.
+ */
+template <typename ExtractRows>
+static int ei_feature_ring_write(ei_feature_ring_t *ring, size_t rows, ExtractRows extract_rows) {
+    if (rows == 0) {
+        return EIDSP_OK;
+    }
+    if (rows > ring->rows) {
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+    }
+
+    size_t head_rows = ring->rows - ring->head;
+    if (head_rows > rows) {
+        head_rows = rows;
+    }
+
+    matrix_t head_part(head_rows, ring->cols, ring->buffer + (ring->head * ring->cols));
+    int ret = extract_rows(0, &head_part);
+    if (ret != EIDSP_OK) {
+        return ret;
+    }
+
+    if (rows > head_rows) {
+        matrix_t wrapped_part(rows - head_rows, ring->cols, ring->buffer);
+        ret = extract_rows(head_rows, &wrapped_part);
+        if (ret != EIDSP_OK) {
+            return ret;
+        }
+    }
+
+    ei_feature_ring_advance(ring, rows);
+    return EIDSP_OK;
+}
+
+/**
+ * Copy the frames of the ring, oldest first, to out (at most two memcpy's)
+ */
+__attribute__((unused)) static void ei_feature_ring_read(const ei_feature_ring_t *ring, float *out) {
+    if (ring->buffer_u8) {
+        const size_t size = ring->rows * ring->cols;
+        size_t src = ring->head * ring->cols;
+        for (size_t ix = 0; ix < size; ix++, src++) {
+            if (src == size) {
+                src = 0;
+            }
+            out[ix] = static_cast<float>(ring->buffer_u8[src]) / 256.0f;
+        }
+        return;
+    }
+    const size_t tail = (ring->rows - ring->head) * ring->cols;
+    memcpy(out, ring->buffer + (ring->head * ring->cols), tail * sizeof(float));
+    memcpy(out + tail, ring->buffer, ring->head * ring->cols * sizeof(float));
+}
 
 __attribute__((unused)) int extract_hr_features(
     signal_t *signal,
@@ -218,7 +320,7 @@ __attribute__((unused)) int extract_flatten_features(signal_t *signal, matrix_t
     return ret;
 }
 
-static class speechpy::processing::preemphasis *preemphasis;
+static EIDSP_THREAD_LOCAL class speechpy::processing::preemphasis *preemphasis;
 static int preemphasized_audio_signal_get_data(size_t offset, size_t length, float *out_ptr) {
     return preemphasis->get_data(offset, length, out_ptr);
 }
@@ -606,7 +708,7 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
 
     ei_dsp_config_spectrogram_t config = *((ei_dsp_config_spectrogram_t*)config_ptr);
 
-    static bool first_run = false;
+    static EIDSP_THREAD_LOCAL bool first_run = false;
 
     if (config.axes != 1) {
         EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
@@ -765,6 +867,161 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
 }
 
 
+#ifndef EI_DSP_MFE_INT16_CHUNK_FRAMES
+#define EI_DSP_MFE_INT16_CHUNK_FRAMES          10
+#endif
+
+/**
+ * MFE (implementation_version >= 3) of `rows` frames that start at sample `offset`,
+ * into output_rows (rows x num_filters). The samples these frames cover are
+ * preemphasized and scaled once, by preemphasize(start, span, buffer), into a
+ * scratch buffer, and the overlapping frames are read from it in place. This runs
+ * EI_DSP_MFE_INT16_CHUNK_FRAMES frames at a time to keep that buffer small.
+ */
+template<typename Preemphasize>
+static int extract_mfe_preemphasized_rows(size_t offset, size_t rows, matrix_t *output_rows, ei_dsp_config_mfe_t *config, const uint32_t frequency, Preemphasize preemphasize) {
+    // same frame geometry as speechpy::processing::stack_frames (version >= 2)
+    const size_t frame_sample_length = static_cast<size_t>(speechpy::processing::ceil_unless_very_close_to_floor(
+        static_cast<float>(frequency) * config->frame_length));
+    const size_t frame_stride = static_cast<size_t>(speechpy::processing::ceil_unless_very_close_to_floor(
+        static_cast<float>(frequency) * config->frame_stride));
+
+    for (size_t frame = 0; frame < rows; frame += EI_DSP_MFE_INT16_CHUNK_FRAMES) {
+        size_t frames = rows - frame;
+        if (frames > EI_DSP_MFE_INT16_CHUNK_FRAMES) {
+            frames = EI_DSP_MFE_INT16_CHUNK_FRAMES;
+        }
+        const size_t span = (frames - 1) * frame_stride + frame_sample_length;
+
+        ei_dsp_workspace_scope workspace_scope;
+
+        ei_dsp_scratch_buffer<float> preemphasized(span);
+        if (!preemphasized.get()) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        int ret = preemphasize(offset + frame * frame_stride, span, preemphasized.get());
+        if (ret != EIDSP_OK) {
+            EIDSP_ERR(ret);
+        }
+
+        matrix_t chunk_rows(frames, output_rows->cols, output_rows->get_row_ptr(frame));
+
+        ret = speechpy::feature::mfe(&chunk_rows, nullptr, preemphasized.get(), span,
+            frequency, config->frame_length, config->frame_stride, config->num_filters, config->fft_length,
+            config->low_frequency, config->high_frequency, config->implementation_version);
+        if (ret != EIDSP_OK) {
+            ei_printf("ERR: MFE failed (%d)\n", ret);
+            EIDSP_ERR(ret);
+        }
+    }
+
+    return EIDSP_OK;
+}
+
+/**
+ * extract_mfe_preemphasized_rows of an int16 signal (signal_t::int16_data), converted,
+ * preemphasized and scaled by processing::preemphasis_int16 against the whole signal.
+ */
+__attribute__((unused)) static int extract_mfe_int16_rows(const EIDSP_i16 *samples, size_t samples_size, size_t offset, size_t rows, matrix_t *output_rows, ei_dsp_config_mfe_t *config, const uint32_t frequency) {
+    return extract_mfe_preemphasized_rows(offset, rows, output_rows, config, frequency,
+        [&](size_t start, size_t span, float *out) {
+            return speechpy::processing::preemphasis_int16(samples, samples_size, start, span, 0.98f, true, out);
+        });
+}
+
+/**
+ * extract_mfe_preemphasized_rows of a float signal read through get_data
+ * (processing::preemphasis_signal), without a preemphasis object or stacked frames.
+ */
+__attribute__((unused)) static int extract_mfe_signal_rows(signal_t *signal, size_t offset, size_t rows, matrix_t *output_rows, ei_dsp_config_mfe_t *config, const uint32_t frequency) {
+    return extract_mfe_preemphasized_rows(offset, rows, output_rows, config, frequency,
+        [&](size_t start, size_t span, float *out) {
+            return speechpy::processing::preemphasis_signal(signal, start, span, 0.98f, true, out);
+        });
+}
+
+/**
+ * Fixed-point MFE (config->fixed_point, implementation_version >= 3) of `rows` frames
+ * that start at sample `offset` of the raw signal, into output_rows, already normalized
+ * (see speechpy::feature::mfe_q15). Int16 audio (signal_t::int16_data) is read in place,
+ * otherwise each chunk of EI_DSP_MFE_INT16_CHUNK_FRAMES frames is read through get_data
+ * and saturated to int16.
+ */
+__attribute__((unused)) static int extract_mfe_q15_rows(signal_t *signal, size_t offset, size_t rows, matrix_t *output_rows, ei_dsp_config_mfe_t *config, const uint32_t frequency) {
+    // same frame geometry as speechpy::processing::stack_frames (version >= 2)
+    const size_t frame_sample_length = static_cast<size_t>(speechpy::processing::ceil_unless_very_close_to_floor(
+        static_cast<float>(frequency) * config->frame_length));
+    const size_t frame_stride = static_cast<size_t>(speechpy::processing::ceil_unless_very_close_to_floor(
+        static_cast<float>(frequency) * config->frame_stride));
+
+    for (size_t frame = 0; frame < rows; frame += EI_DSP_MFE_INT16_CHUNK_FRAMES) {
+        size_t frames = rows - frame;
+        if (frames > EI_DSP_MFE_INT16_CHUNK_FRAMES) {
+            frames = EI_DSP_MFE_INT16_CHUNK_FRAMES;
+        }
+        const size_t start = offset + frame * frame_stride;
+        const size_t span = (frames - 1) * frame_stride + frame_sample_length;
+
+        if (start + span > signal->total_length) {
+            EIDSP_ERR(EIDSP_OUT_OF_BOUNDS);
+        }
+
+        ei_dsp_workspace_scope workspace_scope;
+
+        // the preemphasis of the first sample uses the one before it (the last one at the start)
+        const size_t previous_ix = start > 0 ? start - 1 : signal->total_length - 1;
+
+        const EIDSP_i16 *samples;
+        EIDSP_i16 previous_sample;
+        ei_dsp_scratch_buffer<EIDSP_i16> converted(signal->int16_data ? 0 : span);
+
+        if (signal->int16_data) {
+            samples = signal->int16_data + start;
+            previous_sample = signal->int16_data[previous_ix];
+        }
+        else {
+            ei_dsp_scratch_buffer<float> raw(span);
+            if (!raw.get() || !converted.get()) {
+                EIDSP_ERR(EIDSP_OUT_OF_MEM);
+            }
+
+            float previous;
+            int ret = signal->get_data(previous_ix, 1, &previous);
+            if (ret == EIDSP_OK) {
+                ret = signal->get_data(start, span, raw.get());
+            }
+            if (ret != EIDSP_OK) {
+                EIDSP_ERR(ret);
+            }
+
+            auto to_int16 = [](float v) -> EIDSP_i16 {
+                if (v > 32767.0f) return 32767;
+                if (v < -32768.0f) return -32768;
+                return static_cast<EIDSP_i16>(lrintf(v));
+            };
+
+            for (size_t ix = 0; ix < span; ix++) {
+                converted.get()[ix] = to_int16(raw.get()[ix]);
+            }
+            samples = converted.get();
+            previous_sample = to_int16(previous);
+        }
+
+        matrix_t chunk_rows(frames, output_rows->cols, output_rows->get_row_ptr(frame));
+
+        int ret = speechpy::feature::mfe_q15(&chunk_rows, samples, span, previous_sample,
+            frequency, config->frame_length, config->frame_stride, config->num_filters, config->fft_length,
+            config->low_frequency, config->high_frequency, config->noise_floor_db, config->implementation_version);
+        if (ret != EIDSP_OK) {
+            ei_printf("ERR: MFE failed (%d)\n", ret);
+            EIDSP_ERR(ret);
+        }
+    }
+
+    return EIDSP_OK;
+}
+
 __attribute__((unused)) int extract_mfe_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency) {
     ei_dsp_config_mfe_t config = *((ei_dsp_config_mfe_t*)config_ptr);
 
@@ -782,36 +1039,20 @@ __attribute__((unused)) int extract_mfe_features(signal_t *signal, matrix_t *out
 
     const uint32_t frequency = static_cast<uint32_t>(sampling_frequency);
 
-    signal_t preemphasized_audio_signal;
-
-    // before version 3 we did not have preemphasis
-    if (config.implementation_version < 3) {
-        preemphasis = nullptr;
-
-        preemphasized_audio_signal.total_length = signal->total_length;
-        preemphasized_audio_signal.get_data = signal->get_data;
-    }
-    else {
-        // preemphasis class to preprocess the audio...
-        class speechpy::processing::preemphasis *pre = new class speechpy::processing::preemphasis(signal, 1, 0.98f, true);
-        preemphasis = pre;
-
-        preemphasized_audio_signal.total_length = signal->total_length;
-        preemphasized_audio_signal.get_data = &preemphasized_audio_signal_get_data;
-    }
+    // int16 audio is read directly, see extract_mfe_int16_rows
+    const EIDSP_i16 *int16_data = (config.implementation_version >= 3) ? signal->int16_data : nullptr;
+    // integer pipeline, see extract_mfe_q15_rows
+    const bool fixed_point = config.fixed_point && config.implementation_version >= 3;
 
     // calculate the size of the MFE matrix
     matrix_size_t out_matrix_size =
         speechpy::feature::calculate_mfe_buffer_size(
-            preemphasized_audio_signal.total_length, frequency, config.frame_length, config.frame_stride, config.num_filters,
+            signal->total_length, frequency, config.frame_length, config.frame_stride, config.num_filters,
             config.implementation_version);
     /* Only throw size mismatch error calculated buffer doesn't fit for continuous inferencing */
     if (out_matrix_size.rows * out_matrix_size.cols > output_matrix->rows * output_matrix->cols) {
         ei_printf("out_matrix = %dx%d\n", (int)output_matrix->rows, (int)output_matrix->cols);
         ei_printf("calculated size = %dx%d\n", (int)out_matrix_size.rows, (int)out_matrix_size.cols);
-        if (preemphasis) {
-            delete preemphasis;
-        }
         EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
     }
 
@@ -823,19 +1064,21 @@ __attribute__((unused)) int extract_mfe_features(signal_t *signal, matrix_t *out
     // There's a subtle issue with cmvn and v2, not worth tracking down
     // So for v2 and v1, we'll just use the old code
     // (the new mfe does away with the intermediate filterbank matrix)
-    if (config.implementation_version > 2) {
-        ret = speechpy::feature::mfe(output_matrix, nullptr, &preemphasized_audio_signal,
-            frequency, config.frame_length, config.frame_stride, config.num_filters, config.fft_length,
-            config.low_frequency, config.high_frequency, config.implementation_version);
+    if (fixed_point) {
+        ret = extract_mfe_q15_rows(signal, 0, out_matrix_size.rows, output_matrix, &config, frequency);
+    } else if (int16_data) {
+        ret = extract_mfe_int16_rows(int16_data, signal->total_length, 0, out_matrix_size.rows, output_matrix,
+            &config, frequency);
+    } else if (config.implementation_version > 2) {
+        // preemphasized per chunk, see extract_mfe_signal_rows
+        ret = extract_mfe_signal_rows(signal, 0, out_matrix_size.rows, output_matrix, &config, frequency);
     } else {
-        ret = speechpy::feature::mfe_v3(output_matrix, nullptr, &preemphasized_audio_signal,
+        // before version 3 we did not have preemphasis
+        ret = speechpy::feature::mfe_v3(output_matrix, nullptr, signal,
             frequency, config.frame_length, config.frame_stride, config.num_filters, config.fft_length,
             config.low_frequency, config.high_frequency, config.implementation_version);
     }
 
-    if (preemphasis) {
-        delete preemphasis;
-    }
     if (ret != EIDSP_OK) {
         ei_printf("ERR: MFE failed (%d)\n", ret);
         EIDSP_ERR(ret);
@@ -849,8 +1092,8 @@ __attribute__((unused)) int extract_mfe_features(signal_t *signal, matrix_t *out
             EIDSP_ERR(ret);
         }
     }
-    else {
-        // normalization
+    else if (!fixed_point) {
+        // normalization (the fixed-point MFE is normalized already)
         ret = speechpy::processing::mfe_normalization(output_matrix, config.noise_floor_db);
         if (ret != EIDSP_OK) {
             ei_printf("ERR: normalization failed (%d)\n", ret);
@@ -864,9 +1107,283 @@ __attribute__((unused)) int extract_mfe_features(signal_t *signal, matrix_t *out
     return EIDSP_OK;
 }
 
-__attribute__((unused)) static int extract_mfe_run_slice(signal_t *signal, matrix_t *output_matrix, ei_dsp_config_mfe_t *config, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+#if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1
+
+#ifndef EI_DSP_MFE_QUANTIZED_CHUNK_FRAMES
+#define EI_DSP_MFE_QUANTIZED_CHUNK_FRAMES      10
+#endif
+
+/**
+ * Same features as extract_mfe_features, but quantized straight into output_matrix
+ * (normally the NN input tensor) with the tensor's scale and zero point.
+ * The MFE runs EI_DSP_MFE_QUANTIZED_CHUNK_FRAMES frames at a time, so only that many
+ * float rows are allocated instead of the whole feature matrix, and float audio is
+ * preemphasized per chunk (extract_mfe_signal_rows), so nothing is allocated per call
+ * beyond the workspace.
+ * Only for implementation_version >= 3, older versions normalize over the whole
+ * window (cmvnw).
+ */
+__attribute__((unused)) int extract_mfe_features_quantized(signal_t *signal, matrix_i8_t *output_matrix, void *config_ptr, float scale, float zero_point, const float sampling_frequency) {
+    ei_dsp_config_mfe_t config = *((ei_dsp_config_mfe_t*)config_ptr);
+
+    if (config.axes != 1) {
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+    }
+
+    if (signal->total_length == 0) {
+        EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+    }
+
+    if ((config.implementation_version < 3) || (config.implementation_version > 4)) {
+        EIDSP_ERR(EIDSP_BLOCK_VERSION_INCORRECT);
+    }
+
+    const uint32_t frequency = static_cast<uint32_t>(sampling_frequency);
+
+    matrix_size_t out_matrix_size =
+        speechpy::feature::calculate_mfe_buffer_size(
+            signal->total_length, frequency, config.frame_length, config.frame_stride, config.num_filters,
+            config.implementation_version);
+    if (out_matrix_size.rows * out_matrix_size.cols > output_matrix->rows * output_matrix->cols) {
+        ei_printf("out_matrix = %dx%d\n", (int)output_matrix->rows, (int)output_matrix->cols);
+        ei_printf("calculated size = %dx%d\n", (int)out_matrix_size.rows, (int)out_matrix_size.cols);
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+    }
+
+    // same frame geometry as speechpy::processing::stack_frames (version >= 2)
+    const size_t frame_stride = static_cast<size_t>(speechpy::processing::ceil_unless_very_close_to_floor(
+        static_cast<float>(frequency) * config.frame_stride));
+
+    int8_t table[257];
+    speechpy::processing::mfe_quantization_table(table, scale, static_cast<int32_t>(zero_point));
+
+    ei_dsp_workspace_scope workspace_scope;
+
+    EI_DSP_SCRATCH_MATRIX(chunk, EI_DSP_MFE_QUANTIZED_CHUNK_FRAMES, config.num_filters);
+
+    // int16 audio is read directly, see extract_mfe_int16_rows, float audio
+    // through get_data, see extract_mfe_signal_rows
+    const EIDSP_i16 *int16_data = signal->int16_data;
+    // integer pipeline, see extract_mfe_q15_rows
+    const bool fixed_point = config.fixed_point != 0;
+
+    int ret = EIDSP_OK;
+
+    for (size_t frame = 0; frame < out_matrix_size.rows; frame += EI_DSP_MFE_QUANTIZED_CHUNK_FRAMES) {
+        size_t frames = out_matrix_size.rows - frame;
+        if (frames > EI_DSP_MFE_QUANTIZED_CHUNK_FRAMES) {
+            frames = EI_DSP_MFE_QUANTIZED_CHUNK_FRAMES;
+        }
+
+        // the frames of this chunk, preemphasized against the whole signal
+        size_t range_start = frame * frame_stride;
+
+        matrix_t chunk_rows(frames, config.num_filters, chunk.buffer);
+
+        if (fixed_point) {
+            ret = extract_mfe_q15_rows(signal, range_start, frames, &chunk_rows, &config, frequency);
+            if (ret != EIDSP_OK) {
+                break;
+            }
+
+            ret = speechpy::processing::mfe_quantize_normalized(&chunk_rows, table,
+                output_matrix->buffer + (frame * config.num_filters));
+            if (ret != EIDSP_OK) {
+                break;
+            }
+            continue;
+        }
+
+        if (int16_data) {
+            ret = extract_mfe_int16_rows(int16_data, signal->total_length, range_start, frames, &chunk_rows,
+                &config, frequency);
+        }
+        else {
+            ret = extract_mfe_signal_rows(signal, range_start, frames, &chunk_rows, &config, frequency);
+        }
+        if (ret != EIDSP_OK) {
+            break;
+        }
+
+        ret = speechpy::processing::mfe_normalization_quantized(&chunk_rows, config.noise_floor_db, table,
+            output_matrix->buffer + (frame * config.num_filters));
+        if (ret != EIDSP_OK) {
+            ei_printf("ERR: normalization failed (%d)\n", ret);
+            break;
+        }
+    }
+
+    if (ret != EIDSP_OK) {
+        EIDSP_ERR(ret);
+    }
+
+    output_matrix->cols = out_matrix_size.rows * out_matrix_size.cols;
+    output_matrix->rows = 1;
+
+    return EIDSP_OK;
+}
+
+/**
+ * Continuous counterpart of extract_mfe_features_quantized: the frames of an MFE
+ * feature ring (extract_mfe_per_slice_features_ring), oldest first, are normalized
+ * (unless the ring stores uint8) and quantized straight into output_matrix, one pass
+ * per contiguous part of the ring.
+ * Only for implementation_version >= 3.
+ */
+__attribute__((unused)) int extract_mfe_ring_quantized(const ei_feature_ring_t *ring, matrix_i8_t *output_matrix, void *config_ptr, float scale, float zero_point) {
+    ei_dsp_config_mfe_t *config = (ei_dsp_config_mfe_t*)config_ptr;
+
+    if ((config->implementation_version < 3) || (config->implementation_version > 4)) {
+        EIDSP_ERR(EIDSP_BLOCK_VERSION_INCORRECT);
+    }
+
+    if (ring->rows * ring->cols > output_matrix->rows * output_matrix->cols) {
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+    }
+
+    int8_t table[257];
+    speechpy::processing::mfe_quantization_table(table, scale, static_cast<int32_t>(zero_point));
+
+    output_matrix->cols = ring->rows * ring->cols;
+    output_matrix->rows = 1;
+
+    if (ring->buffer_u8) {
+        // normalized already, one table lookup per feature
+        const size_t tail = (ring->rows - ring->head) * ring->cols;
+        speechpy::processing::mfe_quantize_u8(ring->buffer_u8 + (ring->head * ring->cols), tail, table,
+            output_matrix->buffer);
+        speechpy::processing::mfe_quantize_u8(ring->buffer_u8, ring->head * ring->cols, table,
+            output_matrix->buffer + tail);
+        return EIDSP_OK;
+    }
+
+    const matrix_t oldest(ring->rows - ring->head, ring->cols, ring->buffer + (ring->head * ring->cols));
+    const matrix_t newest(ring->head, ring->cols, ring->buffer);
+    const matrix_t *parts[2] = { &oldest, &newest };
+
+    int8_t *out = output_matrix->buffer;
+    for (size_t ix = 0; ix < 2; ix++) {
+        int ret;
+        if (config->fixed_point || ring->normalized) {
+            // extract_mfe_run_slice_q15 writes normalized features
+            ret = speechpy::processing::mfe_quantize_normalized(parts[ix], table, out);
+        }
+        else {
+            ret = speechpy::processing::mfe_normalization_quantized(parts[ix], config->noise_floor_db, table, out);
+        }
+        if (ret != EIDSP_OK) {
+            ei_printf("ERR: normalization failed (%d)\n", ret);
+            EIDSP_ERR(ret);
+        }
+        out += parts[ix]->rows * parts[ix]->cols;
+    }
+
+    return EIDSP_OK;
+}
+
+#endif // EI_CLASSIFIER_QUANTIZATION_ENABLED == 1
+
+/**
+ * Normalize MFE frames (normalized already with fixed_point) to the head of a uint8
+ * feature ring, one pass per contiguous part of the ring
+ */
+__attribute__((unused)) static int extract_mfe_ring_store_u8(ei_feature_ring_t *ring, const matrix_t *frames, ei_dsp_config_mfe_t *config) {
+    if (frames->rows > ring->rows || (frames->rows > 0 && frames->cols != ring->cols)) {
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+    }
+
+    size_t head_rows = ring->rows - ring->head;
+    if (head_rows > frames->rows) {
+        head_rows = frames->rows;
+    }
+
+    const matrix_t head_part(head_rows, ring->cols, frames->buffer);
+    const matrix_t wrapped_part(frames->rows - head_rows, ring->cols, frames->buffer + (head_rows * ring->cols));
+    const matrix_t *parts[2] = { &head_part, &wrapped_part };
+    uint8_t *out[2] = { ring->buffer_u8 + (ring->head * ring->cols), ring->buffer_u8 };
+
+    for (size_t ix = 0; ix < 2; ix++) {
+        int ret;
+        if (config->fixed_point) {
+            ret = speechpy::processing::mfe_normalized_to_u8(parts[ix], out[ix]);
+        }
+        else {
+            ret = speechpy::processing::mfe_normalization_u8(parts[ix], config->noise_floor_db, out[ix]);
+        }
+        if (ret != EIDSP_OK) {
+            ei_printf("ERR: normalization failed (%d)\n", ret);
+            EIDSP_ERR(ret);
+        }
+    }
+
+    ei_feature_ring_advance(ring, frames->rows);
+    return EIDSP_OK;
+}
+
+/**
+ * Normalize frames that were just written to a normalized float MFE ring
+ * (the fixed-point MFE writes them normalized already)
+ */
+__attribute__((unused)) static int extract_mfe_ring_normalize(const ei_feature_ring_t *ring, matrix_t *frames, ei_dsp_config_mfe_t *config) {
+    if (!ring->normalized || config->fixed_point) {
+        return EIDSP_OK;
+    }
+
+    int ret = speechpy::processing::mfe_normalization(frames, config->noise_floor_db);
+    if (ret != EIDSP_OK) {
+        ei_printf("ERR: normalization failed (%d)\n", ret);
+        EIDSP_ERR(ret);
+    }
+    return EIDSP_OK;
+}
+
+/**
+ * ei_feature_ring_write for MFE rings: the frames are normalized in place on a
+ * normalized ring; the frames of a uint8 ring are computed in scratch memory,
+ * EI_DSP_MFE_INT16_CHUNK_FRAMES at a time, and stored with extract_mfe_ring_store_u8
+ */
+template <typename ExtractRows>
+static int extract_mfe_ring_write(ei_feature_ring_t *ring, size_t rows, ei_dsp_config_mfe_t *config, ExtractRows extract_rows) {
+    if (!ring->buffer_u8) {
+        return ei_feature_ring_write(ring, rows, [&](size_t first_row, matrix_t *part) {
+            int ret = extract_rows(first_row, part);
+            if (ret != EIDSP_OK) {
+                return ret;
+            }
+            return extract_mfe_ring_normalize(ring, part, config);
+        });
+    }
+    if (rows == 0) {
+        return EIDSP_OK;
+    }
+    if (rows > ring->rows) {
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+    }
+
+    const size_t chunk_rows = rows < EI_DSP_MFE_INT16_CHUNK_FRAMES ? rows : EI_DSP_MFE_INT16_CHUNK_FRAMES;
+    EI_DSP_SCRATCH_MATRIX(chunk, chunk_rows, ring->cols);
+
+    for (size_t first_row = 0; first_row < rows; first_row += chunk_rows) {
+        chunk.rows = (rows - first_row) < chunk_rows ? (rows - first_row) : chunk_rows;
+        int ret = extract_rows(first_row, &chunk);
+        if (ret != EIDSP_OK) {
+            return ret;
+        }
+        ret = extract_mfe_ring_store_u8(ring, &chunk, config);
+        if (ret != EIDSP_OK) {
+            return ret;
+        }
+    }
+
+    return EIDSP_OK;
+}
+
+__attribute__((unused)) static int extract_mfe_run_slice(signal_t *signal, ei_feature_ring_t *ring, ei_dsp_config_mfe_t *config, const float sampling_frequency, matrix_size_t *matrix_size_out) {
     uint32_t frequency = (uint32_t)sampling_frequency;
 
+    // the MFE scratch is handed back before the next run over this slice
+    ei_dsp_workspace_scope workspace_scope;
+
     int x;
 
     // calculate the size of the spectrogram matrix
@@ -875,19 +1392,25 @@ __attribute__((unused)) static int extract_mfe_run_slice(signal_t *signal, matri
             signal->total_length, frequency, config->frame_length, config->frame_stride, config->num_filters,
             config->implementation_version);
 
-    // we roll the output matrix back so we have room at the end...
-    x = numpy::roll(output_matrix->buffer, output_matrix->rows * output_matrix->cols,
-        -(out_matrix_size.rows * out_matrix_size.cols));
-    if (x != EIDSP_OK) {
-        EIDSP_ERR(x);
+    if (out_matrix_size.rows > ring->rows || (out_matrix_size.rows > 0 && out_matrix_size.cols != ring->cols)) {
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
     }
 
-    // slice in the output matrix to write to
-    // the offset in the classification matrix here is always at the end
-    size_t output_matrix_offset = (output_matrix->rows * output_matrix->cols) -
-        (out_matrix_size.rows * out_matrix_size.cols);
+    if (out_matrix_size.rows == 0) {
+        return EIDSP_OK;
+    }
 
-    matrix_t output_matrix_slice(out_matrix_size.rows, out_matrix_size.cols, output_matrix->buffer + output_matrix_offset);
+    // the frames go straight to the head of the ring, unless they wrap around its end
+    // or the ring stores uint8: then they are computed in scratch memory and copied
+    // (normalized) in two parts
+    const bool wraps = ring->buffer_u8 || (ring->head + out_matrix_size.rows > ring->rows);
+    ei_dsp_scratch_buffer<float> wrapped_buffer(wraps ? out_matrix_size.rows * out_matrix_size.cols : 0);
+    if (wraps && !wrapped_buffer.get()) {
+        EIDSP_ERR(EIDSP_OUT_OF_MEM);
+    }
+
+    matrix_t output_matrix_slice(out_matrix_size.rows, out_matrix_size.cols,
+        wraps ? wrapped_buffer.get() : ring->buffer + (ring->head * ring->cols));
 
     // and run the MFE extraction
     // This probably seems incorrect, but the mfe func can actually handle all versions
@@ -908,6 +1431,22 @@ __attribute__((unused)) static int extract_mfe_run_slice(signal_t *signal, matri
         EIDSP_ERR(x);
     }
 
+    if (ring->buffer_u8) {
+        x = extract_mfe_ring_store_u8(ring, &output_matrix_slice, config);
+    }
+    else {
+        x = extract_mfe_ring_normalize(ring, &output_matrix_slice, config);
+        if (wraps) {
+            ei_feature_ring_push(ring, output_matrix_slice.buffer, out_matrix_size.rows);
+        }
+        else {
+            ei_feature_ring_advance(ring, out_matrix_size.rows);
+        }
+    }
+    if (x != EIDSP_OK) {
+        EIDSP_ERR(x);
+    }
+
     matrix_size_out->rows += out_matrix_size.rows;
     if (out_matrix_size.cols > 0) {
         matrix_size_out->cols = out_matrix_size.cols;
@@ -916,7 +1455,121 @@ __attribute__((unused)) static int extract_mfe_run_slice(signal_t *signal, matri
     return EIDSP_OK;
 }
 
-__attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+/**
+ * extract_mfe_run_slice over [offset, samples_size) of an int16 signal, see extract_mfe_int16_rows
+ */
+__attribute__((unused)) static int extract_mfe_run_slice_int16(const EIDSP_i16 *samples, size_t samples_size, size_t offset, ei_feature_ring_t *ring, ei_dsp_config_mfe_t *config, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+    uint32_t frequency = (uint32_t)sampling_frequency;
+
+    // the MFE scratch is handed back before the next run over this slice
+    ei_dsp_workspace_scope workspace_scope;
+
+    int x;
+
+    // calculate the size of the spectrogram matrix
+    matrix_size_t out_matrix_size =
+        speechpy::feature::calculate_mfe_buffer_size(
+            samples_size - offset, frequency, config->frame_length, config->frame_stride, config->num_filters,
+            config->implementation_version);
+
+    // rows that wrap around the end of the ring start first_row frames into the slice
+    const size_t frame_stride = static_cast<size_t>(speechpy::processing::ceil_unless_very_close_to_floor(
+        static_cast<float>(frequency) * config->frame_stride));
+
+    x = extract_mfe_ring_write(ring, out_matrix_size.rows, config, [&](size_t first_row, matrix_t *rows) {
+        return extract_mfe_int16_rows(samples, samples_size, offset + first_row * frame_stride, rows->rows, rows,
+            config, frequency);
+    });
+    if (x != EIDSP_OK) {
+        EIDSP_ERR(x);
+    }
+
+    matrix_size_out->rows += out_matrix_size.rows;
+    if (out_matrix_size.cols > 0) {
+        matrix_size_out->cols = out_matrix_size.cols;
+    }
+
+    return EIDSP_OK;
+}
+
+/**
+ * extract_mfe_run_slice over [offset, total_length) of the raw signal with the
+ * fixed-point MFE, see extract_mfe_q15_rows. The features are normalized already.
+ */
+__attribute__((unused)) static int extract_mfe_run_slice_q15(signal_t *signal, size_t offset, ei_feature_ring_t *ring, ei_dsp_config_mfe_t *config, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+    uint32_t frequency = (uint32_t)sampling_frequency;
+
+    // the MFE scratch is handed back before the next run over this slice
+    ei_dsp_workspace_scope workspace_scope;
+
+    int x;
+
+    // calculate the size of the spectrogram matrix
+    matrix_size_t out_matrix_size =
+        speechpy::feature::calculate_mfe_buffer_size(
+            signal->total_length - offset, frequency, config->frame_length, config->frame_stride, config->num_filters,
+            config->implementation_version);
+
+    // rows that wrap around the end of the ring start first_row frames into the slice
+    const size_t frame_stride = static_cast<size_t>(speechpy::processing::ceil_unless_very_close_to_floor(
+        static_cast<float>(frequency) * config->frame_stride));
+
+    x = extract_mfe_ring_write(ring, out_matrix_size.rows, config, [&](size_t first_row, matrix_t *rows) {
+        return extract_mfe_q15_rows(signal, offset + first_row * frame_stride, rows->rows, rows, config, frequency);
+    });
+    if (x != EIDSP_OK) {
+        EIDSP_ERR(x);
+    }
+
+    matrix_size_out->rows += out_matrix_size.rows;
+    if (out_matrix_size.cols > 0) {
+        matrix_size_out->cols = out_matrix_size.cols;
+    }
+
+    return EIDSP_OK;
+}
+
+/**
+ * Fixed-point MFE of the frame carried over between slices (ei_dsp_cont_current_frame,
+ * already preemphasized), written to the ring like extract_mfe_run_slice
+ */
+__attribute__((unused)) static int extract_mfe_run_frame_q15(const float *frame, size_t frame_length, ei_feature_ring_t *ring, ei_dsp_config_mfe_t *config, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+    uint32_t frequency = (uint32_t)sampling_frequency;
+
+    ei_dsp_workspace_scope workspace_scope;
+
+    int x;
+
+    matrix_size_t out_matrix_size =
+        speechpy::feature::calculate_mfe_buffer_size(
+            frame_length, frequency, config->frame_length, config->frame_stride, config->num_filters,
+            config->implementation_version);
+
+
+    x = extract_mfe_ring_write(ring, out_matrix_size.rows, config, [&](size_t first_row, matrix_t *rows) {
+        (void)first_row; // a single frame never wraps
+        return speechpy::feature::mfe_q15(rows, frame, frame_length,
+            frequency, config->frame_length, config->frame_stride, config->num_filters, config->fft_length,
+            config->low_frequency, config->high_frequency, config->noise_floor_db, config->implementation_version);
+    });
+    if (x != EIDSP_OK) {
+        ei_printf("ERR: MFE failed (%d)\n", x);
+        EIDSP_ERR(x);
+    }
+
+    matrix_size_out->rows += out_matrix_size.rows;
+    if (out_matrix_size.cols > 0) {
+        matrix_size_out->cols = out_matrix_size.cols;
+    }
+
+    return EIDSP_OK;
+}
+
+/**
+ * Continuous MFE of one slice: the new frames go to the head of the feature ring
+ * (see ei_feature_ring_t), matrix_size_out counts them
+ */
+__attribute__((unused)) int extract_mfe_per_slice_features_ring(signal_t *signal, ei_feature_ring_t *ring, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out) {
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
     ei_printf("ERR: Continuous audio is not supported when EI_C_LINKAGE is defined\n");
     EIDSP_ERR(EIDSP_NOT_SUPPORTED);
@@ -924,10 +1577,13 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
 
     ei_dsp_config_mfe_t config = *((ei_dsp_config_mfe_t*)config_ptr);
 
+    // everything allocated below is scratch for this slice only
+    ei_dsp_workspace_scope workspace_scope;
+
     // signal is already the right size,
     // output matrix is not the right size, but we can start writing at offset 0 and then it's OK too
 
-    static bool first_run = false;
+    static EIDSP_THREAD_LOCAL bool first_run = false;
 
     if (config.axes != 1) {
         EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
@@ -957,8 +1613,13 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     // ok all setup, let's construct the signal (with preemphasis for impl version >3)
     signal_t preemphasized_audio_signal;
 
+    // int16 audio is read directly (preemphasis_int16 / extract_mfe_run_slice_int16)
+    const EIDSP_i16 *int16_data = (config.implementation_version >= 3) ? signal->int16_data : nullptr;
+    // integer pipeline (extract_mfe_run_frame_q15 / extract_mfe_run_slice_q15)
+    const bool fixed_point = config.fixed_point && config.implementation_version >= 3;
+
    // before version 3 we did not have preemphasis
-    if (config.implementation_version < 3) {
+    if (config.implementation_version < 3 || int16_data) {
         preemphasis = nullptr;
         preemphasized_audio_signal.total_length = signal->total_length;
         preemphasized_audio_signal.get_data = signal->get_data;
@@ -1000,22 +1661,36 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
 
     int x;
 
+    // the partial frame carried over to the next slice: the ring's own, or the shared one
+    float *&current_frame = ring->frame ? ring->frame : ei_dsp_cont_current_frame;
+    size_t &current_frame_size = ring->frame ? ring->frame_size : ei_dsp_cont_current_frame_size;
+    int &current_frame_ix = ring->frame ? ring->frame_ix : ei_dsp_cont_current_frame_ix;
+
+    if (ring->frame && ring->frame_size != frame_length_values) {
+        ei_printf("ERR: feature ring frame (%d) does not match frame_length (%d)\n",
+            (int)ring->frame_size, (int)frame_length_values);
+        if (preemphasis) {
+            delete preemphasis;
+        }
+        EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+    }
+
     // have current frame, but wrong size? then free
-    if (ei_dsp_cont_current_frame && ei_dsp_cont_current_frame_size != frame_length_values) {
-        ei_free(ei_dsp_cont_current_frame);
-        ei_dsp_cont_current_frame = nullptr;
+    if (current_frame && current_frame_size != frame_length_values) {
+        ei_free(current_frame);
+        current_frame = nullptr;
     }
 
-    if (!ei_dsp_cont_current_frame) {
-        ei_dsp_cont_current_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
-        if (!ei_dsp_cont_current_frame) {
+    if (!current_frame) {
+        current_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
+        if (!current_frame) {
             if (preemphasis) {
                 delete preemphasis;
             }
             EIDSP_ERR(EIDSP_OUT_OF_MEM);
         }
-        ei_dsp_cont_current_frame_size = frame_length_values;
-        ei_dsp_cont_current_frame_ix = 0;
+        current_frame_size = frame_length_values;
+        current_frame_ix = 0;
     }
 
     matrix_size_out->rows = 0;
@@ -1024,7 +1699,7 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     // this is the offset in the signal from which we'll work
     size_t offset_in_signal = 0;
 
-    if (ei_dsp_cont_current_frame_ix > (int)ei_dsp_cont_current_frame_size) {
+    if (current_frame_ix > (int)current_frame_size) {
         ei_printf("ERR: ei_dsp_cont_current_frame_ix is larger than frame size\n");
         if (preemphasis) {
             delete preemphasis;
@@ -1033,10 +1708,17 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     }
 
     // if we still have some code from previous run
-    while (ei_dsp_cont_current_frame_ix > 0) {
-        // then from the current frame we need to read `frame_length_values - ei_dsp_cont_current_frame_ix`
+    while (current_frame_ix > 0) {
+        // then from the current frame we need to read `frame_length_values - current_frame_ix`
         // starting at offset 0
-        x = preemphasized_audio_signal.get_data(0, frame_length_values - ei_dsp_cont_current_frame_ix, ei_dsp_cont_current_frame + ei_dsp_cont_current_frame_ix);
+        if (int16_data) {
+            x = speechpy::processing::preemphasis_int16(int16_data, signal->total_length, 0,
+                frame_length_values - current_frame_ix, 0.98f, true,
+                current_frame + current_frame_ix);
+        }
+        else {
+            x = preemphasized_audio_signal.get_data(0, frame_length_values - current_frame_ix, current_frame + current_frame_ix);
+        }
         if (x != EIDSP_OK) {
             if (preemphasis) {
                 delete preemphasis;
@@ -1044,9 +1726,9 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
             EIDSP_ERR(x);
         }
 
-        // now ei_dsp_cont_current_frame is complete
+        // now current_frame is complete
         signal_t frame_signal;
-        x = numpy::signal_from_buffer(ei_dsp_cont_current_frame, frame_length_values, &frame_signal);
+        x = numpy::signal_from_buffer(current_frame, frame_length_values, &frame_signal);
         if (x != EIDSP_OK) {
             if (preemphasis) {
                 delete preemphasis;
@@ -1054,7 +1736,13 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
             EIDSP_ERR(x);
         }
 
-        x = extract_mfe_run_slice(&frame_signal, output_matrix, &config, sampling_frequency, matrix_size_out);
+        if (fixed_point) {
+            x = extract_mfe_run_frame_q15(current_frame, frame_length_values, ring, &config,
+                sampling_frequency, matrix_size_out);
+        }
+        else {
+            x = extract_mfe_run_slice(&frame_signal, ring, &config, sampling_frequency, matrix_size_out);
+        }
         if (x != EIDSP_OK) {
             if (preemphasis) {
                 delete preemphasis;
@@ -1064,15 +1752,15 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
 
         // if there's overlap between frames we roll through
         if (frame_stride_values > 0) {
-            numpy::roll(ei_dsp_cont_current_frame, frame_length_values, -frame_stride_values);
+            numpy::roll(current_frame, frame_length_values, -frame_stride_values);
         }
 
-        ei_dsp_cont_current_frame_ix -= frame_stride_values;
+        current_frame_ix -= frame_stride_values;
     }
 
-    if (ei_dsp_cont_current_frame_ix < 0) {
-        offset_in_signal = -ei_dsp_cont_current_frame_ix;
-        ei_dsp_cont_current_frame_ix = 0;
+    if (current_frame_ix < 0) {
+        offset_in_signal = -current_frame_ix;
+        current_frame_ix = 0;
     }
 
     if (offset_in_signal >= signal->total_length) {
@@ -1083,39 +1771,77 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
         return EIDSP_OK;
     }
 
-    // now... we need to discard part of the signal...
-    SignalWithRange signal_with_range(&preemphasized_audio_signal, offset_in_signal, signal->total_length);
+    int length_of_signal_used;
 
-    signal_t *range_signal = signal_with_range.get_signal();
-    size_t range_signal_orig_length = range_signal->total_length;
+    if (fixed_point) {
+        x = extract_mfe_run_slice_q15(signal, offset_in_signal, ring, &config, sampling_frequency,
+            matrix_size_out);
+        if (x != EIDSP_OK) {
+            if (preemphasis) {
+                delete preemphasis;
+            }
+            EIDSP_ERR(x);
+        }
 
-    // then we'll just go through normal processing of the signal:
-    x = extract_mfe_run_slice(range_signal, output_matrix, &config, sampling_frequency, matrix_size_out);
-    if (x != EIDSP_OK) {
-        if (preemphasis) {
-            delete preemphasis;
+        // update offset
+        length_of_signal_used = speechpy::processing::calculate_signal_used(signal->total_length - offset_in_signal,
+            sampling_frequency, config.frame_length, config.frame_stride, false, config.implementation_version);
+        offset_in_signal += length_of_signal_used;
+    }
+    else if (int16_data) {
+        x = extract_mfe_run_slice_int16(int16_data, signal->total_length, offset_in_signal, ring, &config,
+            sampling_frequency, matrix_size_out);
+        if (x != EIDSP_OK) {
+            EIDSP_ERR(x);
         }
-        EIDSP_ERR(x);
+
+        // update offset
+        length_of_signal_used = speechpy::processing::calculate_signal_used(signal->total_length - offset_in_signal,
+            sampling_frequency, config.frame_length, config.frame_stride, false, config.implementation_version);
+        offset_in_signal += length_of_signal_used;
     }
+    else {
+        // now... we need to discard part of the signal...
+        SignalWithRange signal_with_range(&preemphasized_audio_signal, offset_in_signal, signal->total_length);
 
-    // update offset
-    int length_of_signal_used = speechpy::processing::calculate_signal_used(range_signal->total_length, sampling_frequency,
-        config.frame_length, config.frame_stride, false, config.implementation_version);
-    offset_in_signal += length_of_signal_used;
+        signal_t *range_signal = signal_with_range.get_signal();
+        size_t range_signal_orig_length = range_signal->total_length;
 
-    // not sure why this is being manipulated...
-    range_signal->total_length = range_signal_orig_length;
+        // then we'll just go through normal processing of the signal:
+        x = extract_mfe_run_slice(range_signal, ring, &config, sampling_frequency, matrix_size_out);
+        if (x != EIDSP_OK) {
+            if (preemphasis) {
+                delete preemphasis;
+            }
+            EIDSP_ERR(x);
+        }
+
+        // update offset
+        length_of_signal_used = speechpy::processing::calculate_signal_used(range_signal->total_length, sampling_frequency,
+            config.frame_length, config.frame_stride, false, config.implementation_version);
+        offset_in_signal += length_of_signal_used;
+
+        // not sure why this is being manipulated...
+        range_signal->total_length = range_signal_orig_length;
+    }
 
     // see what's left?
     int bytes_left_end_of_frame = signal->total_length - offset_in_signal;
     bytes_left_end_of_frame += frame_overlap_values;
 
     if (bytes_left_end_of_frame > 0) {
-        // then read that into the ei_dsp_cont_current_frame buffer
-        x = preemphasized_audio_signal.get_data(
-            (preemphasized_audio_signal.total_length - bytes_left_end_of_frame),
-            bytes_left_end_of_frame,
-            ei_dsp_cont_current_frame);
+        // then read that into the current_frame buffer
+        if (int16_data) {
+            x = speechpy::processing::preemphasis_int16(int16_data, signal->total_length,
+                (signal->total_length - bytes_left_end_of_frame), bytes_left_end_of_frame, 0.98f, true,
+                current_frame);
+        }
+        else {
+            x = preemphasized_audio_signal.get_data(
+                (preemphasized_audio_signal.total_length - bytes_left_end_of_frame),
+                bytes_left_end_of_frame,
+                current_frame);
+        }
         if (x != EIDSP_OK) {
             if (preemphasis) {
                 delete preemphasis;
@@ -1124,7 +1850,7 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
         }
     }
 
-    ei_dsp_cont_current_frame_ix = bytes_left_end_of_frame;
+    current_frame_ix = bytes_left_end_of_frame;
 
 
     if (config.implementation_version == 1) {
@@ -1141,6 +1867,37 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
 #endif
 }
 
+/**
+ * extract_mfe_per_slice_features_ring over a plain feature matrix: afterwards the
+ * matrix is rotated so its oldest frame comes first, as the other per-slice extract
+ * functions leave it
+ */
+__attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+    ei_dsp_config_mfe_t *config = (ei_dsp_config_mfe_t*)config_ptr;
+
+    if (config->num_filters <= 0) {
+        EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+    }
+
+    ei_feature_ring_t ring;
+    ring.buffer = output_matrix->buffer;
+    ring.buffer_u8 = nullptr;
+    ring.normalized = false;
+    ring.cols = config->num_filters;
+    ring.rows = (output_matrix->rows * output_matrix->cols) / ring.cols;
+    ring.head = 0;
+    ring.frame = nullptr;
+    ring.frame_size = 0;
+    ring.frame_ix = 0;
+
+    int ret = extract_mfe_per_slice_features_ring(signal, &ring, config_ptr, sampling_frequency, matrix_size_out);
+    if (ret != EIDSP_OK) {
+        EIDSP_ERR(ret);
+    }
+
+    return numpy::roll(ring.buffer, ring.rows * ring.cols, -(int)(ring.head * ring.cols));
+}
+
 __attribute__((unused)) int extract_image_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float frequency) {
     ei_dsp_config_image_t config = *((ei_dsp_config_image_t*)config_ptr);
 
@@ -1467,8 +2224,8 @@ __attribute__((unused)) void calc_cepstral_mean_and_var_normalization_mfe(ei_mat
             return;
         }
     }
-    else {
-        // normalization
+    else if (!config->fixed_point) {
+        // normalization (extract_mfe_run_slice_q15 writes normalized features)
         int ret = speechpy::processing::mfe_normalization(matrix, config->noise_floor_db);
         if (ret != EIDSP_OK) {
             ei_printf("ERR: normalization failed (%d)\n", ret);
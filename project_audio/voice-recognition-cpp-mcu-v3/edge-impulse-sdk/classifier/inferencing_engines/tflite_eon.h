@@ -43,11 +43,279 @@
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
 #include "edge-impulse-sdk/classifier/inferencing_engines/tflite_helper.h"
 #include "edge-impulse-sdk/classifier/ei_run_dsp.h"
+#include <type_traits>
+
+// Keep the EON graph initialized between inferences: model_init (arena memset,
+// every op's init and prepare) runs on first use only, and later inferences just
+// fill the input tensor and invoke. Released by ei_tflite_eon_release_graphs(),
+// which run_classifier_deinit() calls.
+#ifndef EI_CLASSIFIER_TFLITE_EON_PERSISTENT_GRAPH
+#define EI_CLASSIFIER_TFLITE_EON_PERSISTENT_GRAPH       0
+#endif
+
+#if EI_CLASSIFIER_TFLITE_EON_PERSISTENT_GRAPH == 1
+#ifndef EI_CLASSIFIER_TFLITE_EON_MAX_WARM_GRAPHS
+#define EI_CLASSIFIER_TFLITE_EON_MAX_WARM_GRAPHS        4
+#endif
+
+// Keyed by model_reset: graph configs for EON DSP blocks live on the stack,
+// the compiled model functions don't move
+typedef TfLiteStatus (*ei_tflite_eon_reset_fn_t)(void (*)(void*));
+static ei_tflite_eon_reset_fn_t ei_tflite_eon_warm_graphs[EI_CLASSIFIER_TFLITE_EON_MAX_WARM_GRAPHS];
+
+static bool ei_tflite_eon_graph_is_warm(const ei_config_tflite_eon_graph_t *graph_config) {
+    for (size_t ix = 0; ix < EI_CLASSIFIER_TFLITE_EON_MAX_WARM_GRAPHS; ix++) {
+        if (ei_tflite_eon_warm_graphs[ix] == graph_config->model_reset) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void ei_tflite_eon_graph_mark_warm(const ei_config_tflite_eon_graph_t *graph_config) {
+    for (size_t ix = 0; ix < EI_CLASSIFIER_TFLITE_EON_MAX_WARM_GRAPHS; ix++) {
+        if (ei_tflite_eon_warm_graphs[ix] == nullptr) {
+            ei_tflite_eon_warm_graphs[ix] = graph_config->model_reset;
+            return;
+        }
+    }
+    // table full: this graph keeps being initialized and reset per inference
+}
+#endif // EI_CLASSIFIER_TFLITE_EON_PERSISTENT_GRAPH == 1
+
+/**
+ * Frees the arenas of all graphs kept warm by EI_CLASSIFIER_TFLITE_EON_PERSISTENT_GRAPH.
+ * The next inference initializes them again.
+ */
+__attribute__((unused)) static void ei_tflite_eon_release_graphs(void) {
+#if EI_CLASSIFIER_TFLITE_EON_PERSISTENT_GRAPH == 1
+    for (size_t ix = 0; ix < EI_CLASSIFIER_TFLITE_EON_MAX_WARM_GRAPHS; ix++) {
+        if (ei_tflite_eon_warm_graphs[ix] != nullptr) {
+            ei_tflite_eon_warm_graphs[ix](ei_aligned_free);
+            ei_tflite_eon_warm_graphs[ix] = nullptr;
+        }
+    }
+#endif
+}
+
+/**
+ * The graph one inference runs on: a context owned by the impulse handle
+ * (EI_CLASSIFIER_REENTRANT), or the graph's own shared state when ctx is nullptr
+ */
+typedef struct {
+    ei_config_tflite_eon_graph_t *config;
+    void *ctx;
+} ei_tflite_eon_graph_t;
+
+static TfLiteStatus ei_tflite_eon_input(const ei_tflite_eon_graph_t *graph, int index, TfLiteTensor *tensor) {
+    return graph->ctx ? graph->config->model_input_ctx(graph->ctx, index, tensor) : graph->config->model_input(index, tensor);
+}
+
+static TfLiteStatus ei_tflite_eon_output(const ei_tflite_eon_graph_t *graph, int index, TfLiteTensor *tensor) {
+    return graph->ctx ? graph->config->model_output_ctx(graph->ctx, index, tensor) : graph->config->model_output(index, tensor);
+}
+
+static TfLiteStatus ei_tflite_eon_invoke(const ei_tflite_eon_graph_t *graph) {
+    return graph->ctx ? graph->config->model_invoke_ctx(graph->ctx) : graph->config->model_invoke();
+}
+
+/**
+ * Allocates and sets up a graph context (the _ctx functions of the compiled model),
+ * released with ei_tflite_eon_context_free. nullptr with *error set on failure, or
+ * with EI_IMPULSE_OK for graphs compiled without the _ctx functions.
+ */
+static void *ei_tflite_eon_context_create(const ei_config_tflite_eon_graph_t *graph_config, EI_IMPULSE_ERROR *error) {
+    *error = EI_IMPULSE_OK;
+    if (graph_config->model_init_ctx == nullptr) {
+        return nullptr;
+    }
+
+    void *ctx = ei_aligned_calloc(16, graph_config->model_context_size());
+    if (ctx == nullptr) {
+        ei_printf("Failed to allocate the graph context\n");
+        *error = EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
+        return nullptr;
+    }
+    TfLiteStatus init_status = graph_config->model_init_ctx(ctx);
+    if (init_status != kTfLiteOk) {
+        ei_printf("Failed to initialize the model (error code %d)\n", init_status);
+        graph_config->model_reset_ctx(ctx);
+        ei_aligned_free(ctx);
+        *error = EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
+        return nullptr;
+    }
+    return ctx;
+}
+
+static void ei_tflite_eon_context_free(const ei_config_tflite_eon_graph_t *graph_config, void *ctx) {
+    if (ctx != nullptr) {
+        graph_config->model_reset_ctx(ctx);
+        ei_aligned_free(ctx);
+    }
+}
+
+static TfLiteStatus ei_tflite_eon_invoke_batch(const ei_config_tflite_eon_graph_t *graph_config, void *const *contexts,
+    size_t count) {
+    if (graph_config->model_invoke_batch_ctx != nullptr) {
+        return graph_config->model_invoke_batch_ctx(contexts, count);
+    }
+    for (size_t ix = 0; ix < count; ix++) {
+        TfLiteStatus status = graph_config->model_invoke_ctx(contexts[ix]);
+        if (status != kTfLiteOk) {
+            return status;
+        }
+    }
+    return kTfLiteOk;
+}
+
+#if EI_CLASSIFIER_REENTRANT
+/**
+ * Looks up the context of the graph on the handle bound to this thread
+ * (ei_impulse_state_binding) and sets it up on first use. Contexts stay
+ * initialized until the handle releases them (run_classifier_deinit(handle)
+ * or its destructor). Leaves graph->ctx at nullptr, i.e. the shared graph,
+ * without a bound handle, for graphs compiled without the _ctx functions and
+ * once every learning block of the handle has its context (EON DSP blocks).
+ */
+static EI_IMPULSE_ERROR ei_tflite_eon_bind_context(ei_tflite_eon_graph_t *graph) {
+    ei_impulse_state_t *state = ei_current_impulse_state;
+    const ei_config_tflite_eon_graph_t *graph_config = graph->config;
+
+    if (state == nullptr || graph_config->model_init_ctx == nullptr) {
+        return EI_IMPULSE_OK;
+    }
+
+    const size_t contexts_size = state->impulse->learning_blocks_size;
+    if (state->inference_contexts == nullptr) {
+        state->inference_contexts = (ei_inference_context_t *)ei_calloc(contexts_size, sizeof(ei_inference_context_t));
+        if (state->inference_contexts == nullptr) {
+            return EI_IMPULSE_ALLOC_FAILED;
+        }
+    }
+
+    ei_inference_context_t *slot = nullptr;
+    for (size_t ix = 0; ix < contexts_size; ix++) {
+        ei_inference_context_t *context = &state->inference_contexts[ix];
+        if (context->graph != nullptr && context->model_reset_ctx == graph_config->model_reset_ctx) {
+            graph->ctx = context->graph;
+            return EI_IMPULSE_OK;
+        }
+        if (context->graph == nullptr && slot == nullptr) {
+            slot = context;
+        }
+    }
+    if (slot == nullptr) {
+        return EI_IMPULSE_OK;
+    }
+
+    EI_IMPULSE_ERROR error;
+    void *ctx = ei_tflite_eon_context_create(graph_config, &error);
+    if (ctx == nullptr) {
+        return error;
+    }
+
+    slot->graph = ctx;
+    slot->model_reset_ctx = graph_config->model_reset_ctx;
+    graph->ctx = ctx;
+    return EI_IMPULSE_OK;
+}
+#endif // EI_CLASSIFIER_REENTRANT
+
+/**
+ * Resets the graph after an inference, unless it is kept warm (handle contexts always are)
+ */
+static TfLiteStatus inference_tflite_teardown(const ei_tflite_eon_graph_t *graph) {
+    if (graph->ctx) {
+        return kTfLiteOk;
+    }
+#if EI_CLASSIFIER_TFLITE_EON_PERSISTENT_GRAPH == 1
+    if (ei_tflite_eon_graph_is_warm(graph->config)) {
+        return kTfLiteOk;
+    }
+#endif
+    return graph->config->model_reset(ei_aligned_free);
+}
+
+/**
+ * Points graph at the handle's context (EI_CLASSIFIER_REENTRANT) or at the shared
+ * graph, and initializes the shared graph unless it is kept warm
+ */
+static EI_IMPULSE_ERROR inference_tflite_bind_graph(ei_config_tflite_eon_graph_t *graph_config,
+    ei_tflite_eon_graph_t *graph) {
+
+    graph->config = graph_config;
+    graph->ctx = nullptr;
+#if EI_CLASSIFIER_REENTRANT
+    EI_IMPULSE_ERROR context_res = ei_tflite_eon_bind_context(graph);
+    if (context_res != EI_IMPULSE_OK) {
+        return context_res;
+    }
+    if (graph->ctx == nullptr)
+#endif
+#if EI_CLASSIFIER_TFLITE_EON_PERSISTENT_GRAPH == 1
+    if (!ei_tflite_eon_graph_is_warm(graph_config))
+#endif
+    {
+        TfLiteStatus init_status = graph_config->model_init(ei_aligned_calloc);
+        if (init_status != kTfLiteOk) {
+            ei_printf("Failed to initialize the model (error code %d)\n", init_status);
+            return EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
+        }
+#if EI_CLASSIFIER_TFLITE_EON_PERSISTENT_GRAPH == 1
+        ei_tflite_eon_graph_mark_warm(graph_config);
+#endif
+    }
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * The part of the tensor arena of a set up graph that is idle outside invoke
+ * (model_idle_arena: below the kernels' persistent buffers), without `live`, a
+ * tensor in it that is being filled (the input tensor during the DSP): the
+ * larger of the parts before and after that one. 0 bytes for graphs compiled
+ * without model_idle_arena.
+ */
+static void ei_tflite_eon_idle_arena(const ei_tflite_eon_graph_t *graph, const TfLiteTensor *live,
+    uint8_t **start, size_t *bytes) {
+
+    *start = nullptr;
+    *bytes = 0;
+
+    TfLiteStatus status = kTfLiteError;
+    if (graph->ctx && graph->config->model_idle_arena_ctx) {
+        status = graph->config->model_idle_arena_ctx(graph->ctx, start, bytes);
+    }
+    else if (!graph->ctx && graph->config->model_idle_arena) {
+        status = graph->config->model_idle_arena(start, bytes);
+    }
+    if (status != kTfLiteOk) {
+        *start = nullptr;
+        *bytes = 0;
+        return;
+    }
+
+    if (live != nullptr) {
+        uint8_t *live_start = (uint8_t *)live->data.data;
+        uint8_t *live_end = live_start + live->bytes;
+        if (live_end > *start && live_start < *start + *bytes) {
+            size_t before = live_start > *start ? (size_t)(live_start - *start) : 0;
+            size_t after = *start + *bytes > live_end ? (size_t)(*start + *bytes - live_end) : 0;
+            if (after > before) {
+                *start = live_end;
+                *bytes = after;
+            }
+            else {
+                *bytes = before;
+            }
+        }
+    }
+}
 
 /**
  * Setup the TFLite runtime
  *
- * @param      ctx_start_us       Pointer to the start time
+ * @param      ctx_start_cycles   Pointer to the start time (ei_read_cycles)
+ * @param      graph              Set to the graph (or handle context) to run
  * @param      input              Pointer to input tensor
  * @param      output             Pointer to output tensor
  * @param      micro_tensor_arena Pointer to the arena that will be allocated
@@ -56,31 +324,31 @@
  */
 static EI_IMPULSE_ERROR inference_tflite_setup(
     ei_learning_block_config_tflite_graph_t *block_config,
-    uint64_t *ctx_start_us,
+    uint64_t *ctx_start_cycles,
+    ei_tflite_eon_graph_t *graph,
     TfLiteTensor* input,
     TfLiteTensor** output_arg,
     ei_unique_ptr_t& p_tensor_arena) {
 
-    *ctx_start_us = ei_read_timer_us();
+    *ctx_start_cycles = ei_read_cycles();
 
     TfLiteTensor *outputs = *output_arg;
     ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
 
-    TfLiteStatus init_status = graph_config->model_init(ei_aligned_calloc);
-    if (init_status != kTfLiteOk) {
-        ei_printf("Failed to initialize the model (error code %d)\n", init_status);
-        return EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
+    EI_IMPULSE_ERROR bind_res = inference_tflite_bind_graph(graph_config, graph);
+    if (bind_res != EI_IMPULSE_OK) {
+        return bind_res;
     }
 
     TfLiteStatus status;
 
-    status = graph_config->model_input(0, input);
+    status = ei_tflite_eon_input(graph, 0, input);
     if (status != kTfLiteOk) {
         return EI_IMPULSE_TFLITE_ERROR;
     }
 
     for (uint8_t i = 0; i < block_config->output_tensors_size; i++) {
-        status = graph_config->model_output(block_config->output_tensors_indices[i], &outputs[i]);
+        status = ei_tflite_eon_output(graph, block_config->output_tensors_indices[i], &outputs[i]);
         if (status != kTfLiteOk) {
             return EI_IMPULSE_TFLITE_ERROR;
         }
@@ -92,7 +360,8 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
 /**
  * Run TFLite model
  *
- * @param   ctx_start_us    Start time of the setup function (see above)
+ * @param   ctx_start_cycles Start time of the setup function (see above)
+ * @param   graph           Graph set up by inference_tflite_setup
  * @param   output          Output tensor
  * @param   interpreter     TFLite interpreter (non-compiled models)
  * @param   tensor_arena    Allocated arena (will be freed)
@@ -104,23 +373,26 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
 static EI_IMPULSE_ERROR inference_tflite_run(
     const ei_impulse_t *impulse,
     ei_learning_block_config_tflite_graph_t *block_config,
-    uint64_t ctx_start_us,
+    uint64_t ctx_start_cycles,
+    const ei_tflite_eon_graph_t *graph,
     TfLiteTensor** outputs,
     uint8_t* tensor_arena,
     ei_impulse_result_t *result,
     bool debug) {
 
-    ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
-
-    if (graph_config->model_invoke() != kTfLiteOk) {
+    if (ei_tflite_eon_invoke(graph) != kTfLiteOk) {
         return EI_IMPULSE_TFLITE_ERROR;
     }
 
-    uint64_t ctx_end_us = ei_read_timer_us();
-
-    result->timing.classification_us = ctx_end_us - ctx_start_us;
+    result->timing.classification_us = ei_cycles_to_us(ei_read_cycles() - ctx_start_cycles);
     result->timing.classification = (int)(result->timing.classification_us / 1000);
 
+#if EI_CLASSIFIER_PROFILE_NODES
+    result->timing.nodes = ei_node_profiler.nodes;
+    result->timing.nodes_count = ei_node_profiler.count < EI_CLASSIFIER_PROFILE_NODES_MAX ?
+        ei_node_profiler.count : EI_CLASSIFIER_PROFILE_NODES_MAX;
+#endif
+
     EI_LOGD("Predictions (time: %d ms.):\n", result->timing.classification);
 
     if (ei_run_impulse_check_canceled() == EI_IMPULSE_CANCELED) {
@@ -130,6 +402,91 @@ static EI_IMPULSE_ERROR inference_tflite_run(
     return EI_IMPULSE_OK;
 }
 
+/**
+ * Matrix for one output tensor copy in result->_raw_outputs. These are only read
+ * until the inference call returns, so with the workspace arena both the matrix
+ * and its buffer are scratch and handed back when the caller's scope closes
+ * (run_postprocessing skips them). Otherwise they are on the heap as before.
+ */
+template <typename matrix_type>
+static matrix_type *inference_tflite_output_matrix(size_t output_size) {
+#if EIDSP_WORKSPACE_ARENA
+    typedef typename std::remove_pointer<decltype(matrix_type::buffer)>::type value_type;
+    void *matrix_mem = ei_dsp_scratch_calloc(1, sizeof(matrix_type));
+    value_type *buffer = static_cast<value_type *>(ei_dsp_scratch_calloc(output_size, sizeof(value_type)));
+    if (ei_dsp_workspace_contains(matrix_mem) && ei_dsp_workspace_contains(buffer)) {
+        return ::new (matrix_mem) matrix_type(1, output_size, buffer);
+    }
+    if (matrix_mem) {
+        ei_dsp_scratch_free(matrix_mem, sizeof(matrix_type));
+    }
+    if (buffer) {
+        ei_dsp_scratch_free(buffer, output_size * sizeof(value_type));
+    }
+#endif
+    return new matrix_type(1, output_size);
+}
+
+/**
+ * Copy the output tensors into result->_raw_outputs
+ */
+static EI_IMPULSE_ERROR inference_tflite_copy_outputs(
+    ei_learning_block_config_tflite_graph_t *block_config,
+    TfLiteTensor *outputs,
+    uint32_t learn_block_index,
+    ei_impulse_result_t *result) {
+
+    for (uint32_t output_ix = 0; output_ix < block_config->output_tensors_size; output_ix++) {
+        TfLiteTensor* output = &outputs[output_ix];
+        // calculate the size of the output by iterating through dims
+        size_t output_size = 1;
+        for (int dim_num = 0; dim_num < output->dims->size; dim_num++) {
+            output_size *= output->dims->data[dim_num];
+        }
+        switch (output->type) {
+            case kTfLiteFloat32: {
+                result->_raw_outputs[learn_block_index + output_ix].matrix = inference_tflite_output_matrix<matrix_t>(output_size);
+                memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix->buffer, output->data.f, output->bytes);
+                break;
+            }
+            case kTfLiteInt8: {
+                if (block_config->dequantize_output) {
+                    result->_raw_outputs[learn_block_index + output_ix].matrix = inference_tflite_output_matrix<matrix_t>(output_size);
+                    fill_output_matrix_from_tensor(output, result->_raw_outputs[learn_block_index + output_ix].matrix);
+                }
+                else {
+                    result->_raw_outputs[learn_block_index + output_ix].matrix_i8 = inference_tflite_output_matrix<matrix_i8_t>(output_size);
+                    memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix_i8->buffer, output->data.int8, output->bytes);
+                }
+                break;
+            }
+            case kTfLiteUInt8: {
+                if (block_config->dequantize_output) {
+                    result->_raw_outputs[learn_block_index + output_ix].matrix = inference_tflite_output_matrix<matrix_t>(output_size);
+                    fill_output_matrix_from_tensor(output, result->_raw_outputs[learn_block_index + output_ix].matrix);
+                }
+                else {
+                    result->_raw_outputs[learn_block_index + output_ix].matrix_u8 = inference_tflite_output_matrix<matrix_u8_t>(output_size);
+                    memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix_u8->buffer, output->data.uint8, output->bytes);
+                }
+                break;
+            }
+            default: {
+                ei_printf("ERR: Cannot handle output type (%d)\n", output->type);
+                return EI_IMPULSE_OUTPUT_TENSOR_WAS_NULL;
+            }
+        }
+
+        if (result->_raw_outputs[learn_block_index + output_ix].matrix == nullptr) {
+            return EI_IMPULSE_ALLOC_FAILED;
+        }
+
+        result->_raw_outputs[learn_block_index + output_ix].blockId = block_config->block_id + output_ix;
+    }
+
+    return EI_IMPULSE_OK;
+}
+
 /**
  * @brief      Do neural network inferencing over a signal (from the DSP)
  *
@@ -148,15 +505,16 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
     TfLiteTensor *outputs;
 
     // allocate outputs
-    outputs = (TfLiteTensor*)ei_malloc(block_config->output_tensors_size * sizeof(TfLiteTensor));
+    outputs = (TfLiteTensor*)ei_dsp_scratch_calloc(block_config->output_tensors_size, sizeof(TfLiteTensor));
 
-    uint64_t ctx_start_us = ei_read_timer_us();
+    uint64_t ctx_start_cycles = ei_read_cycles();
     ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
-    ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
+    ei_tflite_eon_graph_t graph;
 
     EI_IMPULSE_ERROR init_res = inference_tflite_setup(
         block_config,
-        &ctx_start_us,
+        &ctx_start_cycles,
+        &graph,
         &input,
         &outputs,
         p_tensor_arena);
@@ -171,7 +529,7 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
     }
 
     // invoke the model
-    if (graph_config->model_invoke() != kTfLiteOk) {
+    if (ei_tflite_eon_invoke(&graph) != kTfLiteOk) {
         return EI_IMPULSE_TFLITE_ERROR;
     }
 
@@ -180,10 +538,10 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
         return output_res;
     }
 
-    if (graph_config->model_reset(ei_aligned_free) != kTfLiteOk) {
+    if (inference_tflite_teardown(&graph) != kTfLiteOk) {
         return EI_IMPULSE_TFLITE_ERROR;
     }
-    ei_free(outputs);
+    ei_dsp_scratch_free(outputs, block_config->output_tensors_size * sizeof(TfLiteTensor));
 
     return EI_IMPULSE_OK;
 }
@@ -208,20 +566,21 @@ EI_IMPULSE_ERROR run_nn_inference(
     bool debug = false)
 {
     ei_learning_block_config_tflite_graph_t *block_config = (ei_learning_block_config_tflite_graph_t*)config_ptr;
-    ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
 
     TfLiteTensor input;
     TfLiteTensor *outputs;
 
     // allocate outputs
-    outputs = (TfLiteTensor*)ei_malloc(block_config->output_tensors_size * sizeof(TfLiteTensor));
+    outputs = (TfLiteTensor*)ei_dsp_scratch_calloc(block_config->output_tensors_size, sizeof(TfLiteTensor));
 
-    uint64_t ctx_start_us = ei_read_timer_us();
+    uint64_t ctx_start_cycles = ei_read_cycles();
     ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
+    ei_tflite_eon_graph_t graph;
 
     EI_IMPULSE_ERROR init_res = inference_tflite_setup(
         block_config,
-        &ctx_start_us,
+        &ctx_start_cycles,
+        &graph,
         &input,
         &outputs,
         p_tensor_arena);
@@ -247,56 +606,20 @@ EI_IMPULSE_ERROR run_nn_inference(
     EI_IMPULSE_ERROR run_res = inference_tflite_run(
         impulse,
         block_config,
-        ctx_start_us,
+        ctx_start_cycles,
+        &graph,
         &outputs,
         tensor_arena, result, debug);
 
-    for (uint32_t output_ix = 0; output_ix < block_config->output_tensors_size; output_ix++) {
-        TfLiteTensor* output = &outputs[output_ix];
-        // calculate the size of the output by iterating through dims
-        size_t output_size = 1;
-        for (int dim_num = 0; dim_num < output->dims->size; dim_num++) {
-            output_size *= output->dims->data[dim_num];
-        }
-        switch (output->type) {
-            case kTfLiteFloat32: {
-                result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
-                memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix->buffer, output->data.f, output->bytes);
-                break;
-            }
-            case kTfLiteInt8: {
-                if (block_config->dequantize_output) {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
-                    fill_output_matrix_from_tensor(output, result->_raw_outputs[learn_block_index + output_ix].matrix);
-                }
-                else {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix_i8 = new matrix_i8_t(1, output_size);
-                    memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix_i8->buffer, output->data.int8, output->bytes);
-                }
-                break;
-            }
-            case kTfLiteUInt8: {
-                if (block_config->dequantize_output) {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
-                    fill_output_matrix_from_tensor(output, result->_raw_outputs[learn_block_index + output_ix].matrix);
-                }
-                else {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix_u8 = new matrix_u8_t(1, output_size);
-                    memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix_u8->buffer, output->data.uint8, output->bytes);
-                }
-                break;
-            }
-            default: {
-                ei_printf("ERR: Cannot handle output type (%d)\n", output->type);
-                return EI_IMPULSE_OUTPUT_TENSOR_WAS_NULL;
-            }
-        }
-
-        result->_raw_outputs[learn_block_index + output_ix].blockId = block_config->block_id + output_ix;
+    EI_IMPULSE_ERROR copy_res = inference_tflite_copy_outputs(block_config, outputs, learn_block_index, result);
+    if (copy_res != EI_IMPULSE_OK) {
+        inference_tflite_teardown(&graph);
+        ei_dsp_scratch_free(outputs, block_config->output_tensors_size * sizeof(TfLiteTensor));
+        return copy_res;
     }
 
-    graph_config->model_reset(ei_aligned_free);
-    ei_free(outputs);
+    inference_tflite_teardown(&graph);
+    ei_dsp_scratch_free(outputs, block_config->output_tensors_size * sizeof(TfLiteTensor));
 
     if (run_res != EI_IMPULSE_OK) {
         return run_res;
@@ -307,33 +630,48 @@ EI_IMPULSE_ERROR run_nn_inference(
 
 #if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1
 /**
- * Special function to run the classifier on images, only works on TFLite models (either interpreter or EON or for tensaiflow)
- * that allocates a lot less memory by quantizing in place. This only works if 'can_run_classifier_image_quantized'
- * returns EI_IMPULSE_OK.
+ * DSP block that quantizes its output straight into the input tensor
+ * (context is passed through from run_nn_inference_dsp_quantized)
  */
-EI_IMPULSE_ERROR run_nn_inference_image_quantized(
+typedef int (*ei_extract_features_quantized_fn_t)(
+    const ei_impulse_t *impulse,
+    signal_t *signal,
+    const void *context,
+    ei::matrix_i8_t *output_matrix,
+    float scale,
+    float zero_point);
+
+/**
+ * Runs the (only) DSP block straight into the quantized input tensor, then the graph.
+ * Shared by the image and audio shortcuts below.
+ */
+static EI_IMPULSE_ERROR run_nn_inference_dsp_quantized(
     const ei_impulse_t *impulse,
     signal_t *signal,
     uint32_t learn_block_index,
     ei_impulse_result_t *result,
     void *config_ptr,
-    bool debug = false) {
+    ei_extract_features_quantized_fn_t extract_fn,
+    const void *extract_context,
+    bool allow_uint8,
+    bool debug) {
 
     ei_learning_block_config_tflite_graph_t *block_config = (ei_learning_block_config_tflite_graph_t*)config_ptr;
-    ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
 
-    uint64_t ctx_start_us;
+    uint64_t ctx_start_cycles;
     TfLiteTensor input;
     TfLiteTensor *outputs;
 
     // allocate outputs
-    outputs = (TfLiteTensor*)ei_malloc(block_config->output_tensors_size * sizeof(TfLiteTensor));
+    outputs = (TfLiteTensor*)ei_dsp_scratch_calloc(block_config->output_tensors_size, sizeof(TfLiteTensor));
 
     ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
+    ei_tflite_eon_graph_t graph;
 
     EI_IMPULSE_ERROR init_res = inference_tflite_setup(
         block_config,
-        &ctx_start_us,
+        &ctx_start_cycles,
+        &graph,
         &input,
         &outputs,
         p_tensor_arena);
@@ -342,21 +680,34 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
         return init_res;
     }
 
-    if (input.type != TfLiteType::kTfLiteInt8 && input.type != TfLiteType::kTfLiteUInt8) {
+    if (input.type != TfLiteType::kTfLiteInt8 && !(allow_uint8 && input.type == TfLiteType::kTfLiteUInt8)) {
+        inference_tflite_teardown(&graph);
+        ei_dsp_scratch_free(outputs, block_config->output_tensors_size * sizeof(TfLiteTensor));
         return EI_IMPULSE_ONLY_SUPPORTED_FOR_IMAGES;
     }
 
-    uint64_t dsp_start_us = ei_read_timer_us();
+    uint64_t dsp_start_cycles = ei_read_cycles();
 
     // features matrix maps around the input tensor to not allocate any memory
     ei::matrix_i8_t features_matrix(1, impulse->nn_input_frame_size, input.data.int8);
 
-    // run DSP process and quantize automatically
-    int ret = extract_image_features_quantized(signal, &features_matrix, impulse->dsp_blocks[0].config, input.params.scale, input.params.zero_point,
-        impulse->frequency, impulse->learning_blocks[0].image_scaling);
+    int ret;
+    {
+        // no tensor but the input is live until invoke, so the DSP scratch goes
+        // into the rest of the idle tensor arena
+        uint8_t *idle_arena;
+        size_t idle_arena_bytes;
+        ei_tflite_eon_idle_arena(&graph, &input, &idle_arena, &idle_arena_bytes);
+        ei_dsp_workspace_overlay overlay(idle_arena, idle_arena_bytes);
+
+        // run DSP process and quantize automatically
+        ret = extract_fn(impulse, signal, extract_context, &features_matrix, input.params.scale, input.params.zero_point);
+    }
 
     if (ret != EIDSP_OK) {
         ei_printf("ERR: Failed to run DSP process (%d)\n", ret);
+        inference_tflite_teardown(&graph);
+        ei_dsp_scratch_free(outputs, block_config->output_tensors_size * sizeof(TfLiteTensor));
         return EI_IMPULSE_DSP_ERROR;
     }
 
@@ -364,7 +715,7 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
         return EI_IMPULSE_CANCELED;
     }
 
-    result->timing.dsp_us = ei_read_timer_us() - dsp_start_us;
+    result->timing.dsp_us = ei_cycles_to_us(ei_read_cycles() - dsp_start_cycles);
     result->timing.dsp = (int)(result->timing.dsp_us / 1000);
 
     if (debug) {
@@ -376,67 +727,235 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
         ei_printf("\n");
     }
 
-    ctx_start_us = ei_read_timer_us();
+    ctx_start_cycles = ei_read_cycles();
 
     EI_IMPULSE_ERROR run_res = inference_tflite_run(
         impulse,
         block_config,
-        ctx_start_us,
+        ctx_start_cycles,
+        &graph,
         &outputs,
         static_cast<uint8_t*>(p_tensor_arena.get()),
         result,
         debug);
 
-    for (uint32_t output_ix = 0; output_ix < block_config->output_tensors_size; output_ix++) {
-        TfLiteTensor* output = &outputs[output_ix];
-        // calculate the size of the output by iterating through dims
-        size_t output_size = 1;
-        for (int dim_num = 0; dim_num < output->dims->size; dim_num++) {
-            output_size *= output->dims->data[dim_num];
-        }
+    EI_IMPULSE_ERROR copy_res = inference_tflite_copy_outputs(block_config, outputs, learn_block_index, result);
+    if (copy_res != EI_IMPULSE_OK) {
+        inference_tflite_teardown(&graph);
+        ei_dsp_scratch_free(outputs, block_config->output_tensors_size * sizeof(TfLiteTensor));
+        return copy_res;
+    }
 
-        switch (output->type) {
-            case kTfLiteFloat32: {
-                result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
-                memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix->buffer, output->data.f, output->bytes);
-                break;
-            }
-            case kTfLiteInt8: {
-                if (block_config->dequantize_output) {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
-                    fill_output_matrix_from_tensor(output, result->_raw_outputs[learn_block_index + output_ix].matrix);
-                }
-                else {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix_i8 = new matrix_i8_t(1, output_size);
-                    memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix_i8->buffer, output->data.int8, output->bytes);
-                }
-                break;
-            }
-            case kTfLiteUInt8: {
-                if (block_config->dequantize_output) {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
-                    fill_output_matrix_from_tensor(output, result->_raw_outputs[learn_block_index + output_ix].matrix);
-                }
-                else {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix_u8 = new matrix_u8_t(1, output_size);
-                    memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix_u8->buffer, output->data.uint8, output->bytes);
-                }
-                break;
-            }
-            default: {
-                ei_printf("ERR: Cannot handle output type (%d)\n", output->type);
-                return EI_IMPULSE_OUTPUT_TENSOR_WAS_NULL;
+    inference_tflite_teardown(&graph);
+    ei_dsp_scratch_free(outputs, block_config->output_tensors_size * sizeof(TfLiteTensor));
+
+    if (run_res != EI_IMPULSE_OK) {
+        return run_res;
+    }
+
+    return EI_IMPULSE_OK;
+}
+
+static int extract_image_features_quantized_fn(const ei_impulse_t *impulse, signal_t *signal, const void *context,
+    ei::matrix_i8_t *output_matrix, float scale, float zero_point) {
+    return extract_image_features_quantized(signal, output_matrix, impulse->dsp_blocks[0].config, scale, zero_point,
+        impulse->frequency, impulse->learning_blocks[0].image_scaling);
+}
+
+/**
+ * Special function to run the classifier on images, only works on TFLite models (either interpreter or EON or for tensaiflow)
+ * that allocates a lot less memory by quantizing in place. This only works if 'can_run_classifier_image_quantized'
+ * returns EI_IMPULSE_OK.
+ */
+EI_IMPULSE_ERROR run_nn_inference_image_quantized(
+    const ei_impulse_t *impulse,
+    signal_t *signal,
+    uint32_t learn_block_index,
+    ei_impulse_result_t *result,
+    void *config_ptr,
+    bool debug = false) {
+
+    return run_nn_inference_dsp_quantized(impulse, signal, learn_block_index, result, config_ptr,
+        &extract_image_features_quantized_fn, nullptr, true, debug);
+}
+
+static int extract_mfe_features_quantized_fn(const ei_impulse_t *impulse, signal_t *signal, const void *context,
+    ei::matrix_i8_t *output_matrix, float scale, float zero_point) {
+    return extract_mfe_features_quantized(signal, output_matrix, impulse->dsp_blocks[0].config, scale, zero_point,
+        impulse->frequency);
+}
+
+/**
+ * Audio counterpart of run_nn_inference_image_quantized: the MFE block quantizes its
+ * features straight into the input tensor, so the float feature matrix is never
+ * allocated. Only works if 'can_run_classifier_audio_quantized' returns EI_IMPULSE_OK.
+ */
+EI_IMPULSE_ERROR run_nn_inference_audio_quantized(
+    const ei_impulse_t *impulse,
+    signal_t *signal,
+    uint32_t learn_block_index,
+    ei_impulse_result_t *result,
+    void *config_ptr,
+    bool debug = false) {
+
+    return run_nn_inference_dsp_quantized(impulse, signal, learn_block_index, result, config_ptr,
+        &extract_mfe_features_quantized_fn, nullptr, false, debug);
+}
+
+static int extract_mfe_ring_quantized_fn(const ei_impulse_t *impulse, signal_t *signal, const void *context,
+    ei::matrix_i8_t *output_matrix, float scale, float zero_point) {
+    return extract_mfe_ring_quantized((const ei_feature_ring_t *)context, output_matrix, impulse->dsp_blocks[0].config,
+        scale, zero_point);
+}
+
+/**
+ * Continuous counterpart of run_nn_inference_audio_quantized: the MFE frames of the
+ * feature ring are normalized and quantized straight into the input tensor.
+ */
+EI_IMPULSE_ERROR run_nn_inference_audio_ring_quantized(
+    const ei_impulse_t *impulse,
+    const ei_feature_ring_t *ring,
+    uint32_t learn_block_index,
+    ei_impulse_result_t *result,
+    void *config_ptr,
+    bool debug = false) {
+
+    return run_nn_inference_dsp_quantized(impulse, nullptr, learn_block_index, result, config_ptr,
+        &extract_mfe_ring_quantized_fn, ring, false, debug);
+}
+
+/**
+ * The idle tensor arena of a learning block's graph between inferences, lent to
+ * the DSP of a continuous slice (the feature ring holds the window, so no tensor
+ * is live). Only graphs that stay set up between inferences lend it: handle
+ * contexts and EI_CLASSIFIER_TFLITE_EON_PERSISTENT_GRAPH; 0 bytes otherwise.
+ */
+EI_IMPULSE_ERROR inference_tflite_idle_arena(
+    const ei_impulse_t *impulse,
+    uint32_t learn_block_index,
+    uint8_t **start,
+    size_t *bytes) {
+
+    *start = nullptr;
+    *bytes = 0;
+
+    ei_learning_block_config_tflite_graph_t *block_config =
+        (ei_learning_block_config_tflite_graph_t*)impulse->learning_blocks[learn_block_index].config;
+    ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
+    ei_tflite_eon_graph_t graph;
+
+#if EI_CLASSIFIER_TFLITE_EON_PERSISTENT_GRAPH == 1
+    EI_IMPULSE_ERROR bind_res = inference_tflite_bind_graph(graph_config, &graph);
+    if (bind_res != EI_IMPULSE_OK) {
+        return bind_res;
+    }
+#elif EI_CLASSIFIER_REENTRANT
+    graph.config = graph_config;
+    graph.ctx = nullptr;
+    EI_IMPULSE_ERROR context_res = ei_tflite_eon_bind_context(&graph);
+    if (context_res != EI_IMPULSE_OK) {
+        return context_res;
+    }
+    if (graph.ctx == nullptr) {
+        // the shared graph is reset after every inference
+        return EI_IMPULSE_OK;
+    }
+#else
+    (void)graph_config;
+    (void)graph;
+    return EI_IMPULSE_OK;
+#endif
+
+    ei_tflite_eon_idle_arena(&graph, nullptr, start, bytes);
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * run_nn_inference_audio_ring_quantized over a batch of windows: each ring is quantized
+ * into the input tensor of its own graph context (ei_tflite_eon_context_create), then
+ * all contexts are invoked together, layer by layer. timing.dsp_us of a result is the
+ * quantization of its window, timing.classification_us the whole batched invoke.
+ */
+EI_IMPULSE_ERROR run_nn_inference_audio_ring_quantized_batch(
+    const ei_impulse_t *impulse,
+    const ei_feature_ring_t *const *rings,
+    void *const *contexts,
+    size_t count,
+    ei_impulse_result_t *results,
+    void *config_ptr,
+    bool debug = false) {
+
+    ei_learning_block_config_tflite_graph_t *block_config = (ei_learning_block_config_tflite_graph_t*)config_ptr;
+    const ei_config_tflite_eon_graph_t *graph_config = (const ei_config_tflite_eon_graph_t*)block_config->graph_config;
+
+    if (graph_config->model_input_ctx == nullptr) {
+        return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+    }
+
+    // output tensors of every context, output_tensors_size per window
+    ei_dsp_scratch_buffer<TfLiteTensor> outputs_buffer(count * block_config->output_tensors_size);
+    TfLiteTensor *outputs = outputs_buffer.get();
+    if (outputs == nullptr) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+
+    for (size_t ix = 0; ix < count; ix++) {
+        uint64_t dsp_start_cycles = ei_read_cycles();
+
+        TfLiteTensor input;
+        if (graph_config->model_input_ctx(contexts[ix], 0, &input) != kTfLiteOk) {
+            return EI_IMPULSE_TFLITE_ERROR;
+        }
+        if (input.type != TfLiteType::kTfLiteInt8) {
+            return EI_IMPULSE_ONLY_SUPPORTED_FOR_IMAGES;
+        }
+        for (uint8_t i = 0; i < block_config->output_tensors_size; i++) {
+            if (graph_config->model_output_ctx(contexts[ix], block_config->output_tensors_indices[i],
+                    &outputs[ix * block_config->output_tensors_size + i]) != kTfLiteOk) {
+                return EI_IMPULSE_TFLITE_ERROR;
             }
         }
 
-        result->_raw_outputs[learn_block_index + output_ix].blockId = block_config->block_id + output_ix;
+        ei::matrix_i8_t features_matrix(1, impulse->nn_input_frame_size, input.data.int8);
+        int ret = extract_mfe_ring_quantized(rings[ix], &features_matrix, impulse->dsp_blocks[0].config,
+            input.params.scale, input.params.zero_point);
+        if (ret != EIDSP_OK) {
+            ei_printf("ERR: Failed to run DSP process (%d)\n", ret);
+            return EI_IMPULSE_DSP_ERROR;
+        }
+
+        results[ix].timing.dsp_us = ei_cycles_to_us(ei_read_cycles() - dsp_start_cycles);
+        results[ix].timing.dsp = (int)(results[ix].timing.dsp_us / 1000);
+    }
+
+    uint64_t ctx_start_cycles = ei_read_cycles();
+    if (ei_tflite_eon_invoke_batch(graph_config, contexts, count) != kTfLiteOk) {
+        return EI_IMPULSE_TFLITE_ERROR;
     }
+    const uint64_t classification_us = ei_cycles_to_us(ei_read_cycles() - ctx_start_cycles);
 
-    graph_config->model_reset(ei_aligned_free);
-    ei_free(outputs);
+    if (debug) {
+        ei_printf("Batch of %d windows (%d us.)\n", (int)count, (int)classification_us);
+    }
 
-    if (run_res != EI_IMPULSE_OK) {
-        return run_res;
+    for (size_t ix = 0; ix < count; ix++) {
+        results[ix].timing.classification_us = classification_us;
+        results[ix].timing.classification = (int)(classification_us / 1000);
+#if EI_CLASSIFIER_PROFILE_NODES
+        results[ix].timing.nodes = ei_node_profiler.nodes;
+        results[ix].timing.nodes_count = ei_node_profiler.count < EI_CLASSIFIER_PROFILE_NODES_MAX ?
+            ei_node_profiler.count : EI_CLASSIFIER_PROFILE_NODES_MAX;
+#endif
+
+        EI_IMPULSE_ERROR copy_res = inference_tflite_copy_outputs(block_config,
+            &outputs[ix * block_config->output_tensors_size], 0, &results[ix]);
+        if (copy_res != EI_IMPULSE_OK) {
+            return copy_res;
+        }
+    }
+
+    if (ei_run_impulse_check_canceled() == EI_IMPULSE_CANCELED) {
+        return EI_IMPULSE_CANCELED;
     }
 
     return EI_IMPULSE_OK;
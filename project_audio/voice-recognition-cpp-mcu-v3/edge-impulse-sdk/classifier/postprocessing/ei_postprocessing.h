@@ -123,10 +123,12 @@ extern "C" EI_IMPULSE_ERROR run_postprocessing(ei_impulse_handle_t *handle,
         }
     }
 
-    // free raw results
+    // free raw results (copies in the workspace arena go with its scope)
     for (size_t ix = 0; ix < impulse->output_tensors_size; ix++) {
         if (result->_raw_outputs[ix].matrix) {
-            delete result->_raw_outputs[ix].matrix;
+            if (!ei::ei_dsp_workspace_contains(result->_raw_outputs[ix].matrix)) {
+                delete result->_raw_outputs[ix].matrix;
+            }
             result->_raw_outputs[ix].matrix = nullptr;
         }
     }
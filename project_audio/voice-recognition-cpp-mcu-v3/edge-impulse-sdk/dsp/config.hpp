@@ -102,6 +102,31 @@
 #define EIDSP_SIGNAL_C_FN_POINTER    0
 #endif // EIDSP_SIGNAL_C_FN_POINTER
 
+// take DSP / classifier scratch buffers from a static arena (memory.cpp) instead
+// of the heap while an ei_dsp_workspace_scope is open, see memory.hpp
+#ifndef EIDSP_WORKSPACE_ARENA
+#define EIDSP_WORKSPACE_ARENA    0
+#endif // EIDSP_WORKSPACE_ARENA
+
+// number of sparse mel filterbanks (one per MFE configuration) that
+// speechpy::feature::mfe keeps around between calls
+#ifndef EIDSP_MEL_FILTERBANK_CACHE_SIZE
+#define EIDSP_MEL_FILTERBANK_CACHE_SIZE    2
+#endif // EIDSP_MEL_FILTERBANK_CACHE_SIZE
+
+// run several impulse handles on different threads at once: every handle owns
+// its EON graph context and feature ring, and the DSP state that is not per
+// handle (workspace arena, filterbank cache) is kept per thread
+#ifndef EI_CLASSIFIER_REENTRANT
+#define EI_CLASSIFIER_REENTRANT    0
+#endif // EI_CLASSIFIER_REENTRANT
+
+#if EI_CLASSIFIER_REENTRANT
+#define EIDSP_THREAD_LOCAL    thread_local
+#else
+#define EIDSP_THREAD_LOCAL
+#endif // EI_CLASSIFIER_REENTRANT
+
 #ifndef EIDSP_USE_ESP_DSP
 #if defined(ESP32) || defined(CONFIG_IDF_TARGET_ESP32) || defined(CONFIG_IDF_TARGET_ESP32S3) || defined(CONFIG_IDF_TARGET_ESP32P4) || defined(CONFIG_IDF_TARGET_ESP32C3)
 #define EIDSP_USE_ESP_DSP 1
@@ -216,6 +216,24 @@ static int hw_r2c_fft(const float *input, ei::fft_complex_t *output_as_complex,
     return ei::EIDSP_OK;
 }
 
+/**
+ * Q15 real FFT (arm_rfft_q15). The input is modified. The output holds all n_fft complex
+ * bins (re, im interleaved, 2 * n_fft values), downscaled by n_fft because the CFFT
+ * halves every stage.
+ */
+static int hw_rfft_q15(int16_t *input, int16_t *output, size_t n_fft)
+{
+    if(!can_do_fft(n_fft)) { return ei::EIDSP_FFT_SIZE_NOT_SUPPORTED; }
+
+    arm_rfft_instance_q15 rfft_instance;
+    if (arm_rfft_init_q15(&rfft_instance, n_fft, 0, 1) != ARM_MATH_SUCCESS) {
+        return ei::EIDSP_FFT_TABLE_NOT_LOADED;
+    }
+
+    arm_rfft_q15(&rfft_instance, input, output);
+    return ei::EIDSP_OK;
+}
+
 constexpr int MIN_FFT_SIZE = 32;
 constexpr int MAX_FFT_SIZE = 4096;
 
@@ -149,6 +149,11 @@ static int hw_r2c_fft(const float *input, ei::fft_complex_t *output, size_t n_ff
     return EIDSP_OK;
 }
 
+static int hw_rfft_q15(int16_t *input, int16_t *output, size_t n_fft)
+{
+    return ei::EIDSP_NO_HW_ACCEL;
+}
+
 } // namespace fft
 
 } // namespace ei
@@ -85,6 +85,10 @@ out:
     return 0;
 }
 
+static int hw_rfft_q15(int16_t *input, int16_t *output, size_t n_fft) {
+    return ei::EIDSP_NO_HW_ACCEL;
+}
+
 } // namespace fft
 } // namespace ei
 
@@ -49,6 +49,10 @@ constexpr int hw_r2c_fft(const float *input, ei::fft_complex_t *output, size_t n
     return EIDSP_NO_HW_ACCEL;
 }
 
+constexpr int hw_rfft_q15(int16_t *input, int16_t *output, size_t n_fft) {
+    return EIDSP_NO_HW_ACCEL;
+}
+
 // dummy values
 constexpr int MIN_FFT_SIZE = 0;
 constexpr int MAX_FFT_SIZE = 0;
@@ -30,5 +30,53 @@
  */
 #include "memory.hpp"
 
+#if EIDSP_WORKSPACE_ARENA && __has_include("model-parameters/model_metadata.h")
+#include "model-parameters/model_metadata.h"
+#endif
+
 size_t ei_memory_in_use = 0;
 size_t ei_memory_peak_use = 0;
+
+#if EIDSP_WORKSPACE_ARENA
+#ifndef EIDSP_WORKSPACE_ARENA_SIZE
+#if defined(EI_CLASSIFIER_NN_INPUT_FRAME_SIZE) && defined(EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW)
+
+#if EI_CLASSIFIER_LOAD_FFT_4096
+#define EIDSP_WORKSPACE_FFT_LENGTH      4096
+#elif EI_CLASSIFIER_LOAD_FFT_2048
+#define EIDSP_WORKSPACE_FFT_LENGTH      2048
+#elif EI_CLASSIFIER_LOAD_FFT_1024
+#define EIDSP_WORKSPACE_FFT_LENGTH      1024
+#elif EI_CLASSIFIER_LOAD_FFT_512
+#define EIDSP_WORKSPACE_FFT_LENGTH      512
+#else
+#define EIDSP_WORKSPACE_FFT_LENGTH      256
+#endif
+
+// DSP and classifier use the arena one after the other, so it is sized for the
+// larger of the two (continuous mode, measured 13.1 KB for the quantized MFE model):
+// - DSP, per slice: one slice of features (rolling the feature window, MFE
+//   frames that wrap around the feature ring or go to a uint8 ring), plus
+//   the FFT input, bins, kissfft plan and the frame (~32 bytes per FFT point),
+//   plus the preemphasized chunk of an int16 signal (10 frames, 10 ms stride)
+// - classifier: the normalized copy of the feature window (float input tensors;
+//   quantized MFE models fill the tensor from the feature ring), plus the result
+//   arrays, output tensors and their copies
+#define EIDSP_WORKSPACE_DSP_BYTES       ((EI_CLASSIFIER_NN_INPUT_FRAME_SIZE / EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW) * sizeof(float) + \
+                                         32 * EIDSP_WORKSPACE_FFT_LENGTH + \
+                                         (EI_CLASSIFIER_FREQUENCY / 100) * 11 * sizeof(float))
+#define EIDSP_WORKSPACE_NN_BYTES        (EI_CLASSIFIER_NN_INPUT_FRAME_SIZE * sizeof(float) + 4096)
+#define EIDSP_WORKSPACE_ARENA_SIZE      ((EIDSP_WORKSPACE_DSP_BYTES > EIDSP_WORKSPACE_NN_BYTES) ? \
+                                            EIDSP_WORKSPACE_DSP_BYTES : EIDSP_WORKSPACE_NN_BYTES)
+#else
+#define EIDSP_WORKSPACE_ARENA_SIZE      (32 * 1024)
+#endif
+#endif // EIDSP_WORKSPACE_ARENA_SIZE
+
+namespace ei {
+alignas(EIDSP_WORKSPACE_ALIGNMENT) EIDSP_THREAD_LOCAL uint8_t ei_dsp_workspace_arena[EIDSP_WORKSPACE_ARENA_SIZE];
+EIDSP_THREAD_LOCAL ei_dsp_workspace_stats_t ei_dsp_workspace_stats = { EIDSP_WORKSPACE_ARENA_SIZE, 0, 0, 0, 0 };
+EIDSP_THREAD_LOCAL uint32_t ei_dsp_workspace_depth = 0;
+EIDSP_THREAD_LOCAL ei_dsp_workspace_lent_t ei_dsp_workspace_lent = { nullptr, 0, 0 };
+} // namespace ei
+#endif // EIDSP_WORKSPACE_ARENA
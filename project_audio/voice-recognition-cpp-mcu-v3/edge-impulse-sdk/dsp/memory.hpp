@@ -34,6 +34,7 @@
 // clang-format off
 #include <functional>
 #include <stdio.h>
+#include <string.h>
 #include <memory>
 #include "../porting/ei_classifier_porting.h"
 #include "edge-impulse-sdk/classifier/ei_aligned_malloc.h"
@@ -236,6 +237,209 @@ static ei_unique_ptr_t make_tracked_unique_ptr(void* ptr_in, size_t size)
 }
 #endif
 
+/**
+ * DSP workspace arena (EIDSP_WORKSPACE_ARENA=1)
+ *
+ * Scratch buffers that only live for one DSP / inference call are taken with
+ * ei_dsp_scratch_calloc. While an ei_dsp_workspace_scope is open these come
+ * from a static arena (ei_dsp_workspace_arena, EIDSP_WORKSPACE_ARENA_SIZE
+ * bytes, see memory.cpp) with a bump pointer, and closing the scope hands
+ * everything allocated inside it back at once; scopes nest. Outside a scope,
+ * with the arena disabled or when it is full, the buffers come from the heap
+ * as before (a full arena is counted in heap_fallbacks).
+ * Buffers that outlive the call (caches, warm graphs) keep using ei_dsp_calloc.
+ *
+ * Memory that is idle for a while, e.g. the tensor arena of a warm graph while
+ * the DSP runs, can be lent to the workspace with an ei_dsp_workspace_overlay:
+ * while it is open, scratch buffers go there first and only take arena space
+ * when they don't fit.
+ */
+typedef struct {
+    size_t size;                // arena size in bytes
+    size_t in_use;
+    size_t peak;
+    uint32_t heap_fallbacks;    // scratch allocations inside a scope that did not fit
+    size_t lent_peak;           // most bytes in use of lent memory (ei_dsp_workspace_overlay)
+} ei_dsp_workspace_stats_t;
+
+#if EIDSP_WORKSPACE_ARENA
+#define EIDSP_WORKSPACE_ALIGNMENT   16
+
+// memory lent to the workspace by the innermost ei_dsp_workspace_overlay
+typedef struct {
+    uint8_t *base;
+    size_t size;
+    size_t in_use;
+} ei_dsp_workspace_lent_t;
+
+// one arena per thread with EI_CLASSIFIER_REENTRANT
+extern EIDSP_THREAD_LOCAL uint8_t ei_dsp_workspace_arena[];
+extern EIDSP_THREAD_LOCAL ei_dsp_workspace_stats_t ei_dsp_workspace_stats;
+extern EIDSP_THREAD_LOCAL uint32_t ei_dsp_workspace_depth;
+extern EIDSP_THREAD_LOCAL ei_dsp_workspace_lent_t ei_dsp_workspace_lent;
+
+class ei_dsp_workspace_scope {
+public:
+    ei_dsp_workspace_scope()
+        : _mark(ei_dsp_workspace_stats.in_use), _lent_mark(ei_dsp_workspace_lent.in_use) {
+        ei_dsp_workspace_depth++;
+    }
+
+    ~ei_dsp_workspace_scope() {
+        ei_dsp_workspace_stats.in_use = _mark;
+        ei_dsp_workspace_lent.in_use = _lent_mark;
+        ei_dsp_workspace_depth--;
+    }
+
+    ei_dsp_workspace_scope(const ei_dsp_workspace_scope &) = delete;
+    ei_dsp_workspace_scope &operator=(const ei_dsp_workspace_scope &) = delete;
+
+private:
+    size_t _mark;
+    size_t _lent_mark;
+};
+
+/**
+ * Lends `bytes` at `region` to the workspace until it goes out of scope. It is a
+ * scope itself: everything allocated while it is open is handed back when it
+ * closes, so nothing outlives the time the region is idle. No-op for a nullptr
+ * region.
+ */
+class ei_dsp_workspace_overlay {
+public:
+    ei_dsp_workspace_overlay(void *region, size_t bytes) : _previous(ei_dsp_workspace_lent) {
+        if (region == nullptr) {
+            return;
+        }
+        const uintptr_t start = ((uintptr_t)region + EIDSP_WORKSPACE_ALIGNMENT - 1) &
+            ~(uintptr_t)(EIDSP_WORKSPACE_ALIGNMENT - 1);
+        const uintptr_t end = (uintptr_t)region + bytes;
+        ei_dsp_workspace_lent.base = (uint8_t *)start;
+        ei_dsp_workspace_lent.size = end > start ? end - start : 0;
+        ei_dsp_workspace_lent.in_use = 0;
+    }
+
+    ~ei_dsp_workspace_overlay() {
+        ei_dsp_workspace_lent = _previous;
+    }
+
+    ei_dsp_workspace_overlay(const ei_dsp_workspace_overlay &) = delete;
+    ei_dsp_workspace_overlay &operator=(const ei_dsp_workspace_overlay &) = delete;
+
+private:
+    ei_dsp_workspace_scope _scope;
+    ei_dsp_workspace_lent_t _previous;
+};
+
+__attribute__((unused)) static void *ei_dsp_scratch_calloc(size_t num, size_t size) {
+    if (ei_dsp_workspace_depth > 0) {
+        size_t bytes = (num * size + EIDSP_WORKSPACE_ALIGNMENT - 1) & ~(size_t)(EIDSP_WORKSPACE_ALIGNMENT - 1);
+        if (ei_dsp_workspace_lent.in_use + bytes <= ei_dsp_workspace_lent.size) {
+            void *ptr = ei_dsp_workspace_lent.base + ei_dsp_workspace_lent.in_use;
+            ei_dsp_workspace_lent.in_use += bytes;
+            if (ei_dsp_workspace_lent.in_use > ei_dsp_workspace_stats.lent_peak) {
+                ei_dsp_workspace_stats.lent_peak = ei_dsp_workspace_lent.in_use;
+            }
+            memset(ptr, 0, num * size);
+            return ptr;
+        }
+        if (ei_dsp_workspace_stats.in_use + bytes <= ei_dsp_workspace_stats.size) {
+            void *ptr = ei_dsp_workspace_arena + ei_dsp_workspace_stats.in_use;
+            ei_dsp_workspace_stats.in_use += bytes;
+            if (ei_dsp_workspace_stats.in_use > ei_dsp_workspace_stats.peak) {
+                ei_dsp_workspace_stats.peak = ei_dsp_workspace_stats.in_use;
+            }
+            memset(ptr, 0, num * size);
+            return ptr;
+        }
+        ei_dsp_workspace_stats.heap_fallbacks++;
+    }
+    return ei_dsp_calloc(num, size);
+}
+
+__attribute__((unused)) static bool ei_dsp_workspace_contains(const void *ptr) {
+    const uint8_t *p = static_cast<const uint8_t *>(ptr);
+    if (p >= ei_dsp_workspace_lent.base && p < ei_dsp_workspace_lent.base + ei_dsp_workspace_lent.size) {
+        return true;
+    }
+    return p >= ei_dsp_workspace_arena && p < ei_dsp_workspace_arena + ei_dsp_workspace_stats.size;
+}
+
+__attribute__((unused)) static void ei_dsp_scratch_free(void *ptr, size_t size) {
+    (void)size; // only read by ei_dsp_free when EIDSP_TRACK_ALLOCATIONS is set
+    if (ei_dsp_workspace_contains(ptr)) {
+        return; // handed back when its scope closes
+    }
+    ei_dsp_free(ptr, size);
+}
+#else
+class ei_dsp_workspace_scope {
+public:
+    ei_dsp_workspace_scope() { }
+};
+
+class ei_dsp_workspace_overlay {
+public:
+    ei_dsp_workspace_overlay(void *region, size_t bytes) {
+        (void)region;
+        (void)bytes;
+    }
+};
+
+__attribute__((unused)) static void *ei_dsp_scratch_calloc(size_t num, size_t size) {
+    return ei_dsp_calloc(num, size);
+}
+
+__attribute__((unused)) static bool ei_dsp_workspace_contains(const void *ptr) {
+    (void)ptr;
+    return false;
+}
+
+__attribute__((unused)) static void ei_dsp_scratch_free(void *ptr, size_t size) {
+    (void)size;
+    ei_dsp_free(ptr, size);
+}
+#endif // EIDSP_WORKSPACE_ARENA
+
+/**
+ * Scratch buffer of `count` zeroed T's that is handed back when it goes out of scope
+ */
+template <typename T>
+class ei_dsp_scratch_buffer {
+public:
+    explicit ei_dsp_scratch_buffer(size_t count)
+        : _buffer(static_cast<T *>(ei_dsp_scratch_calloc(count, sizeof(T)))), _size(count * sizeof(T)) { }
+
+    ~ei_dsp_scratch_buffer() {
+        if (_buffer) {
+            ei_dsp_scratch_free(_buffer, _size);
+        }
+    }
+
+    ei_dsp_scratch_buffer(const ei_dsp_scratch_buffer &) = delete;
+    ei_dsp_scratch_buffer &operator=(const ei_dsp_scratch_buffer &) = delete;
+
+    T *get() const { return _buffer; }
+
+private:
+    T *_buffer;
+    size_t _size;
+};
+
+// like EI_DSP_MATRIX, but the buffer is a scratch buffer (from the workspace arena when a scope is open)
+#define EI_DSP_SCRATCH_MATRIX(name, n_rows, n_cols) \
+    ei_dsp_scratch_buffer<float> name##_scratch((n_rows) * (n_cols)); \
+    if (!name##_scratch.get()) { EIDSP_ERR(EIDSP_OUT_OF_MEM); } \
+    matrix_t name(n_rows, n_cols, name##_scratch.get());
+
+__attribute__((unused)) static void ei_dsp_get_workspace_stats(ei_dsp_workspace_stats_t *stats) {
+#if EIDSP_WORKSPACE_ARENA
+    *stats = ei_dsp_workspace_stats;
+#else
+    memset(stats, 0, sizeof(ei_dsp_workspace_stats_t));
+#endif
+}
+
 /*
  * @brief Make a unique ptr that supports memory tracking
  * @param ptr A pointer that will be written with the malloc'd address
@@ -119,6 +119,78 @@ static constexpr float quantized_values_one_zero[] = { (0.0f / 1.0f), (1.0f / 10
     1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
 // clang-format on
 
+/**
+ * Scratch buffers for numpy::power_spectrum, sized for one FFT length.
+ * Allocate once before a frame loop and pass to every call, so the loop
+ * itself does not touch the heap.
+ */
+struct power_spectrum_workspace {
+    size_t n_fft = 0;
+    float *fft_input = nullptr;             // n_fft samples, frame + zero padding
+    fft_complex_t *fft_output = nullptr;    // n_fft / 2 + 1 bins
+    kiss_fftr_cfg kiss_cfg = nullptr;       // software FFT plan, built on first use
+    size_t kiss_cfg_size = 0;
+
+    power_spectrum_workspace(size_t n_fft) : n_fft(n_fft) {
+        fft_input = (float *)ei_dsp_scratch_calloc(n_fft, sizeof(float));
+        fft_output = (fft_complex_t *)ei_dsp_scratch_calloc(n_fft / 2 + 1, sizeof(fft_complex_t));
+    }
+
+    ~power_spectrum_workspace() {
+        if (kiss_cfg) {
+            ei_dsp_scratch_free(kiss_cfg, kiss_cfg_size);
+        }
+        if (fft_output) {
+            ei_dsp_scratch_free(fft_output, (n_fft / 2 + 1) * sizeof(fft_complex_t));
+        }
+        if (fft_input) {
+            ei_dsp_scratch_free(fft_input, n_fft * sizeof(float));
+        }
+    }
+
+    power_spectrum_workspace(const power_spectrum_workspace &) = delete;
+    power_spectrum_workspace &operator=(const power_spectrum_workspace &) = delete;
+
+    bool is_valid() const {
+        return fft_input && fft_output;
+    }
+};
+
+/**
+ * Scratch buffers for numpy::power_spectrum_q15, sized for one FFT length
+ * (see power_spectrum_workspace).
+ */
+struct power_spectrum_q15_workspace {
+    size_t n_fft = 0;
+    int16_t *fft_input = nullptr;           // n_fft q15 samples, frame + zero padding
+    int16_t *fft_output = nullptr;          // n_fft complex bins, re / im interleaved
+    int16_t *twiddles = nullptr;            // software FFT: n_fft / 2 cos, then n_fft / 2 sin, built on first use
+
+    power_spectrum_q15_workspace(size_t n_fft) : n_fft(n_fft) {
+        fft_input = (int16_t *)ei_dsp_scratch_calloc(n_fft, sizeof(int16_t));
+        fft_output = (int16_t *)ei_dsp_scratch_calloc(n_fft * 2, sizeof(int16_t));
+    }
+
+    ~power_spectrum_q15_workspace() {
+        if (twiddles) {
+            ei_dsp_scratch_free(twiddles, n_fft * sizeof(int16_t));
+        }
+        if (fft_output) {
+            ei_dsp_scratch_free(fft_output, n_fft * 2 * sizeof(int16_t));
+        }
+        if (fft_input) {
+            ei_dsp_scratch_free(fft_input, n_fft * sizeof(int16_t));
+        }
+    }
+
+    power_spectrum_q15_workspace(const power_spectrum_q15_workspace &) = delete;
+    power_spectrum_q15_workspace &operator=(const power_spectrum_q15_workspace &) = delete;
+
+    bool is_valid() const {
+        return fft_input && fft_output;
+    }
+};
+
 class numpy {
 public:
 
@@ -141,27 +213,7 @@ public:
      * @returns EIDSP_OK if OK
      */
     static int roll(float *input_array, size_t input_array_size, int shift) {
-        if (shift < 0) {
-            shift = input_array_size + shift;
-        }
-
-        if (shift == 0) {
-            return EIDSP_OK;
-        }
-
-        // so we need to allocate a buffer of the size of shift...
-        EI_DSP_MATRIX(shift_matrix, 1, shift);
-
-        // we copy from the end of the buffer into the shift buffer
-        memcpy(shift_matrix.buffer, input_array + input_array_size - shift, shift * sizeof(float));
-
-        // now we do a memmove to shift the array
-        memmove(input_array + shift, input_array, (input_array_size - shift) * sizeof(float));
-
-        // and copy the shift buffer back to the beginning of the array
-        memcpy(input_array, shift_matrix.buffer, shift * sizeof(float));
-
-        return EIDSP_OK;
+        return roll_array(input_array, input_array_size, shift);
     }
 
     /**
@@ -173,27 +225,7 @@ public:
      * @returns EIDSP_OK if OK
      */
     static int roll(int *input_array, size_t input_array_size, int shift) {
-        if (shift < 0) {
-            shift = input_array_size + shift;
-        }
-
-        if (shift == 0) {
-            return EIDSP_OK;
-        }
-
-        // so we need to allocate a buffer of the size of shift...
-        EI_DSP_MATRIX(shift_matrix, 1, shift);
-
-        // we copy from the end of the buffer into the shift buffer
-        memcpy(shift_matrix.buffer, input_array + input_array_size - shift, shift * sizeof(int));
-
-        // now we do a memmove to shift the array
-        memmove(input_array + shift, input_array, (input_array_size - shift) * sizeof(int));
-
-        // and copy the shift buffer back to the beginning of the array
-        memcpy(input_array, shift_matrix.buffer, shift * sizeof(int));
-
-        return EIDSP_OK;
+        return roll_array(input_array, input_array_size, shift);
     }
 
     /**
@@ -205,27 +237,7 @@ public:
      * @returns EIDSP_OK if OK
      */
     static int roll(int16_t *input_array, size_t input_array_size, int shift) {
-        if (shift < 0) {
-            shift = input_array_size + shift;
-        }
-
-        if (shift == 0) {
-            return EIDSP_OK;
-        }
-
-        // so we need to allocate a buffer of the size of shift...
-        EI_DSP_MATRIX(shift_matrix, 1, shift);
-
-        // we copy from the end of the buffer into the shift buffer
-        memcpy(shift_matrix.buffer, input_array + input_array_size - shift, shift * sizeof(int16_t));
-
-        // now we do a memmove to shift the array
-        memmove(input_array + shift, input_array, (input_array_size - shift) * sizeof(int16_t));
-
-        // and copy the shift buffer back to the beginning of the array
-        memcpy(input_array, shift_matrix.buffer, shift * sizeof(int16_t));
-
-        return EIDSP_OK;
+        return roll_array(input_array, input_array_size, shift);
     }
 
     static float sum(float *input_array, size_t input_array_size) {
@@ -1498,6 +1510,7 @@ public:
     static int signal_from_buffer(const float *data, size_t data_size, signal_t *signal)
     {
         signal->total_length = data_size;
+        signal->int16_data = nullptr;
 #ifdef __MBED__
         signal->get_data = mbed::callback(&numpy::signal_get_data, data);
 #else
@@ -1508,6 +1521,29 @@ public:
         return EIDSP_OK;
     }
 
+    /**
+     * Create a signal structure from an int16 buffer (e.g. audio).
+     * get_data converts to float, and DSP blocks that support it read the
+     * samples directly through signal->int16_data.
+     * @param data Buffer, make sure to keep this pointer alive
+     * @param data_size Size of the buffer
+     * @param signal Output signal
+     * @returns EIDSP_OK if ok
+     */
+    static int signal_from_int16_buffer(const EIDSP_i16 *data, size_t data_size, signal_t *signal)
+    {
+        signal->total_length = data_size;
+        signal->int16_data = data;
+#ifdef __MBED__
+        signal->get_data = mbed::callback(&numpy::signal_get_data_int16, data);
+#else
+        signal->get_data = [data](size_t offset, size_t length, float *out_ptr) {
+            return numpy::signal_get_data_int16(data, offset, length, out_ptr);
+        };
+#endif
+        return EIDSP_OK;
+    }
+
 #endif
 
 #if defined ( __GNUC__ )
@@ -1771,6 +1807,11 @@ public:
         return 0;
     }
 
+    static int signal_get_data_int16(const EIDSP_i16 *in_buffer, size_t offset, size_t length, float *out_ptr)
+    {
+        return int16_to_float(in_buffer + offset, out_ptr, length);
+    }
+
 #if EIDSP_USE_CMSIS_DSP
     /**
      * @brief      The CMSIS std variance function with the same behaviour as the NumPy
@@ -2049,23 +2090,171 @@ public:
         size_t out_buffer_size,
         uint16_t fft_points)
     {
-        if (out_buffer_size != static_cast<size_t>(fft_points / 2 + 1)) {
+        power_spectrum_workspace workspace(fft_points);
+        if (!workspace.is_valid()) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        return power_spectrum(frame, frame_size, out_buffer, out_buffer_size, &workspace);
+    }
+
+    /**
+     * Power spectrum of a frame, (r^2 + i^2) / n_fft straight from the complex
+     * FFT output (no magnitude / sqrt round trip) and without allocating:
+     * all scratch memory comes from the workspace.
+     * @param frame Row of a frame
+     * @param frame_size Size of the frame, zero-padded (or truncated) to workspace->n_fft
+     * @param out_buffer Out buffer, size should be n_fft / 2 + 1
+     * @param out_buffer_size Buffer size
+     * @param workspace Scratch buffers for this FFT length, reuse it for every frame
+     * @returns EIDSP_OK if OK
+     */
+    static int power_spectrum(
+        const float *frame,
+        size_t frame_size,
+        float *out_buffer,
+        size_t out_buffer_size,
+        power_spectrum_workspace *workspace)
+    {
+        const size_t n_fft = workspace->n_fft;
+        if (out_buffer_size != n_fft / 2 + 1) {
             EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
         }
+        if (!workspace->is_valid()) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
 
-        int r = numpy::rfft(frame, frame_size, out_buffer, out_buffer_size, fft_points);
-        if (r != EIDSP_OK) {
-            return r;
+        if (frame_size > n_fft) {
+            frame_size = n_fft;
+        }
+
+        // the FFT modifies its input (arm) so copy and pad every time
+        memcpy(workspace->fft_input, frame, frame_size * sizeof(float));
+        memset(workspace->fft_input + frame_size, 0, (n_fft - frame_size) * sizeof(float));
+
+        auto res = ei::fft::hw_r2c_fft(workspace->fft_input, workspace->fft_output, n_fft);
+        if (handle_fft_hw_failure(res, n_fft)) {
+#if EIDSP_INCLUDE_KISSFFT || !defined(EIDSP_INCLUDE_KISSFFT)
+            if (!workspace->kiss_cfg) {
+                // query the plan size first, so the plan can live in scratch memory
+                size_t cfg_size = 0;
+                kiss_fftr_alloc(n_fft, 0, NULL, &cfg_size, NULL);
+                void *cfg_mem = ei_dsp_scratch_calloc(cfg_size, 1);
+                if (!cfg_mem) {
+                    EIDSP_ERR(EIDSP_OUT_OF_MEM);
+                }
+                workspace->kiss_cfg = kiss_fftr_alloc(n_fft, 0, cfg_mem, &cfg_size, NULL);
+                workspace->kiss_cfg_size = cfg_size;
+                if (!workspace->kiss_cfg) {
+                    ei_dsp_scratch_free(cfg_mem, cfg_size);
+                    EIDSP_ERR(EIDSP_OUT_OF_MEM);
+                }
+            }
+            kiss_fftr(workspace->kiss_cfg, workspace->fft_input, (kiss_fft_cpx *)workspace->fft_output);
+#else
+            return EIDSP_NOT_SUPPORTED;
+#endif
         }
 
+        const float scale = 1.0f / static_cast<float>(n_fft);
+#if EIDSP_USE_CMSIS_DSP
+        arm_cmplx_mag_squared_f32((const float *)workspace->fft_output, out_buffer, out_buffer_size);
+        arm_scale_f32(out_buffer, scale, out_buffer, out_buffer_size);
+#else
+        const fft_complex_t *bins = workspace->fft_output;
         for (size_t ix = 0; ix < out_buffer_size; ix++) {
-            out_buffer[ix] = (1.0 / static_cast<float>(fft_points)) *
-                (out_buffer[ix] * out_buffer[ix]);
+            out_buffer[ix] = (bins[ix].r * bins[ix].r + bins[ix].i * bins[ix].i) * scale;
         }
+#endif
 
         return EIDSP_OK;
     }
 
+    /**
+     * Power spectrum of a q15 frame: r^2 + i^2 of the q15 real FFT, which is
+     * downscaled by n_fft (arm_rfft_q15, or the same in software). So
+     * out[k] * n_fft equals |FFT(frame)[k]|^2, in q15 units; the float
+     * power_spectrum of frame / 32768 is out[k] * n_fft / 2^30.
+     * @param frame q15 samples
+     * @param frame_size Size of the frame, zero-padded (or truncated) to workspace->n_fft
+     * @param out_buffer Out buffer, size should be n_fft / 2 + 1
+     * @param out_buffer_size Buffer size
+     * @param workspace Scratch buffers for this FFT length, reuse it for every frame
+     * @returns EIDSP_OK if OK
+     */
+    static int power_spectrum_q15(
+        const int16_t *frame,
+        size_t frame_size,
+        uint32_t *out_buffer,
+        size_t out_buffer_size,
+        power_spectrum_q15_workspace *workspace)
+    {
+        const size_t n_fft = workspace->n_fft;
+        if (out_buffer_size != n_fft / 2 + 1) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+        if (!workspace->is_valid()) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+        if ((n_fft & (n_fft - 1)) != 0 || n_fft < 4) {
+            EIDSP_ERR(EIDSP_FFT_SIZE_NOT_SUPPORTED);
+        }
+
+        if (frame_size > n_fft) {
+            frame_size = n_fft;
+        }
+
+        // the FFT modifies its input (arm) so copy and pad every time
+        memcpy(workspace->fft_input, frame, frame_size * sizeof(int16_t));
+        memset(workspace->fft_input + frame_size, 0, (n_fft - frame_size) * sizeof(int16_t));
+
+        auto res = ei::fft::hw_rfft_q15(workspace->fft_input, workspace->fft_output, n_fft);
+        if (handle_fft_hw_failure(res, n_fft)) {
+            int ret = software_rfft_q15(workspace);
+            if (ret != EIDSP_OK) {
+                EIDSP_ERR(ret);
+            }
+        }
+
+        const int16_t *bins = workspace->fft_output;
+        for (size_t ix = 0; ix < out_buffer_size; ix++) {
+            const int32_t r = bins[ix * 2];
+            const int32_t i = bins[ix * 2 + 1];
+            out_buffer[ix] = static_cast<uint32_t>(r * r) + static_cast<uint32_t>(i * i);
+        }
+
+        return EIDSP_OK;
+    }
+
+    /**
+     * Fixed-point log2
+     * @param x Input, > 0
+     * @returns log2(x) in Q16 (error < 2^-12)
+     */
+    static int32_t log2_q16(uint64_t x)
+    {
+        // log2(1 + i / 32) in Q16, linearly interpolated in between
+        static const int32_t table[33] = {
+            0, 2909, 5732, 8473, 11136, 13727, 16248, 18704, 21098, 23433, 25711,
+            27936, 30109, 32234, 34312, 36346, 38336, 40286, 42196, 44068, 45904,
+            47705, 49472, 51207, 52911, 54584, 56229, 57845, 59434, 60997, 62534,
+            64047, 65536
+        };
+
+        if (x == 0) {
+            return INT32_MIN;
+        }
+
+        const int msb = 63 - __builtin_clzll(x);
+        // mantissa in [2^31, 2^32)
+        const uint32_t mantissa = static_cast<uint32_t>(msb >= 31 ? (x >> (msb - 31)) : (x << (31 - msb)));
+        const uint32_t fraction = mantissa & 0x7fffffffu;
+        const uint32_t ix = fraction >> 26;
+        const int64_t rem = fraction & ((1u << 26) - 1);
+
+        return (msb << 16) + table[ix] + static_cast<int32_t>(((table[ix + 1] - table[ix]) * rem) >> 26);
+    }
+
     static int welch_max_hold(
         float *input,
         size_t input_size,
@@ -2394,9 +2583,13 @@ public:
 
     static float dot(const float* x, const float* y, size_t n) {
         float res = 0;
+#if EIDSP_USE_CMSIS_DSP
+        arm_dot_prod_f32(x, y, n, &res);
+#else
         for (size_t i = 0; i < n; i++) {
             res += x[i] * y[i];
         }
+#endif
         return res;
     }
 
@@ -2467,14 +2660,123 @@ public:
     }
 
 private:
+    /**
+     * Rotate an array right by shift (negative = left), only the smaller of the
+     * two parts goes through a scratch buffer
+     */
+    template <typename T>
+    static int roll_array(T *input_array, size_t input_array_size, int shift) {
+        if (input_array_size == 0) {
+            return EIDSP_OK;
+        }
+        if (shift < 0) {
+            shift = input_array_size + shift;
+        }
+
+        if (shift == 0) {
+            return EIDSP_OK;
+        }
+
+        const size_t tail = static_cast<size_t>(shift);
+        const size_t head = input_array_size - tail;
+
+        if (tail <= head) {
+            ei_dsp_scratch_buffer<T> shift_buffer(tail);
+            if (!shift_buffer.get()) {
+                EIDSP_ERR(EIDSP_OUT_OF_MEM);
+            }
+            // the last `tail` elements move to the front
+            memcpy(shift_buffer.get(), input_array + head, tail * sizeof(T));
+            memmove(input_array + tail, input_array, head * sizeof(T));
+            memcpy(input_array, shift_buffer.get(), tail * sizeof(T));
+        }
+        else {
+            ei_dsp_scratch_buffer<T> shift_buffer(head);
+            if (!shift_buffer.get()) {
+                EIDSP_ERR(EIDSP_OUT_OF_MEM);
+            }
+            // the first `head` elements move to the back
+            memcpy(shift_buffer.get(), input_array, head * sizeof(T));
+            memmove(input_array, input_array + head, tail * sizeof(T));
+            memcpy(input_array + tail, shift_buffer.get(), head * sizeof(T));
+        }
+
+        return EIDSP_OK;
+    }
+
     /**
      * Helper function to handle FFT hardware acceleration failures and logging
      * @param res Result code from hardware FFT attempt
      * @param n_fft FFT size that was attempted
      * @returns true if should fallback to software FFT
      */
+    /**
+     * Radix-2 q15 FFT of the real workspace->fft_input into workspace->fft_output,
+     * halving every stage like arm_cfft_q15, for targets without CMSIS-DSP
+     */
+    static int software_rfft_q15(power_spectrum_q15_workspace *workspace)
+    {
+        const size_t n_fft = workspace->n_fft;
+        const size_t half = n_fft / 2;
+
+        if (!workspace->twiddles) {
+            workspace->twiddles = (int16_t *)ei_dsp_scratch_calloc(n_fft, sizeof(int16_t));
+            if (!workspace->twiddles) {
+                EIDSP_ERR(EIDSP_OUT_OF_MEM);
+            }
+            for (size_t k = 0; k < half; k++) {
+                const double angle = 2.0 * M_PI * static_cast<double>(k) / static_cast<double>(n_fft);
+                workspace->twiddles[k] = static_cast<int16_t>(lround(32767.0 * cos(angle)));
+                workspace->twiddles[half + k] = static_cast<int16_t>(lround(32767.0 * sin(angle)));
+            }
+        }
+
+        size_t log2_n_fft = 0;
+        while ((static_cast<size_t>(1) << log2_n_fft) < n_fft) {
+            log2_n_fft++;
+        }
+
+        // bit-reversed copy, imaginary part 0
+        int16_t *out = workspace->fft_output;
+        for (size_t ix = 0; ix < n_fft; ix++) {
+            size_t rev = 0;
+            for (size_t bit = 0; bit < log2_n_fft; bit++) {
+                rev |= ((ix >> bit) & 1) << (log2_n_fft - 1 - bit);
+            }
+            out[rev * 2] = workspace->fft_input[ix];
+            out[rev * 2 + 1] = 0;
+        }
+
+        const int16_t *cos_table = workspace->twiddles;
+        const int16_t *sin_table = workspace->twiddles + half;
+
+        for (size_t len = 2; len <= n_fft; len <<= 1) {
+            const size_t span = len / 2;
+            const size_t step = n_fft / len;
+            for (size_t start = 0; start < n_fft; start += len) {
+                for (size_t k = 0; k < span; k++) {
+                    // w = exp(-2 pi i k / len)
+                    const int32_t wr = cos_table[k * step];
+                    const int32_t wi = -sin_table[k * step];
+                    int16_t *a = out + (start + k) * 2;
+                    int16_t *b = out + (start + k + span) * 2;
+                    const int32_t tr = (wr * b[0] - wi * b[1] + (1 << 14)) >> 15;
+                    const int32_t ti = (wr * b[1] + wi * b[0] + (1 << 14)) >> 15;
+                    const int32_t ar = a[0];
+                    const int32_t ai = a[1];
+                    a[0] = static_cast<int16_t>((ar + tr) >> 1);
+                    a[1] = static_cast<int16_t>((ai + ti) >> 1);
+                    b[0] = static_cast<int16_t>((ar - tr) >> 1);
+                    b[1] = static_cast<int16_t>((ai - ti) >> 1);
+                }
+            }
+        }
+
+        return EIDSP_OK;
+    }
+
     static bool handle_fft_hw_failure(int res, size_t n_fft) {
-        static bool first_time = true;
+        static EIDSP_THREAD_LOCAL bool first_time = true;
         if (res == EIDSP_OK) {
             return false;
         }
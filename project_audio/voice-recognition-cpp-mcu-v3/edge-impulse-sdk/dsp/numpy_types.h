@@ -699,6 +699,13 @@ typedef struct ei_signal_t {
      *  preprocessing and inference.
     */
     size_t total_length;
+
+    /**
+     * Optional: the int16 samples that get_data converts (get_data must still be set,
+     * see numpy::signal_from_int16_buffer). DSP blocks that can (MFE) then read them
+     * directly and convert, preemphasize and scale in one pass instead of calling get_data.
+     */
+    const EIDSP_i16 *int16_data = nullptr;
 } signal_t;
 
 /** @} */
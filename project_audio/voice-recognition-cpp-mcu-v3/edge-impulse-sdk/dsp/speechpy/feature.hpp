@@ -43,6 +43,27 @@
 namespace ei {
 namespace speechpy {
 
+// one triangular filter of a sparse mel filterbank
+typedef struct {
+    uint16_t start_bin;         // first FFT bin with a non-zero weight
+    uint16_t length;            // number of consecutive bins from start_bin
+    uint16_t weights_offset;    // first weight of this filter in mel_filterbank_t::weights
+} mel_filter_t;
+
+// sparse mel filterbank for mfe, see feature::get_mel_filterbank
+typedef struct {
+    uint32_t sampling_frequency;
+    uint32_t low_frequency;
+    uint32_t high_frequency;
+    uint16_t num_filters;
+    uint16_t fft_length;
+    uint16_t version;
+    mel_filter_t *filters;      // num_filters entries
+    float *weights;             // weights of all filters, back to back
+    int16_t *weights_q15;       // the same weights in q15, for mfe_q15
+    size_t weights_size;
+} mel_filterbank_t;
+
 class feature {
 public:
     /**
@@ -194,89 +215,29 @@ public:
     }
 
     /**
-     * Compute Mel-filterbank energy features from an audio signal.
-     * @param out_features Use `calculate_mfe_buffer_size` to allocate the right matrix.
-     * @param out_energies A matrix in the form of Mx1 where M is the rows from `calculate_mfe_buffer_size`
-     * @param signal: audio signal structure with functions to retrieve data from a signal
-     * @param sampling_frequency (int): the sampling frequency of the signal
-     *     we are working with.
-     * @param frame_length (float): the length of each frame in seconds.
-     *     Default is 0.020s
-     * @param frame_stride (float): the step between successive frames in seconds.
-     *     Default is 0.02s (means no overlap)
-     * @param num_filters (int): the number of filters in the filterbank,
-     *     default 40.
-     * @param fft_length (int): number of FFT points. Default is 512.
-     * @param low_frequency (int): lowest band edge of mel filters.
-     *     In Hz, default is 0.
-     * @param high_frequency (int): highest band edge of mel filters.
-     *     In Hz, default is samplerate/2
-     * @EIDSP_OK if OK
+     * Build the sparse mel filterbank used by mfe. Same triangles as the
+     * dense filterbanks() (including the v<4 bin bug and the last-bucket fix),
+     * but every filter only keeps the bins with a non-zero weight, so applying
+     * it is one multiply-accumulate over consecutive bins per filter.
+     * @param filterbank Out, release with free_mel_filterbank
+     * @returns EIDSP_OK if OK
      */
-    static int mfe(matrix_t *out_features, matrix_t *out_energies,
-        signal_t *signal,
-        uint32_t sampling_frequency,
-        float frame_length, float frame_stride, uint16_t num_filters,
-        uint16_t fft_length, uint32_t low_frequency, uint32_t high_frequency,
-        uint16_t version
-        )
+    static int build_mel_filterbank(
+        mel_filterbank_t *filterbank,
+        uint32_t sampling_frequency, uint16_t num_filters, uint16_t fft_length,
+        uint32_t low_frequency, uint32_t high_frequency, uint16_t version)
     {
-        int ret = 0;
-
-        if (high_frequency == 0) {
-            high_frequency = sampling_frequency / 2;
-        }
-
-        if (version<4) {
-            if (low_frequency == 0) {
-                low_frequency = 300;
-            }
-        }
-
-        stack_frames_info_t stack_frame_info = { 0 };
-        stack_frame_info.signal = signal;
-
-        ret = processing::stack_frames(
-            &stack_frame_info,
-            sampling_frequency,
-            frame_length,
-            frame_stride,
-            false,
-            version
-        );
-        if (ret != 0) {
-            EIDSP_ERR(ret);
-        }
-
-        if (stack_frame_info.frame_ixs.size() != out_features->rows) {
-            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
-        }
-
-        if (num_filters != out_features->cols) {
-            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
-        }
-
-        if (out_energies) {
-            if (stack_frame_info.frame_ixs.size() != out_energies->rows || out_energies->cols != 1) {
-                EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
-            }
-        }
-
-        for (uint32_t i = 0; i < out_features->rows * out_features->cols; i++) {
-            *(out_features->buffer + i) = 0;
-        }
+        memset(filterbank, 0, sizeof(mel_filterbank_t));
 
         const size_t power_spectrum_frame_size = (fft_length / 2 + 1);
         // Computing the Mel filterbank
         // converting the upper and lower frequencies to Mels.
         // num_filter + 2 is because for num_filter filterbanks we need
         // num_filter+2 point.
-        float *mels;
         const int MELS_SIZE = num_filters + 2;
-        const size_t mem_size = MELS_SIZE * sizeof(float);
-        mels = (float*)ei_dsp_calloc(MELS_SIZE, sizeof(float));
+        float *mels = (float*)ei_dsp_calloc(MELS_SIZE, sizeof(float));
         EI_ERR_AND_RETURN_ON_NULL(mels, EIDSP_OUT_OF_MEM);
-        ei_unique_ptr_t __ptr__(mels,[mem_size](void* ptr){ei::ei_dsp_free_func(ptr, mem_size);});
+        ei_unique_ptr_t __ptr__(mels,[MELS_SIZE](void* ptr){ei::ei_dsp_free_func(ptr, MELS_SIZE * sizeof(float));});
         uint16_t* bins = reinterpret_cast<uint16_t*>(mels); // alias the mels array so we can reuse the space
 
         numpy::linspace(
@@ -309,90 +270,246 @@ public:
         mels[MELS_SIZE-1] -= 0.001;
         bins[MELS_SIZE-1] = get_fft_bin_from_hertz(max_bin, mels[MELS_SIZE-1], sampling_frequency);
 
-        EI_DSP_MATRIX(power_spectrum_frame, 1, power_spectrum_frame_size);
-        if (!power_spectrum_frame.buffer) {
-            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        // both left and right have zero weight, middle always has weight 1.0
+        // (also when it coincides with left or right), so a filter covers
+        // [min(left + 1, middle), max(right - 1, middle)]
+        size_t weights_size = 0;
+        for (size_t i = 0; i < num_filters; i++) {
+            size_t first = (bins[i] + 1u < bins[i+1]) ? bins[i] + 1u : bins[i+1];
+            size_t last = (bins[i+2] > bins[i+1]) ? bins[i+2] - 1u : bins[i+1];
+            if (last >= power_spectrum_frame_size) {
+                EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+            }
+            weights_size += last - first + 1;
         }
 
-        // get signal data from the audio file
-        EI_DSP_MATRIX(signal_frame, 1, stack_frame_info.frame_length);
+        filterbank->filters = (mel_filter_t*)ei_dsp_calloc(num_filters, sizeof(mel_filter_t));
+        filterbank->weights = (float*)ei_dsp_calloc(weights_size, sizeof(float));
+        filterbank->weights_q15 = (int16_t*)ei_dsp_calloc(weights_size, sizeof(int16_t));
+        if (!filterbank->filters || !filterbank->weights || !filterbank->weights_q15) {
+            free_mel_filterbank(filterbank);
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
 
-        for (size_t ix = 0; ix < stack_frame_info.frame_ixs.size(); ix++) {
-            // don't read outside of the audio buffer... we'll automatically zero pad then
-            size_t signal_offset = stack_frame_info.frame_ixs.at(ix);
-            size_t signal_length = stack_frame_info.frame_length;
-            if (signal_offset + signal_length > stack_frame_info.signal->total_length) {
-                signal_length = signal_length -
-                    (stack_frame_info.signal->total_length - (signal_offset + signal_length));
+        filterbank->sampling_frequency = sampling_frequency;
+        filterbank->low_frequency = low_frequency;
+        filterbank->high_frequency = high_frequency;
+        filterbank->num_filters = num_filters;
+        filterbank->fft_length = fft_length;
+        filterbank->version = version;
+        filterbank->weights_size = weights_size;
+
+        size_t offset = 0;
+        for (size_t i = 0; i < num_filters; i++) {
+            size_t left = bins[i];
+            size_t middle = bins[i+1];
+            size_t right = bins[i+2];
+            size_t first = (left + 1 < middle) ? left + 1 : middle;
+            size_t last = (right > middle) ? right - 1 : middle;
+
+            mel_filter_t *filter = &filterbank->filters[i];
+            filter->start_bin = first;
+            filter->length = last - first + 1;
+            filter->weights_offset = offset;
+
+            for (size_t bin = first; bin <= last; bin++) {
+                float weight = 1.0f;
+                if (bin < middle) {
+                    weight = (static_cast<float>(bin) - left) / (middle - left);
+                }
+                if (bin > middle) {
+                    weight = (right - static_cast<float>(bin)) / (right - middle);
+                }
+                // 1.0 saturates to 32767
+                int32_t weight_q15 = static_cast<int32_t>(lroundf(weight * 32768.0f));
+                filterbank->weights_q15[offset] = static_cast<int16_t>(weight_q15 > 32767 ? 32767 : weight_q15);
+                filterbank->weights[offset++] = weight;
             }
+        }
 
-            ret = stack_frame_info.signal->get_data(
-                signal_offset,
-                signal_length,
-                signal_frame.buffer
-            );
-            if (ret != 0) {
-                EIDSP_ERR(ret);
-            }
+        return EIDSP_OK;
+    }
 
-            ret = numpy::power_spectrum(
-                signal_frame.buffer,
-                stack_frame_info.frame_length,
-                power_spectrum_frame.buffer,
-                power_spectrum_frame_size,
-                fft_length
-            );
+    /**
+     * Release the buffers of a filterbank from build_mel_filterbank
+     */
+    static void free_mel_filterbank(mel_filterbank_t *filterbank)
+    {
+        if (filterbank->filters) {
+            ei_dsp_free(filterbank->filters, filterbank->num_filters * sizeof(mel_filter_t));
+        }
+        if (filterbank->weights) {
+            ei_dsp_free(filterbank->weights, filterbank->weights_size * sizeof(float));
+        }
+        if (filterbank->weights_q15) {
+            ei_dsp_free(filterbank->weights_q15, filterbank->weights_size * sizeof(int16_t));
+        }
+        memset(filterbank, 0, sizeof(mel_filterbank_t));
+    }
 
-            if (ret != 0) {
-                EIDSP_ERR(ret);
+    /**
+     * Sparse mel filterbank for an MFE configuration. Built on the first call
+     * and kept in a cache of EIDSP_MEL_FILTERBANK_CACHE_SIZE entries, so later
+     * calls with the same parameters neither allocate nor recompute anything.
+     * @returns the filterbank, or nullptr when out of memory
+     */
+    static const mel_filterbank_t *get_mel_filterbank(
+        uint32_t sampling_frequency, uint16_t num_filters, uint16_t fft_length,
+        uint32_t low_frequency, uint32_t high_frequency, uint16_t version)
+    {
+        mel_filterbank_t *cache = mel_filterbank_cache();
+        mel_filterbank_t *slot = nullptr;
+
+        for (size_t ix = 0; ix < EIDSP_MEL_FILTERBANK_CACHE_SIZE; ix++) {
+            mel_filterbank_t *entry = &cache[ix];
+            if (!entry->filters) {
+                if (!slot) {
+                    slot = entry;
+                }
+                continue;
             }
-
-            float energy = numpy::sum(power_spectrum_frame.buffer, power_spectrum_frame_size);
-            if (energy == 0) {
-                energy = 1e-10;
+            if (entry->sampling_frequency == sampling_frequency &&
+                entry->num_filters == num_filters &&
+                entry->fft_length == fft_length &&
+                entry->low_frequency == low_frequency &&
+                entry->high_frequency == high_frequency &&
+                entry->version == version) {
+                return entry;
             }
+        }
 
-            if (out_energies) {
-                out_energies->buffer[ix] = energy;
-            }
+        // cache full, replace the last entry
+        if (!slot) {
+            slot = &cache[EIDSP_MEL_FILTERBANK_CACHE_SIZE - 1];
+            free_mel_filterbank(slot);
+        }
 
-            auto row_ptr = out_features->get_row_ptr(ix);
-            for (size_t i = 0; i < num_filters; i++) {
-                size_t left = bins[i];
-                size_t middle = bins[i+1];
-                size_t right = bins[i+2];
-
-                assert(right < power_spectrum_frame_size);
-                // now we have weights and locations to move from fft to mel sgram
-                // both left and right become zero weights, so skip them
-
-                // middle always has weight of 1.0
-                // since we skip left and right, if left = middle we need to handle that
-                row_ptr[i] = power_spectrum_frame.buffer[middle];
-
-                for (size_t bin = left+1; bin < right; bin++) {
-                    if (bin < middle) {
-                        row_ptr[i] +=
-                            ((static_cast<float>(bin) - left) / (middle - left)) * // weight *
-                            power_spectrum_frame.buffer[bin];
-                    }
-                    // intentionally skip middle, handled above
-                    if (bin > middle) {
-                        row_ptr[i] +=
-                            ((right - static_cast<float>(bin)) / (right - middle)) * // weight *
-                            power_spectrum_frame.buffer[bin];
-                    }
-                }
-            }
+        if (build_mel_filterbank(slot, sampling_frequency, num_filters, fft_length,
+                low_frequency, high_frequency, version) != EIDSP_OK) {
+            return nullptr;
+        }
+        return slot;
+    }
 
-            if (ret != 0) {
-                EIDSP_ERR(ret);
-            }
+    /**
+     * Free all cached mel filterbanks (e.g. from run_classifier_deinit)
+     */
+    static void release_mel_filterbanks()
+    {
+        mel_filterbank_t *cache = mel_filterbank_cache();
+        for (size_t ix = 0; ix < EIDSP_MEL_FILTERBANK_CACHE_SIZE; ix++) {
+            free_mel_filterbank(&cache[ix]);
         }
+    }
 
-        numpy::zero_handling(out_features);
+    /**
+     * Compute Mel-filterbank energy features from an audio signal.
+     * @param out_features Use `calculate_mfe_buffer_size` to allocate the right matrix.
+     * @param out_energies A matrix in the form of Mx1 where M is the rows from `calculate_mfe_buffer_size`
+     * @param signal: audio signal structure with functions to retrieve data from a signal
+     * @param sampling_frequency (int): the sampling frequency of the signal
+     *     we are working with.
+     * @param frame_length (float): the length of each frame in seconds.
+     *     Default is 0.020s
+     * @param frame_stride (float): the step between successive frames in seconds.
+     *     Default is 0.02s (means no overlap)
+     * @param num_filters (int): the number of filters in the filterbank,
+     *     default 40.
+     * @param fft_length (int): number of FFT points. Default is 512.
+     * @param low_frequency (int): lowest band edge of mel filters.
+     *     In Hz, default is 0.
+     * @param high_frequency (int): highest band edge of mel filters.
+     *     In Hz, default is samplerate/2
+     * @EIDSP_OK if OK
+     */
+    static int mfe(matrix_t *out_features, matrix_t *out_energies,
+        signal_t *signal,
+        uint32_t sampling_frequency,
+        float frame_length, float frame_stride, uint16_t num_filters,
+        uint16_t fft_length, uint32_t low_frequency, uint32_t high_frequency,
+        uint16_t version
+        )
+    {
+        return mfe_frames(out_features, out_energies, signal, nullptr, 0, sampling_frequency,
+            frame_length, frame_stride, num_filters, fft_length, low_frequency, high_frequency, version);
+    }
 
-        return EIDSP_OK;
+    /**
+     * Compute Mel-filterbank energy features from an audio signal that is already
+     * in memory (e.g. after processing::preemphasis_int16). The frames are read
+     * straight from the buffer, overlapping frames are not copied.
+     * @param samples Audio samples
+     * @param samples_length Number of samples
+     * Other parameters are the same as above.
+     * @EIDSP_OK if OK
+     */
+    static int mfe(matrix_t *out_features, matrix_t *out_energies,
+        const float *samples, size_t samples_length,
+        uint32_t sampling_frequency,
+        float frame_length, float frame_stride, uint16_t num_filters,
+        uint16_t fft_length, uint32_t low_frequency, uint32_t high_frequency,
+        uint16_t version
+        )
+    {
+        if (!samples) {
+            EIDSP_ERR(EIDSP_SIGNAL_SIZE_MISMATCH);
+        }
+        return mfe_frames(out_features, out_energies, nullptr, samples, samples_length, sampling_frequency,
+            frame_length, frame_stride, num_filters, fft_length, low_frequency, high_frequency, version);
+    }
+
+    /**
+     * Fixed-point MFE (implementation_version >= 3) of int16 audio that is in memory,
+     * already normalized: every feature is k / 256 with k in 0..256, the same
+     * values as mfe() followed by processing::mfe_normalization, up to the
+     * rounding of the q15 arithmetic (see README). Preemphasis (0.98), the FFT
+     * (numpy::power_spectrum_q15), the mel filterbank and the log are all integer.
+     * @param out_features One row per frame of the buffer, num_filters columns
+     * @param samples Int16 audio samples
+     * @param samples_length Number of samples
+     * @param previous_sample The sample before samples[0], for the preemphasis
+     * @param noise_floor_db Noise floor of the normalization
+     * Other parameters are the same as mfe().
+     * @EIDSP_OK if OK
+     */
+    static int mfe_q15(matrix_t *out_features,
+        const EIDSP_i16 *samples, size_t samples_length, EIDSP_i16 previous_sample,
+        uint32_t sampling_frequency,
+        float frame_length, float frame_stride, uint16_t num_filters,
+        uint16_t fft_length, uint32_t low_frequency, uint32_t high_frequency,
+        int noise_floor_db, uint16_t version
+        )
+    {
+        if (!samples) {
+            EIDSP_ERR(EIDSP_SIGNAL_SIZE_MISMATCH);
+        }
+        return mfe_q15_frames(out_features, samples, previous_sample, nullptr, samples_length,
+            sampling_frequency, frame_length, frame_stride, num_filters, fft_length,
+            low_frequency, high_frequency, noise_floor_db, version);
+    }
+
+    /**
+     * mfe_q15() of audio that is already preemphasized and scaled to [-1 .. 1]
+     * (e.g. the frame carried over between slices in continuous mode)
+     * @param preemphasized Preemphasized samples
+     * @param samples_length Number of samples
+     * Other parameters are the same as above.
+     * @EIDSP_OK if OK
+     */
+    static int mfe_q15(matrix_t *out_features,
+        const float *preemphasized, size_t samples_length,
+        uint32_t sampling_frequency,
+        float frame_length, float frame_stride, uint16_t num_filters,
+        uint16_t fft_length, uint32_t low_frequency, uint32_t high_frequency,
+        int noise_floor_db, uint16_t version
+        )
+    {
+        if (!preemphasized) {
+            EIDSP_ERR(EIDSP_SIGNAL_SIZE_MISMATCH);
+        }
+        return mfe_q15_frames(out_features, nullptr, 0, preemphasized, samples_length,
+            sampling_frequency, frame_length, frame_stride, num_filters, fft_length,
+            low_frequency, high_frequency, noise_floor_db, version);
     }
 
     /**
@@ -448,7 +565,7 @@ public:
             EIDSP_ERR(ret);
         }
 
-        if (stack_frame_info.frame_ixs.size() != out_features->rows) {
+        if (stack_frame_info.frame_count != out_features->rows) {
             EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
         }
 
@@ -457,7 +574,7 @@ public:
         }
 
         if (out_energies) {
-            if (stack_frame_info.frame_ixs.size() != out_energies->rows || out_energies->cols != 1) {
+            if (stack_frame_info.frame_count != out_energies->rows || out_energies->cols != 1) {
                 EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
             }
         }
@@ -484,7 +601,14 @@ public:
         if (ret != 0) {
             EIDSP_ERR(ret);
         }
-        for (size_t ix = 0; ix < stack_frame_info.frame_ixs.size(); ix++) {
+
+        // FFT scratch shared by all frames, so the frame loop does not allocate
+        power_spectrum_workspace fft_workspace(fft_length);
+        if (!fft_workspace.is_valid()) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        for (size_t ix = 0; ix < stack_frame_info.frame_count; ix++) {
             size_t power_spectrum_frame_size = (fft_length / 2 + 1);
 
             EI_DSP_MATRIX(power_spectrum_frame, 1, power_spectrum_frame_size);
@@ -496,7 +620,7 @@ public:
             EI_DSP_MATRIX(signal_frame, 1, stack_frame_info.frame_length);
 
             // don't read outside of the audio buffer... we'll automatically zero pad then
-            size_t signal_offset = stack_frame_info.frame_ixs.at(ix);
+            size_t signal_offset = ix * stack_frame_info.frame_stride;
             size_t signal_length = stack_frame_info.frame_length;
             if (signal_offset + signal_length > stack_frame_info.signal->total_length) {
                 signal_length = signal_length -
@@ -517,7 +641,7 @@ public:
                 stack_frame_info.frame_length,
                 power_spectrum_frame.buffer,
                 power_spectrum_frame_size,
-                fft_length
+                &fft_workspace
             );
 
             if (ret != 0) {
@@ -588,7 +712,7 @@ public:
             EIDSP_ERR(ret);
         }
 
-        if (stack_frame_info.frame_ixs.size() != out_features->rows) {
+        if (stack_frame_info.frame_count != out_features->rows) {
             EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
         }
 
@@ -602,12 +726,18 @@ public:
             *(out_features->buffer + i) = 0;
         }
 
-        for (size_t ix = 0; ix < stack_frame_info.frame_ixs.size(); ix++) {
+        // FFT scratch shared by all frames, so the frame loop does not allocate
+        power_spectrum_workspace fft_workspace(fft_length);
+        if (!fft_workspace.is_valid()) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        for (size_t ix = 0; ix < stack_frame_info.frame_count; ix++) {
             // get signal data from the audio file
             EI_DSP_MATRIX(signal_frame, 1, stack_frame_info.frame_length);
 
             // don't read outside of the audio buffer... we'll automatically zero pad then
-            size_t signal_offset = stack_frame_info.frame_ixs.at(ix);
+            size_t signal_offset = ix * stack_frame_info.frame_stride;
             size_t signal_length = stack_frame_info.frame_length;
             if (signal_offset + signal_length > stack_frame_info.signal->total_length) {
                 signal_length = signal_length -
@@ -647,7 +777,7 @@ public:
                 stack_frame_info.frame_length,
                 out_features->buffer + (ix * coefficients),
                 coefficients,
-                fft_length
+                &fft_workspace
             );
 
             if (ret != 0) {
@@ -813,6 +943,363 @@ public:
         size_matrix.cols = (uint32_t)cols;
         return size_matrix;
     }
+
+private:
+    /**
+     * mfe() over a signal_t or over a buffer (samples != nullptr)
+     */
+    static int mfe_frames(matrix_t *out_features, matrix_t *out_energies,
+        signal_t *signal, const float *samples, size_t samples_length,
+        uint32_t sampling_frequency,
+        float frame_length, float frame_stride, uint16_t num_filters,
+        uint16_t fft_length, uint32_t low_frequency, uint32_t high_frequency,
+        uint16_t version
+        )
+    {
+        int ret = 0;
+
+        if (high_frequency == 0) {
+            high_frequency = sampling_frequency / 2;
+        }
+
+        if (version<4) {
+            if (low_frequency == 0) {
+                low_frequency = 300;
+            }
+        }
+
+        stack_frames_info_t stack_frame_info = { 0 };
+        stack_frame_info.signal = signal;
+
+        if (samples) {
+            ret = processing::stack_frames(
+                &stack_frame_info,
+                &samples_length,
+                sampling_frequency,
+                frame_length,
+                frame_stride,
+                false,
+                version
+            );
+        }
+        else {
+            ret = processing::stack_frames(
+                &stack_frame_info,
+                sampling_frequency,
+                frame_length,
+                frame_stride,
+                false,
+                version
+            );
+        }
+        if (ret != 0) {
+            EIDSP_ERR(ret);
+        }
+
+        if (stack_frame_info.frame_count != out_features->rows) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        if (num_filters != out_features->cols) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        if (out_energies) {
+            if (stack_frame_info.frame_count != out_energies->rows || out_energies->cols != 1) {
+                EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+            }
+        }
+
+        for (uint32_t i = 0; i < out_features->rows * out_features->cols; i++) {
+            *(out_features->buffer + i) = 0;
+        }
+
+        const size_t power_spectrum_frame_size = (fft_length / 2 + 1);
+
+        const mel_filterbank_t *filterbank = get_mel_filterbank(
+            sampling_frequency, num_filters, fft_length, low_frequency, high_frequency, version);
+        if (!filterbank) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        EI_DSP_SCRATCH_MATRIX(power_spectrum_frame, 1, power_spectrum_frame_size);
+
+        // get signal data from the audio file (frames in a buffer are used in place)
+        ei_dsp_scratch_buffer<float> signal_frame(samples ? 0 : stack_frame_info.frame_length);
+        if (!samples && !signal_frame.get()) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        // FFT scratch shared by all frames, so the frame loop does not allocate
+        power_spectrum_workspace fft_workspace(fft_length);
+        if (!fft_workspace.is_valid()) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        for (size_t ix = 0; ix < stack_frame_info.frame_count; ix++) {
+            size_t signal_offset = ix * stack_frame_info.frame_stride;
+            const float *frame;
+
+            if (samples) {
+                if (signal_offset + stack_frame_info.frame_length > samples_length) {
+                    EIDSP_ERR(EIDSP_OUT_OF_BOUNDS);
+                }
+                frame = samples + signal_offset;
+            }
+            else {
+                // don't read outside of the audio buffer... we'll automatically zero pad then
+                size_t signal_length = stack_frame_info.frame_length;
+                if (signal_offset + signal_length > stack_frame_info.signal->total_length) {
+                    signal_length = signal_length -
+                        (stack_frame_info.signal->total_length - (signal_offset + signal_length));
+                }
+
+                ret = stack_frame_info.signal->get_data(
+                    signal_offset,
+                    signal_length,
+                    signal_frame.get()
+                );
+                if (ret != 0) {
+                    EIDSP_ERR(ret);
+                }
+                frame = signal_frame.get();
+            }
+
+            ret = numpy::power_spectrum(
+                frame,
+                stack_frame_info.frame_length,
+                power_spectrum_frame.buffer,
+                power_spectrum_frame_size,
+                &fft_workspace
+            );
+
+            if (ret != 0) {
+                EIDSP_ERR(ret);
+            }
+
+            float energy = numpy::sum(power_spectrum_frame.buffer, power_spectrum_frame_size);
+            if (energy == 0) {
+                energy = 1e-10;
+            }
+
+            if (out_energies) {
+                out_energies->buffer[ix] = energy;
+            }
+
+            auto row_ptr = out_features->get_row_ptr(ix);
+            for (size_t i = 0; i < num_filters; i++) {
+                const mel_filter_t *filter = &filterbank->filters[i];
+                row_ptr[i] = numpy::dot(
+                    filterbank->weights + filter->weights_offset,
+                    power_spectrum_frame.buffer + filter->start_bin,
+                    filter->length);
+            }
+
+            if (ret != 0) {
+                EIDSP_ERR(ret);
+            }
+        }
+
+        numpy::zero_handling(out_features);
+
+        return EIDSP_OK;
+    }
+
+    /**
+     * mfe_q15() over int16 samples (with previous_sample) or over preemphasized floats.
+     * Every frame is preemphasized into int32 with 29 fractional bits, shifted into
+     * q15 by its own block exponent (r, so the largest sample uses the full range),
+     * transformed by the q15 FFT (which scales by 1 / n_fft) and accumulated
+     * through the q15 filterbank weights. The float energy of a filter is then
+     * E = sum * n_fft * 2^(2r - 73), so log2(E) is the fixed-point log2 of the
+     * sum plus an integer, and the normalization is one multiply-add in Q32.
+     */
+    static int mfe_q15_frames(matrix_t *out_features,
+        const EIDSP_i16 *samples, EIDSP_i16 previous_sample, const float *preemphasized, size_t samples_length,
+        uint32_t sampling_frequency,
+        float frame_length, float frame_stride, uint16_t num_filters,
+        uint16_t fft_length, uint32_t low_frequency, uint32_t high_frequency,
+        int noise_floor_db, uint16_t version
+        )
+    {
+        if (version < 3) {
+            EIDSP_ERR(EIDSP_BLOCK_VERSION_INCORRECT);
+        }
+
+        if (high_frequency == 0) {
+            high_frequency = sampling_frequency / 2;
+        }
+
+        if (version<4) {
+            if (low_frequency == 0) {
+                low_frequency = 300;
+            }
+        }
+
+        stack_frames_info_t stack_frame_info = { 0 };
+        int ret = processing::stack_frames(
+            &stack_frame_info,
+            &samples_length,
+            sampling_frequency,
+            frame_length,
+            frame_stride,
+            false,
+            version
+        );
+        if (ret != 0) {
+            EIDSP_ERR(ret);
+        }
+
+        if (stack_frame_info.frame_count != out_features->rows) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        if (num_filters != out_features->cols) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        const size_t power_spectrum_frame_size = (fft_length / 2 + 1);
+        const size_t frame_size = stack_frame_info.frame_length;
+        // the FFT only sees the first fft_length samples of a frame (as in numpy::power_spectrum)
+        const size_t fft_frame_size = frame_size < fft_length ? frame_size : fft_length;
+
+        const mel_filterbank_t *filterbank = get_mel_filterbank(
+            sampling_frequency, num_filters, fft_length, low_frequency, high_frequency, version);
+        if (!filterbank) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        int32_t log2_fft_length = 0;
+        while ((1 << log2_fft_length) < fft_length) {
+            log2_fft_length++;
+        }
+
+        // k = round(256 * (10 * log10(E) + noise) * noise_scale), see processing::mfe_normalization,
+        // as ((log2(E) in Q16) * c1 + c0) in Q32
+        const double noise = static_cast<double>(noise_floor_db * -1);
+        const double noise_scale = 1.0 / (noise + 12.0);
+        const int64_t c1 = llround(256.0 * noise_scale * 10.0 * log10(2.0) * 65536.0);
+        const int64_t c0 = llround(256.0 * noise_scale * noise * 4294967296.0);
+
+        ei_dsp_scratch_buffer<int32_t> frame_q29(fft_frame_size);
+        ei_dsp_scratch_buffer<int16_t> frame_q15(fft_frame_size);
+        ei_dsp_scratch_buffer<uint32_t> power_spectrum_frame(power_spectrum_frame_size);
+        if (!frame_q29.get() || !frame_q15.get() || !power_spectrum_frame.get()) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        power_spectrum_q15_workspace fft_workspace(fft_length);
+        if (!fft_workspace.is_valid()) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        // 0.98 in Q14
+        const int32_t cof_q14 = 16056;
+
+        for (size_t ix = 0; ix < stack_frame_info.frame_count; ix++) {
+            const size_t signal_offset = ix * stack_frame_info.frame_stride;
+            if (signal_offset + frame_size > samples_length) {
+                EIDSP_ERR(EIDSP_OUT_OF_BOUNDS);
+            }
+
+            int32_t *e = frame_q29.get();
+            uint32_t max_abs = 0;
+
+            if (samples) {
+                const EIDSP_i16 *in = samples + signal_offset;
+                int32_t prev = signal_offset > 0 ? in[-1] : previous_sample;
+                for (size_t n = 0; n < fft_frame_size; n++) {
+                    // (x[n] - 0.98 x[n - 1]) / 32768 with 29 fractional bits
+                    e[n] = static_cast<int32_t>(in[n]) * 16384 - cof_q14 * prev;
+                    prev = in[n];
+                }
+            }
+            else {
+                const float *in = preemphasized + signal_offset;
+                for (size_t n = 0; n < fft_frame_size; n++) {
+                    float v = in[n] * 536870912.0f;
+                    if (v > 2147483520.0f) v = 2147483520.0f;
+                    else if (v < -2147483520.0f) v = -2147483520.0f;
+                    e[n] = static_cast<int32_t>(lrintf(v));
+                }
+            }
+
+            for (size_t n = 0; n < fft_frame_size; n++) {
+                uint32_t a = e[n] < 0 ? static_cast<uint32_t>(-static_cast<int64_t>(e[n])) : static_cast<uint32_t>(e[n]);
+                if (a > max_abs) {
+                    max_abs = a;
+                }
+            }
+
+            auto row_ptr = out_features->get_row_ptr(ix);
+
+            if (max_abs == 0) {
+                for (size_t i = 0; i < num_filters; i++) {
+                    row_ptr[i] = 0.0f;
+                }
+                continue;
+            }
+
+            // block exponent: q = e / 2^r has at most 15 significant bits
+            const int32_t bits = 32 - __builtin_clz(max_abs);
+            const int32_t r = bits - 15;
+            int16_t *q = frame_q15.get();
+            for (size_t n = 0; n < fft_frame_size; n++) {
+                int32_t v;
+                if (r > 0) {
+                    v = static_cast<int32_t>((static_cast<int64_t>(e[n]) + (1 << (r - 1))) >> r);
+                }
+                else {
+                    v = e[n] * (1 << -r);
+                }
+                if (v > 32767) v = 32767;
+                else if (v < -32768) v = -32768;
+                q[n] = static_cast<int16_t>(v);
+            }
+
+            ret = numpy::power_spectrum_q15(
+                q,
+                fft_frame_size,
+                power_spectrum_frame.get(),
+                power_spectrum_frame_size,
+                &fft_workspace
+            );
+            if (ret != 0) {
+                EIDSP_ERR(ret);
+            }
+
+            const int64_t log2_offset = static_cast<int64_t>(log2_fft_length + 2 * r - 73) * 65536;
+
+            for (size_t i = 0; i < num_filters; i++) {
+                const mel_filter_t *filter = &filterbank->filters[i];
+                const int16_t *weights = filterbank->weights_q15 + filter->weights_offset;
+                const uint32_t *power = power_spectrum_frame.get() + filter->start_bin;
+
+                uint64_t energy = 0;
+                for (size_t bin = 0; bin < filter->length; bin++) {
+                    energy += static_cast<uint64_t>(weights[bin]) * power[bin];
+                }
+
+                int32_t k = 0;
+                if (energy > 0) {
+                    const int64_t log2_energy = numpy::log2_q16(energy) + log2_offset;
+                    k = static_cast<int32_t>((log2_energy * c1 + c0 + (static_cast<int64_t>(1) << 31)) >> 32);
+                    if (k < 0) k = 0;
+                    else if (k > 256) k = 256;
+                }
+                row_ptr[i] = static_cast<float>(k) / 256.0f;
+            }
+        }
+
+        return EIDSP_OK;
+    }
+
+    static mel_filterbank_t *mel_filterbank_cache()
+    {
+        // per thread with EI_CLASSIFIER_REENTRANT, release_mel_filterbanks frees the caller's
+        static EIDSP_THREAD_LOCAL mel_filterbank_t cache[EIDSP_MEL_FILTERBANK_CACHE_SIZE] = { };
+        return cache;
+    }
 };
 
 } // namespace speechpy
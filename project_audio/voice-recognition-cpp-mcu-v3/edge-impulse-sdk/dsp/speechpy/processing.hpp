@@ -39,7 +39,8 @@ namespace speechpy {
 // one stack frame returned by stack_frames
 typedef struct ei_stack_frames_info {
     signal_t *signal;
-    ei_vector<uint32_t> frame_ixs;
+    size_t frame_count;     // frame ix starts at signal offset ix * frame_stride
+    size_t frame_stride;
     int frame_length;
 } stack_frames_info_t;
 
@@ -55,8 +56,8 @@ public:
         preemphasis(ei_signal_t *signal, int shift, float cof, bool rescale)
             : _signal(signal), _shift(shift), _cof(cof), _rescale(rescale)
         {
-            _prev_buffer = (float*)ei_dsp_calloc(shift * sizeof(float), 1);
-            _end_of_signal_buffer = (float*)ei_dsp_calloc(shift * sizeof(float), 1);
+            _prev_buffer = (float*)ei_dsp_scratch_calloc(shift * sizeof(float), 1);
+            _end_of_signal_buffer = (float*)ei_dsp_scratch_calloc(shift * sizeof(float), 1);
             _next_offset_should_be = 0;
 
             if (shift < 0) {
@@ -131,12 +132,21 @@ public:
             return EIDSP_OK;
         }
 
+        // created per DSP call, so it lives in scratch memory like its buffers
+        void* operator new(size_t size) {
+            return ei_dsp_scratch_calloc(size, 1);
+        }
+
+        void operator delete(void* ptr, size_t size) {
+            ei_dsp_scratch_free(ptr, size);
+        }
+
         ~preemphasis() {
             if (_prev_buffer) {
-                ei_dsp_free(_prev_buffer, _shift * sizeof(float));
+                ei_dsp_scratch_free(_prev_buffer, _shift * sizeof(float));
             }
             if (_end_of_signal_buffer) {
-                ei_dsp_free(_end_of_signal_buffer, _shift * sizeof(float));
+                ei_dsp_scratch_free(_end_of_signal_buffer, _shift * sizeof(float));
             }
         }
 
@@ -193,6 +203,86 @@ namespace processing {
         return EIDSP_OK;
     }
 
+    /**
+     * Int16 audio front end in one pass: convert, preemphasize (shift 1) and
+     * optionally rescale to [-1 .. 1]. Gives the same values as reading
+     * [offset, offset + length) through the preemphasis class, so the first sample
+     * of the signal is filtered against the last one.
+     * @param signal Int16 samples of the whole signal
+     * @param signal_size Number of samples in signal
+     * @param offset First sample to write
+     * @param length Number of samples to write into out_buffer
+     * @param cof (float): The preemphasising coefficient. 0 equals to no filtering.
+     * @param rescale Divide by 32768
+     * @returns 0 when successful
+     */
+    __attribute__((unused)) static int preemphasis_int16(const EIDSP_i16 *signal, size_t signal_size,
+        size_t offset, size_t length, float cof, bool rescale, float *out_buffer)
+    {
+        if (offset + length > signal_size) {
+            EIDSP_ERR(EIDSP_OUT_OF_BOUNDS);
+        }
+        if (length == 0) {
+            return EIDSP_OK;
+        }
+
+        const float scale = rescale ? (1.0f / 32768.0f) : 1.0f;
+        const EIDSP_i16 *in = signal + offset;
+
+        float prev = static_cast<float>(offset > 0 ? in[-1] : signal[signal_size - 1]);
+        out_buffer[0] = (static_cast<float>(in[0]) - (cof * prev)) * scale;
+
+        // every output only depends on the input, so this loop vectorizes
+        for (size_t ix = 1; ix < length; ix++) {
+            out_buffer[ix] = (static_cast<float>(in[ix]) - (cof * static_cast<float>(in[ix - 1]))) * scale;
+        }
+
+        return EIDSP_OK;
+    }
+
+    /**
+     * preemphasis_int16 for a signal read through get_data: preemphasize (shift 1)
+     * and optionally rescale [offset, offset + length) in place in out_buffer,
+     * with the same values as reading it through the preemphasis class, but
+     * without its state, so any range can be read on its own.
+     * @param signal The input signal
+     * @param offset First sample to write
+     * @param length Number of samples to write into out_buffer
+     * @param cof (float): The preemphasising coefficient. 0 equals to no filtering.
+     * @param rescale Divide by 32768
+     * @returns 0 when successful
+     */
+    __attribute__((unused)) static int preemphasis_signal(ei_signal_t *signal,
+        size_t offset, size_t length, float cof, bool rescale, float *out_buffer)
+    {
+        if (offset + length > signal->total_length) {
+            EIDSP_ERR(EIDSP_OUT_OF_BOUNDS);
+        }
+        if (length == 0) {
+            return EIDSP_OK;
+        }
+
+        float prev;
+        int ret = signal->get_data(offset > 0 ? offset - 1 : signal->total_length - 1, 1, &prev);
+        if (ret != 0) {
+            EIDSP_ERR(ret);
+        }
+        ret = signal->get_data(offset, length, out_buffer);
+        if (ret != 0) {
+            EIDSP_ERR(ret);
+        }
+
+        const float scale = rescale ? (1.0f / 32768.0f) : 1.0f;
+
+        // back to front, so every sample is filtered against the one before it
+        for (size_t ix = length - 1; ix > 0; ix--) {
+            out_buffer[ix] = (out_buffer[ix] - (cof * out_buffer[ix - 1])) * scale;
+        }
+        out_buffer[0] = (out_buffer[0] - (cof * prev)) * scale;
+
+        return EIDSP_OK;
+    }
+
     /**
      * frame_length is a float and can thus be off by a little bit, e.g.
      * frame_length = 0.018f actually can yield 0.018000011f
@@ -260,28 +350,24 @@ namespace processing {
     }
 
     /**
-     * Frame a signal into overlapping frames.
-     * @param info This is both the base object and where we'll store our results.
-     * @param sampling_frequency (int): The sampling frequency of the signal.
-     * @param frame_length (float): The length of the frame in second.
-     * @param frame_stride (float): The stride between frames.
-     * @param zero_padding (bool): If the samples is not a multiple of
-     *        frame_length(number of frames sample), zero padding will
-     *        be done for generating last frame.
-     * @returns EIDSP_OK if OK
+     * Frame a signal that is not behind a signal_t (e.g. a buffer) into overlapping frames.
+     * Same as below, info->signal is not used.
+     * @param signal_length Length of the signal, updated to the length that is used
+     *        (or padded to) like signal->total_length below
      */
     static int stack_frames(stack_frames_info_t *info,
+                            size_t *signal_length,
                             float sampling_frequency,
                             float frame_length,
                             float frame_stride,
                             bool zero_padding,
                             uint16_t version)
     {
-        if (!info->signal || !info->signal->get_data || info->signal->total_length == 0) {
+        if (*signal_length == 0) {
             EIDSP_ERR(EIDSP_SIGNAL_SIZE_MISMATCH);
         }
 
-        size_t length_signal = info->signal->total_length;
+        size_t length_signal = *signal_length;
         int frame_sample_length;
         int length;
         if (version == 1) {
@@ -307,7 +393,7 @@ namespace processing {
             // Zero padding
             len_sig = static_cast<int>(static_cast<float>(numframes) * frame_stride) + frame_sample_length;
 
-            info->signal->total_length = static_cast<size_t>(len_sig);
+            *signal_length = static_cast<size_t>(len_sig);
         }
         else {
             numframes = static_cast<int>(
@@ -315,25 +401,55 @@ namespace processing {
             len_sig = static_cast<int>(
                 (static_cast<float>(numframes - 1) * frame_stride + frame_sample_length));
 
-            info->signal->total_length = static_cast<size_t>(len_sig);
+            *signal_length = static_cast<size_t>(len_sig);
         }
 
-        info->frame_ixs.clear();
-        info->frame_ixs.reserve(numframes); //limit the memory allocation
-
-        int frame_count = 0;
-
-        for (size_t ix = 0; ix < static_cast<uint32_t>(len_sig); ix += static_cast<size_t>(frame_stride)) {
-            if (++frame_count > numframes) break;
-
-            info->frame_ixs.push_back(ix);
+        // frames start every frame_stride samples below len_sig, at most numframes of them
+        size_t stride = static_cast<size_t>(frame_stride);
+        size_t frame_count = 0;
+        if (numframes > 0 && len_sig > 0) {
+            frame_count = static_cast<size_t>(numframes);
+            if (stride > 0) {
+                size_t frames_in_signal = (static_cast<size_t>(len_sig) + stride - 1) / stride;
+                if (frames_in_signal < frame_count) {
+                    frame_count = frames_in_signal;
+                }
+            }
         }
 
+        info->frame_count = frame_count;
+        info->frame_stride = stride;
         info->frame_length = frame_sample_length;
 
         return EIDSP_OK;
     }
 
+    /**
+     * Frame a signal into overlapping frames.
+     * @param info This is both the base object and where we'll store our results.
+     * @param sampling_frequency (int): The sampling frequency of the signal.
+     * @param frame_length (float): The length of the frame in second.
+     * @param frame_stride (float): The stride between frames.
+     * @param zero_padding (bool): If the samples is not a multiple of
+     *        frame_length(number of frames sample), zero padding will
+     *        be done for generating last frame.
+     * @returns EIDSP_OK if OK
+     */
+    static int stack_frames(stack_frames_info_t *info,
+                            float sampling_frequency,
+                            float frame_length,
+                            float frame_stride,
+                            bool zero_padding,
+                            uint16_t version)
+    {
+        if (!info->signal || !info->signal->get_data || info->signal->total_length == 0) {
+            EIDSP_ERR(EIDSP_SIGNAL_SIZE_MISMATCH);
+        }
+
+        return stack_frames(info, &info->signal->total_length, sampling_frequency,
+            frame_length, frame_stride, zero_padding, version);
+    }
+
     /**
      * Calculate the number of stack frames for the settings provided.
      * This is needed to allocate the right buffer size for the output of f.e. the MFE
@@ -524,6 +640,138 @@ namespace processing {
         return EIDSP_OK;
     }
 
+    /**
+     * mfe_normalization() produces k / 256 with k in 0..256. This fills table[k] with
+     * that value quantized for a tensor with the given scale and zero point, so the
+     * quantized path needs no divide or round per feature.
+     * @param table Output, 257 entries
+     */
+    static void mfe_quantization_table(int8_t *table, float scale, int32_t zero_point) {
+        for (int k = 0; k <= 256; k++) {
+            int32_t q = static_cast<int32_t>(round((static_cast<float>(k) / 256.0f) / scale)) + zero_point;
+            if (q < -128) q = -128;
+            else if (q > 127) q = 127;
+            table[k] = static_cast<int8_t>(q);
+        }
+    }
+
+    /**
+     * Same as mfe_normalization, but writes int8 values (see mfe_quantization_table)
+     * to out_buffer instead of modifying the features in place.
+     * @param features_matrix input feature matrix (MFE energies)
+     * @param table Table from mfe_quantization_table
+     * @param out_buffer rows * cols int8 values
+     */
+    static int mfe_normalization_quantized(const matrix_t *features_matrix, int noise_floor_db,
+        const int8_t *table, int8_t *out_buffer)
+    {
+        const float noise = static_cast<float>(noise_floor_db * -1);
+        const float noise_scale = 1.0f / (static_cast<float>(noise_floor_db * -1) + 12.0f);
+
+        for (size_t ix = 0; ix < features_matrix->rows * features_matrix->cols; ix++) {
+            float f = features_matrix->buffer[ix];
+            if (f < 1e-30) {
+                f = 1e-30;
+            }
+            f = numpy::log10(f);
+            f *= 10.0f; // scale by 10
+            f += noise;
+            f *= noise_scale;
+
+            int32_t k = static_cast<int32_t>(roundf(f * 256));
+            if (k < 0) k = 0;
+            else if (k > 256) k = 256;
+            out_buffer[ix] = table[k];
+        }
+
+        return EIDSP_OK;
+    }
+
+    /**
+     * Quantize features that are already normalized (k / 256, e.g. from
+     * feature::mfe_q15) with a table from mfe_quantization_table
+     * @param features_matrix normalized features
+     * @param table Table from mfe_quantization_table
+     * @param out_buffer rows * cols int8 values
+     */
+    static int mfe_quantize_normalized(const matrix_t *features_matrix, const int8_t *table, int8_t *out_buffer)
+    {
+        for (size_t ix = 0; ix < features_matrix->rows * features_matrix->cols; ix++) {
+            int32_t k = static_cast<int32_t>(features_matrix->buffer[ix] * 256.0f);
+            if (k < 0) k = 0;
+            else if (k > 256) k = 256;
+            out_buffer[ix] = table[k];
+        }
+
+        return EIDSP_OK;
+    }
+
+    /**
+     * Same as mfe_normalization, but stores the 1/256 steps as uint8 (k of k / 256)
+     * in out_buffer instead of modifying the features in place. k = 256 (1.0) is
+     * stored as 255, like the Python block does (np.clip(mfe, 0, 255)).
+     * @param features_matrix input feature matrix (MFE energies)
+     * @param out_buffer rows * cols uint8 values
+     */
+    static int mfe_normalization_u8(const matrix_t *features_matrix, int noise_floor_db, uint8_t *out_buffer)
+    {
+        const float noise = static_cast<float>(noise_floor_db * -1);
+        const float noise_scale = 1.0f / (static_cast<float>(noise_floor_db * -1) + 12.0f);
+
+        for (size_t ix = 0; ix < features_matrix->rows * features_matrix->cols; ix++) {
+            float f = features_matrix->buffer[ix];
+            if (f < 1e-30) {
+                f = 1e-30;
+            }
+            f = numpy::log10(f);
+            f *= 10.0f; // scale by 10
+            f += noise;
+            f *= noise_scale;
+
+            int32_t k = static_cast<int32_t>(roundf(f * 256));
+            if (k < 0) k = 0;
+            else if (k > 255) k = 255;
+            out_buffer[ix] = static_cast<uint8_t>(k);
+        }
+
+        return EIDSP_OK;
+    }
+
+    /**
+     * Store features that are already normalized (k / 256, e.g. from feature::mfe_q15)
+     * as uint8, see mfe_normalization_u8
+     * @param features_matrix normalized features
+     * @param out_buffer rows * cols uint8 values
+     */
+    static int mfe_normalized_to_u8(const matrix_t *features_matrix, uint8_t *out_buffer)
+    {
+        for (size_t ix = 0; ix < features_matrix->rows * features_matrix->cols; ix++) {
+            int32_t k = static_cast<int32_t>(features_matrix->buffer[ix] * 256.0f);
+            if (k < 0) k = 0;
+            else if (k > 255) k = 255;
+            out_buffer[ix] = static_cast<uint8_t>(k);
+        }
+
+        return EIDSP_OK;
+    }
+
+    /**
+     * Quantize uint8 features (mfe_normalization_u8) with a table from mfe_quantization_table,
+     * one lookup per feature
+     * @param features uint8 features
+     * @param features_size Number of features
+     * @param table Table from mfe_quantization_table
+     * @param out_buffer features_size int8 values
+     */
+    static int mfe_quantize_u8(const uint8_t *features, size_t features_size, const int8_t *table, int8_t *out_buffer)
+    {
+        for (size_t ix = 0; ix < features_size; ix++) {
+            out_buffer[ix] = table[features[ix]];
+        }
+
+        return EIDSP_OK;
+    }
+
     /**
      * Perform normalization for spectrogram frames, this converts the signal to dB,
      * then add a hard filter
@@ -116,6 +116,32 @@ uint64_t ei_read_timer_ms();
  */
 uint64_t ei_read_timer_us();
 
+/**
+ * @brief Read the cycle counter
+ *
+ * This function should return a free-running, monotonic count of the finest clock the
+ * target can read cheaply: the core cycle counter on a microcontroller (e.g. DWT CYCCNT
+ * on a Cortex-M), or a nanosecond clock on a host. The SDK subtracts two readings and
+ * passes the difference to `ei_cycles_to_us()` to report the DSP, inference and per-node
+ * times, so the count only has to be correct across one inference: it may lose wraps
+ * between readings far apart or stop while the core sleeps, which is why it is not used
+ * for `ei_read_timer_us()` or `ei_read_timer_ms()`. It is optional: the weak default in
+ * `porting/ei_classifier_porting.cpp` returns `ei_read_timer_us()`, and its
+ * `ei_cycles_to_us()` returns its argument.
+ *
+ * @return The number of cycles that have passed since the counter was started
+ */
+uint64_t ei_read_cycles();
+
+/**
+ * @brief Convert a cycle count from `ei_read_cycles()` to microseconds
+ *
+ * @param[in] cycles Difference of two `ei_read_cycles()` readings
+ *
+ * @return The number of microseconds (rounded down)
+ */
+uint64_t ei_cycles_to_us(uint64_t cycles);
+
 /**
  * @brief Send a single character to the serial port
  *
@@ -374,6 +400,12 @@ void ei_free(void *ptr);
 #define EI_MAX_OVERFLOW_BUFFER_COUNT	30
 #endif
 
+// The x86 int8 kernels (EI_CLASSIFIER_TFLITE_ENABLE_X86_SIMD) keep the repacked weights of every
+// convolution and fully connected node in a persistent buffer the arena was not planned for
+#if defined(__x86_64__) && !defined(EI_MAX_OVERFLOW_BUFFER_COUNT)
+#define EI_MAX_OVERFLOW_BUFFER_COUNT	64
+#endif
+
 // End additional configuration
 
 #endif // _EI_CLASSIFIER_PORTING_H_
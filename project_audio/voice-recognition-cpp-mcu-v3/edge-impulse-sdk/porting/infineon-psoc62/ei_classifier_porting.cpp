@@ -106,6 +106,47 @@ uint64_t ei_read_timer_us() {
 }
 #endif /* FREERTOS_ENABLED */
 
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+static bool cycle_counter_init = false;
+static uint32_t cycle_counter_last = 0;
+static uint64_t cycle_counter = 0;
+
+/**
+ * DWT CYCCNT of the CM4, extended to 64 bits. The 32-bit counter wraps every
+ * 2^32 / SystemCoreClock seconds (28.6 s at 150 MHz); a wrap that happens
+ * between two reads is accounted for, but the count falls behind by 2^32
+ * for every further wrap it does not see, and it stops while the CM4 sleeps
+ * in WFI. So it only times short intervals without sleep (a DSP run, an
+ * inference, a node), which it gets exact; ei_read_timer_ms()/_us() stay on
+ * the tick for wall-clock time.
+ */
+uint64_t ei_read_cycles() {
+    uint32_t irq_state = cyhal_system_critical_section_enter();
+
+    if (cycle_counter_init == false) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+        cycle_counter_last = 0;
+        cycle_counter_init = true;
+    }
+
+    uint32_t now = DWT->CYCCNT;
+    cycle_counter += (uint32_t)(now - cycle_counter_last);
+    cycle_counter_last = now;
+    uint64_t cycles = cycle_counter;
+
+    cyhal_system_critical_section_exit(irq_state);
+    return cycles;
+}
+
+uint64_t ei_cycles_to_us(uint64_t cycles) {
+    const uint64_t clock = SystemCoreClock;
+    // whole seconds and the rest apart, so cycles * 1000000 cannot overflow
+    return (cycles / clock) * 1000000ULL + ((cycles % clock) * 1000000ULL) / clock;
+}
+#endif /* DWT_CTRL_CYCCNTENA_Msk */
+
 void ei_putchar(char c)
 {
     putchar(c);
@@ -77,6 +77,20 @@ uint64_t ei_read_timer_us() {
 #endif
 }
 
+/**
+ * Nanoseconds of the monotonic clock: wall time, so the DSP and inference
+ * timings include time the process was not scheduled
+ */
+uint64_t ei_read_cycles() {
+    struct timespec spec;
+    clock_gettime(CLOCK_MONOTONIC, &spec);
+    return (static_cast<uint64_t>(spec.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(spec.tv_nsec);
+}
+
+uint64_t ei_cycles_to_us(uint64_t cycles) {
+    return cycles / 1000;
+}
+
 __attribute__((weak)) void ei_printf(const char *format, ...) {
     va_list myargs;
     va_start(myargs, format);
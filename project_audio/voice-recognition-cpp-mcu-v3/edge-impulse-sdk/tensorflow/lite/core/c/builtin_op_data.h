@@ -89,6 +89,13 @@ typedef struct {
   // Note: Version 2 supports dilation values not equal to 1.
   int dilation_width_factor;
   int dilation_height_factor;
+
+  // Explicit zero padding of the input, on top of `padding`. Set when the EON
+  // compiler folds a PAD op in front of the convolution into it.
+  int explicit_padding_top;
+  int explicit_padding_bottom;
+  int explicit_padding_left;
+  int explicit_padding_right;
 } TfLiteConvParams;
 
 typedef struct {
@@ -136,8 +143,23 @@ typedef struct {
   // Parameters for DepthwiseConv version 2 or above.
   int dilation_width_factor;
   int dilation_height_factor;
+
+  // Explicit zero padding of the input, on top of `padding`. Set when the EON
+  // compiler folds a PAD op in front of the convolution into it.
+  int explicit_padding_top;
+  int explicit_padding_bottom;
+  int explicit_padding_left;
+  int explicit_padding_right;
 } TfLiteDepthwiseConvParams;
 
+// A depthwise convolution feeding a 1x1 convolution, fused by the EON compiler
+// into one DEPTHWISE_SEPARABLE_CONV_2D node (micro/kernels/
+// depthwise_separable_conv.cc).
+typedef struct {
+  TfLiteDepthwiseConvParams depthwise;
+  TfLiteConvParams pointwise;
+} TfLiteDepthwiseSeparableConvParams;
+
 typedef struct {
   int rank;
   TfLiteFusedActivation activation;
@@ -0,0 +1,460 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+#if EI_CLASSIFIER_TFLITE_ENABLE_X86_SIMD == 1
+
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/x86_int8.h"
+
+#include <cpuid.h>
+#include <immintrin.h>
+#include <string.h>
+
+#include <atomic>
+
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/common.h"
+
+namespace tflite {
+namespace x86_int8 {
+
+// The kernels, once per instruction set. Only the functions inside a region
+// may use its instructions, and only after the CPUID check in ActiveIsa().
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+#define X86_INT8_NAMESPACE avx2
+#define X86_INT8_MAC(acc, a, b) _mm256_add_epi32((acc), _mm256_madd_epi16((a), (b)))
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/x86_int8_kernels.h"
+#undef X86_INT8_NAMESPACE
+#undef X86_INT8_MAC
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,avxvnni"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,avxvnni")
+#endif
+#define X86_INT8_NAMESPACE avxvnni
+#define X86_INT8_MAC(acc, a, b) _mm256_dpwssd_avx_epi32((acc), (a), (b))
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/x86_int8_kernels.h"
+#undef X86_INT8_NAMESPACE
+#undef X86_INT8_MAC
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,avx512f,avx512vl,avx512vnni"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,avx512f,avx512vl,avx512vnni")
+#endif
+#define X86_INT8_NAMESPACE avx512vnni
+#define X86_INT8_MAC(acc, a, b) _mm256_dpwssd_epi32((acc), (a), (b))
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/x86_int8_kernels.h"
+#undef X86_INT8_NAMESPACE
+#undef X86_INT8_MAC
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+namespace {
+
+constexpr int kLanes = 8;
+
+std::atomic<int> active_isa(-1);
+
+uint64_t ReadXcr0() {
+  uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+}
+
+// Bit per Isa this CPU and OS can run
+unsigned int DetectIsas() {
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    return 1u << static_cast<int>(Isa::kNone);
+  }
+  // AVX, and the OS saving the YMM registers
+  if (!(ecx & bit_OSXSAVE) || !(ecx & bit_AVX)) {
+    return 1u << static_cast<int>(Isa::kNone);
+  }
+  const uint64_t xcr0 = ReadXcr0();
+  if ((xcr0 & 0x6) != 0x6 || __get_cpuid_max(0, nullptr) < 7) {
+    return 1u << static_cast<int>(Isa::kNone);
+  }
+  __cpuid_count(7, 0, eax, ebx, ecx, edx);
+  const unsigned int leaf7_subleaves = eax;
+  if (!(ebx & bit_AVX2)) {
+    return 1u << static_cast<int>(Isa::kNone);
+  }
+
+  unsigned int isas = (1u << static_cast<int>(Isa::kNone)) |
+                      (1u << static_cast<int>(Isa::kAvx2));
+  // EVEX vpdpwssd on ymm needs AVX512F, VL and VNNI, and the opmask and ZMM state
+  if ((ebx & bit_AVX512F) && (ebx & bit_AVX512VL) && (ecx & bit_AVX512VNNI) &&
+      (xcr0 & 0xE6) == 0xE6) {
+    isas |= 1u << static_cast<int>(Isa::kAvx512Vnni);
+  }
+  if (leaf7_subleaves >= 1) {
+    __cpuid_count(7, 1, eax, ebx, ecx, edx);
+    if (eax & (1u << 4)) {
+      isas |= 1u << static_cast<int>(Isa::kAvxVnni);
+    }
+  }
+  return isas;
+}
+
+unsigned int SupportedIsas() {
+  static const unsigned int isas = DetectIsas();
+  return isas;
+}
+
+int RoundUpToLanes(int n) { return (n + kLanes - 1) / kLanes * kLanes; }
+
+size_t PackedBytes(int output_depth_padded, size_t weight_count) {
+  return 4 * output_depth_padded * sizeof(int32_t) +
+         weight_count * sizeof(int16_t);
+}
+
+// Carves the scaling arrays and the weights out of buffer and fills the
+// scaling (zero in the padding lanes)
+int16_t* PackScaling(int output_depth, int output_depth_padded, int pairs,
+                     const int32_t* bias_data,
+                     const int32_t* output_multiplier,
+                     const int32_t* output_shift, bool per_channel,
+                     void* buffer, PackedFilter* packed) {
+  int32_t* bias = static_cast<int32_t*>(buffer);
+  int32_t* multiplier = bias + output_depth_padded;
+  int32_t* left_shift = multiplier + output_depth_padded;
+  int32_t* right_shift = left_shift + output_depth_padded;
+  memset(bias, 0, 4 * output_depth_padded * sizeof(int32_t));
+
+  for (int channel = 0; channel < output_depth; channel++) {
+    const int shift = output_shift[per_channel ? channel : 0];
+    bias[channel] = bias_data ? bias_data[channel] : 0;
+    multiplier[channel] = output_multiplier[per_channel ? channel : 0];
+    left_shift[channel] = shift > 0 ? shift : 0;
+    right_shift[channel] = shift > 0 ? 0 : -shift;
+  }
+
+  packed->output_depth = output_depth;
+  packed->output_depth_padded = output_depth_padded;
+  packed->pairs = pairs;
+  packed->bias = bias;
+  packed->multiplier = multiplier;
+  packed->left_shift = left_shift;
+  packed->right_shift = right_shift;
+  packed->weights = reinterpret_cast<int16_t*>(right_shift + output_depth_padded);
+  return reinterpret_cast<int16_t*>(right_shift + output_depth_padded);
+}
+
+// [tap][input pair][output channel][2] from [output channel][tap][input channel]
+void PackRows(const int8_t* filter_data, int output_depth, int taps,
+              int input_depth, int16_t* weights, int output_depth_padded) {
+  const int pairs = (input_depth + 1) / 2;
+  memset(weights, 0, static_cast<size_t>(taps) * pairs * output_depth_padded * 2 * sizeof(int16_t));
+  for (int out_c = 0; out_c < output_depth; out_c++) {
+    for (int tap = 0; tap < taps; tap++) {
+      for (int in_c = 0; in_c < input_depth; in_c++) {
+        const size_t pair = static_cast<size_t>(tap) * pairs + in_c / 2;
+        weights[(pair * output_depth_padded + out_c) * 2 + in_c % 2] =
+            filter_data[(static_cast<size_t>(out_c) * taps + tap) * input_depth + in_c];
+      }
+    }
+  }
+}
+
+}  // namespace
+
+bool IsaSupported(Isa isa) {
+  return SupportedIsas() & (1u << static_cast<int>(isa));
+}
+
+Isa DetectedIsa() {
+  // the VEX encoding where there is a choice, same instruction otherwise
+  if (IsaSupported(Isa::kAvxVnni)) {
+    return Isa::kAvxVnni;
+  }
+  if (IsaSupported(Isa::kAvx512Vnni)) {
+    return Isa::kAvx512Vnni;
+  }
+  return IsaSupported(Isa::kAvx2) ? Isa::kAvx2 : Isa::kNone;
+}
+
+Isa ActiveIsa() {
+  int isa = active_isa.load(std::memory_order_relaxed);
+  if (isa < 0) {
+    isa = static_cast<int>(DetectedIsa());
+    active_isa.store(isa, std::memory_order_relaxed);
+  }
+  return static_cast<Isa>(isa);
+}
+
+Isa SetIsa(Isa isa) {
+  if (!IsaSupported(isa)) {
+    isa = DetectedIsa();
+  }
+  active_isa.store(static_cast<int>(isa), std::memory_order_relaxed);
+  return isa;
+}
+
+const char* IsaName(Isa isa) {
+  switch (isa) {
+    case Isa::kAvx2: return "avx2";
+    case Isa::kAvxVnni: return "avx-vnni";
+    case Isa::kAvx512Vnni: return "avx512-vnni";
+    default: return "reference";
+  }
+}
+
+size_t ConvPackedBytes(const RuntimeShape& filter_shape) {
+  const int output_depth_padded = RoundUpToLanes(filter_shape.Dims(0));
+  const int taps = filter_shape.Dims(1) * filter_shape.Dims(2);
+  const int pairs = (filter_shape.Dims(3) + 1) / 2;
+  return PackedBytes(output_depth_padded, static_cast<size_t>(taps) * pairs * output_depth_padded * 2);
+}
+
+size_t DepthwiseConvPackedBytes(const RuntimeShape& filter_shape) {
+  const int output_depth_padded = RoundUpToLanes(filter_shape.Dims(3));
+  const int tap_pairs = (filter_shape.Dims(1) * filter_shape.Dims(2) + 1) / 2;
+  return PackedBytes(output_depth_padded, static_cast<size_t>(tap_pairs) * output_depth_padded * 2);
+}
+
+size_t FullyConnectedPackedBytes(const RuntimeShape& filter_shape) {
+  const int dims = filter_shape.DimensionsCount();
+  const int output_depth_padded = RoundUpToLanes(filter_shape.Dims(dims - 2));
+  const int pairs = (filter_shape.Dims(dims - 1) + 1) / 2;
+  return PackedBytes(output_depth_padded, static_cast<size_t>(pairs) * output_depth_padded * 2);
+}
+
+void PackConvPerChannel(const RuntimeShape& filter_shape,
+                        const int8_t* filter_data, const int32_t* bias_data,
+                        const int32_t* output_multiplier,
+                        const int32_t* output_shift, void* buffer,
+                        PackedFilter* packed) {
+  const int output_depth = filter_shape.Dims(0);
+  const int output_depth_padded = RoundUpToLanes(output_depth);
+  const int taps = filter_shape.Dims(1) * filter_shape.Dims(2);
+  const int input_depth = filter_shape.Dims(3);
+  int16_t* weights = PackScaling(output_depth, output_depth_padded, (input_depth + 1) / 2,
+                                 bias_data, output_multiplier, output_shift,
+                                 true, buffer, packed);
+  PackRows(filter_data, output_depth, taps, input_depth, weights, output_depth_padded);
+}
+
+void PackDepthwiseConvPerChannel(const RuntimeShape& filter_shape,
+                                 const int8_t* filter_data,
+                                 const int32_t* bias_data,
+                                 const int32_t* output_multiplier,
+                                 const int32_t* output_shift, void* buffer,
+                                 PackedFilter* packed) {
+  const int output_depth = filter_shape.Dims(3);
+  const int output_depth_padded = RoundUpToLanes(output_depth);
+  const int taps = filter_shape.Dims(1) * filter_shape.Dims(2);
+  const int tap_pairs = (taps + 1) / 2;
+  int16_t* weights = PackScaling(output_depth, output_depth_padded, tap_pairs,
+                                 bias_data, output_multiplier, output_shift,
+                                 true, buffer, packed);
+
+  // [tap pair][channel][2] from [tap][channel]
+  memset(weights, 0, static_cast<size_t>(tap_pairs) * output_depth_padded * 2 * sizeof(int16_t));
+  for (int tap = 0; tap < taps; tap++) {
+    for (int channel = 0; channel < output_depth; channel++) {
+      weights[(static_cast<size_t>(tap / 2) * output_depth_padded + channel) * 2 + tap % 2] =
+          filter_data[static_cast<size_t>(tap) * output_depth + channel];
+    }
+  }
+}
+
+void PackFullyConnected(const RuntimeShape& filter_shape,
+                        const int8_t* filter_data, const int32_t* bias_data,
+                        int32_t output_multiplier, int output_shift,
+                        void* buffer, PackedFilter* packed) {
+  const int dims = filter_shape.DimensionsCount();
+  const int output_depth = filter_shape.Dims(dims - 2);
+  const int output_depth_padded = RoundUpToLanes(output_depth);
+  const int accum_depth = filter_shape.Dims(dims - 1);
+  const int32_t shift = output_shift;
+  int16_t* weights = PackScaling(output_depth, output_depth_padded, (accum_depth + 1) / 2,
+                                 bias_data, &output_multiplier, &shift,
+                                 false, buffer, packed);
+  PackRows(filter_data, output_depth, 1, accum_depth, weights, output_depth_padded);
+}
+
+bool ConvPerChannel(const ConvParams& params, const PackedFilter& packed,
+                    const RuntimeShape& input_shape, const int8_t* input_data,
+                    const RuntimeShape& filter_shape,
+                    const RuntimeShape& output_shape, int8_t* output_data) {
+  TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(filter_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
+  if (output_shape.Dims(3) != packed.output_depth ||
+      input_shape.Dims(3) != filter_shape.Dims(3)) {
+    return false;
+  }
+
+  switch (ActiveIsa()) {
+    case Isa::kAvx2:
+      avx2::ConvPerChannel(params, packed, input_shape, input_data, filter_shape, output_shape, output_data);
+      return true;
+    case Isa::kAvxVnni:
+      avxvnni::ConvPerChannel(params, packed, input_shape, input_data, filter_shape, output_shape, output_data);
+      return true;
+    case Isa::kAvx512Vnni:
+      avx512vnni::ConvPerChannel(params, packed, input_shape, input_data, filter_shape, output_shape, output_data);
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool DepthwiseConvPerChannel(const DepthwiseParams& params,
+                             const PackedFilter& packed,
+                             const RuntimeShape& input_shape,
+                             const int8_t* input_data,
+                             const RuntimeShape& filter_shape,
+                             const RuntimeShape& output_shape,
+                             int8_t* output_data) {
+  TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(filter_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
+  if (params.depth_multiplier != 1 ||
+      filter_shape.Dims(1) * filter_shape.Dims(2) > kMaxDepthwiseTaps ||
+      output_shape.Dims(3) != packed.output_depth ||
+      input_shape.Dims(3) != packed.output_depth) {
+    return false;
+  }
+
+  switch (ActiveIsa()) {
+    case Isa::kAvx2:
+      avx2::DepthwiseConvPerChannel(params, packed, input_shape, input_data, filter_shape, output_shape, output_data);
+      return true;
+    case Isa::kAvxVnni:
+      avxvnni::DepthwiseConvPerChannel(params, packed, input_shape, input_data, filter_shape, output_shape, output_data);
+      return true;
+    case Isa::kAvx512Vnni:
+      avx512vnni::DepthwiseConvPerChannel(params, packed, input_shape, input_data, filter_shape, output_shape, output_data);
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool FullyConnected(const FullyConnectedParams& params,
+                    const PackedFilter& packed,
+                    const RuntimeShape& input_shape, const int8_t* input_data,
+                    const RuntimeShape& filter_shape,
+                    const RuntimeShape& output_shape, int8_t* output_data) {
+  // the kernel reads batches * accum_depth inputs, batches from the output
+  const int output_dim_count = output_shape.DimensionsCount();
+  const int batches = FlatSizeSkipDim(output_shape, output_dim_count - 1);
+  const int accum_depth = filter_shape.Dims(filter_shape.DimensionsCount() - 1);
+  if (params.weights_offset != 0 ||
+      output_shape.Dims(output_dim_count - 1) != packed.output_depth ||
+      input_shape.FlatSize() != batches * accum_depth) {
+    return false;
+  }
+
+  switch (ActiveIsa()) {
+    case Isa::kAvx2:
+      avx2::FullyConnected(params, packed, input_data, filter_shape, output_shape, output_data);
+      return true;
+    case Isa::kAvxVnni:
+      avxvnni::FullyConnected(params, packed, input_data, filter_shape, output_shape, output_data);
+      return true;
+    case Isa::kAvx512Vnni:
+      avx512vnni::FullyConnected(params, packed, input_data, filter_shape, output_shape, output_data);
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool DepthwiseSeparableConvPerChannel(
+    const DepthwiseParams& depthwise_params,
+    const PackedFilter& depthwise_packed, const ConvParams& pointwise_params,
+    const PackedFilter& pointwise_packed, const RuntimeShape& input_shape,
+    const int8_t* input_data, const RuntimeShape& depthwise_filter_shape,
+    const RuntimeShape& output_shape, int8_t* output_data, int8_t* tile,
+    int tile_pixels) {
+  TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(depthwise_filter_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
+  if (depthwise_params.depth_multiplier != 1 ||
+      depthwise_filter_shape.Dims(1) * depthwise_filter_shape.Dims(2) > kMaxDepthwiseTaps ||
+      input_shape.Dims(3) != depthwise_packed.output_depth ||
+      pointwise_packed.pairs != (depthwise_packed.output_depth + 1) / 2 ||
+      output_shape.Dims(3) != pointwise_packed.output_depth || tile_pixels < 1) {
+    return false;
+  }
+
+  switch (ActiveIsa()) {
+    case Isa::kAvx2:
+      avx2::DepthwiseSeparableConvPerChannel(depthwise_params, depthwise_packed, pointwise_params, pointwise_packed,
+                                             input_shape, input_data, depthwise_filter_shape, output_shape,
+                                             output_data, tile, tile_pixels);
+      return true;
+    case Isa::kAvxVnni:
+      avxvnni::DepthwiseSeparableConvPerChannel(depthwise_params, depthwise_packed, pointwise_params, pointwise_packed,
+                                                input_shape, input_data, depthwise_filter_shape, output_shape,
+                                                output_data, tile, tile_pixels);
+      return true;
+    case Isa::kAvx512Vnni:
+      avx512vnni::DepthwiseSeparableConvPerChannel(depthwise_params, depthwise_packed, pointwise_params, pointwise_packed,
+                                                   input_shape, input_data, depthwise_filter_shape, output_shape,
+                                                   output_data, tile, tile_pixels);
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace x86_int8
+}  // namespace tflite
+
+#endif  // EI_CLASSIFIER_TFLITE_ENABLE_X86_SIMD == 1
@@ -0,0 +1,150 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_X86_INT8_H_
+#define TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_X86_INT8_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/types.h"
+
+// int8 CONV_2D, DEPTHWISE_CONV_2D, FULLY_CONNECTED and the fused
+// DEPTHWISE_SEPARABLE_CONV_2D for x86-64 hosts
+// (EI_CLASSIFIER_TFLITE_ENABLE_X86_SIMD in ei_classifier_config.h), used by
+// the micro kernels in place of reference_integer_ops. The kernels are built
+// once per instruction set (AVX2, AVX-VNNI, AVX512-VNNI) in x86_int8.cc and
+// picked at runtime from CPUID, so the binary still runs on any x86-64.
+//
+// The weights are repacked once, in Prepare, so that one vector holds 8 output
+// channels: int16 pairs of two input channels (two filter taps for depthwise)
+// that vpmaddwd (or vpdpwssd with VNNI) multiplies and adds into 8 int32
+// accumulators. Requantization follows MultiplyByQuantizedMultiplier (the
+// gemmlowp double rounding) lane by lane, so the outputs are bit-exact
+// against the reference kernels.
+namespace tflite {
+namespace x86_int8 {
+
+enum class Isa : int {
+  kNone = 0,        // reference kernels
+  kAvx2 = 1,
+  kAvxVnni = 2,     // AVX2 + vpdpwssd (VEX, Alder Lake and later)
+  kAvx512Vnni = 3,  // AVX2 + vpdpwssd (EVEX on 256-bit vectors, Cascade Lake and later)
+};
+
+// Whether this CPU and OS can run isa (CPUID, XGETBV)
+bool IsaSupported(Isa isa);
+// Best supported instruction set
+Isa DetectedIsa();
+// Instruction set the kernels run with: DetectedIsa() unless SetIsa() changed it
+Isa ActiveIsa();
+// Runs the kernels with isa (DetectedIsa() if it isn't supported), e.g. kNone
+// to time or check against the reference kernels; returns the one in effect
+Isa SetIsa(Isa isa);
+const char* IsaName(Isa isa);
+
+// Weights and per-channel output scaling of one node, repacked for the kernels
+// (one buffer of ...PackedBytes(), from AllocatePersistentBuffer in Prepare)
+struct PackedFilter {
+  int output_depth;
+  int output_depth_padded;  // multiple of 8
+  int pairs;                // input channel pairs (conv, fully connected) or tap pairs (depthwise)
+  const int32_t* bias;
+  const int32_t* multiplier;
+  const int32_t* left_shift;
+  const int32_t* right_shift;
+  const int16_t* weights;
+};
+
+// filter_shape: OHWI (conv), 1HWO (depthwise) or OI (fully connected)
+size_t ConvPackedBytes(const RuntimeShape& filter_shape);
+size_t DepthwiseConvPackedBytes(const RuntimeShape& filter_shape);
+size_t FullyConnectedPackedBytes(const RuntimeShape& filter_shape);
+
+// Per-channel output_multiplier and output_shift as computed by
+// CalculateOpDataConv; bias_data may be null
+void PackConvPerChannel(const RuntimeShape& filter_shape,
+                        const int8_t* filter_data, const int32_t* bias_data,
+                        const int32_t* output_multiplier,
+                        const int32_t* output_shift, void* buffer,
+                        PackedFilter* packed);
+void PackDepthwiseConvPerChannel(const RuntimeShape& filter_shape,
+                                 const int8_t* filter_data,
+                                 const int32_t* bias_data,
+                                 const int32_t* output_multiplier,
+                                 const int32_t* output_shift, void* buffer,
+                                 PackedFilter* packed);
+// Per-tensor scaling, symmetric weights (weights_offset 0)
+void PackFullyConnected(const RuntimeShape& filter_shape,
+                        const int8_t* filter_data, const int32_t* bias_data,
+                        int32_t output_multiplier, int output_shift,
+                        void* buffer, PackedFilter* packed);
+
+// Same results as the reference_integer_ops kernels of the same name. Return
+// false (and leave the output alone) when ActiveIsa() is kNone or the shapes
+// are not handled (depth_multiplier other than 1, more than
+// kMaxDepthwiseTaps taps); the caller then runs the reference kernel.
+constexpr int kMaxDepthwiseTaps = 64;
+
+bool ConvPerChannel(const ConvParams& params, const PackedFilter& packed,
+                    const RuntimeShape& input_shape, const int8_t* input_data,
+                    const RuntimeShape& filter_shape,
+                    const RuntimeShape& output_shape, int8_t* output_data);
+bool DepthwiseConvPerChannel(const DepthwiseParams& params,
+                             const PackedFilter& packed,
+                             const RuntimeShape& input_shape,
+                             const int8_t* input_data,
+                             const RuntimeShape& filter_shape,
+                             const RuntimeShape& output_shape,
+                             int8_t* output_data);
+bool FullyConnected(const FullyConnectedParams& params,
+                    const PackedFilter& packed,
+                    const RuntimeShape& input_shape, const int8_t* input_data,
+                    const RuntimeShape& filter_shape,
+                    const RuntimeShape& output_shape, int8_t* output_data);
+// reference_integer_ops::DepthwiseSeparableConvPerChannel, with the depthwise
+// filter packed by PackDepthwiseConvPerChannel and the 1x1 filter by
+// PackConvPerChannel; tile holds tile_pixels * depth int8 values
+bool DepthwiseSeparableConvPerChannel(
+    const DepthwiseParams& depthwise_params,
+    const PackedFilter& depthwise_packed, const ConvParams& pointwise_params,
+    const PackedFilter& pointwise_packed, const RuntimeShape& input_shape,
+    const int8_t* input_data, const RuntimeShape& depthwise_filter_shape,
+    const RuntimeShape& output_shape, int8_t* output_data, int8_t* tile,
+    int tile_pixels);
+
+}  // namespace x86_int8
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_X86_INT8_H_
@@ -0,0 +1,510 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Kernel bodies of x86_int8.cc. No include guard: x86_int8.cc includes this
+// once per instruction set, inside a target region, with X86_INT8_NAMESPACE
+// and X86_INT8_MAC(acc, a, b) (acc + pairwise products of int16 a and b, as
+// vpmaddwd + vpaddd or vpdpwssd) defined.
+
+namespace X86_INT8_NAMESPACE {
+
+// Output channels per vector, and vectors kept in registers per output pixel
+constexpr int kLanes = 8;
+constexpr int kBlocks = 4;
+
+struct Requantization {
+  __m256i output_offset;
+  __m256i activation_min;
+  __m256i activation_max;
+};
+
+static inline Requantization MakeRequantization(int32_t output_offset,
+                                                int32_t activation_min,
+                                                int32_t activation_max) {
+  Requantization rq;
+  rq.output_offset = _mm256_set1_epi32(output_offset);
+  rq.activation_min = _mm256_set1_epi32(activation_min);
+  rq.activation_max = _mm256_set1_epi32(activation_max);
+  return rq;
+}
+
+// MultiplyByQuantizedMultiplier on 8 channels, plus the output offset and the
+// activation clamp. With a non-negative multiplier the saturating case of
+// SaturatingRoundingDoublingHighMul can't happen, and its nudge and division
+// truncating towards zero come down to (x * m + 2^30) >> 31 for either sign.
+static inline __m256i Requantize(__m256i acc, const PackedFilter& packed,
+                                 int channel, const Requantization& rq) {
+  const __m256i multiplier = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i*>(packed.multiplier + channel));
+  const __m256i left_shift = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i*>(packed.left_shift + channel));
+  const __m256i right_shift = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i*>(packed.right_shift + channel));
+  const __m256i nudge = _mm256_set1_epi64x(1ll << 30);
+  const __m256i one = _mm256_set1_epi32(1);
+
+  const __m256i x = _mm256_sllv_epi32(acc, left_shift);
+  __m256i even = _mm256_add_epi64(_mm256_mul_epi32(x, multiplier), nudge);
+  __m256i odd = _mm256_add_epi64(
+      _mm256_mul_epi32(_mm256_srli_epi64(x, 32),
+                       _mm256_srli_epi64(multiplier, 32)),
+      nudge);
+  even = _mm256_srli_epi64(even, 31);  // bits 31..62 into the low half
+  odd = _mm256_slli_epi64(odd, 1);     // bits 31..62 into the high half
+  const __m256i high = _mm256_blend_epi32(even, odd, 0xAA);
+
+  // RoundingDivideByPOT
+  const __m256i mask =
+      _mm256_sub_epi32(_mm256_sllv_epi32(one, right_shift), one);
+  const __m256i remainder = _mm256_and_si256(high, mask);
+  const __m256i threshold = _mm256_sub_epi32(_mm256_srai_epi32(mask, 1),
+                                             _mm256_srai_epi32(high, 31));
+  __m256i result = _mm256_srav_epi32(high, right_shift);
+  result = _mm256_sub_epi32(result, _mm256_cmpgt_epi32(remainder, threshold));
+
+  result = _mm256_add_epi32(result, rq.output_offset);
+  result = _mm256_max_epi32(result, rq.activation_min);
+  return _mm256_min_epi32(result, rq.activation_max);
+}
+
+// Stores the first count (up to 8) lanes of v, already within int8, as int8
+static inline void Store(int8_t* out, __m256i v, int count) {
+  const __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(v),
+                                        _mm256_extracti128_si256(v, 1));
+  const __m128i bytes = _mm_packs_epi16(words, words);
+  if (count >= kLanes) {
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), bytes);
+  } else {
+    // 4, 2 and 1 byte pieces (fixed-size copies, no call into memcpy)
+    uint64_t lanes = static_cast<uint64_t>(_mm_cvtsi128_si64(bytes));
+    if (count & 4) {
+      const uint32_t piece = static_cast<uint32_t>(lanes);
+      memcpy(out, &piece, 4);
+      out += 4;
+      lanes >>= 32;
+    }
+    if (count & 2) {
+      const uint16_t piece = static_cast<uint16_t>(lanes);
+      memcpy(out, &piece, 2);
+      out += 2;
+      lanes >>= 16;
+    }
+    if (count & 1) {
+      *out = static_cast<int8_t>(lanes);
+    }
+  }
+}
+
+template <int N>
+static inline void LoadBias(__m256i* acc, const PackedFilter& packed,
+                            int block) {
+  for (int k = 0; k < N; k++) {
+    acc[k] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+        packed.bias + (block + k) * kLanes));
+  }
+}
+
+template <int N>
+static inline void StoreBlocks(int8_t* out, const __m256i* acc,
+                               const PackedFilter& packed, int block,
+                               const Requantization& rq) {
+  for (int k = 0; k < N; k++) {
+    const int channel = (block + k) * kLanes;
+    Store(out + channel, Requantize(acc[k], packed, channel, rq),
+          packed.output_depth - channel);
+  }
+}
+
+// acc[k] += the input row (depth int8 values plus offset) times the packed
+// weights of output block k, one input channel pair at a time
+template <int N>
+static inline void AccumulateRow(__m256i* acc, const int8_t* in, int depth,
+                                 int32_t offset, const int16_t* weights,
+                                 int pair_stride) {
+  int ix = 0;
+  for (; ix + 1 < depth; ix += 2, weights += pair_stride) {
+    const uint32_t pair =
+        static_cast<uint16_t>(in[ix] + offset) |
+        (static_cast<uint32_t>(static_cast<uint16_t>(in[ix + 1] + offset)) << 16);
+    const __m256i x = _mm256_set1_epi32(static_cast<int32_t>(pair));
+    for (int k = 0; k < N; k++) {
+      acc[k] = X86_INT8_MAC(acc[k], x,
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                                weights + k * 2 * kLanes)));
+    }
+  }
+  if (ix < depth) {
+    const __m256i x =
+        _mm256_set1_epi32(static_cast<uint16_t>(in[ix] + offset));
+    for (int k = 0; k < N; k++) {
+      acc[k] = X86_INT8_MAC(acc[k], x,
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                                weights + k * 2 * kLanes)));
+    }
+  }
+}
+
+struct ConvGeometry {
+  int input_height, input_width, input_depth;
+  int filter_height, filter_width;
+  int dilation_height, dilation_width;
+  int32_t input_offset;
+};
+
+template <int N>
+static inline void ConvPixel(const ConvGeometry& g, const PackedFilter& packed,
+                             const int8_t* input, int in_y_origin,
+                             int in_x_origin, int block, int8_t* out,
+                             const Requantization& rq) {
+  const int pair_stride = packed.output_depth_padded * 2;
+  const size_t tap_stride = static_cast<size_t>(packed.pairs) * pair_stride;
+
+  __m256i acc[N];
+  LoadBias<N>(acc, packed, block);
+  for (int filter_y = 0; filter_y < g.filter_height; ++filter_y) {
+    const int in_y = in_y_origin + g.dilation_height * filter_y;
+    if (in_y < 0 || in_y >= g.input_height) {
+      continue;
+    }
+    for (int filter_x = 0; filter_x < g.filter_width; ++filter_x) {
+      const int in_x = in_x_origin + g.dilation_width * filter_x;
+      if (in_x < 0 || in_x >= g.input_width) {
+        continue;
+      }
+      const int tap = filter_y * g.filter_width + filter_x;
+      AccumulateRow<N>(
+          acc, input + (static_cast<size_t>(in_y) * g.input_width + in_x) * g.input_depth,
+          g.input_depth, g.input_offset,
+          packed.weights + tap * tap_stride + block * 2 * kLanes, pair_stride);
+    }
+  }
+  StoreBlocks<N>(out, acc, packed, block, rq);
+}
+
+static void ConvPerChannel(const ConvParams& params, const PackedFilter& packed,
+                           const RuntimeShape& input_shape,
+                           const int8_t* input_data,
+                           const RuntimeShape& filter_shape,
+                           const RuntimeShape& output_shape,
+                           int8_t* output_data) {
+  ConvGeometry g;
+  g.input_height = input_shape.Dims(1);
+  g.input_width = input_shape.Dims(2);
+  g.input_depth = input_shape.Dims(3);
+  g.filter_height = filter_shape.Dims(1);
+  g.filter_width = filter_shape.Dims(2);
+  g.dilation_height = params.dilation_height_factor;
+  g.dilation_width = params.dilation_width_factor;
+  g.input_offset = params.input_offset;
+
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  const int output_depth = packed.output_depth;
+  const int blocks = packed.output_depth_padded / kLanes;
+  const Requantization rq =
+      MakeRequantization(params.output_offset, params.quantized_activation_min,
+                         params.quantized_activation_max);
+
+  for (int batch = 0; batch < batches; ++batch) {
+    const int8_t* input = input_data + static_cast<size_t>(batch) *
+                                           g.input_height * g.input_width *
+                                           g.input_depth;
+    for (int out_y = 0; out_y < output_height; ++out_y) {
+      const int in_y_origin =
+          out_y * params.stride_height - params.padding_values.height;
+      for (int out_x = 0; out_x < output_width; ++out_x) {
+        const int in_x_origin =
+            out_x * params.stride_width - params.padding_values.width;
+        int8_t* out = output_data + ((static_cast<size_t>(batch) * output_height + out_y) *
+                                         output_width + out_x) * output_depth;
+        int block = 0;
+        for (; block + kBlocks <= blocks; block += kBlocks) {
+          ConvPixel<kBlocks>(g, packed, input, in_y_origin, in_x_origin, block, out, rq);
+        }
+        switch (blocks - block) {
+          case 3: ConvPixel<3>(g, packed, input, in_y_origin, in_x_origin, block, out, rq); break;
+          case 2: ConvPixel<2>(g, packed, input, in_y_origin, in_x_origin, block, out, rq); break;
+          case 1: ConvPixel<1>(g, packed, input, in_y_origin, in_x_origin, block, out, rq); break;
+          default: break;
+        }
+      }
+    }
+  }
+}
+
+// 8 channels of one tap as int16 plus the input offset. Past the last channel
+// the lanes hold the next pixel (their packed weights are 0); only at the end
+// of the tensor are just count (up to 8) read.
+static inline __m128i LoadChannels(const int8_t* in, int count,
+                                   const int8_t* end, __m128i offset) {
+  __m128i v;
+  if (count >= kLanes || in + kLanes <= end) {
+    v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in));
+  } else {
+    int8_t lanes[kLanes] = {0};
+    memcpy(lanes, in, count);
+    v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(lanes));
+  }
+  return _mm_add_epi16(_mm_cvtepi8_epi16(v), offset);
+}
+
+// taps: input pixel of every filter tap for this output pixel, null where the
+// tap falls in the padding; two taps are interleaved per int16 pair
+template <int N>
+static inline void DepthwisePixel(const PackedFilter& packed,
+                                  const int8_t* const* taps, int tap_count,
+                                  int depth, const int8_t* end, __m128i offset,
+                                  int block,
+                                  int8_t* out, const Requantization& rq) {
+  const int pair_stride = packed.output_depth_padded * 2;
+  const __m128i zero = _mm_setzero_si128();
+
+  __m256i acc[N];
+  LoadBias<N>(acc, packed, block);
+  for (int pair = 0; pair < packed.pairs; pair++) {
+    const int8_t* tap0 = taps[2 * pair];
+    const int8_t* tap1 = 2 * pair + 1 < tap_count ? taps[2 * pair + 1] : nullptr;
+    if (!tap0 && !tap1) {
+      continue;
+    }
+    const int16_t* weights =
+        packed.weights + pair * pair_stride + block * 2 * kLanes;
+    for (int k = 0; k < N; k++) {
+      const int channel = (block + k) * kLanes;
+      const __m128i a =
+          tap0 ? LoadChannels(tap0 + channel, depth - channel, end, offset)
+               : zero;
+      const __m128i b =
+          tap1 ? LoadChannels(tap1 + channel, depth - channel, end, offset)
+               : zero;
+      const __m256i x = _mm256_set_m128i(_mm_unpackhi_epi16(a, b),
+                                         _mm_unpacklo_epi16(a, b));
+      acc[k] = X86_INT8_MAC(acc[k], x,
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                                weights + k * 2 * kLanes)));
+    }
+  }
+  StoreBlocks<N>(out, acc, packed, block, rq);
+}
+
+// Input pixel of every filter tap for output pixel (out_y, out_x), null where
+// the tap falls in the padding
+static inline void DepthwiseTaps(const DepthwiseParams& params,
+                                 const int8_t* input, int input_height,
+                                 int input_width, int depth, int filter_height,
+                                 int filter_width, int out_y, int out_x,
+                                 const int8_t** taps) {
+  const int in_y_origin =
+      out_y * params.stride_height - params.padding_values.height;
+  const int in_x_origin =
+      out_x * params.stride_width - params.padding_values.width;
+  for (int filter_y = 0; filter_y < filter_height; ++filter_y) {
+    const int in_y = in_y_origin + params.dilation_height_factor * filter_y;
+    for (int filter_x = 0; filter_x < filter_width; ++filter_x) {
+      const int in_x = in_x_origin + params.dilation_width_factor * filter_x;
+      const bool inside = in_x >= 0 && in_x < input_width && in_y >= 0 &&
+                          in_y < input_height;
+      taps[filter_y * filter_width + filter_x] =
+          inside ? input + (static_cast<size_t>(in_y) * input_width + in_x) * depth
+                 : nullptr;
+    }
+  }
+}
+
+// All output channels of one depthwise pixel, kBlocks vectors at a time
+static inline void DepthwiseOutputs(const PackedFilter& packed,
+                                    const int8_t* const* taps, int tap_count,
+                                    int depth, const int8_t* end,
+                                    __m128i offset, int8_t* out,
+                                    const Requantization& rq) {
+  const int blocks = packed.output_depth_padded / kLanes;
+  int block = 0;
+  for (; block + kBlocks <= blocks; block += kBlocks) {
+    DepthwisePixel<kBlocks>(packed, taps, tap_count, depth, end, offset, block, out, rq);
+  }
+  switch (blocks - block) {
+    case 3: DepthwisePixel<3>(packed, taps, tap_count, depth, end, offset, block, out, rq); break;
+    case 2: DepthwisePixel<2>(packed, taps, tap_count, depth, end, offset, block, out, rq); break;
+    case 1: DepthwisePixel<1>(packed, taps, tap_count, depth, end, offset, block, out, rq); break;
+    default: break;
+  }
+}
+
+static void DepthwiseConvPerChannel(const DepthwiseParams& params,
+                                    const PackedFilter& packed,
+                                    const RuntimeShape& input_shape,
+                                    const int8_t* input_data,
+                                    const RuntimeShape& filter_shape,
+                                    const RuntimeShape& output_shape,
+                                    int8_t* output_data) {
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int depth = input_shape.Dims(3);
+  const int filter_height = filter_shape.Dims(1);
+  const int filter_width = filter_shape.Dims(2);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  const int tap_count = filter_height * filter_width;
+  const __m128i offset = _mm_set1_epi16(static_cast<int16_t>(params.input_offset));
+  const Requantization rq =
+      MakeRequantization(params.output_offset, params.quantized_activation_min,
+                         params.quantized_activation_max);
+
+  const int8_t* taps[kMaxDepthwiseTaps];
+  for (int batch = 0; batch < batches; ++batch) {
+    const int8_t* input = input_data + static_cast<size_t>(batch) *
+                                           input_height * input_width * depth;
+    const int8_t* end = input + static_cast<size_t>(input_height) * input_width * depth;
+    for (int out_y = 0; out_y < output_height; ++out_y) {
+      for (int out_x = 0; out_x < output_width; ++out_x) {
+        DepthwiseTaps(params, input, input_height, input_width, depth,
+                      filter_height, filter_width, out_y, out_x, taps);
+        int8_t* out = output_data + ((static_cast<size_t>(batch) * output_height + out_y) *
+                                         output_width + out_x) * depth;
+        DepthwiseOutputs(packed, taps, tap_count, depth, end, offset, out, rq);
+      }
+    }
+  }
+}
+
+template <int N>
+static inline void FullyConnectedRow(const PackedFilter& packed,
+                                     const int8_t* input, int accum_depth,
+                                     int32_t input_offset, int block,
+                                     int8_t* out, const Requantization& rq) {
+  __m256i acc[N];
+  LoadBias<N>(acc, packed, block);
+  AccumulateRow<N>(acc, input, accum_depth, input_offset,
+                   packed.weights + block * 2 * kLanes,
+                   packed.output_depth_padded * 2);
+  StoreBlocks<N>(out, acc, packed, block, rq);
+}
+
+// All output channels of one input row, kBlocks vectors at a time
+static inline void FullyConnectedOutputs(const PackedFilter& packed,
+                                         const int8_t* input, int accum_depth,
+                                         int32_t input_offset, int8_t* out,
+                                         const Requantization& rq) {
+  const int blocks = packed.output_depth_padded / kLanes;
+  int block = 0;
+  for (; block + kBlocks <= blocks; block += kBlocks) {
+    FullyConnectedRow<kBlocks>(packed, input, accum_depth, input_offset, block, out, rq);
+  }
+  switch (blocks - block) {
+    case 3: FullyConnectedRow<3>(packed, input, accum_depth, input_offset, block, out, rq); break;
+    case 2: FullyConnectedRow<2>(packed, input, accum_depth, input_offset, block, out, rq); break;
+    case 1: FullyConnectedRow<1>(packed, input, accum_depth, input_offset, block, out, rq); break;
+    default: break;
+  }
+}
+
+static void FullyConnected(const FullyConnectedParams& params,
+                           const PackedFilter& packed,
+                           const int8_t* input_data,
+                           const RuntimeShape& filter_shape,
+                           const RuntimeShape& output_shape,
+                           int8_t* output_data) {
+  const int output_dim_count = output_shape.DimensionsCount();
+  const int batches = FlatSizeSkipDim(output_shape, output_dim_count - 1);
+  const int output_depth = output_shape.Dims(output_dim_count - 1);
+  const int accum_depth = filter_shape.Dims(filter_shape.DimensionsCount() - 1);
+  const Requantization rq =
+      MakeRequantization(params.output_offset, params.quantized_activation_min,
+                         params.quantized_activation_max);
+
+  for (int batch = 0; batch < batches; ++batch) {
+    FullyConnectedOutputs(packed, input_data + static_cast<size_t>(batch) * accum_depth,
+                          accum_depth, params.input_offset,
+                          output_data + static_cast<size_t>(batch) * output_depth, rq);
+  }
+}
+
+// Depthwise outputs of tile_pixels pixels into tile, then the 1x1 convolution
+// of the tile (packed as a convolution with one tap, which is the fully
+// connected layout) straight into the output
+static void DepthwiseSeparableConvPerChannel(
+    const DepthwiseParams& depthwise_params, const PackedFilter& depthwise_packed,
+    const ConvParams& pointwise_params, const PackedFilter& pointwise_packed,
+    const RuntimeShape& input_shape, const int8_t* input_data,
+    const RuntimeShape& depthwise_filter_shape,
+    const RuntimeShape& output_shape, int8_t* output_data, int8_t* tile,
+    int tile_pixels) {
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int depth = input_shape.Dims(3);
+  const int filter_height = depthwise_filter_shape.Dims(1);
+  const int filter_width = depthwise_filter_shape.Dims(2);
+  const int output_width = output_shape.Dims(2);
+  const int pixels = output_shape.Dims(1) * output_width;
+  const int output_depth = pointwise_packed.output_depth;
+  const int tap_count = filter_height * filter_width;
+  const __m128i offset =
+      _mm_set1_epi16(static_cast<int16_t>(depthwise_params.input_offset));
+  const Requantization depthwise_rq = MakeRequantization(
+      depthwise_params.output_offset, depthwise_params.quantized_activation_min,
+      depthwise_params.quantized_activation_max);
+  const Requantization pointwise_rq = MakeRequantization(
+      pointwise_params.output_offset, pointwise_params.quantized_activation_min,
+      pointwise_params.quantized_activation_max);
+
+  const int8_t* taps[kMaxDepthwiseTaps];
+  for (int batch = 0; batch < batches; ++batch) {
+    const int8_t* input = input_data + static_cast<size_t>(batch) *
+                                           input_height * input_width * depth;
+    const int8_t* end = input + static_cast<size_t>(input_height) * input_width * depth;
+    int8_t* output = output_data + static_cast<size_t>(batch) * pixels * output_depth;
+    for (int first = 0; first < pixels; first += tile_pixels) {
+      const int count = pixels - first < tile_pixels ? pixels - first : tile_pixels;
+      for (int ix = 0; ix < count; ++ix) {
+        DepthwiseTaps(depthwise_params, input, input_height, input_width,
+                      depth, filter_height, filter_width,
+                      (first + ix) / output_width, (first + ix) % output_width,
+                      taps);
+        DepthwiseOutputs(depthwise_packed, taps, tap_count, depth, end, offset,
+                         tile + static_cast<size_t>(ix) * depth, depthwise_rq);
+      }
+      for (int ix = 0; ix < count; ++ix) {
+        FullyConnectedOutputs(pointwise_packed, tile + static_cast<size_t>(ix) * depth,
+                              depth, pointwise_params.input_offset,
+                              output + static_cast<size_t>(first + ix) * output_depth,
+                              pointwise_rq);
+      }
+    }
+  }
+}
+
+}  // namespace X86_INT8_NAMESPACE
@@ -0,0 +1,246 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_KERNELS_INTERNAL_REFERENCE_INTEGER_OPS_DEPTHWISE_SEPARABLE_CONV_H_
+#define TENSORFLOW_LITE_KERNELS_INTERNAL_REFERENCE_INTEGER_OPS_DEPTHWISE_SEPARABLE_CONV_H_
+
+#include <algorithm>
+
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/common.h"
+
+// A DEPTHWISE_CONV_2D (depth_multiplier 1) feeding a 1x1, stride 1 CONV_2D,
+// the depthwise-separable block of MobileNet, computed a tile of output pixels
+// at a time: the depthwise outputs of a tile go to `tile` ([pixels][depth],
+// quantized as the intermediate tensor of the two ops) and the 1x1 convolution
+// reads them back from there, so the intermediate tensor is never whole.
+// Same results as DepthwiseConvPerChannel followed by ConvPerChannel.
+namespace tflite {
+namespace reference_integer_ops {
+
+inline int8_t RequantizeToInt8(int32_t acc, int32_t output_multiplier,
+                               int32_t output_shift, int32_t output_offset,
+                               int32_t output_activation_min,
+                               int32_t output_activation_max) {
+  acc = MultiplyByQuantizedMultiplier(acc, output_multiplier, output_shift);
+  acc += output_offset;
+  acc = std::max(acc, output_activation_min);
+  acc = std::min(acc, output_activation_max);
+  return static_cast<int8_t>(acc);
+}
+
+// Depthwise outputs [first, first + count) of one batch, numbered in row-major
+// output order, into tile[count][depth]. The taps inside the input are worked
+// out once per pixel instead of being checked per channel.
+inline void DepthwiseConvTile(
+    const DepthwiseParams& params, const int32_t* output_multiplier,
+    const int32_t* output_shift, const RuntimeShape& input_shape,
+    const int8_t* input_data, const RuntimeShape& filter_shape,
+    const int8_t* filter_data, const int32_t* bias_data, int output_width,
+    int first, int count, int8_t* tile) {
+  const int stride_width = params.stride_width;
+  const int stride_height = params.stride_height;
+  const int dilation_width_factor = params.dilation_width_factor;
+  const int dilation_height_factor = params.dilation_height_factor;
+  const int pad_width = params.padding_values.width;
+  const int pad_height = params.padding_values.height;
+  const int32_t input_offset = params.input_offset;
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int depth = input_shape.Dims(3);
+  const int filter_height = filter_shape.Dims(1);
+  const int filter_width = filter_shape.Dims(2);
+
+  for (int ix = 0; ix < count; ++ix) {
+    const int out_y = (first + ix) / output_width;
+    const int out_x = (first + ix) % output_width;
+    const int in_y_origin = (out_y * stride_height) - pad_height;
+    const int in_x_origin = (out_x * stride_width) - pad_width;
+
+    // Zero padding by leaving out the taps outside the image.
+    int filter_y_begin = 0;
+    while (filter_y_begin < filter_height &&
+           in_y_origin + dilation_height_factor * filter_y_begin < 0) {
+      ++filter_y_begin;
+    }
+    int filter_y_end = filter_height;
+    while (filter_y_end > filter_y_begin &&
+           in_y_origin + dilation_height_factor * (filter_y_end - 1) >=
+               input_height) {
+      --filter_y_end;
+    }
+    int filter_x_begin = 0;
+    while (filter_x_begin < filter_width &&
+           in_x_origin + dilation_width_factor * filter_x_begin < 0) {
+      ++filter_x_begin;
+    }
+    int filter_x_end = filter_width;
+    while (filter_x_end > filter_x_begin &&
+           in_x_origin + dilation_width_factor * (filter_x_end - 1) >=
+               input_width) {
+      --filter_x_end;
+    }
+
+    int8_t* out = tile + ix * depth;
+    for (int channel = 0; channel < depth; ++channel) {
+      int32_t acc = 0;
+      for (int filter_y = filter_y_begin; filter_y < filter_y_end;
+           ++filter_y) {
+        const int in_y = in_y_origin + dilation_height_factor * filter_y;
+        const int8_t* in_row =
+            input_data + in_y * input_width * depth + channel;
+        const int8_t* filter_row =
+            filter_data + filter_y * filter_width * depth + channel;
+        for (int filter_x = filter_x_begin; filter_x < filter_x_end;
+             ++filter_x) {
+          const int in_x = in_x_origin + dilation_width_factor * filter_x;
+          acc += filter_row[filter_x * depth] *
+                 (in_row[in_x * depth] + input_offset);
+        }
+      }
+      if (bias_data) {
+        acc += bias_data[channel];
+      }
+      out[channel] = RequantizeToInt8(
+          acc, output_multiplier[channel], output_shift[channel],
+          params.output_offset, params.quantized_activation_min,
+          params.quantized_activation_max);
+    }
+  }
+}
+
+// The 1x1 convolution of tile[count][input_depth] into
+// output[count][output_depth], a matrix product with the filter rows, two
+// pixels by two output channels per inner loop as in arm_nn_mat_mult_nt_t_s8.
+// An odd last pixel or channel goes through the same loop a second time.
+inline void PointwiseConvTile(const ConvParams& params,
+                              const int32_t* output_multiplier,
+                              const int32_t* output_shift, const int8_t* tile,
+                              int count, int input_depth,
+                              const int8_t* filter_data,
+                              const int32_t* bias_data, int output_depth,
+                              int8_t* output_data) {
+  const int32_t input_offset = params.input_offset;
+  const int32_t output_offset = params.output_offset;
+  const int32_t output_activation_min = params.quantized_activation_min;
+  const int32_t output_activation_max = params.quantized_activation_max;
+
+  for (int pixel = 0; pixel < count; pixel += 2) {
+    const bool two_pixels = pixel + 1 < count;
+    const int8_t* lhs0 = tile + pixel * input_depth;
+    const int8_t* lhs1 = two_pixels ? lhs0 + input_depth : lhs0;
+    int8_t* out0 = output_data + pixel * output_depth;
+    int8_t* out1 = out0 + output_depth;
+
+    for (int channel = 0; channel < output_depth; channel += 2) {
+      const bool two_channels = channel + 1 < output_depth;
+      const int8_t* rhs0 = filter_data + channel * input_depth;
+      const int8_t* rhs1 = two_channels ? rhs0 + input_depth : rhs0;
+
+      int32_t acc00 = 0;
+      int32_t acc01 = 0;
+      int32_t acc10 = 0;
+      int32_t acc11 = 0;
+      for (int k = 0; k < input_depth; ++k) {
+        const int32_t x0 = lhs0[k] + input_offset;
+        const int32_t x1 = lhs1[k] + input_offset;
+        const int32_t w0 = rhs0[k];
+        const int32_t w1 = rhs1[k];
+        acc00 += w0 * x0;
+        acc01 += w1 * x0;
+        acc10 += w0 * x1;
+        acc11 += w1 * x1;
+      }
+      if (bias_data) {
+        acc00 += bias_data[channel];
+        acc10 += bias_data[channel];
+        if (two_channels) {
+          acc01 += bias_data[channel + 1];
+          acc11 += bias_data[channel + 1];
+        }
+      }
+
+      out0[channel] = RequantizeToInt8(
+          acc00, output_multiplier[channel], output_shift[channel],
+          output_offset, output_activation_min, output_activation_max);
+      if (two_channels) {
+        out0[channel + 1] = RequantizeToInt8(
+            acc01, output_multiplier[channel + 1], output_shift[channel + 1],
+            output_offset, output_activation_min, output_activation_max);
+      }
+      if (two_pixels) {
+        out1[channel] = RequantizeToInt8(
+            acc10, output_multiplier[channel], output_shift[channel],
+            output_offset, output_activation_min, output_activation_max);
+        if (two_channels) {
+          out1[channel + 1] = RequantizeToInt8(
+              acc11, output_multiplier[channel + 1],
+              output_shift[channel + 1], output_offset,
+              output_activation_min, output_activation_max);
+        }
+      }
+    }
+  }
+}
+
+// tile holds tile_pixels * depth int8 values
+inline void DepthwiseSeparableConvPerChannel(
+    const DepthwiseParams& depthwise_params,
+    const int32_t* depthwise_output_multiplier,
+    const int32_t* depthwise_output_shift, const RuntimeShape& input_shape,
+    const int8_t* input_data, const RuntimeShape& depthwise_filter_shape,
+    const int8_t* depthwise_filter_data, const int32_t* depthwise_bias_data,
+    const ConvParams& pointwise_params,
+    const int32_t* pointwise_output_multiplier,
+    const int32_t* pointwise_output_shift,
+    const RuntimeShape& pointwise_filter_shape,
+    const int8_t* pointwise_filter_data, const int32_t* pointwise_bias_data,
+    const RuntimeShape& output_shape, int8_t* output_data, int8_t* tile,
+    int tile_pixels) {
+  TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(depthwise_filter_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(pointwise_filter_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(depthwise_params.depth_multiplier, 1);
+  TFLITE_DCHECK_GT(tile_pixels, 0);
+
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int input_depth =
+      MatchingDim(input_shape, 3, depthwise_filter_shape, 3);
+  TFLITE_DCHECK_EQ(pointwise_filter_shape.Dims(3), input_depth);
+  const int output_depth = MatchingDim(pointwise_filter_shape, 0, output_shape, 3);
+  const int output_width = output_shape.Dims(2);
+  const int pixels = output_shape.Dims(1) * output_width;
+  const int input_size = input_shape.Dims(1) * input_shape.Dims(2) * input_depth;
+
+  for (int batch = 0; batch < batches; ++batch) {
+    const int8_t* input = input_data + batch * input_size;
+    int8_t* output = output_data + batch * pixels * output_depth;
+    for (int first = 0; first < pixels; first += tile_pixels) {
+      const int count = std::min(tile_pixels, pixels - first);
+      DepthwiseConvTile(depthwise_params, depthwise_output_multiplier,
+                        depthwise_output_shift, input_shape, input,
+                        depthwise_filter_shape, depthwise_filter_data,
+                        depthwise_bias_data, output_width, first, count, tile);
+      PointwiseConvTile(pointwise_params, pointwise_output_multiplier,
+                        pointwise_output_shift, tile, count, input_depth,
+                        pointwise_filter_data, pointwise_bias_data,
+                        output_depth, output + first * output_depth);
+    }
+  }
+}
+
+}  // namespace reference_integer_ops
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_KERNELS_INTERNAL_REFERENCE_INTEGER_OPS_DEPTHWISE_SEPARABLE_CONV_H_
@@ -81,6 +81,32 @@ inline TfLitePaddingValues ComputePaddingHeightWidth(
   return padding_values;
 }
 
+// ComputePaddingHeightWidth for TfLiteConvParams / TfLiteDepthwiseConvParams
+// with explicit padding (a PAD op folded into the convolution): the output
+// size and the padding of `padding` are those of the explicitly padded input,
+// and the explicit padding adds to them. The kernels only take the padding
+// before the first row and column; what falls past the input after them reads
+// as zero through their bounds checks.
+template <typename ConvParamsT>
+inline TfLitePaddingValues ComputeConvPaddingHeightWidth(
+    const ConvParamsT& params, int in_height, int in_width, int filter_height,
+    int filter_width, int* out_height, int* out_width) {
+  TfLitePaddingValues padding_values = ComputePaddingHeightWidth(
+      params.stride_height, params.stride_width, params.dilation_height_factor,
+      params.dilation_width_factor,
+      in_height + params.explicit_padding_top + params.explicit_padding_bottom,
+      in_width + params.explicit_padding_left + params.explicit_padding_right,
+      filter_height, filter_width, params.padding, out_height, out_width);
+  // the offset is the padding after less the padding before
+  padding_values.height_offset +=
+      params.explicit_padding_bottom - params.explicit_padding_top;
+  padding_values.width_offset +=
+      params.explicit_padding_right - params.explicit_padding_left;
+  padding_values.height += params.explicit_padding_top;
+  padding_values.width += params.explicit_padding_left;
+  return padding_values;
+}
+
 inline Padding3DValues ComputePadding3DValues(
     int stride_height, int stride_width, int stride_depth,
     int dilation_rate_height, int dilation_rate_width, int dilation_rate_depth,
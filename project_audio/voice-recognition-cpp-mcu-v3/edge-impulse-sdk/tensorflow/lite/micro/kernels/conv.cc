@@ -629,11 +629,9 @@ TfLiteStatus CalculateOpData(TfLiteContext* context, TfLiteNode* node,
   TF_LITE_ENSURE_EQ(context, node->outputs->size, 1);
 
   // Matching GetWindowedOutputSize in TensorFlow.
-  auto padding = params->padding;
-  data->padding = ComputePaddingHeightWidth(
-      params->stride_height, params->stride_width,
-      params->dilation_height_factor, params->dilation_width_factor, height,
-      width, filter_height, filter_width, padding, &out_height, &out_width);
+  data->padding = ComputeConvPaddingHeightWidth(
+      *params, height, width, filter_height, filter_width, &out_height,
+      &out_width);
   // Note that quantized inference requires that all tensors have their
   // parameters set. This is usually done during quantized training.
 #if !defined(TF_LITE_STRIP_REFERENCE_IMPL)
@@ -832,7 +830,12 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
     }
     data->cfg->stride_width = params->stride_width;
     data->cfg->stride_height = params->stride_height;
-    if (params->padding == kTfLitePaddingValid) {
+    // data->padding holds the explicit_padding_* of a VALID convolution (a
+    // PAD folded by arena_planner --fold)
+    const bool explicit_padding =
+        params->explicit_padding_top || params->explicit_padding_bottom ||
+        params->explicit_padding_left || params->explicit_padding_right;
+    if (params->padding == kTfLitePaddingValid && !explicit_padding) {
       data->cfg->padding_left = 0;
       data->cfg->padding_right = 0;
       data->cfg->padding_top = 0;
@@ -1352,13 +1355,14 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node)
   data->op_params.padding         = params->padding == kTfLitePaddingSame;
 
   int dummy_height, dummy_width;
-  const auto padding = ComputePaddingHeightWidth(
-                         params->stride_height, params->stride_width,
-                         params->dilation_height_factor, params->dilation_width_factor,
+  const auto padding = ComputeConvPaddingHeightWidth(
+                         *params,
                          data->op_params.input_height, data->op_params.input_width,
                          data->op_params.filter_height, data->op_params.filter_width,
-                         params->padding,
                          &dummy_height, &dummy_width);
+  // the MVP derives its padding from the padding type alone
+  const bool explicit_padding = params->explicit_padding_top || params->explicit_padding_bottom ||
+                                params->explicit_padding_left || params->explicit_padding_right;
 
   data->op_params.pad_height = padding.height;
   data->op_params.pad_width  = padding.width;
@@ -1366,7 +1370,7 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node)
   const int num_channels = data->op_params.out_channels;
 
   if (input->type == kTfLiteInt8) {
-    if (sli_mvp_ml_conv2d_s8_is_supported(&data->op_params)) {
+    if (!explicit_padding && sli_mvp_ml_conv2d_s8_is_supported(&data->op_params)) {
       data->supported = kMvp;
 
       float16_t *bias_data = static_cast<float16_t*>(context->AllocatePersistentBuffer(
@@ -2036,6 +2040,246 @@ TfLiteRegistration Register_CONV_2D() {
 
 }  // namespace tflite
 
+#elif EI_CLASSIFIER_TFLITE_ENABLE_X86_SIMD == 1
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/conv.h"
+
+#include "edge-impulse-sdk/tensorflow/lite/c/builtin_op_data.h"
+#include "edge-impulse-sdk/tensorflow/lite/c/common.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/x86_int8.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/portable_tensor_utils.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/conv.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/conv.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/kernel_util.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/kernel_util.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/micro_log.h"
+
+namespace tflite {
+namespace {
+
+struct NodeData {
+  OpDataConv op_data;  // first, ConvPrepare fills it through node->user_data
+  x86_int8::PackedFilter packed;
+  bool has_packed;
+};
+
+void* Init(TfLiteContext* context, const char* buffer, size_t length) {
+  TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+  return context->AllocatePersistentBuffer(context, sizeof(NodeData));
+}
+
+TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
+  TF_LITE_ENSURE_STATUS(ConvPrepare(context, node));
+
+  NodeData* data = static_cast<NodeData*>(node->user_data);
+  data->has_packed = false;
+
+  MicroContext* micro_context = GetMicroContext(context);
+  TfLiteTensor* input =
+      micro_context->AllocateTempInputTensor(node, kConvInputTensor);
+  TF_LITE_ENSURE(context, input != nullptr);
+  TfLiteTensor* filter =
+      micro_context->AllocateTempInputTensor(node, kConvWeightsTensor);
+  TF_LITE_ENSURE(context, filter != nullptr);
+  TfLiteTensor* bias =
+      micro_context->AllocateTempInputTensor(node, kConvBiasTensor);
+
+  // int8 with constant int8 weights and int32 bias: repack for the x86 kernel
+  if (input->type == kTfLiteInt8 && filter->type == kTfLiteInt8 &&
+      filter->data.int8 != nullptr &&
+      (bias == nullptr || (bias->type == kTfLiteInt32 && bias->data.i32 != nullptr)) &&
+      x86_int8::DetectedIsa() != x86_int8::Isa::kNone) {
+    const RuntimeShape filter_shape = GetTensorShape(filter);
+    void* buffer = context->AllocatePersistentBuffer(
+        context, x86_int8::ConvPackedBytes(filter_shape));
+    if (buffer != nullptr) {
+      x86_int8::PackConvPerChannel(
+          filter_shape, filter->data.int8,
+          bias != nullptr ? bias->data.i32 : nullptr,
+          data->op_data.per_channel_output_multiplier,
+          data->op_data.per_channel_output_shift, buffer, &data->packed);
+      data->has_packed = true;
+    }
+  }
+
+  micro_context->DeallocateTempTfLiteTensor(input);
+  micro_context->DeallocateTempTfLiteTensor(filter);
+  if (bias != nullptr) {
+    micro_context->DeallocateTempTfLiteTensor(bias);
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
+  const TfLiteEvalTensor* input =
+      tflite::micro::GetEvalInput(context, node, kConvInputTensor);
+  const TfLiteEvalTensor* filter =
+      tflite::micro::GetEvalInput(context, node, kConvWeightsTensor);
+  const TfLiteEvalTensor* bias =
+      (NumInputs(node) == 3)
+          ? tflite::micro::GetEvalInput(context, node, kConvBiasTensor)
+          : nullptr;
+  TfLiteEvalTensor* output =
+      tflite::micro::GetEvalOutput(context, node, kConvOutputTensor);
+
+  TFLITE_DCHECK(node->builtin_data != nullptr);
+  const auto& params =
+      *(reinterpret_cast<TfLiteConvParams*>(node->builtin_data));
+  TFLITE_DCHECK(node->user_data != nullptr);
+  const auto& node_data = *(static_cast<const NodeData*>(node->user_data));
+  const OpDataConv& data = node_data.op_data;
+
+  TF_LITE_ENSURE_EQ(context, input->type, output->type);
+  TF_LITE_ENSURE_MSG(
+      context,
+      input->type == filter->type ||
+          (input->type == kTfLiteInt16 && filter->type == kTfLiteInt8) ||
+          (input->type == kTfLiteInt8 && filter->type == kTfLiteInt4),
+      "Hybrid models are not supported on TFLite Micro.");
+
+  switch (input->type) {  // Already know in/out types are same.
+    case kTfLiteFloat32: {
+#if EI_TFLITE_DISABLE_CONV_2D_IN_F32
+      MicroPrintf("Type %s (%d) not supported.", TfLiteTypeGetName(input->type),
+                  input->type);
+      return kTfLiteError;
+#endif
+      tflite::reference_ops::Conv(
+          ConvParamsFloat(params, data), tflite::micro::GetTensorShape(input),
+          tflite::micro::GetTensorData<float>(input),
+          tflite::micro::GetTensorShape(filter),
+          tflite::micro::GetTensorData<float>(filter),
+          tflite::micro::GetTensorShape(bias),
+          tflite::micro::GetOptionalTensorData<float>(bias),
+          tflite::micro::GetTensorShape(output),
+          tflite::micro::GetTensorData<float>(output),
+          tflite::micro::GetTensorShape(nullptr), nullptr);
+      break;
+    }
+    case kTfLiteInt16: {
+      switch (bias->type) {
+        case kTfLiteInt32: {
+          reference_integer_ops::ConvPerChannel(
+              ConvParamsQuantized(params, data),
+              data.per_channel_output_multiplier, data.per_channel_output_shift,
+              tflite::micro::GetTensorShape(input),
+              tflite::micro::GetTensorData<int16_t>(input),
+              tflite::micro::GetTensorShape(filter),
+              tflite::micro::GetTensorData<int8_t>(filter),
+              tflite::micro::GetTensorShape(bias),
+              tflite::micro::GetOptionalTensorData<std::int32_t>(bias),
+              tflite::micro::GetTensorShape(output),
+              tflite::micro::GetTensorData<int16_t>(output));
+          break;
+        }
+        case kTfLiteInt64: {
+          reference_integer_ops::ConvPerChannel(
+              ConvParamsQuantized(params, data),
+              data.per_channel_output_multiplier, data.per_channel_output_shift,
+              tflite::micro::GetTensorShape(input),
+              tflite::micro::GetTensorData<int16_t>(input),
+              tflite::micro::GetTensorShape(filter),
+              tflite::micro::GetTensorData<int8_t>(filter),
+              tflite::micro::GetTensorShape(bias),
+              tflite::micro::GetOptionalTensorData<std::int64_t>(bias),
+              tflite::micro::GetTensorShape(output),
+              tflite::micro::GetTensorData<int16_t>(output));
+          break;
+        }
+        default:
+          MicroPrintf("Bias type %s (%d) not supported.",
+                      TfLiteTypeGetName(bias->type), bias->type);
+          return kTfLiteError;
+      }
+      break;
+    }
+    case kTfLiteInt8: {
+#if EI_TFLITE_DISABLE_CONV_2D_IN_I8
+      MicroPrintf("Type %s (%d) not supported.", TfLiteTypeGetName(input->type),
+                  input->type);
+      return kTfLiteError;
+#endif
+      switch (filter->type) {
+        case kTfLiteInt4: {
+          int8_t* unpacked_filter_data = static_cast<int8_t*>(
+              context->GetScratchBuffer(context, data.filter_buffer_index));
+          tflite::tensor_utils::UnpackDenseInt4IntoInt8(
+              tflite::micro::GetTensorData<int8_t>(filter),
+              tflite::micro::GetTensorShape(filter).FlatSize(),
+              unpacked_filter_data);
+          reference_integer_ops::ConvPerChannel(
+              ConvParamsQuantized(params, data),
+              data.per_channel_output_multiplier, data.per_channel_output_shift,
+              tflite::micro::GetTensorShape(input),
+              tflite::micro::GetTensorData<int8_t>(input),
+              tflite::micro::GetTensorShape(filter), unpacked_filter_data,
+              tflite::micro::GetTensorShape(bias),
+              tflite::micro::GetOptionalTensorData<int32_t>(bias),
+              tflite::micro::GetTensorShape(output),
+              tflite::micro::GetTensorData<int8_t>(output));
+          break;
+        }
+        case kTfLiteInt8: {
+          if (node_data.has_packed &&
+              x86_int8::ConvPerChannel(
+                  ConvParamsQuantized(params, data), node_data.packed,
+                  tflite::micro::GetTensorShape(input),
+                  tflite::micro::GetTensorData<int8_t>(input),
+                  tflite::micro::GetTensorShape(filter),
+                  tflite::micro::GetTensorShape(output),
+                  tflite::micro::GetTensorData<int8_t>(output))) {
+            break;
+          }
+          reference_integer_ops::ConvPerChannel(
+              ConvParamsQuantized(params, data),
+              data.per_channel_output_multiplier, data.per_channel_output_shift,
+              tflite::micro::GetTensorShape(input),
+              tflite::micro::GetTensorData<int8_t>(input),
+              tflite::micro::GetTensorShape(filter),
+              tflite::micro::GetTensorData<int8_t>(filter),
+              tflite::micro::GetTensorShape(bias),
+              tflite::micro::GetOptionalTensorData<int32_t>(bias),
+              tflite::micro::GetTensorShape(output),
+              tflite::micro::GetTensorData<int8_t>(output));
+          break;
+        }
+        default:
+          MicroPrintf("Weight type %s (%d) not supported.",
+                      TfLiteTypeGetName(filter->type), filter->type);
+          return kTfLiteError;
+      }
+      break;
+    }
+    default:
+      MicroPrintf("Type %s (%d) not supported.", TfLiteTypeGetName(input->type),
+                  input->type);
+      return kTfLiteError;
+  }
+  return kTfLiteOk;
+}
+
+}  // namespace
+
+TfLiteRegistration Register_CONV_2D() {
+  return tflite::micro::RegisterOp(Init, Prepare, Eval);
+}
+
+}  // namespace tflite
+
 #else
 /* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
 
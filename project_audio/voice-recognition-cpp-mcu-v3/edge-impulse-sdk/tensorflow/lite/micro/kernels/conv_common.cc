@@ -83,11 +83,9 @@ TfLiteStatus CalculateOpDataConv(TfLiteContext* context, TfLiteNode* node,
   TF_LITE_ENSURE_EQ(context, node->outputs->size, 1);
 
   // Matching GetWindowedOutputSize in TensorFlow.
-  auto padding = params.padding;
-  data->padding = ComputePaddingHeightWidth(
-      params.stride_height, params.stride_width, params.dilation_height_factor,
-      params.dilation_width_factor, height, width, filter_height, filter_width,
-      padding, &out_height, &out_width);
+  data->padding = ComputeConvPaddingHeightWidth(
+      params, height, width, filter_height, filter_width, &out_height,
+      &out_width);
 
   MicroContext* micro_context = GetMicroContext(context);
 
@@ -590,10 +590,9 @@ TfLiteStatus CalculateOpData(TfLiteContext* context, TfLiteNode* node,
   TF_LITE_ENSURE_EQ(context, node->outputs->size, 1);
 
   int unused_output_height, unused_output_width;
-  data->padding = ComputePaddingHeightWidth(
-      params->stride_height, params->stride_width, 1, 1, height, width,
-      filter_height, filter_width, params->padding, &unused_output_height,
-      &unused_output_width);
+  data->padding = ComputeConvPaddingHeightWidth(
+      *params, height, width, filter_height, filter_width,
+      &unused_output_height, &unused_output_width);
 
   // Note that quantized inference requires that all tensors have their
   // parameters set. This is usually done during quantized training.
@@ -802,7 +801,12 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
 
     data->cfg->stride_width = params->stride_width;
     data->cfg->stride_height = params->stride_height;
-    if (params->padding == kTfLitePaddingValid) {
+    // data->padding holds the explicit_padding_* of a VALID convolution (a
+    // PAD folded by arena_planner --fold)
+    const bool explicit_padding =
+        params->explicit_padding_top || params->explicit_padding_bottom ||
+        params->explicit_padding_left || params->explicit_padding_right;
+    if (params->padding == kTfLitePaddingValid && !explicit_padding) {
       data->cfg->padding_left = 0;
       data->cfg->padding_right = 0;
       data->cfg->padding_top = 0;
@@ -1284,13 +1288,14 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node)
   data->op_params.padding         = params->padding == kTfLitePaddingSame;
 
   int dummy_height, dummy_width;
-  const auto padding = ComputePaddingHeightWidth(
-                         params->stride_height, params->stride_width,
-                         params->dilation_height_factor, params->dilation_width_factor,
+  const auto padding = ComputeConvPaddingHeightWidth(
+                         *params,
                          data->op_params.input_height, data->op_params.input_width,
                          data->op_params.filter_height, data->op_params.filter_width,
-                         params->padding,
                          &dummy_height, &dummy_width);
+  // the MVP derives its padding from the padding type alone
+  const bool explicit_padding = params->explicit_padding_top || params->explicit_padding_bottom ||
+                                params->explicit_padding_left || params->explicit_padding_right;
 
   data->op_params.pad_height = padding.height;
   data->op_params.pad_width  = padding.width;
@@ -1298,7 +1303,7 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node)
   const int num_channels = data->op_params.out_channels;
 
   if (input->type == kTfLiteInt8) {
-    if (sli_mvp_ml_depthwise_conv2d_s8_is_supported(&data->op_params)) {
+    if (!explicit_padding && sli_mvp_ml_depthwise_conv2d_s8_is_supported(&data->op_params)) {
       data->supported = kMvp;
 
       float16_t *bias_data = static_cast<float16_t*>(context->AllocatePersistentBuffer(
@@ -1973,6 +1978,206 @@ TfLiteRegistration Register_DEPTHWISE_CONV_2D() {
 
 }  // namespace tflite
 
+#elif EI_CLASSIFIER_TFLITE_ENABLE_X86_SIMD == 1
+/* Copyright 2017 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/depthwise_conv.h"
+
+#include "edge-impulse-sdk/tensorflow/lite/c/builtin_op_data.h"
+#include "edge-impulse-sdk/tensorflow/lite/c/common.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/x86_int8.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/portable_tensor_utils.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/depthwiseconv_float.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/depthwise_conv.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/kernel_util.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/kernel_util.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/micro_log.h"
+
+namespace tflite {
+namespace {
+
+struct NodeData {
+  OpDataConv op_data;  // first, DepthwiseConvPrepare fills it through node->user_data
+  x86_int8::PackedFilter packed;
+  bool has_packed;
+};
+
+void* Init(TfLiteContext* context, const char* buffer, size_t length) {
+  TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+  return context->AllocatePersistentBuffer(context, sizeof(NodeData));
+}
+
+TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
+  TF_LITE_ENSURE_STATUS(DepthwiseConvPrepare(context, node));
+
+  NodeData* data = static_cast<NodeData*>(node->user_data);
+  data->has_packed = false;
+
+  MicroContext* micro_context = GetMicroContext(context);
+  TfLiteTensor* input =
+      micro_context->AllocateTempInputTensor(node, kDepthwiseConvInputTensor);
+  TF_LITE_ENSURE(context, input != nullptr);
+  TfLiteTensor* filter =
+      micro_context->AllocateTempInputTensor(node, kDepthwiseConvWeightsTensor);
+  TF_LITE_ENSURE(context, filter != nullptr);
+  TfLiteTensor* bias =
+      micro_context->AllocateTempInputTensor(node, kDepthwiseConvBiasTensor);
+
+  // int8 with constant int8 weights and int32 bias: repack for the x86 kernel
+  const auto& params =
+      *(reinterpret_cast<TfLiteDepthwiseConvParams*>(node->builtin_data));
+  const RuntimeShape filter_shape = GetTensorShape(filter);
+  if (input->type == kTfLiteInt8 && filter->type == kTfLiteInt8 &&
+      filter->data.int8 != nullptr &&
+      (bias == nullptr || (bias->type == kTfLiteInt32 && bias->data.i32 != nullptr)) &&
+      params.depth_multiplier == 1 &&
+      filter_shape.Dims(1) * filter_shape.Dims(2) <= x86_int8::kMaxDepthwiseTaps &&
+      x86_int8::DetectedIsa() != x86_int8::Isa::kNone) {
+    void* buffer = context->AllocatePersistentBuffer(
+        context, x86_int8::DepthwiseConvPackedBytes(filter_shape));
+    if (buffer != nullptr) {
+      x86_int8::PackDepthwiseConvPerChannel(
+          filter_shape, filter->data.int8,
+          bias != nullptr ? bias->data.i32 : nullptr,
+          data->op_data.per_channel_output_multiplier,
+          data->op_data.per_channel_output_shift, buffer, &data->packed);
+      data->has_packed = true;
+    }
+  }
+
+  micro_context->DeallocateTempTfLiteTensor(input);
+  micro_context->DeallocateTempTfLiteTensor(filter);
+  if (bias != nullptr) {
+    micro_context->DeallocateTempTfLiteTensor(bias);
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
+  TFLITE_DCHECK(node->user_data != nullptr);
+  TFLITE_DCHECK(node->builtin_data != nullptr);
+
+  auto& params =
+      *(reinterpret_cast<TfLiteDepthwiseConvParams*>(node->builtin_data));
+  const auto& node_data = *(static_cast<const NodeData*>(node->user_data));
+  const OpDataConv& data = node_data.op_data;
+
+  TfLiteEvalTensor* output =
+      tflite::micro::GetEvalOutput(context, node, kDepthwiseConvOutputTensor);
+  const TfLiteEvalTensor* input =
+      tflite::micro::GetEvalInput(context, node, kDepthwiseConvInputTensor);
+  const TfLiteEvalTensor* filter =
+      tflite::micro::GetEvalInput(context, node, kDepthwiseConvWeightsTensor);
+  const TfLiteEvalTensor* bias =
+      (NumInputs(node) == 3)
+          ? tflite::micro::GetEvalInput(context, node, kDepthwiseConvBiasTensor)
+          : nullptr;
+
+  switch (input->type) {  // Already know in/out types are same.
+    case kTfLiteFloat32: {
+#if EI_TFLITE_DISABLE_DEPTHWISE_CONV_2D_IN_F32
+      MicroPrintf("Type %s (%d) not supported.", TfLiteTypeGetName(input->type),
+                  input->type);
+      return kTfLiteError;
+#endif
+      tflite::reference_ops::DepthwiseConv(
+          DepthwiseConvParamsFloat(params, data),
+          tflite::micro::GetTensorShape(input),
+          tflite::micro::GetTensorData<float>(input),
+          tflite::micro::GetTensorShape(filter),
+          tflite::micro::GetTensorData<float>(filter),
+          tflite::micro::GetTensorShape(bias),
+          tflite::micro::GetOptionalTensorData<float>(bias),
+          tflite::micro::GetTensorShape(output),
+          tflite::micro::GetTensorData<float>(output));
+      break;
+    }
+    case kTfLiteInt8: {
+#if EI_TFLITE_DISABLE_DEPTHWISE_CONV_2D_IN_I8
+      MicroPrintf("Type %s (%d) not supported.", TfLiteTypeGetName(input->type),
+                  input->type);
+      return kTfLiteError;
+#endif
+      switch (filter->type) {
+        case kTfLiteInt4: {
+          int8_t* unpacked_filter_data = static_cast<int8_t*>(
+              context->GetScratchBuffer(context, data.filter_buffer_index));
+          tflite::tensor_utils::UnpackDenseInt4IntoInt8(
+              tflite::micro::GetTensorData<int8_t>(filter),
+              tflite::micro::GetTensorShape(filter).FlatSize(),
+              unpacked_filter_data);
+          reference_integer_ops::DepthwiseConvPerChannel(
+              DepthwiseConvParamsQuantized(params, data),
+              data.per_channel_output_multiplier, data.per_channel_output_shift,
+              tflite::micro::GetTensorShape(input),
+              tflite::micro::GetTensorData<int8_t>(input),
+              tflite::micro::GetTensorShape(filter), unpacked_filter_data,
+              tflite::micro::GetTensorShape(bias),
+              tflite::micro::GetOptionalTensorData<int32_t>(bias),
+              tflite::micro::GetTensorShape(output),
+              tflite::micro::GetTensorData<int8_t>(output));
+          break;
+        }
+        case kTfLiteInt8: {
+          if (node_data.has_packed &&
+              x86_int8::DepthwiseConvPerChannel(
+                  DepthwiseConvParamsQuantized(params, data), node_data.packed,
+                  tflite::micro::GetTensorShape(input),
+                  tflite::micro::GetTensorData<int8_t>(input),
+                  tflite::micro::GetTensorShape(filter),
+                  tflite::micro::GetTensorShape(output),
+                  tflite::micro::GetTensorData<int8_t>(output))) {
+            break;
+          }
+          reference_integer_ops::DepthwiseConvPerChannel(
+              DepthwiseConvParamsQuantized(params, data),
+              data.per_channel_output_multiplier, data.per_channel_output_shift,
+              tflite::micro::GetTensorShape(input),
+              tflite::micro::GetTensorData<int8_t>(input),
+              tflite::micro::GetTensorShape(filter),
+              tflite::micro::GetTensorData<int8_t>(filter),
+              tflite::micro::GetTensorShape(bias),
+              tflite::micro::GetOptionalTensorData<int32_t>(bias),
+              tflite::micro::GetTensorShape(output),
+              tflite::micro::GetTensorData<int8_t>(output));
+          break;
+        }
+        default:
+          MicroPrintf("Filter type %s (%d) not supported.",
+                      TfLiteTypeGetName(filter->type), filter->type);
+          return kTfLiteError;
+      }
+      break;
+    }
+    default:
+      MicroPrintf("Input type %s (%d) not supported.",
+                  TfLiteTypeGetName(input->type), input->type);
+      return kTfLiteError;
+  }
+  return kTfLiteOk;
+}
+
+}  // namespace
+
+TfLiteRegistration Register_DEPTHWISE_CONV_2D() {
+  return tflite::micro::RegisterOp(Init, Prepare, Eval);
+}
+
+}  // namespace tflite
+
 #else
 /* Copyright 2017 The TensorFlow Authors. All Rights Reserved.
 
@@ -0,0 +1,296 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// DEPTHWISE_SEPARABLE_CONV_2D: a DEPTHWISE_CONV_2D whose output only feeds a
+// 1x1, stride 1 CONV_2D, fused into one node by the EON compiler
+// (arena_planner --fuse), int8 only.
+//
+// Inputs: input, depthwise filter, depthwise bias, intermediate, 1x1 filter,
+// 1x1 bias; output: the output of the 1x1 convolution. The intermediate
+// tensor keeps the dims and quantization of the depthwise output, but the
+// compiler only gives it arena space for a tile of pixels: the kernel runs the
+// depthwise convolution into it one tile at a time and the 1x1 convolution
+// out of it, so the full intermediate tensor is never in the arena. Run by an
+// interpreter, the tile is the whole tensor.
+//
+// x86 only: the fused kernel is measured faster than the two ops with the x86
+// kernels and otherwise runs the reference loops. With CMSIS-NN it would give
+// up arm_depthwise_conv_wrapper_s8 and arm_convolve_1x1_s8_fast unmeasured, so
+// a fused graph does not build with EI_CLASSIFIER_TFLITE_ENABLE_CMSIS_NN.
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+
+#include "edge-impulse-sdk/tensorflow/lite/c/builtin_op_data.h"
+#include "edge-impulse-sdk/tensorflow/lite/c/common.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/depthwise_separable_conv.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/kernel_util.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/conv.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/depthwise_conv.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/kernel_util.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/micro_log.h"
+#if EI_CLASSIFIER_TFLITE_ENABLE_X86_SIMD == 1
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/x86_int8.h"
+#endif
+
+namespace tflite {
+namespace {
+
+constexpr int kInputTensor = 0;
+constexpr int kDepthwiseWeightsTensor = 1;
+constexpr int kDepthwiseBiasTensor = 2;
+constexpr int kTileTensor = 3;
+constexpr int kPointwiseWeightsTensor = 4;
+constexpr int kPointwiseBiasTensor = 5;
+constexpr int kOutputTensor = 0;
+
+struct OpData {
+  OpDataConv depthwise;
+  OpDataConv pointwise;
+  int tile_pixels;
+#if EI_CLASSIFIER_TFLITE_ENABLE_X86_SIMD == 1
+  x86_int8::PackedFilter depthwise_packed;
+  x86_int8::PackedFilter pointwise_packed;
+  bool has_packed;
+#endif
+};
+
+// TfLiteIntArray of a fixed size, for the nodes of the two ops
+template <int N>
+struct IntArray {
+  int size;
+  int data[N];
+};
+
+void* Init(TfLiteContext* context, const char* buffer, size_t length) {
+  TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+  return context->AllocatePersistentBuffer(context, sizeof(OpData));
+}
+
+TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
+  TFLITE_DCHECK(node->user_data != nullptr);
+  TFLITE_DCHECK(node->builtin_data != nullptr);
+  TF_LITE_ENSURE_EQ(context, NumInputs(node), 6);
+  TF_LITE_ENSURE_EQ(context, NumOutputs(node), 1);
+
+  OpData* data = static_cast<OpData*>(node->user_data);
+  auto* params =
+      static_cast<TfLiteDepthwiseSeparableConvParams*>(node->builtin_data);
+  const TfLiteConvParams& pointwise = params->pointwise;
+  TF_LITE_ENSURE(context, pointwise.stride_width == 1 &&
+                              pointwise.stride_height == 1 &&
+                              pointwise.explicit_padding_top == 0 &&
+                              pointwise.explicit_padding_bottom == 0 &&
+                              pointwise.explicit_padding_left == 0 &&
+                              pointwise.explicit_padding_right == 0);
+
+  // The two ops prepare as they would unfused, each on a node of its own
+  const int* tensors = node->inputs->data;
+  IntArray<3> depthwise_inputs = {
+      3, {tensors[kInputTensor], tensors[kDepthwiseWeightsTensor],
+          tensors[kDepthwiseBiasTensor]}};
+  IntArray<1> depthwise_outputs = {1, {tensors[kTileTensor]}};
+  IntArray<3> pointwise_inputs = {
+      3, {tensors[kTileTensor], tensors[kPointwiseWeightsTensor],
+          tensors[kPointwiseBiasTensor]}};
+  IntArray<1> pointwise_outputs = {1, {node->outputs->data[kOutputTensor]}};
+
+  TfLiteNode depthwise_node = {};
+  depthwise_node.inputs = reinterpret_cast<TfLiteIntArray*>(&depthwise_inputs);
+  depthwise_node.outputs = reinterpret_cast<TfLiteIntArray*>(&depthwise_outputs);
+  depthwise_node.user_data = &data->depthwise;
+  depthwise_node.builtin_data = &params->depthwise;
+  TF_LITE_ENSURE_STATUS(DepthwiseConvPrepare(context, &depthwise_node));
+
+  TfLiteNode pointwise_node = {};
+  pointwise_node.inputs = reinterpret_cast<TfLiteIntArray*>(&pointwise_inputs);
+  pointwise_node.outputs = reinterpret_cast<TfLiteIntArray*>(&pointwise_outputs);
+  pointwise_node.user_data = &data->pointwise;
+  pointwise_node.builtin_data = &params->pointwise;
+  TF_LITE_ENSURE_STATUS(ConvPrepare(context, &pointwise_node));
+
+  MicroContext* micro_context = GetMicroContext(context);
+  TfLiteTensor* input =
+      micro_context->AllocateTempInputTensor(node, kInputTensor);
+  TF_LITE_ENSURE(context, input != nullptr);
+  TfLiteTensor* depthwise_filter =
+      micro_context->AllocateTempInputTensor(node, kDepthwiseWeightsTensor);
+  TF_LITE_ENSURE(context, depthwise_filter != nullptr);
+  TfLiteTensor* depthwise_bias =
+      micro_context->AllocateTempInputTensor(node, kDepthwiseBiasTensor);
+  TF_LITE_ENSURE(context, depthwise_bias != nullptr);
+  TfLiteTensor* tile = micro_context->AllocateTempInputTensor(node, kTileTensor);
+  TF_LITE_ENSURE(context, tile != nullptr);
+  TfLiteTensor* pointwise_filter =
+      micro_context->AllocateTempInputTensor(node, kPointwiseWeightsTensor);
+  TF_LITE_ENSURE(context, pointwise_filter != nullptr);
+  TfLiteTensor* pointwise_bias =
+      micro_context->AllocateTempInputTensor(node, kPointwiseBiasTensor);
+  TF_LITE_ENSURE(context, pointwise_bias != nullptr);
+  TfLiteTensor* output =
+      micro_context->AllocateTempOutputTensor(node, kOutputTensor);
+  TF_LITE_ENSURE(context, output != nullptr);
+
+  if (input->type != kTfLiteInt8 || depthwise_filter->type != kTfLiteInt8 ||
+      tile->type != kTfLiteInt8 || pointwise_filter->type != kTfLiteInt8 ||
+      output->type != kTfLiteInt8) {
+    MicroPrintf("Type %s (%d) not supported.", TfLiteTypeGetName(input->type),
+                input->type);
+    return kTfLiteError;
+  }
+  TF_LITE_ENSURE_TYPES_EQ(context, depthwise_bias->type, kTfLiteInt32);
+  TF_LITE_ENSURE_TYPES_EQ(context, pointwise_bias->type, kTfLiteInt32);
+
+  // depth_multiplier 1, and a 1x1 convolution over the depthwise pixels
+  const int depth = input->dims->data[3];
+  TF_LITE_ENSURE_EQ(context, tile->dims->data[3], depth);
+  TF_LITE_ENSURE_EQ(context, pointwise_filter->dims->data[1], 1);
+  TF_LITE_ENSURE_EQ(context, pointwise_filter->dims->data[2], 1);
+  TF_LITE_ENSURE_EQ(context, tile->dims->data[1], output->dims->data[1]);
+  TF_LITE_ENSURE_EQ(context, tile->dims->data[2], output->dims->data[2]);
+
+  const int pixels = output->dims->data[1] * output->dims->data[2];
+  data->tile_pixels = static_cast<int>(tile->bytes) / depth;
+  if (data->tile_pixels > pixels) {
+    data->tile_pixels = pixels;
+  }
+  TF_LITE_ENSURE(context, data->tile_pixels >= 1);
+
+#if EI_CLASSIFIER_TFLITE_ENABLE_X86_SIMD == 1
+  // constant weights: repack both filters for the x86 kernel
+  data->has_packed = false;
+  const RuntimeShape depthwise_filter_shape = GetTensorShape(depthwise_filter);
+  const RuntimeShape pointwise_filter_shape = GetTensorShape(pointwise_filter);
+  if (depthwise_filter->data.int8 != nullptr &&
+      pointwise_filter->data.int8 != nullptr &&
+      depthwise_filter_shape.Dims(1) * depthwise_filter_shape.Dims(2) <=
+          x86_int8::kMaxDepthwiseTaps &&
+      x86_int8::DetectedIsa() != x86_int8::Isa::kNone) {
+    void* depthwise_buffer = context->AllocatePersistentBuffer(
+        context, x86_int8::DepthwiseConvPackedBytes(depthwise_filter_shape));
+    void* pointwise_buffer = context->AllocatePersistentBuffer(
+        context, x86_int8::ConvPackedBytes(pointwise_filter_shape));
+    if (depthwise_buffer != nullptr && pointwise_buffer != nullptr) {
+      x86_int8::PackDepthwiseConvPerChannel(
+          depthwise_filter_shape, depthwise_filter->data.int8,
+          depthwise_bias->data.i32,
+          data->depthwise.per_channel_output_multiplier,
+          data->depthwise.per_channel_output_shift, depthwise_buffer,
+          &data->depthwise_packed);
+      x86_int8::PackConvPerChannel(
+          pointwise_filter_shape, pointwise_filter->data.int8,
+          pointwise_bias->data.i32,
+          data->pointwise.per_channel_output_multiplier,
+          data->pointwise.per_channel_output_shift, pointwise_buffer,
+          &data->pointwise_packed);
+      data->has_packed = true;
+    }
+  }
+#endif
+
+  micro_context->DeallocateTempTfLiteTensor(input);
+  micro_context->DeallocateTempTfLiteTensor(depthwise_filter);
+  micro_context->DeallocateTempTfLiteTensor(depthwise_bias);
+  micro_context->DeallocateTempTfLiteTensor(tile);
+  micro_context->DeallocateTempTfLiteTensor(pointwise_filter);
+  micro_context->DeallocateTempTfLiteTensor(pointwise_bias);
+  micro_context->DeallocateTempTfLiteTensor(output);
+  return kTfLiteOk;
+}
+
+TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
+  TFLITE_DCHECK(node->user_data != nullptr);
+  TFLITE_DCHECK(node->builtin_data != nullptr);
+
+  const auto& params = *(
+      static_cast<const TfLiteDepthwiseSeparableConvParams*>(node->builtin_data));
+  const OpData& data = *(static_cast<const OpData*>(node->user_data));
+
+  const TfLiteEvalTensor* input =
+      tflite::micro::GetEvalInput(context, node, kInputTensor);
+  const TfLiteEvalTensor* depthwise_filter =
+      tflite::micro::GetEvalInput(context, node, kDepthwiseWeightsTensor);
+  const TfLiteEvalTensor* depthwise_bias =
+      tflite::micro::GetEvalInput(context, node, kDepthwiseBiasTensor);
+  TfLiteEvalTensor* tile =
+      tflite::micro::GetMutableEvalInput(context, node, kTileTensor);
+  const TfLiteEvalTensor* pointwise_filter =
+      tflite::micro::GetEvalInput(context, node, kPointwiseWeightsTensor);
+  const TfLiteEvalTensor* pointwise_bias =
+      tflite::micro::GetEvalInput(context, node, kPointwiseBiasTensor);
+  TfLiteEvalTensor* output =
+      tflite::micro::GetEvalOutput(context, node, kOutputTensor);
+
+  const DepthwiseParams depthwise_params =
+      DepthwiseConvParamsQuantized(params.depthwise, data.depthwise);
+  const ConvParams pointwise_params =
+      ConvParamsQuantized(params.pointwise, data.pointwise);
+
+#if EI_CLASSIFIER_TFLITE_ENABLE_X86_SIMD == 1
+  if (data.has_packed &&
+      x86_int8::DepthwiseSeparableConvPerChannel(
+          depthwise_params, data.depthwise_packed, pointwise_params,
+          data.pointwise_packed, tflite::micro::GetTensorShape(input),
+          tflite::micro::GetTensorData<int8_t>(input),
+          tflite::micro::GetTensorShape(depthwise_filter),
+          tflite::micro::GetTensorShape(output),
+          tflite::micro::GetTensorData<int8_t>(output),
+          tflite::micro::GetTensorData<int8_t>(tile), data.tile_pixels)) {
+    return kTfLiteOk;
+  }
+#endif
+  reference_integer_ops::DepthwiseSeparableConvPerChannel(
+      depthwise_params, data.depthwise.per_channel_output_multiplier,
+      data.depthwise.per_channel_output_shift,
+      tflite::micro::GetTensorShape(input),
+      tflite::micro::GetTensorData<int8_t>(input),
+      tflite::micro::GetTensorShape(depthwise_filter),
+      tflite::micro::GetTensorData<int8_t>(depthwise_filter),
+      tflite::micro::GetTensorData<int32_t>(depthwise_bias), pointwise_params,
+      data.pointwise.per_channel_output_multiplier,
+      data.pointwise.per_channel_output_shift,
+      tflite::micro::GetTensorShape(pointwise_filter),
+      tflite::micro::GetTensorData<int8_t>(pointwise_filter),
+      tflite::micro::GetTensorData<int32_t>(pointwise_bias),
+      tflite::micro::GetTensorShape(output),
+      tflite::micro::GetTensorData<int8_t>(output),
+      tflite::micro::GetTensorData<int8_t>(tile), data.tile_pixels);
+  return kTfLiteOk;
+}
+
+}  // namespace
+
+TfLiteRegistration Register_DEPTHWISE_SEPARABLE_CONV_2D() {
+  return tflite::micro::RegisterOp(Init, Prepare, Eval);
+}
+
+}  // namespace tflite
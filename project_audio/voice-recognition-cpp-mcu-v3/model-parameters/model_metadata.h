@@ -250,6 +250,7 @@ typedef struct {
     int high_frequency;
     int win_size;
     int noise_floor_db;
+    int fixed_point;
 } ei_dsp_config_mfe_t;
 
 typedef struct {
@@ -67,7 +67,8 @@ ei_dsp_config_mfe_t ei_dsp_config_820755_5 = {
     0, // int low_frequency
     0, // int high_frequency
     101, // int win_size
-    -52 // int noise_floor_db
+    -52, // int noise_floor_db
+    0 // int fixed_point
 };
 
 const uint8_t ei_dsp_blocks_820755_1_size = 1;
@@ -91,6 +92,15 @@ const ei_config_tflite_eon_graph_t ei_config_graph_820755_3 = {
     .model_reset = &tflite_learn_820755_3_reset,
     .model_input = &tflite_learn_820755_3_input,
     .model_output = &tflite_learn_820755_3_output,
+    .model_context_size = &tflite_learn_820755_3_context_size,
+    .model_init_ctx = &tflite_learn_820755_3_init_ctx,
+    .model_invoke_ctx = &tflite_learn_820755_3_invoke_ctx,
+    .model_reset_ctx = &tflite_learn_820755_3_reset_ctx,
+    .model_input_ctx = &tflite_learn_820755_3_input_ctx,
+    .model_output_ctx = &tflite_learn_820755_3_output_ctx,
+    .model_invoke_batch_ctx = &tflite_learn_820755_3_invoke_batch_ctx,
+    .model_idle_arena = &tflite_learn_820755_3_idle_arena,
+    .model_idle_arena_ctx = &tflite_learn_820755_3_idle_arena_ctx,
 };
 
 const uint8_t ei_output_tensors_indices_820755_3[1] = { 0 };
@@ -32,10 +32,15 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <new>
 #include "edge-impulse-sdk/tensorflow/lite/c/builtin_op_data.h"
 #include "edge-impulse-sdk/tensorflow/lite/c/common.h"
 #include "edge-impulse-sdk/tensorflow/lite/micro/micro_mutable_op_resolver.h"
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/classifier/ei_node_profiler.h"
+#if EI_CLASSIFIER_PROFILE_NODES
+#include "edge-impulse-sdk/tensorflow/lite/builtin_ops.h"
+#endif
 
 #if EI_CLASSIFIER_PRINT_STATE
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
@@ -94,9 +99,9 @@ using namespace tflite::ops::micro;
 namespace {
 
 #if defined(EI_CLASSIFIER_ALLOCATION_STATIC_HIMAX) || defined(EI_CLASSIFIER_ALLOCATION_STATIC_HIMAX_GNU)
-constexpr int kTensorArenaSize = 34224;
+constexpr int kTensorArenaSize = 30800;
 #else
-constexpr int kTensorArenaSize = 33200;
+constexpr int kTensorArenaSize = 29776;
 #endif
 
 #if defined(EI_CLASSIFIER_ALLOCATION_STATIC)
@@ -116,9 +121,6 @@ uint8_t tensor_arena[kTensorArenaSize] ALIGN(16) __attribute__((section(".tensor
 uint8_t* tensor_arena = NULL;
 #endif
 
-static uint8_t* tensor_boundary;
-static uint8_t* current_location;
-
 template <int SZ, class T> struct TfArray {
   int sz; T elem[SZ];
 };
@@ -146,12 +148,60 @@ typedef struct {
   int16_t index;
 } TfLiteEvalTensorWithIndex;
 
-TfLiteContext ctx{};
 static const int MAX_TFL_TENSOR_COUNT = 4;
-static TfLiteTensorWithIndex tflTensors[MAX_TFL_TENSOR_COUNT];
 static const int MAX_TFL_EVAL_COUNT = 4;
-static TfLiteEvalTensorWithIndex tflEvalTensors[MAX_TFL_EVAL_COUNT];
-TfLiteRegistration registrations[OP_LAST];
+
+typedef struct {
+  size_t bytes;
+  void *ptr;
+} scratch_buffer_t;
+
+struct GraphContext;
+
+class EonMicroContext : public MicroContext {
+ public:
+
+  EonMicroContext(GraphContext *graph): MicroContext(nullptr, nullptr, nullptr), graph_(graph) { }
+
+  void* AllocatePersistentBuffer(size_t bytes);
+  TfLiteStatus RequestScratchBufferInArena(size_t bytes, int* buffer_index);
+  void* GetScratchBuffer(int buffer_index);
+  TfLiteTensor* AllocateTempTfLiteTensor(int tensor_index);
+  void DeallocateTempTfLiteTensor(TfLiteTensor* tensor) { }
+  bool IsAllTempTfLiteTensorDeallocated() { return true; }
+  TfLiteEvalTensor* GetEvalTensor(int tensor_index);
+
+  GraphContext *graph_;
+};
+
+// Mutable state of one instance of the graph: arena, tensors handed to the
+// kernels, kernel user data (in nodes) and scratch buffers. The plain API runs
+// default_graph; the _ctx API runs a GraphContext in caller memory, followed by
+// its copy of the nodes and its arena, so several instances can run at once.
+struct GraphContext {
+  GraphContext(): micro_context(this) { }
+
+  uint8_t* arena;
+  uint8_t* tensor_boundary;
+  uint8_t* current_location;
+  TfLiteContext ctx{};
+  EonMicroContext micro_context;
+  TfLiteTensorWithIndex tflTensors[MAX_TFL_TENSOR_COUNT];
+  TfLiteEvalTensorWithIndex tflEvalTensors[MAX_TFL_EVAL_COUNT];
+  TfLiteRegistration registrations[OP_LAST];
+  TfLiteNode* nodes;
+  void* overflow_buffers[EI_MAX_OVERFLOW_BUFFER_COUNT];
+  size_t overflow_buffers_ix = 0;
+  scratch_buffer_t scratch_buffers[EI_MAX_SCRATCH_BUFFER_COUNT];
+  size_t scratch_buffers_ix = 0;
+  size_t current_subgraph_index = 0;
+};
+
+static GraphContext default_graph;
+
+static GraphContext* graph_of(const struct TfLiteContext* ctx) {
+  return static_cast<EonMicroContext*>(ctx->impl_)->graph_;
+}
 
 namespace g0 {
 const TfArray<2, int> tensor_dimension0 = { 2, { 1,3960 } };
@@ -1222,96 +1272,85 @@ const TfArray<1, int> quant96_zero = { 1, { 56 } };
 const TfLiteAffineQuantization quant96 = { (TfLiteFloatArray*)&quant96_scale, (TfLiteIntArray*)&quant96_zero, 0 };
 const TfArray<1, float> quant97_scale = { 1, { 0.00390625, } };
 const TfLiteAffineQuantization quant97 = { (TfLiteFloatArray*)&quant97_scale, (TfLiteIntArray*)&g0::quant0_zero, 0 };
-const TfLiteReshapeParams opdata0 = { { 0, 0, 0, 0, 0, 0, 0, 0, }, 0 };
-const TfArray<2, int> inputs0 = { 2, { 0,1 } };
-const TfArray<1, int> outputs0 = { 1, { 62 } };
-const TfLiteConvParams opdata1 = { kTfLitePaddingSame, 2,2, kTfLiteActRelu6, 1,1 };
+const TfLiteConvParams opdata1 = { kTfLitePaddingSame, 2,2, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs1 = { 3, { 62,61,60 } };
 const TfArray<1, int> outputs1 = { 1, { 63 } };
-const TfLiteDepthwiseConvParams opdata2 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1 };
+const TfLiteDepthwiseConvParams opdata2 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs2 = { 3, { 63,59,58 } };
 const TfArray<1, int> outputs2 = { 1, { 64 } };
-const TfLiteConvParams opdata3 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1 };
+const TfLiteConvParams opdata3 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs3 = { 3, { 64,57,56 } };
 const TfArray<1, int> outputs3 = { 1, { 65 } };
-const TfArray<2, int> inputs4 = { 2, { 65,2 } };
-const TfArray<1, int> outputs4 = { 1, { 66 } };
-const TfLiteDepthwiseConvParams opdata5 = { kTfLitePaddingValid, 2,2, 1, kTfLiteActRelu6, 1,1 };
-const TfArray<3, int> inputs5 = { 3, { 66,55,54 } };
+const TfLiteDepthwiseConvParams opdata5 = { kTfLitePaddingValid, 2,2, 1, kTfLiteActRelu6, 1,1, 0,1, 0,1 };
+const TfArray<3, int> inputs5 = { 3, { 65,55,54 } };
 const TfArray<1, int> outputs5 = { 1, { 67 } };
-const TfLiteConvParams opdata6 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1 };
+const TfLiteConvParams opdata6 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs6 = { 3, { 67,53,52 } };
 const TfArray<1, int> outputs6 = { 1, { 68 } };
-const TfLiteDepthwiseConvParams opdata7 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1 };
+const TfLiteDepthwiseConvParams opdata7 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs7 = { 3, { 68,51,50 } };
 const TfArray<1, int> outputs7 = { 1, { 69 } };
-const TfLiteConvParams opdata8 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1 };
+const TfLiteConvParams opdata8 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs8 = { 3, { 69,49,48 } };
 const TfArray<1, int> outputs8 = { 1, { 70 } };
-const TfArray<2, int> inputs9 = { 2, { 70,2 } };
-const TfArray<1, int> outputs9 = { 1, { 71 } };
-const TfLiteDepthwiseConvParams opdata10 = { kTfLitePaddingValid, 2,2, 1, kTfLiteActRelu6, 1,1 };
-const TfArray<3, int> inputs10 = { 3, { 71,47,46 } };
+const TfLiteDepthwiseConvParams opdata10 = { kTfLitePaddingValid, 2,2, 1, kTfLiteActRelu6, 1,1, 0,1, 0,1 };
+const TfArray<3, int> inputs10 = { 3, { 70,47,46 } };
 const TfArray<1, int> outputs10 = { 1, { 72 } };
-const TfLiteConvParams opdata11 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1 };
+const TfLiteConvParams opdata11 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs11 = { 3, { 72,45,44 } };
 const TfArray<1, int> outputs11 = { 1, { 73 } };
-const TfLiteDepthwiseConvParams opdata12 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1 };
+const TfLiteDepthwiseConvParams opdata12 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs12 = { 3, { 73,43,42 } };
 const TfArray<1, int> outputs12 = { 1, { 74 } };
-const TfLiteConvParams opdata13 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1 };
+const TfLiteConvParams opdata13 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs13 = { 3, { 74,41,40 } };
 const TfArray<1, int> outputs13 = { 1, { 75 } };
-const TfArray<2, int> inputs14 = { 2, { 75,2 } };
-const TfArray<1, int> outputs14 = { 1, { 76 } };
-const TfLiteDepthwiseConvParams opdata15 = { kTfLitePaddingValid, 2,2, 1, kTfLiteActRelu6, 1,1 };
-const TfArray<3, int> inputs15 = { 3, { 76,39,38 } };
+const TfLiteDepthwiseConvParams opdata15 = { kTfLitePaddingValid, 2,2, 1, kTfLiteActRelu6, 1,1, 0,1, 0,1 };
+const TfArray<3, int> inputs15 = { 3, { 75,39,38 } };
 const TfArray<1, int> outputs15 = { 1, { 77 } };
-const TfLiteConvParams opdata16 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1 };
+const TfLiteConvParams opdata16 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs16 = { 3, { 77,37,36 } };
 const TfArray<1, int> outputs16 = { 1, { 78 } };
-const TfLiteDepthwiseConvParams opdata17 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1 };
+const TfLiteDepthwiseConvParams opdata17 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs17 = { 3, { 78,35,34 } };
 const TfArray<1, int> outputs17 = { 1, { 79 } };
-const TfLiteConvParams opdata18 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1 };
+const TfLiteConvParams opdata18 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs18 = { 3, { 79,33,32 } };
 const TfArray<1, int> outputs18 = { 1, { 80 } };
-const TfLiteDepthwiseConvParams opdata19 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1 };
+const TfLiteDepthwiseConvParams opdata19 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs19 = { 3, { 80,31,30 } };
 const TfArray<1, int> outputs19 = { 1, { 81 } };
-const TfLiteConvParams opdata20 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1 };
+const TfLiteConvParams opdata20 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs20 = { 3, { 81,29,28 } };
 const TfArray<1, int> outputs20 = { 1, { 82 } };
-const TfLiteDepthwiseConvParams opdata21 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1 };
+const TfLiteDepthwiseConvParams opdata21 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs21 = { 3, { 82,27,26 } };
 const TfArray<1, int> outputs21 = { 1, { 83 } };
-const TfLiteConvParams opdata22 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1 };
+const TfLiteConvParams opdata22 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs22 = { 3, { 83,25,24 } };
 const TfArray<1, int> outputs22 = { 1, { 84 } };
-const TfLiteDepthwiseConvParams opdata23 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1 };
+const TfLiteDepthwiseConvParams opdata23 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs23 = { 3, { 84,23,22 } };
 const TfArray<1, int> outputs23 = { 1, { 85 } };
-const TfLiteConvParams opdata24 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1 };
+const TfLiteConvParams opdata24 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs24 = { 3, { 85,21,20 } };
 const TfArray<1, int> outputs24 = { 1, { 86 } };
-const TfLiteDepthwiseConvParams opdata25 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1 };
+const TfLiteDepthwiseConvParams opdata25 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs25 = { 3, { 86,19,18 } };
 const TfArray<1, int> outputs25 = { 1, { 87 } };
-const TfLiteConvParams opdata26 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1 };
+const TfLiteConvParams opdata26 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs26 = { 3, { 87,17,16 } };
 const TfArray<1, int> outputs26 = { 1, { 88 } };
-const TfArray<2, int> inputs27 = { 2, { 88,2 } };
-const TfArray<1, int> outputs27 = { 1, { 89 } };
-const TfLiteDepthwiseConvParams opdata28 = { kTfLitePaddingValid, 2,2, 1, kTfLiteActRelu6, 1,1 };
-const TfArray<3, int> inputs28 = { 3, { 89,15,14 } };
+const TfLiteDepthwiseConvParams opdata28 = { kTfLitePaddingValid, 2,2, 1, kTfLiteActRelu6, 1,1, 0,1, 0,1 };
+const TfArray<3, int> inputs28 = { 3, { 88,15,14 } };
 const TfArray<1, int> outputs28 = { 1, { 90 } };
-const TfLiteConvParams opdata29 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1 };
+const TfLiteConvParams opdata29 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs29 = { 3, { 90,13,12 } };
 const TfArray<1, int> outputs29 = { 1, { 91 } };
-const TfLiteDepthwiseConvParams opdata30 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1 };
+const TfLiteDepthwiseConvParams opdata30 = { kTfLitePaddingSame, 1,1, 1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs30 = { 3, { 91,11,10 } };
 const TfArray<1, int> outputs30 = { 1, { 92 } };
-const TfLiteConvParams opdata31 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1 };
+const TfLiteConvParams opdata31 = { kTfLitePaddingSame, 1,1, kTfLiteActRelu6, 1,1, 0,0, 0,0 };
 const TfArray<3, int> inputs31 = { 3, { 92,9,8 } };
 const TfArray<1, int> outputs31 = { 1, { 93 } };
 const ALIGN(1) uint8_t opdata32[1] = { 0,  }; /* op type 40=MEAN */
@@ -1329,7 +1368,7 @@ const TfArray<1, int> outputs35 = { 1, { 97 } };
 };
 
 TensorInfo_t tensorData[] = {
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 3968), (TfLiteIntArray*)&g0::tensor_dimension0, 3960, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant0))}, },
+{ kTfLiteMmapRo, kTfLiteInt8, nullptr, (TfLiteIntArray*)&g0::tensor_dimension0, 3960, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant0))}, },
 { kTfLiteMmapRo, kTfLiteInt32, (int32_t*)g0::tensor_data1, (TfLiteIntArray*)&g0::tensor_dimension1, 16, {kTfLiteNoQuantization, nullptr}, },
 { kTfLiteMmapRo, kTfLiteInt32, (int32_t*)g0::tensor_data2, (TfLiteIntArray*)&g0::tensor_dimension2, 32, {kTfLiteNoQuantization, nullptr}, },
 { kTfLiteMmapRo, kTfLiteInt32, (int32_t*)g0::tensor_data3, (TfLiteIntArray*)&g0::tensor_dimension3, 8, {kTfLiteNoQuantization, nullptr}, },
@@ -1394,58 +1433,54 @@ TensorInfo_t tensorData[] = {
 { kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension62, 3960, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant0))}, },
 { kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 3968), (TfLiteIntArray*)&g0::tensor_dimension63, 3000, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant63))}, },
 { kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension63, 3000, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant64))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 6432), (TfLiteIntArray*)&g0::tensor_dimension65, 6000, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension66, 6426, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 6432), (TfLiteIntArray*)&g0::tensor_dimension67, 1500, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 3008), (TfLiteIntArray*)&g0::tensor_dimension68, 3000, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension68, 3000, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant69))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 3440), (TfLiteIntArray*)&g0::tensor_dimension68, 3000, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension71, 3432, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 3440), (TfLiteIntArray*)&g0::tensor_dimension72, 720, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant72))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 3008), (TfLiteIntArray*)&g0::tensor_dimension65, 6000, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteMmapRo, kTfLiteInt8, nullptr, (TfLiteIntArray*)&g0::tensor_dimension66, 6426, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension67, 1500, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 1504), (TfLiteIntArray*)&g0::tensor_dimension68, 3000, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 4512), (TfLiteIntArray*)&g0::tensor_dimension68, 3000, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant69))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension68, 3000, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteMmapRo, kTfLiteInt8, nullptr, (TfLiteIntArray*)&g0::tensor_dimension71, 3432, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 3008), (TfLiteIntArray*)&g0::tensor_dimension72, 720, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant72))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension73, 1500, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
 { kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 1504), (TfLiteIntArray*)&g0::tensor_dimension73, 1500, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
 { kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension73, 1500, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 1952), (TfLiteIntArray*)&g0::tensor_dimension73, 1500, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension76, 1950, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 2416), (TfLiteIntArray*)&g0::tensor_dimension77, 300, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 928), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 1552), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 928), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 1552), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 928), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 1552), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 928), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 1552), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 928), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 1696), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant87))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 1072), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension89, 1071, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 2000), (TfLiteIntArray*)&g0::tensor_dimension90, 153, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant90))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 2160), (TfLiteIntArray*)&g0::tensor_dimension91, 306, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 1840), (TfLiteIntArray*)&g0::tensor_dimension91, 306, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 416), (TfLiteIntArray*)&g0::tensor_dimension91, 306, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant93))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 736), (TfLiteIntArray*)&g0::tensor_dimension94, 102, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant94))}, },
+{ kTfLiteMmapRo, kTfLiteInt8, nullptr, (TfLiteIntArray*)&g0::tensor_dimension76, 1950, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 1504), (TfLiteIntArray*)&g0::tensor_dimension77, 300, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 624), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 624), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 624), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 624), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 624), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant87))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension78, 612, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteMmapRo, kTfLiteInt8, nullptr, (TfLiteIntArray*)&g0::tensor_dimension89, 1071, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 624), (TfLiteIntArray*)&g0::tensor_dimension90, 153, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant90))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension91, 306, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 320), (TfLiteIntArray*)&g0::tensor_dimension91, 306, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant65))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension91, 306, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant93))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 320), (TfLiteIntArray*)&g0::tensor_dimension94, 102, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant94))}, },
 { kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension95, 128, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant95))}, },
 { kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 128), (TfLiteIntArray*)&g0::tensor_dimension96, 8, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant96))}, },
 { kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension96, 8, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant97))}, },
 };
 
 #ifndef TF_LITE_STATIC_MEMORY
-TfLiteNode tflNodes[36] = {
-{ (TfLiteIntArray*)&g0::inputs0, (TfLiteIntArray*)&g0::outputs0, (TfLiteIntArray*)&g0::inputs0, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata0)), nullptr, 0, },
+TfLiteNode tflNodes[31] = {
 { (TfLiteIntArray*)&g0::inputs1, (TfLiteIntArray*)&g0::outputs1, (TfLiteIntArray*)&g0::inputs1, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata1)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs2, (TfLiteIntArray*)&g0::outputs2, (TfLiteIntArray*)&g0::inputs2, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata2)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs3, (TfLiteIntArray*)&g0::outputs3, (TfLiteIntArray*)&g0::inputs3, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata3)), nullptr, 0, },
-{ (TfLiteIntArray*)&g0::inputs4, (TfLiteIntArray*)&g0::outputs4, (TfLiteIntArray*)&g0::inputs4, nullptr, nullptr, nullptr, nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs5, (TfLiteIntArray*)&g0::outputs5, (TfLiteIntArray*)&g0::inputs5, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata5)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs6, (TfLiteIntArray*)&g0::outputs6, (TfLiteIntArray*)&g0::inputs6, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata6)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs7, (TfLiteIntArray*)&g0::outputs7, (TfLiteIntArray*)&g0::inputs7, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata7)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs8, (TfLiteIntArray*)&g0::outputs8, (TfLiteIntArray*)&g0::inputs8, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata8)), nullptr, 0, },
-{ (TfLiteIntArray*)&g0::inputs9, (TfLiteIntArray*)&g0::outputs9, (TfLiteIntArray*)&g0::inputs9, nullptr, nullptr, nullptr, nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs10, (TfLiteIntArray*)&g0::outputs10, (TfLiteIntArray*)&g0::inputs10, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata10)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs11, (TfLiteIntArray*)&g0::outputs11, (TfLiteIntArray*)&g0::inputs11, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata11)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs12, (TfLiteIntArray*)&g0::outputs12, (TfLiteIntArray*)&g0::inputs12, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata12)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs13, (TfLiteIntArray*)&g0::outputs13, (TfLiteIntArray*)&g0::inputs13, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata13)), nullptr, 0, },
-{ (TfLiteIntArray*)&g0::inputs14, (TfLiteIntArray*)&g0::outputs14, (TfLiteIntArray*)&g0::inputs14, nullptr, nullptr, nullptr, nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs15, (TfLiteIntArray*)&g0::outputs15, (TfLiteIntArray*)&g0::inputs15, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata15)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs16, (TfLiteIntArray*)&g0::outputs16, (TfLiteIntArray*)&g0::inputs16, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata16)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs17, (TfLiteIntArray*)&g0::outputs17, (TfLiteIntArray*)&g0::inputs17, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata17)), nullptr, 0, },
@@ -1458,7 +1493,6 @@ TfLiteNode tflNodes[36] = {
 { (TfLiteIntArray*)&g0::inputs24, (TfLiteIntArray*)&g0::outputs24, (TfLiteIntArray*)&g0::inputs24, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata24)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs25, (TfLiteIntArray*)&g0::outputs25, (TfLiteIntArray*)&g0::inputs25, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata25)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs26, (TfLiteIntArray*)&g0::outputs26, (TfLiteIntArray*)&g0::inputs26, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata26)), nullptr, 0, },
-{ (TfLiteIntArray*)&g0::inputs27, (TfLiteIntArray*)&g0::outputs27, (TfLiteIntArray*)&g0::inputs27, nullptr, nullptr, nullptr, nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs28, (TfLiteIntArray*)&g0::outputs28, (TfLiteIntArray*)&g0::inputs28, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata28)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs29, (TfLiteIntArray*)&g0::outputs29, (TfLiteIntArray*)&g0::inputs29, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata29)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs30, (TfLiteIntArray*)&g0::outputs30, (TfLiteIntArray*)&g0::inputs30, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata30)), nullptr, 0, },
@@ -1469,22 +1503,18 @@ TfLiteNode tflNodes[36] = {
 { (TfLiteIntArray*)&g0::inputs35, (TfLiteIntArray*)&g0::outputs35, (TfLiteIntArray*)&g0::inputs35, nullptr, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata35)), nullptr, 0, },
 };
 #else
-TfLiteNode tflNodes[36] = {
-{ (TfLiteIntArray*)&g0::inputs0, (TfLiteIntArray*)&g0::outputs0, (TfLiteIntArray*)&g0::inputs0, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata0)), nullptr, 0, },
+TfLiteNode tflNodes[31] = {
 { (TfLiteIntArray*)&g0::inputs1, (TfLiteIntArray*)&g0::outputs1, (TfLiteIntArray*)&g0::inputs1, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata1)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs2, (TfLiteIntArray*)&g0::outputs2, (TfLiteIntArray*)&g0::inputs2, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata2)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs3, (TfLiteIntArray*)&g0::outputs3, (TfLiteIntArray*)&g0::inputs3, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata3)), nullptr, 0, },
-{ (TfLiteIntArray*)&g0::inputs4, (TfLiteIntArray*)&g0::outputs4, (TfLiteIntArray*)&g0::inputs4, nullptr, nullptr, nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs5, (TfLiteIntArray*)&g0::outputs5, (TfLiteIntArray*)&g0::inputs5, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata5)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs6, (TfLiteIntArray*)&g0::outputs6, (TfLiteIntArray*)&g0::inputs6, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata6)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs7, (TfLiteIntArray*)&g0::outputs7, (TfLiteIntArray*)&g0::inputs7, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata7)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs8, (TfLiteIntArray*)&g0::outputs8, (TfLiteIntArray*)&g0::inputs8, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata8)), nullptr, 0, },
-{ (TfLiteIntArray*)&g0::inputs9, (TfLiteIntArray*)&g0::outputs9, (TfLiteIntArray*)&g0::inputs9, nullptr, nullptr, nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs10, (TfLiteIntArray*)&g0::outputs10, (TfLiteIntArray*)&g0::inputs10, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata10)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs11, (TfLiteIntArray*)&g0::outputs11, (TfLiteIntArray*)&g0::inputs11, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata11)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs12, (TfLiteIntArray*)&g0::outputs12, (TfLiteIntArray*)&g0::inputs12, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata12)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs13, (TfLiteIntArray*)&g0::outputs13, (TfLiteIntArray*)&g0::inputs13, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata13)), nullptr, 0, },
-{ (TfLiteIntArray*)&g0::inputs14, (TfLiteIntArray*)&g0::outputs14, (TfLiteIntArray*)&g0::inputs14, nullptr, nullptr, nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs15, (TfLiteIntArray*)&g0::outputs15, (TfLiteIntArray*)&g0::inputs15, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata15)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs16, (TfLiteIntArray*)&g0::outputs16, (TfLiteIntArray*)&g0::inputs16, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata16)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs17, (TfLiteIntArray*)&g0::outputs17, (TfLiteIntArray*)&g0::inputs17, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata17)), nullptr, 0, },
@@ -1497,7 +1527,6 @@ TfLiteNode tflNodes[36] = {
 { (TfLiteIntArray*)&g0::inputs24, (TfLiteIntArray*)&g0::outputs24, (TfLiteIntArray*)&g0::inputs24, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata24)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs25, (TfLiteIntArray*)&g0::outputs25, (TfLiteIntArray*)&g0::inputs25, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata25)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs26, (TfLiteIntArray*)&g0::outputs26, (TfLiteIntArray*)&g0::inputs26, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata26)), nullptr, 0, },
-{ (TfLiteIntArray*)&g0::inputs27, (TfLiteIntArray*)&g0::outputs27, (TfLiteIntArray*)&g0::inputs27, nullptr, nullptr, nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs28, (TfLiteIntArray*)&g0::outputs28, (TfLiteIntArray*)&g0::inputs28, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata28)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs29, (TfLiteIntArray*)&g0::outputs29, (TfLiteIntArray*)&g0::inputs29, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata29)), nullptr, 0, },
 { (TfLiteIntArray*)&g0::inputs30, (TfLiteIntArray*)&g0::outputs30, (TfLiteIntArray*)&g0::inputs30, nullptr, const_cast<void*>(static_cast<const void*>(&g0::opdata30)), nullptr, 0, },
@@ -1510,49 +1539,51 @@ TfLiteNode tflNodes[36] = {
 #endif
 
 used_operators_e used_ops[] =
-{OP_RESHAPE, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_PAD, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_PAD, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_PAD, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_PAD, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_MEAN, OP_FULLY_CONNECTED, OP_FULLY_CONNECTED, OP_SOFTMAX, };
+{OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_DEPTHWISE_CONV_2D, OP_CONV_2D, OP_MEAN, OP_FULLY_CONNECTED, OP_FULLY_CONNECTED, OP_SOFTMAX, };
 
 
 // Indices into tflTensors and tflNodes for subgraphs
 const size_t tflTensors_subgraph_index[] = {0, 98, };
-const size_t tflNodes_subgraph_index[] = {0, 36, };
+const size_t tflNodes_subgraph_index[] = {0, 31, };
 
 // Input/output tensors
 static const int in_tensor_indices[] = {
-  0, 
+  62, 
 };
 
 static const int out_tensor_indices[] = {
   97, 
 };
 
-
-size_t current_subgraph_index = 0;
-
-static void init_tflite_tensor(size_t i, TfLiteTensor *tensor) {
-  tensor->type = tensorData[i].type;
-  tensor->is_variable = false;
-
+static bool is_arena_tensor(size_t i) {
 #if defined(EI_CLASSIFIER_ALLOCATION_HEAP)
-  tensor->allocation_type = tensorData[i].allocation_type;
+  return tensorData[i].allocation_type == kTfLiteArenaRw;
 #else
-  tensor->allocation_type = (tensor_arena <= tensorData[i].data && tensorData[i].data < tensor_arena + kTensorArenaSize) ? kTfLiteArenaRw : kTfLiteMmapRo;
+  return tensor_arena <= tensorData[i].data && tensorData[i].data < tensor_arena + kTensorArenaSize;
 #endif
-  tensor->bytes = tensorData[i].bytes;
-  tensor->dims = tensorData[i].dims;
-
-#if defined(EI_CLASSIFIER_ALLOCATION_HEAP)
-  if(tensor->allocation_type == kTfLiteArenaRw){
-    uint8_t* start = (uint8_t*) ((uintptr_t)tensorData[i].data + (uintptr_t) tensor_arena);
+}
 
-    tensor->data.data =  start;
-  }
-  else {
-      tensor->data.data = tensorData[i].data;
+// Arena tensors are stored as offsets (heap allocation) or as pointers into
+// tensor_arena (static allocation); both resolve against the graph's own arena.
+static void* tensor_data(const GraphContext *graph, size_t i) {
+  if (!is_arena_tensor(i)) {
+    return tensorData[i].data;
   }
+#if defined(EI_CLASSIFIER_ALLOCATION_HEAP)
+  uintptr_t offset = (uintptr_t)tensorData[i].data;
 #else
-  tensor->data.data = tensorData[i].data;
-#endif // EI_CLASSIFIER_ALLOCATION_HEAP
+  uintptr_t offset = (uintptr_t)((uint8_t*)tensorData[i].data - tensor_arena);
+#endif
+  return graph->arena + offset;
+}
+
+static void init_tflite_tensor(const GraphContext *graph, size_t i, TfLiteTensor *tensor) {
+  tensor->type = tensorData[i].type;
+  tensor->is_variable = false;
+  tensor->allocation_type = is_arena_tensor(i) ? kTfLiteArenaRw : kTfLiteMmapRo;
+  tensor->bytes = tensorData[i].bytes;
+  tensor->dims = tensorData[i].dims;
+  tensor->data.data = tensor_data(graph, i);
   tensor->quantization = tensorData[i].quantization;
   if (tensor->quantization.type == kTfLiteAffineQuantization) {
     TfLiteAffineQuantization const* quant = ((TfLiteAffineQuantization const*)(tensorData[i].quantization.params));
@@ -1562,36 +1593,23 @@ static void init_tflite_tensor(size_t i, TfLiteTensor *tensor) {
 
 }
 
-static void init_tflite_eval_tensor(int i, TfLiteEvalTensor *tensor) {
+static void init_tflite_eval_tensor(const GraphContext *graph, int i, TfLiteEvalTensor *tensor) {
 
   tensor->type = tensorData[i].type;
 
   tensor->dims = tensorData[i].dims;
 
-#if defined(EI_CLASSIFIER_ALLOCATION_HEAP)
-  auto allocation_type = tensorData[i].allocation_type;
-  if(allocation_type == kTfLiteArenaRw) {
-    uint8_t* start = (uint8_t*) ((uintptr_t)tensorData[i].data + (uintptr_t) tensor_arena);
-
-    tensor->data.data =  start;
-  }
-  else {
-    tensor->data.data = tensorData[i].data;
-  }
-#else
-  tensor->data.data = tensorData[i].data;
-#endif // EI_CLASSIFIER_ALLOCATION_HEAP
+  tensor->data.data = tensor_data(graph, i);
 }
 
-static void* overflow_buffers[EI_MAX_OVERFLOW_BUFFER_COUNT];
-static size_t overflow_buffers_ix = 0;
 static void * AllocatePersistentBufferImpl(struct TfLiteContext* ctx,
                                        size_t bytes) {
+  GraphContext *graph = graph_of(ctx);
   void *ptr;
   uint32_t align_bytes = (bytes % 16) ? 16 - (bytes % 16) : 0;
 
-  if (current_location - (bytes + align_bytes) < tensor_boundary) {
-    if (overflow_buffers_ix > EI_MAX_OVERFLOW_BUFFER_COUNT - 1) {
+  if (graph->current_location - (bytes + align_bytes) < graph->tensor_boundary) {
+    if (graph->overflow_buffers_ix > EI_MAX_OVERFLOW_BUFFER_COUNT - 1) {
       ei_printf("ERR: Failed to allocate persistent buffer of size %d, does not fit in tensor arena and reached EI_MAX_OVERFLOW_BUFFER_COUNT\n",
         (int)bytes);
       return NULL;
@@ -1604,33 +1622,26 @@ static void * AllocatePersistentBufferImpl(struct TfLiteContext* ctx,
       ei_printf("ERR: Failed to allocate persistent buffer of size %d\n", (int)bytes);
       return NULL;
     }
-    overflow_buffers[overflow_buffers_ix++] = ptr;
+    graph->overflow_buffers[graph->overflow_buffers_ix++] = ptr;
     return ptr;
   }
 
-  current_location -= bytes;
+  graph->current_location -= bytes;
 
   // align to the left aligned boundary of 16 bytes
-  current_location -= 15; // for alignment
-  current_location += 16 - ((uintptr_t)(current_location) & 15);
+  graph->current_location -= 15; // for alignment
+  graph->current_location += 16 - ((uintptr_t)(graph->current_location) & 15);
 
-  ptr = current_location;
+  ptr = graph->current_location;
   memset(ptr, 0, bytes);
 
   return ptr;
 }
 
-typedef struct {
-  size_t bytes;
-  void *ptr;
-} scratch_buffer_t;
-
-static scratch_buffer_t scratch_buffers[EI_MAX_SCRATCH_BUFFER_COUNT];
-static size_t scratch_buffers_ix = 0;
-
 static TfLiteStatus RequestScratchBufferInArenaImpl(struct TfLiteContext* ctx, size_t bytes,
                                                 int* buffer_idx) {
-  if (scratch_buffers_ix > EI_MAX_SCRATCH_BUFFER_COUNT - 1) {
+  GraphContext *graph = graph_of(ctx);
+  if (graph->scratch_buffers_ix > EI_MAX_SCRATCH_BUFFER_COUNT - 1) {
     ei_printf("ERR: Failed to allocate scratch buffer of size %d, reached EI_MAX_SCRATCH_BUFFER_COUNT\n",
       (int)bytes);
     return kTfLiteError;
@@ -1646,36 +1657,39 @@ static TfLiteStatus RequestScratchBufferInArenaImpl(struct TfLiteContext* ctx, s
     return kTfLiteError;
   }
 
-  scratch_buffers[scratch_buffers_ix] = b;
-  *buffer_idx = scratch_buffers_ix;
+  graph->scratch_buffers[graph->scratch_buffers_ix] = b;
+  *buffer_idx = graph->scratch_buffers_ix;
 
-  scratch_buffers_ix++;
+  graph->scratch_buffers_ix++;
 
   return kTfLiteOk;
 }
 
 static void* GetScratchBufferImpl(struct TfLiteContext* ctx, int buffer_idx) {
-  if (buffer_idx > (int)scratch_buffers_ix) {
+  GraphContext *graph = graph_of(ctx);
+  if (buffer_idx > (int)graph->scratch_buffers_ix) {
     return NULL;
   }
-  return scratch_buffers[buffer_idx].ptr;
+  return graph->scratch_buffers[buffer_idx].ptr;
 }
 
 static const uint16_t TENSOR_IX_UNUSED = 0x7FFF;
 
-static void ResetTensors() {
+static void ResetTensors(GraphContext *graph) {
   for (size_t ix = 0; ix < MAX_TFL_TENSOR_COUNT; ix++) {
-    tflTensors[ix].index = TENSOR_IX_UNUSED;
+    graph->tflTensors[ix].index = TENSOR_IX_UNUSED;
   }
   for (size_t ix = 0; ix < MAX_TFL_EVAL_COUNT; ix++) {
-    tflEvalTensors[ix].index = TENSOR_IX_UNUSED;
+    graph->tflEvalTensors[ix].index = TENSOR_IX_UNUSED;
   }
 }
 
 static TfLiteTensor* GetTensorImpl(const struct TfLiteContext* context,
                                int tensor_idx) {
+  GraphContext *graph = graph_of(context);
+  TfLiteTensorWithIndex *tflTensors = graph->tflTensors;
 
-  tensor_idx = tflTensors_subgraph_index[current_subgraph_index] + tensor_idx;
+  tensor_idx = tflTensors_subgraph_index[graph->current_subgraph_index] + tensor_idx;
 
   for (size_t ix = 0; ix < MAX_TFL_TENSOR_COUNT; ix++) {
     // already used? OK!
@@ -1685,7 +1699,7 @@ static TfLiteTensor* GetTensorImpl(const struct TfLiteContext* context,
     // passed all the ones we've used, so end of the list?
     if (tflTensors[ix].index == TENSOR_IX_UNUSED) {
       // init the tensor
-      init_tflite_tensor(tensor_idx, &tflTensors[ix].tensor);
+      init_tflite_tensor(graph, tensor_idx, &tflTensors[ix].tensor);
       tflTensors[ix].index = tensor_idx;
       return &tflTensors[ix].tensor;
     }
@@ -1697,8 +1711,10 @@ static TfLiteTensor* GetTensorImpl(const struct TfLiteContext* context,
 
 static TfLiteEvalTensor* GetEvalTensorImpl(const struct TfLiteContext* context,
                                        int tensor_idx) {
+  GraphContext *graph = graph_of(context);
+  TfLiteEvalTensorWithIndex *tflEvalTensors = graph->tflEvalTensors;
 
-  tensor_idx = tflTensors_subgraph_index[current_subgraph_index] + tensor_idx;
+  tensor_idx = tflTensors_subgraph_index[graph->current_subgraph_index] + tensor_idx;
 
   for (size_t ix = 0; ix < MAX_TFL_EVAL_COUNT; ix++) {
     // already used? OK!
@@ -1708,7 +1724,7 @@ static TfLiteEvalTensor* GetEvalTensorImpl(const struct TfLiteContext* context,
     // passed all the ones we've used, so end of the list?
     if (tflEvalTensors[ix].index == TENSOR_IX_UNUSED) {
       // init the tensor
-      init_tflite_eval_tensor(tensor_idx, &tflEvalTensors[ix].tensor);
+      init_tflite_eval_tensor(graph, tensor_idx, &tflEvalTensors[ix].tensor);
       tflEvalTensors[ix].index = tensor_idx;
       return &tflEvalTensors[ix].tensor;
     }
@@ -1718,62 +1734,97 @@ static TfLiteEvalTensor* GetEvalTensorImpl(const struct TfLiteContext* context,
   return nullptr;
 }
 
-class EonMicroContext : public MicroContext {
- public:
- 
-  EonMicroContext(): MicroContext(nullptr, nullptr, nullptr) { }
+void* EonMicroContext::AllocatePersistentBuffer(size_t bytes) {
+  return AllocatePersistentBufferImpl(&graph_->ctx, bytes);
+}
 
-  void* AllocatePersistentBuffer(size_t bytes) {
-    return AllocatePersistentBufferImpl(nullptr, bytes);
-  }
+TfLiteStatus EonMicroContext::RequestScratchBufferInArena(size_t bytes,
+                                                          int* buffer_index) {
+  return RequestScratchBufferInArenaImpl(&graph_->ctx, bytes, buffer_index);
+}
 
-  TfLiteStatus RequestScratchBufferInArena(size_t bytes,
-                                           int* buffer_index) {
-  return RequestScratchBufferInArenaImpl(nullptr, bytes, buffer_index);
-  }
+void* EonMicroContext::GetScratchBuffer(int buffer_index) {
+  return GetScratchBufferImpl(&graph_->ctx, buffer_index);
+}
 
-  void* GetScratchBuffer(int buffer_index) {
-    return GetScratchBufferImpl(nullptr, buffer_index);
-  }
- 
-  TfLiteTensor* AllocateTempTfLiteTensor(int tensor_index) {
-    return GetTensorImpl(nullptr, tensor_index);
-  }
+TfLiteTensor* EonMicroContext::AllocateTempTfLiteTensor(int tensor_index) {
+  return GetTensorImpl(&graph_->ctx, tensor_index);
+}
 
-  void DeallocateTempTfLiteTensor(TfLiteTensor* tensor) {
-    return;
-  }
+TfLiteEvalTensor* EonMicroContext::GetEvalTensor(int tensor_index) {
+  return GetEvalTensorImpl(&graph_->ctx, tensor_index);
+}
 
-  bool IsAllTempTfLiteTensorDeallocated() {
-    return true;
-  }
+#if EI_CLASSIFIER_PROFILE_NODES
+// builtin operator of every entry of used_operators_e
+const uint16_t used_op_builtins[OP_LAST] = {
+  kTfLiteBuiltinReshape, kTfLiteBuiltinConv2d, kTfLiteBuiltinDepthwiseConv2d, kTfLiteBuiltinPad,
+  kTfLiteBuiltinMean, kTfLiteBuiltinFullyConnected, kTfLiteBuiltinSoftmax,
+};
 
-  TfLiteEvalTensor* GetEvalTensor(int tensor_index) {
-    return GetEvalTensorImpl(nullptr, tensor_index);
+static uint32_t tensor_elements(const TfLiteIntArray *dims) {
+  uint32_t elements = 1;
+  for (int ix = 0; ix < dims->size; ix++) {
+    elements *= dims->data[ix];
   }
+  return elements;
+}
 
-};
+// multiply-accumulates of node i, from its output and weight dims
+static uint32_t node_macs(size_t i) {
+  const TfLiteIntArray *inputs = tflNodes[i].inputs;
+  const uint32_t out_elements = tensor_elements(tensorData[tflNodes[i].outputs->data[0]].dims);
 
+  switch (used_ops[i]) {
+    case OP_CONV_2D: { // filter [out channels, h, w, in channels]
+      const TfLiteIntArray *filter = tensorData[inputs->data[1]].dims;
+      return out_elements * filter->data[1] * filter->data[2] * filter->data[3];
+    }
+    case OP_DEPTHWISE_CONV_2D: { // filter [1, h, w, channels]
+      const TfLiteIntArray *filter = tensorData[inputs->data[1]].dims;
+      return out_elements * filter->data[1] * filter->data[2];
+    }
+    case OP_FULLY_CONNECTED: { // weights [units, inputs]
+      const TfLiteIntArray *weights = tensorData[inputs->data[1]].dims;
+      return out_elements * weights->data[1];
+    }
+    default:
+      return 0;
+  }
+}
 
-} // namespace
+// bytes of the arena tensors node i reads and writes
+static uint32_t node_arena_bytes(const GraphContext *graph, size_t i) {
+  const TfLiteIntArray *lists[2] = { tflNodes[i].inputs, tflNodes[i].outputs };
+  uint32_t bytes = 0;
 
-TfLiteStatus tflite_learn_820755_3_init( void*(*alloc_fnc)(size_t,size_t) ) {
-#ifdef EI_CLASSIFIER_ALLOCATION_HEAP
-  tensor_arena = (uint8_t*) alloc_fnc(16, kTensorArenaSize);
-  if (!tensor_arena) {
-    ei_printf("ERR: failed to allocate tensor arena\n");
-    return kTfLiteError;
+  for (size_t l = 0; l < 2; l++) {
+    for (int ix = 0; ix < lists[l]->size; ix++) {
+      if (lists[l]->data[ix] < 0) {
+        continue;
+      }
+      TfLiteTensor tensor;
+      init_tflite_tensor(graph, lists[l]->data[ix], &tensor);
+      if (tensor.allocation_type == kTfLiteArenaRw) {
+        bytes += tensor.bytes;
+      }
+    }
   }
-#else
-  memset(tensor_arena, 0, kTensorArenaSize);
-#endif
-  tensor_boundary = tensor_arena;
-  current_location = tensor_arena + kTensorArenaSize;
+  return bytes;
+}
+#endif // EI_CLASSIFIER_PROFILE_NODES
+
+
+// Init and prepare of every node, with graph->arena and graph->nodes set
+static TfLiteStatus init_graph(GraphContext *graph) {
+  TfLiteContext &ctx = graph->ctx;
+  TfLiteRegistration *registrations = graph->registrations;
+
+  graph->tensor_boundary = graph->arena;
+  graph->current_location = graph->arena + kTensorArenaSize;
 
-  EonMicroContext micro_context_;
-  
   // Set microcontext as the context ptr
-  ctx.impl_ = static_cast<void*>(&micro_context_);
+  ctx.impl_ = static_cast<void*>(&graph->micro_context);
   // Setup tflitecontext functions
   ctx.AllocatePersistentBuffer = &AllocatePersistentBufferImpl;
   ctx.RequestScratchBufferInArena = &RequestScratchBufferInArenaImpl;
@@ -1785,82 +1836,74 @@ TfLiteStatus tflite_learn_820755_3_init( void*(*alloc_fnc)(size_t,size_t) ) {
   ctx.tensors_size = 98;
   for (size_t i = 0; i < 98; ++i) {
     TfLiteTensor tensor;
-    init_tflite_tensor(i, &tensor);
+    init_tflite_tensor(graph, i, &tensor);
     if (tensor.allocation_type == kTfLiteArenaRw) {
       auto data_end_ptr = (uint8_t*)tensor.data.data + tensorData[i].bytes;
-      if (data_end_ptr > tensor_boundary) {
-        tensor_boundary = data_end_ptr;
+      if (data_end_ptr > graph->tensor_boundary) {
+        graph->tensor_boundary = data_end_ptr;
       }
     }
   }
 
-  if (tensor_boundary > current_location /* end of arena size */) {
+  if (graph->tensor_boundary > graph->current_location /* end of arena size */) {
     ei_printf("ERR: tensor arena is too small, does not fit model - even without scratch buffers\n");
     return kTfLiteError;
   }
 
-  registrations[OP_RESHAPE] = Register_RESHAPE();
   registrations[OP_CONV_2D] = Register_CONV_2D();
   registrations[OP_DEPTHWISE_CONV_2D] = Register_DEPTHWISE_CONV_2D();
-  registrations[OP_PAD] = Register_PAD();
   registrations[OP_MEAN] = Register_MEAN();
   registrations[OP_FULLY_CONNECTED] = Register_FULLY_CONNECTED();
   registrations[OP_SOFTMAX] = Register_SOFTMAX();
 
   for (size_t g = 0; g < 1; ++g) {
-    current_subgraph_index = g;
+    graph->current_subgraph_index = g;
     for(size_t i = tflNodes_subgraph_index[g]; i < tflNodes_subgraph_index[g+1]; ++i) {
       if (registrations[used_ops[i]].init) {
-        tflNodes[i].user_data = registrations[used_ops[i]].init(&ctx, (const char*)tflNodes[i].builtin_data, 0);
+        graph->nodes[i].user_data = registrations[used_ops[i]].init(&ctx, (const char*)graph->nodes[i].builtin_data, 0);
       }
     }
   }
-  current_subgraph_index = 0;
+  graph->current_subgraph_index = 0;
 
   for(size_t g = 0; g < 1; ++g) {
-    current_subgraph_index = g;
+    graph->current_subgraph_index = g;
     for(size_t i = tflNodes_subgraph_index[g]; i < tflNodes_subgraph_index[g+1]; ++i) {
       if (registrations[used_ops[i]].prepare) {
-        ResetTensors();
-        TfLiteStatus status = registrations[used_ops[i]].prepare(&ctx, &tflNodes[i]);
+        ResetTensors(graph);
+        TfLiteStatus status = registrations[used_ops[i]].prepare(&ctx, &graph->nodes[i]);
         if (status != kTfLiteOk) {
           return status;
         }
       }
     }
   }
-  current_subgraph_index = 0;
-
-  return kTfLiteOk;
-}
+  graph->current_subgraph_index = 0;
 
-TfLiteStatus tflite_learn_820755_3_input(int index, TfLiteTensor *tensor) {
-  init_tflite_tensor(in_tensor_indices[index], tensor);
   return kTfLiteOk;
 }
 
-TfLiteStatus tflite_learn_820755_3_output(int index, TfLiteTensor *tensor) {
-  init_tflite_tensor(out_tensor_indices[index], tensor);
-  return kTfLiteOk;
-}
-
-TfLiteStatus tflite_learn_820755_3_invoke() {
-  for (size_t i = 0; i < 36; ++i) {
-    ResetTensors();
+// Runs every node of the graph
+static TfLiteStatus invoke_graph(GraphContext *graph) {
+  for (size_t i = 0; i < 31; ++i) {
+    ResetTensors(graph);
 
-    TfLiteStatus status = registrations[used_ops[i]].invoke(&ctx, &tflNodes[i]);
+#if EI_CLASSIFIER_PROFILE_NODES
+    const uint64_t node_start_cycles = ei_read_cycles();
+#endif
+    TfLiteStatus status = graph->registrations[used_ops[i]].invoke(&graph->ctx, &graph->nodes[i]);
+#if EI_CLASSIFIER_PROFILE_NODES
+    ei_node_profiler_record(i, used_op_builtins[used_ops[i]], (uint32_t)(ei_read_cycles() - node_start_cycles),
+      node_macs(i), node_arena_bytes(graph, i));
+#endif
 
 #if EI_CLASSIFIER_PRINT_STATE
     ei_printf("layer %lu\n", i);
     ei_printf("    inputs:\n");
-    for (size_t ix = 0; ix < tflNodes[i].inputs->size; ix++) {
-      auto d = tensorData[tflNodes[i].inputs->data[ix]];
-
-      size_t data_ptr = (size_t)d.data;
+    for (size_t ix = 0; ix < graph->nodes[i].inputs->size; ix++) {
+      auto d = tensorData[graph->nodes[i].inputs->data[ix]];
 
-      if (d.allocation_type == kTfLiteArenaRw) {
-        data_ptr = (size_t)tensor_arena + data_ptr;
-      }
+      size_t data_ptr = (size_t)tensor_data(graph, graph->nodes[i].inputs->data[ix]);
 
       if (d.type == TfLiteType::kTfLiteInt8) {
         int8_t* data = (int8_t*)data_ptr;
@@ -1881,14 +1924,10 @@ TfLiteStatus tflite_learn_820755_3_invoke() {
     ei_printf("\n");
 
     ei_printf("    outputs:\n");
-    for (size_t ix = 0; ix < tflNodes[i].outputs->size; ix++) {
-      auto d = tensorData[tflNodes[i].outputs->data[ix]];
-
-      size_t data_ptr = (size_t)d.data;
+    for (size_t ix = 0; ix < graph->nodes[i].outputs->size; ix++) {
+      auto d = tensorData[graph->nodes[i].outputs->data[ix]];
 
-      if (d.allocation_type == kTfLiteArenaRw) {
-        data_ptr = (size_t)tensor_arena + data_ptr;
-      }
+      size_t data_ptr = (size_t)tensor_data(graph, graph->nodes[i].outputs->data[ix]);
 
       if (d.type == TfLiteType::kTfLiteInt8) {
         int8_t* data = (int8_t*)data_ptr;
@@ -1916,18 +1955,150 @@ TfLiteStatus tflite_learn_820755_3_invoke() {
   return kTfLiteOk;
 }
 
-TfLiteStatus tflite_learn_820755_3_reset( void (*free_fnc)(void* ptr) ) {
-#ifdef EI_CLASSIFIER_ALLOCATION_HEAP
-  free_fnc(tensor_arena);
+// Node by node over a batch of graphs: every kernel runs on all of them before
+// the next one starts. Kernels reading the constant weights (reference,
+// CMSIS-NN) then find them in cache after the first graph; the x86 kernels
+// repack the weights in Prepare into each graph's own persistent buffer, so
+// they still read one copy per graph
+static TfLiteStatus invoke_graph_batch(GraphContext *const *graphs, size_t count) {
+  for (size_t i = 0; i < 31; ++i) {
+#if EI_CLASSIFIER_PROFILE_NODES
+    const uint64_t node_start_cycles = ei_read_cycles();
+#endif
+    for (size_t b = 0; b < count; ++b) {
+      GraphContext *graph = graphs[b];
+      ResetTensors(graph);
+      TfLiteStatus status = graph->registrations[used_ops[i]].invoke(&graph->ctx, &graph->nodes[i]);
+      if (status != kTfLiteOk) {
+        return status;
+      }
+    }
+#if EI_CLASSIFIER_PROFILE_NODES
+    // the whole batch: cycles and MACs of all graphs
+    ei_node_profiler_record(i, used_op_builtins[used_ops[i]], (uint32_t)(ei_read_cycles() - node_start_cycles),
+      node_macs(i) * count, node_arena_bytes(graphs[0], i));
 #endif
+  }
+  return kTfLiteOk;
+}
 
+// Scratch buffers are in the arena, overflow buffers on the heap
+static void reset_graph(GraphContext *graph) {
   // scratch buffers are allocated within the arena, so just reset the counter so memory can be reused
-  scratch_buffers_ix = 0;
+  graph->scratch_buffers_ix = 0;
 
   // overflow buffers are on the heap, so free them first
-  for (size_t ix = 0; ix < overflow_buffers_ix; ix++) {
-    ei_free(overflow_buffers[ix]);
+  for (size_t ix = 0; ix < graph->overflow_buffers_ix; ix++) {
+    ei_free(graph->overflow_buffers[ix]);
   }
-  overflow_buffers_ix = 0;
+  graph->overflow_buffers_ix = 0;
+}
+
+// The arena below the persistent buffers only holds tensors, none of which is
+// live outside invoke_graph
+static TfLiteStatus idle_arena(const GraphContext *graph, uint8_t **start, size_t *bytes) {
+  if (!graph->arena) {
+    return kTfLiteError;
+  }
+  *start = graph->arena;
+  *bytes = (size_t)(graph->current_location - graph->arena);
+  return kTfLiteOk;
+}
+
+// Caller memory of the _ctx API: the GraphContext, its nodes, its arena
+constexpr size_t kContextNodesOffset = (sizeof(GraphContext) + 15) & ~(size_t)15;
+constexpr size_t kContextArenaOffset = (kContextNodesOffset + sizeof(tflNodes) + 15) & ~(size_t)15;
+
+} // namespace
+
+TfLiteStatus tflite_learn_820755_3_init( void*(*alloc_fnc)(size_t,size_t) ) {
+#ifdef EI_CLASSIFIER_ALLOCATION_HEAP
+  default_graph.arena = (uint8_t*) alloc_fnc(16, kTensorArenaSize);
+  if (!default_graph.arena) {
+    ei_printf("ERR: failed to allocate tensor arena\n");
+    return kTfLiteError;
+  }
+#else
+  default_graph.arena = tensor_arena;
+  memset(tensor_arena, 0, kTensorArenaSize);
+#endif
+  default_graph.nodes = tflNodes;
+
+  return init_graph(&default_graph);
+}
+
+TfLiteStatus tflite_learn_820755_3_input(int index, TfLiteTensor *tensor) {
+  init_tflite_tensor(&default_graph, in_tensor_indices[index], tensor);
+  return kTfLiteOk;
+}
+
+TfLiteStatus tflite_learn_820755_3_output(int index, TfLiteTensor *tensor) {
+  init_tflite_tensor(&default_graph, out_tensor_indices[index], tensor);
+  return kTfLiteOk;
+}
+
+TfLiteStatus tflite_learn_820755_3_invoke() {
+  return invoke_graph(&default_graph);
+}
+
+TfLiteStatus tflite_learn_820755_3_idle_arena(uint8_t **start, size_t *bytes) {
+  return idle_arena(&default_graph, start, bytes);
+}
+
+TfLiteStatus tflite_learn_820755_3_reset( void (*free_fnc)(void* ptr) ) {
+#ifdef EI_CLASSIFIER_ALLOCATION_HEAP
+  free_fnc(default_graph.arena);
+  default_graph.arena = NULL;
+#endif
+
+  reset_graph(&default_graph);
+  return kTfLiteOk;
+}
+
+size_t tflite_learn_820755_3_context_size() {
+  return kContextArenaOffset + kTensorArenaSize;
+}
+
+TfLiteStatus tflite_learn_820755_3_init_ctx(void *ctx) {
+  uint8_t *mem = (uint8_t*)ctx;
+  GraphContext *graph = new (mem) GraphContext();
+
+  graph->nodes = (TfLiteNode*)(mem + kContextNodesOffset);
+  memcpy(graph->nodes, tflNodes, sizeof(tflNodes));
+  for (size_t i = 0; i < 31; ++i) {
+    graph->nodes[i].user_data = nullptr;
+  }
+  graph->arena = mem + kContextArenaOffset;
+  memset(graph->arena, 0, kTensorArenaSize);
+
+  return init_graph(graph);
+}
+
+TfLiteStatus tflite_learn_820755_3_input_ctx(void *ctx, int index, TfLiteTensor *tensor) {
+  init_tflite_tensor((GraphContext*)ctx, in_tensor_indices[index], tensor);
+  return kTfLiteOk;
+}
+
+TfLiteStatus tflite_learn_820755_3_output_ctx(void *ctx, int index, TfLiteTensor *tensor) {
+  init_tflite_tensor((GraphContext*)ctx, out_tensor_indices[index], tensor);
+  return kTfLiteOk;
+}
+
+TfLiteStatus tflite_learn_820755_3_invoke_ctx(void *ctx) {
+  return invoke_graph((GraphContext*)ctx);
+}
+
+TfLiteStatus tflite_learn_820755_3_idle_arena_ctx(void *ctx, uint8_t **start, size_t *bytes) {
+  return idle_arena((GraphContext*)ctx, start, bytes);
+}
+
+TfLiteStatus tflite_learn_820755_3_invoke_batch_ctx(void *const *ctxs, size_t count) {
+  return invoke_graph_batch((GraphContext *const *)ctxs, count);
+}
+
+TfLiteStatus tflite_learn_820755_3_reset_ctx(void *ctx) {
+  GraphContext *graph = (GraphContext*)ctx;
+  reset_graph(graph);
+  graph->~GraphContext();
   return kTfLiteOk;
 }
@@ -45,6 +45,28 @@ TfLiteStatus tflite_learn_820755_3_output(int index, TfLiteTensor* tensor);
 TfLiteStatus tflite_learn_820755_3_invoke();
 //Frees memory allocated
 TfLiteStatus tflite_learn_820755_3_reset( void (*free)(void* ptr) );
+// The part of the (initialized) arena that only holds tensors, so is idle
+// outside invoke: everything below the kernels' persistent buffers.
+TfLiteStatus tflite_learn_820755_3_idle_arena(uint8_t **start, size_t *bytes);
+
+// Re-entrant variants: every context is an independent instance of the model
+// (tensors, kernel data, arena) in caller memory, so contexts can be invoked
+// concurrently. Bytes (16-byte aligned) one context needs, arena included.
+size_t tflite_learn_820755_3_context_size();
+// Sets up the model in ctx with init and prepare steps.
+TfLiteStatus tflite_learn_820755_3_init_ctx(void *ctx);
+// Returns the input tensor with the given index, in ctx's arena.
+TfLiteStatus tflite_learn_820755_3_input_ctx(void *ctx, int index, TfLiteTensor* tensor);
+// Returns the output tensor with the given index, in ctx's arena.
+TfLiteStatus tflite_learn_820755_3_output_ctx(void *ctx, int index, TfLiteTensor* tensor);
+// Runs inference on ctx.
+TfLiteStatus tflite_learn_820755_3_invoke_ctx(void *ctx);
+// tflite_learn_820755_3_idle_arena of ctx.
+TfLiteStatus tflite_learn_820755_3_idle_arena_ctx(void *ctx, uint8_t **start, size_t *bytes);
+// Runs inference on count contexts at once, layer by layer across all of them.
+TfLiteStatus tflite_learn_820755_3_invoke_batch_ctx(void *const *ctxs, size_t count);
+// Frees the overflow buffers of ctx; the caller frees ctx itself.
+TfLiteStatus tflite_learn_820755_3_reset_ctx(void *ctx);
 
 
 // Returns the number of input tensors.